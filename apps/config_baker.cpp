@@ -0,0 +1,9 @@
+#include "boke/framework.h"
+#include "spdlog/spdlog.h"
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    spdlog::error("usage: config_baker <config json> <baked config>");
+    return 1;
+  }
+  return boke::BakeConfig(argv[1], argv[2]);
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "boke/allocator.h"
+#include "boke/job_system.h"
+#include "spdlog/spdlog.h"
+namespace {
+using namespace boke;
+void EmptyJob(JobSystem*, Job*, void*) {}
+struct FibonacciJobData {
+  uint32_t n{};
+  uint64_t result{};
+};
+uint64_t Fibonacci(const uint32_t n) {
+  if (n < 2) { return n; }
+  return Fibonacci(n - 1) + Fibonacci(n - 2);
+}
+/**
+ * fork-join down to a serial cutoff, measures spawn, steal and join overhead.
+ **/
+void FibonacciJob(JobSystem* job_system, Job*, void* user_data) {
+  const uint32_t serial_cutoff = 12;
+  auto data = static_cast<FibonacciJobData*>(user_data);
+  if (data->n < serial_cutoff) {
+    data->result = Fibonacci(data->n);
+    return;
+  }
+  FibonacciJobData child_data[2]{{.n = data->n - 1,}, {.n = data->n - 2,}};
+  auto join = CreateJob(job_system, EmptyJob, nullptr);
+  for (auto& d : child_data) {
+    RunJob(job_system, CreateChildJob(job_system, join, FibonacciJob, &d));
+  }
+  RunJob(job_system, join);
+  WaitJob(job_system, join);
+  data->result = child_data[0].result + child_data[1].result;
+}
+auto RunForkJoin(JobSystem* job_system, const uint32_t n) {
+  FibonacciJobData data{.n = n,};
+  auto job = CreateJob(job_system, FibonacciJob, &data);
+  RunJob(job_system, job);
+  WaitJob(job_system, job);
+  return data.result;
+}
+struct ParallelForData {
+  const float* src{};
+  float* dst{};
+};
+/**
+ * a few hundred flops per element, roughly a per-object transform and cull.
+ **/
+void TransformRange(void* user_data, const uint32_t begin, const uint32_t end) {
+  auto data = static_cast<ParallelForData*>(user_data);
+  for (uint32_t i = begin; i < end; i++) {
+    auto v = data->src[i];
+    for (uint32_t j = 0; j < 64; j++) {
+      v = std::sin(v) * 0.5f + std::cos(v) * 0.5f;
+    }
+    data->dst[i] = v;
+  }
+}
+template <typename F>
+auto MeasureMilliseconds(const uint32_t iteration_num, F&& func) {
+  const auto start = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < iteration_num; i++) {
+    func();
+  }
+  const auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / iteration_num;
+}
+void RunBenchmark(const uint32_t worker_thread_num, const uint32_t element_num, const float* src, float* dst) {
+  auto job_system = CreateJobSystem(worker_thread_num);
+  const uint32_t iteration_num = 10;
+  const uint32_t fibonacci_n = 30;
+  uint64_t fibonacci_result = 0;
+  const auto fork_join_ms = MeasureMilliseconds(iteration_num, [&]() { fibonacci_result = RunForkJoin(job_system, fibonacci_n); });
+  ParallelForData data{.src = src, .dst = dst,};
+  const auto parallel_for_ms = MeasureMilliseconds(iteration_num, [&]() { ParallelFor(job_system, element_num, 256, TransformRange, &data); });
+  const uint32_t small_element_num = 1024;
+  const auto small_parallel_for_ms = MeasureMilliseconds(iteration_num * 100, [&]() { ParallelFor(job_system, small_element_num, 64, TransformRange, &data); });
+  spdlog::info("threads:{:2} fork-join fib({}):{:8.3f}ms parallel-for {}:{:8.3f}ms parallel-for {}:{:8.3f}ms",
+               GetJobSystemThreadNum(job_system), fibonacci_n, fork_join_ms, element_num, parallel_for_ms, small_element_num, small_parallel_for_ms);
+  if (fibonacci_result != Fibonacci(fibonacci_n)) {
+    spdlog::error("fork-join result mismatch {}", fibonacci_result);
+  }
+  ReleaseJobSystem(job_system);
+}
+} // namespace
+int main(int argc, char* argv[]) {
+  const uint32_t main_buffer_size_in_bytes = 32 * 1024 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  const uint32_t max_thread_num = (argc > 1) ? static_cast<uint32_t>(std::atoi(argv[1])) : std::max(std::thread::hardware_concurrency(), 1U);
+  const uint32_t element_num = 1024 * 1024;
+  auto src = AllocateArray<float>(element_num);
+  auto dst = AllocateArray<float>(element_num);
+  for (uint32_t i = 0; i < element_num; i++) {
+    src[i] = static_cast<float>(i) / element_num;
+  }
+  for (uint32_t thread_num = 1; thread_num <= max_thread_num; thread_num *= 2) {
+    RunBenchmark(thread_num - 1, element_num, src, dst);
+  }
+  Deallocate(dst);
+  Deallocate(src);
+  return 0;
+}
@@ -4,6 +4,12 @@ namespace boke {
 void InitAllocator(void* buffer, const uint32_t buffer_size_in_bytes);
 void* Allocate(const uint32_t size_in_bytes, const uint32_t alignment);
 void Deallocate(void* ptr);
+struct AllocatorStats {
+  uint32_t total_size{};
+  uint32_t free_size{};
+  uint32_t largest_free_region{};
+};
+AllocatorStats GetAllocatorStats();
 template <typename T>
 T* Allocate() {
   auto buf = Allocate(sizeof(T), alignof(T));
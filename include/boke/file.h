@@ -2,4 +2,21 @@
 namespace boke {
 char* LoadFileToBuffer(const char* const filepath);
 char* LoadFileToBuffer(const char* const filepath, uint32_t* bytes_read);
+/**
+ * read-only view of a file mapped to memory.
+ * buffer is not null-terminated.
+ * buffer is nullptr if the file could not be mapped or is empty.
+ **/
+struct MappedFile {
+  const char* buffer{};
+  uint64_t size{};
+};
+MappedFile MapFile(const char* const filepath);
+/**
+ * same as MapFile but pages are copied on write, so buffer may be modified after a const_cast.
+ * changes are never written back to the file.
+ **/
+MappedFile MapFileCopyOnWrite(const char* const filepath);
+void UnmapFile(MappedFile&);
+bool SaveBufferToFile(const char* const filepath, const void* buffer, const uint32_t size);
 }
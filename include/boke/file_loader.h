@@ -0,0 +1,37 @@
+#pragma once
+namespace boke {
+struct FileLoader;
+struct FileLoadBatch;
+/**
+ * contents of a loaded file, owned by its FileLoadBatch.
+ * buffer is nullptr if the file could not be loaded or is empty.
+ **/
+struct LoadedFile {
+  const char* buffer{};
+  uint64_t size{};
+};
+/**
+ * called on the thread waiting for the batch, once per file, in completion order.
+ **/
+using FileLoadCallback = void (*)(void* user_data, const uint32_t file_index, const LoadedFile&);
+/**
+ * reads are submitted via io_uring when available (BOKE_ENABLE_IO_URING),
+ * otherwise files are mapped and paged in by worker threads.
+ * the thread waiting for a batch also processes its remaining requests,
+ * so worker_thread_num can be zero.
+ **/
+FileLoader* CreateFileLoader(const uint32_t worker_thread_num);
+void ReleaseFileLoader(FileLoader*);
+/**
+ * filepath_list must stay valid until WaitFileLoadBatch returns.
+ **/
+FileLoadBatch* SubmitFileLoadBatch(FileLoader*, const uint32_t file_num, const char* const* filepath_list);
+/**
+ * only one thread may wait for batches of a loader at a time.
+ * with io_uring, the waiting thread reaps completions of every batch from a single ring without locking,
+ * so the waits for different batches must not overlap.
+ **/
+void WaitFileLoadBatch(FileLoader*, FileLoadBatch*, FileLoadCallback callback, void* user_data);
+LoadedFile GetLoadedFile(const FileLoadBatch*, const uint32_t file_index);
+void ReleaseFileLoadBatch(FileLoadBatch*);
+}
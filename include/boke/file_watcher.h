@@ -0,0 +1,18 @@
+#pragma once
+namespace boke {
+struct FileWatcher;
+/**
+ * called from PollFileWatcher once per changed file, file_index is the index in filepath_list.
+ **/
+using FileChangeCallback = void (*)(void* user_data, const uint32_t file_index);
+/**
+ * watches directories containing the files, files written to or replaced via rename are reported.
+ * filepath_list must stay valid until ReleaseFileWatcher.
+ **/
+FileWatcher* CreateFileWatcher(const uint32_t file_num, const char* const* filepath_list);
+void ReleaseFileWatcher(FileWatcher*);
+/**
+ * returns without blocking, a file changed several times since the last call is reported once.
+ **/
+void PollFileWatcher(FileWatcher*, FileChangeCallback callback, void* user_data);
+}
@@ -1,4 +1,8 @@
 #pragma once
 namespace boke {
 int32_t Run(const char* const config_path);
+/**
+ * converts a gfx config json to the binary format loaded by LoadBakedGfxConfig.
+ **/
+int32_t BakeConfig(const char* const config_path, const char* const baked_config_path);
 }
@@ -0,0 +1,43 @@
+#pragma once
+namespace boke {
+struct JobSystem;
+struct Job;
+/**
+ * called on a worker thread or on a thread waiting in WaitJob.
+ * child jobs of job can be created and run from inside the function.
+ **/
+using JobFunc = void (*)(JobSystem*, Job* job, void* user_data);
+using ParallelForFunc = void (*)(void* user_data, const uint32_t begin, const uint32_t end);
+/**
+ * work stealing scheduler, every thread owns a deque of jobs, idle threads steal from the others.
+ * the thread calling CreateJobSystem is a worker too (worker_thread_num can be zero)
+ * and, like the worker threads, is the only one allowed to create, run and wait for jobs of the system.
+ * jobs are taken from per thread pools preallocated at creation, nothing is allocated while jobs run
+ * and the engine allocator (not thread safe) must not be used from jobs.
+ * creating a job while the pool of the thread is exhausted runs queued jobs until one is recycled.
+ **/
+JobSystem* CreateJobSystem(const uint32_t worker_thread_num);
+void ReleaseJobSystem(JobSystem*);
+uint32_t GetJobSystemThreadNum(const JobSystem*);
+Job* CreateJob(JobSystem*, JobFunc func, void* user_data);
+/**
+ * parent completes after all of its children, waiting for parent waits for the whole tree.
+ **/
+Job* CreateChildJob(JobSystem*, Job* parent, JobFunc func, void* user_data);
+void RunJob(JobSystem*, Job*);
+/**
+ * for long jobs off the frame (e.g. pso compilation), taken only when no other job is queued
+ * and run by WaitJob only while waiting for a low priority job.
+ **/
+void RunLowPriorityJob(JobSystem*, Job*);
+/**
+ * runs other jobs until job and its children are complete instead of blocking the thread.
+ * a job is recycled once complete, do not touch it after waiting for it.
+ **/
+void WaitJob(JobSystem*, const Job*);
+bool IsJobComplete(const Job*);
+/**
+ * splits [0, count) in halves recursively down to min_batch_size and waits for all of them.
+ **/
+void ParallelFor(JobSystem*, const uint32_t count, const uint32_t min_batch_size, ParallelForFunc func, void* user_data);
+}
@@ -59,9 +59,10 @@ AllocatorData* GetAllocatorData(void* buffer, const uint32_t buffer_size_in_byte
   const auto aligned_head_addr = Align(head_addr, alignof(AllocatorData));
   auto allocator_data = static_cast<AllocatorData*>(reinterpret_cast<void*>(aligned_head_addr));
   const auto offset_allocator_addr = Align(aligned_head_addr + sizeof(AllocatorData), alignof(OffsetAllocator::Allocator));
-  allocator_data->offset_allocator = new (reinterpret_cast<void*>(offset_allocator_addr)) OffsetAllocator::Allocator(buffer_size_in_bytes, kMaxNodeIndex);
   allocator_data->head_addr = offset_allocator_addr + sizeof(OffsetAllocator::Allocator);
   allocator_data->size = buffer_size_in_bytes - GetUint32(allocator_data->head_addr - head_addr);
+  // manage only the bytes left after the bookkeeping data so that free space reports match the usable size.
+  allocator_data->offset_allocator = new (reinterpret_cast<void*>(offset_allocator_addr)) OffsetAllocator::Allocator(allocator_data->size, kMaxNodeIndex);
   return allocator_data;
 }
 } // namespace
@@ -97,6 +98,14 @@ void Deallocate(void* ptr) {
   DEBUG_ASSERT(metadata < kMaxNodeIndex, DebugAssert());
   allocator->offset_allocator->free({.offset = offset, .metadata = metadata});
 }
+AllocatorStats GetAllocatorStats() {
+  const auto report = allocator->offset_allocator->storageReport();
+  return {
+    .total_size = allocator->size,
+    .free_size = report.totalFreeSpace,
+    .largest_free_region = report.largestFreeRegion,
+  };
+}
 } // namespace boke
 #include "doctest/doctest.h"
 TEST_CASE("aligned address") {
@@ -239,3 +248,16 @@ TEST_CASE("AllocationData") {
     }
   }
 }
+TEST_CASE("allocator stats") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 16 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  const auto stats = GetAllocatorStats();
+  CHECK_LE(stats.total_size, main_buffer_size_in_bytes);
+  CHECK_EQ(stats.free_size, stats.total_size);
+  auto ptr = Allocate(1024, 8);
+  CHECK_LE(GetAllocatorStats().free_size, stats.free_size - 1024);
+  Deallocate(ptr);
+  CHECK_EQ(GetAllocatorStats().free_size, stats.free_size);
+}
@@ -1,40 +1,46 @@
-#include "json.h"
-#include <windows.h>
+#include <limits>
 #include "boke/allocator.h"
 #include "boke/debug_assert.h"
 #include "boke/file.h"
+#include "platform/file_io.h"
 namespace {
-HANDLE OpenFile(const char* filename) {
-  auto file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-  return file;
-}
-void CloseFile(HANDLE file) {
-  CloseHandle(file);
-}
-DWORD GetFileSize(HANDLE file) {
-  if (file == INVALID_HANDLE_VALUE) { return DWORD{}; }
-  LARGE_INTEGER file_size{};
-  if (!GetFileSizeEx(file, &file_size)) { return DWORD{}; }
-  return static_cast<DWORD>(file_size.QuadPart);
-}
-DWORD ReadFileToBuffer(HANDLE file, const DWORD file_size, LPVOID buffer) {
-  DWORD bytes_read{};
-  ReadFile(file, buffer, file_size, &bytes_read, NULL);
-  return bytes_read;
+using namespace boke;
+MappedFile MapFileImpl(const char* const filepath, const bool copy_on_write) {
+  auto file = OpenFile(filepath);
+  if (file == kInvalidFileHandle) { return {}; }
+  const auto file_size = GetFileSize(file);
+  if (file_size == 0) {
+    // empty files cannot be mapped.
+    CloseFile(file);
+    return {};
+  }
+  auto mapped_file = copy_on_write ? MapFileViewCopyOnWrite(file, file_size) : MapFileView(file, file_size);
+  CloseFile(file);
+  return mapped_file;
 }
 char* LoadFileToBufferImpl(const char* const filepath, uint32_t* bytes_read) {
-  using namespace boke;
+  if (bytes_read) {
+    *bytes_read = 0;
+  }
   auto file = OpenFile(filepath);
-  DEBUG_ASSERT(file != 0, DebugAssert{});
-  auto file_size = GetFileSize(file);
-  auto buffer = AllocateArray<char>(file_size + 1);
-  const auto read_size = ReadFileToBuffer(file, file_size, buffer);
-  if (read_size != file_size) {
+  DEBUG_ASSERT(file != kInvalidFileHandle, DebugAssert{});
+  if (file == kInvalidFileHandle) { return nullptr; }
+  const auto file_size = GetFileSize(file);
+  // engine allocator takes uint32_t and one extra byte is needed for the terminator.
+  DEBUG_ASSERT(file_size < std::numeric_limits<uint32_t>::max(), DebugAssert{});
+  if (file_size >= std::numeric_limits<uint32_t>::max()) {
+    CloseFile(file);
+    return nullptr;
+  }
+  const auto buffer_size = static_cast<uint32_t>(file_size);
+  auto buffer = AllocateArray<char>(buffer_size + 1);
+  const auto read_size = ReadFileToBuffer(file, buffer_size, buffer);
+  CloseFile(file);
+  if (read_size != buffer_size) {
     Deallocate(buffer);
-    buffer = nullptr;
+    return nullptr;
   }
   buffer[read_size] = '\0';
-  CloseFile(file);
   if (bytes_read) {
     *bytes_read = read_size;
   }
@@ -48,6 +54,25 @@ char* LoadFileToBuffer(const char* const filepath) {
 char* LoadFileToBuffer(const char* const filepath, uint32_t* bytes_read) {
   return LoadFileToBufferImpl(filepath, bytes_read);
 }
+MappedFile MapFile(const char* const filepath) {
+  return MapFileImpl(filepath, false);
+}
+MappedFile MapFileCopyOnWrite(const char* const filepath) {
+  return MapFileImpl(filepath, true);
+}
+void UnmapFile(MappedFile& file) {
+  if (file.buffer == nullptr) { return; }
+  UnmapFileView(file);
+  file = {};
+}
+bool SaveBufferToFile(const char* const filepath, const void* buffer, const uint32_t size) {
+  auto file = CreateFileForWrite(filepath);
+  DEBUG_ASSERT(file != kInvalidFileHandle, DebugAssert{});
+  if (file == kInvalidFileHandle) { return false; }
+  const auto bytes_written = WriteBufferToFile(file, size, buffer);
+  CloseFile(file);
+  return bytes_written == size;
+}
 } // namespace boke
 #include "doctest/doctest.h"
 TEST_CASE("read file") {
@@ -56,10 +81,11 @@ TEST_CASE("read file") {
   std::byte main_buffer[main_buffer_size_in_bytes];
   const char filepath[] = "tests/test.json";
   auto file = OpenFile(filepath);
-  auto file_size = GetFileSize(file);
+  REQUIRE_NE(file, kInvalidFileHandle);
+  auto file_size = static_cast<uint32_t>(GetFileSize(file));
   REQUIRE_LE(file_size, main_buffer_size_in_bytes);
   InitAllocator(main_buffer, main_buffer_size_in_bytes);
-  auto buffer = static_cast<LPVOID>(Allocate(file_size, alignof(char)));
+  auto buffer = Allocate(file_size, alignof(char));
   CHECK_EQ(ReadFileToBuffer(file, file_size, buffer), file_size);
   CloseFile(file);
 }
@@ -72,3 +98,49 @@ TEST_CASE("load file to buffer") {
   auto buffer = LoadFileToBuffer(filepath);
   CHECK_NE(buffer, nullptr);
 }
+TEST_CASE("map file") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 16 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  const char filepath[] = "tests/test.json";
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  uint32_t bytes_read = 0;
+  auto buffer = LoadFileToBuffer(filepath, &bytes_read);
+  REQUIRE_NE(buffer, nullptr);
+  auto file = MapFile(filepath);
+  REQUIRE_NE(file.buffer, nullptr);
+  CHECK_EQ(file.size, bytes_read);
+  CHECK_EQ(memcmp(file.buffer, buffer, bytes_read), 0);
+  UnmapFile(file);
+  CHECK_EQ(file.buffer, nullptr);
+  CHECK_EQ(file.size, 0);
+  Deallocate(buffer);
+  file = MapFile("tests/file-not-exist.json");
+  CHECK_EQ(file.buffer, nullptr);
+  CHECK_EQ(file.size, 0);
+  UnmapFile(file);
+}
+TEST_CASE("save file and map copy-on-write") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 16 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  const char filepath[] = "tests/save-file-test.txt";
+  const char text[] = "save file test";
+  const auto text_len = static_cast<uint32_t>(strlen(text));
+  CHECK_UNARY(SaveBufferToFile(filepath, text, text_len));
+  auto file = MapFileCopyOnWrite(filepath);
+  REQUIRE_NE(file.buffer, nullptr);
+  REQUIRE_EQ(file.size, text_len);
+  CHECK_EQ(memcmp(file.buffer, text, text_len), 0);
+  const_cast<char*>(file.buffer)[0] = 'S';
+  UnmapFile(file);
+  // writes to the view are not written back.
+  auto buffer = LoadFileToBuffer(filepath);
+  REQUIRE_NE(buffer, nullptr);
+  CHECK_EQ(strcmp(buffer, text), 0);
+  Deallocate(buffer);
+  CHECK_UNARY(RemoveFile(filepath));
+  file = MapFile(filepath);
+  CHECK_EQ(file.buffer, nullptr);
+}
@@ -0,0 +1,528 @@
+#include "boke/file_loader.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <thread>
+#if defined(BOKE_ENABLE_IO_URING)
+#include <liburing.h>
+#endif
+#include "boke/allocator.h"
+#include "boke/debug_assert.h"
+#include "boke/file.h"
+#include "platform/file_io.h"
+namespace {
+#if defined(BOKE_ENABLE_IO_URING)
+const uint32_t kIoUringQueueDepth = 64;
+struct IoUringRequest {
+  boke::FileLoadBatch* batch{};
+  uint32_t file_index{};
+};
+#endif
+} // namespace
+namespace boke {
+struct FileLoader {
+  std::mutex mutex;
+  std::condition_variable job_cv;
+  std::condition_variable completion_cv;
+  FileLoadBatch* pending_batch_head{};
+  FileLoadBatch* pending_batch_tail{};
+  bool terminate{};
+  uint32_t worker_thread_num{};
+  std::thread* worker_thread_list{};
+#if defined(BOKE_ENABLE_IO_URING)
+  bool io_uring_enabled{};
+  uint32_t io_uring_request_in_flight{};
+  io_uring ring{};
+  // completions are reaped by a single waiting thread, see WaitFileLoadBatch.
+  std::atomic<bool> io_uring_waiting{};
+  // lowered by tests to force short reads and resubmission.
+  uint64_t io_uring_max_read_size{std::numeric_limits<uint64_t>::max()};
+  uint32_t io_uring_forced_retry_num{}; // next completions handled as -EAGAIN
+#endif
+};
+struct FileLoadBatch {
+  uint32_t file_num{};
+  const char* const* filepath_list{};
+  LoadedFile* file_list{};
+  bool heap_buffer{};
+  // guarded by FileLoader::mutex
+  uint32_t next_request_index{};
+  uint32_t completed_num{};
+  uint32_t* completed_index_list{};
+  FileLoadBatch* next_pending_batch{};
+  // accessed only by the waiting thread
+  uint32_t reported_num{};
+#if defined(BOKE_ENABLE_IO_URING)
+  FileHandle* file_handle_list{};
+  uint64_t* read_size_list{};
+  IoUringRequest* request_list{};
+#endif
+};
+} // namespace boke
+namespace {
+using namespace boke;
+void TouchPages(const LoadedFile& file) {
+  // fault the mapped pages in on the loading thread, not on the consumer.
+  const uint64_t page_size = 4096;
+  volatile char sum = 0;
+  for (uint64_t i = 0; i < file.size; i += page_size) {
+    sum = static_cast<char>(sum + file.buffer[i]);
+  }
+}
+void LoadFileMapped(FileLoadBatch* batch, const uint32_t file_index) {
+  auto file = MapFile(batch->filepath_list[file_index]);
+  batch->file_list[file_index] = {
+    .buffer = file.buffer,
+    .size = file.size,
+  };
+  TouchPages(batch->file_list[file_index]);
+}
+void PushPendingBatch(FileLoader* loader, FileLoadBatch* batch) {
+  if (loader->pending_batch_tail) {
+    loader->pending_batch_tail->next_pending_batch = batch;
+  } else {
+    loader->pending_batch_head = batch;
+  }
+  loader->pending_batch_tail = batch;
+}
+void PopPendingBatch(FileLoader* loader) {
+  auto batch = loader->pending_batch_head;
+  loader->pending_batch_head = batch->next_pending_batch;
+  if (loader->pending_batch_head == nullptr) {
+    loader->pending_batch_tail = nullptr;
+  }
+  batch->next_pending_batch = nullptr;
+}
+void RemovePendingBatch(FileLoader* loader, FileLoadBatch* batch) {
+  FileLoadBatch* prev = nullptr;
+  auto current = loader->pending_batch_head;
+  while (current && current != batch) {
+    prev = current;
+    current = current->next_pending_batch;
+  }
+  if (current == nullptr) { return; }
+  if (prev == nullptr) {
+    PopPendingBatch(loader);
+    return;
+  }
+  prev->next_pending_batch = batch->next_pending_batch;
+  if (loader->pending_batch_tail == batch) {
+    loader->pending_batch_tail = prev;
+  }
+  batch->next_pending_batch = nullptr;
+}
+void CompleteRequest(FileLoadBatch* batch, const uint32_t file_index) {
+  batch->completed_index_list[batch->completed_num] = file_index;
+  batch->completed_num++;
+}
+void WorkerThreadLoop(FileLoader* loader) {
+  std::unique_lock<std::mutex> lock(loader->mutex);
+  while (true) {
+    loader->job_cv.wait(lock, [loader]() { return loader->terminate || loader->pending_batch_head != nullptr; });
+    if (loader->terminate) { return; }
+    auto batch = loader->pending_batch_head;
+    const auto file_index = batch->next_request_index;
+    batch->next_request_index++;
+    if (batch->next_request_index == batch->file_num) {
+      PopPendingBatch(loader);
+    }
+    lock.unlock();
+    LoadFileMapped(batch, file_index);
+    lock.lock();
+    CompleteRequest(batch, file_index);
+    loader->completion_cv.notify_all();
+  }
+}
+#if defined(BOKE_ENABLE_IO_URING)
+void SubmitIoUringRead(FileLoader* loader, FileLoadBatch* batch, const uint32_t file_index) {
+  auto sqe = io_uring_get_sqe(&loader->ring);
+  DEBUG_ASSERT(sqe != nullptr, DebugAssert{});
+  const auto read_size = batch->read_size_list[file_index];
+  auto buffer = const_cast<char*>(batch->file_list[file_index].buffer) + read_size;
+  const auto remaining_size = std::min(batch->file_list[file_index].size - read_size, loader->io_uring_max_read_size);
+  io_uring_prep_read(sqe, static_cast<int>(batch->file_handle_list[file_index]), buffer, static_cast<uint32_t>(remaining_size), read_size);
+  io_uring_sqe_set_data(sqe, &batch->request_list[file_index]);
+}
+void SubmitIoUringRequests(FileLoader* loader, FileLoadBatch* batch) {
+  // cap requests in flight to the queue depth so that completions never overflow the ring.
+  uint32_t submit_num = 0;
+  while (batch->next_request_index < batch->file_num && loader->io_uring_request_in_flight < kIoUringQueueDepth) {
+    const auto file_index = batch->next_request_index;
+    batch->next_request_index++;
+    if (batch->file_handle_list[file_index] == kInvalidFileHandle) {
+      CompleteRequest(batch, file_index);
+      continue;
+    }
+    SubmitIoUringRead(loader, batch, file_index);
+    loader->io_uring_request_in_flight++;
+    submit_num++;
+  }
+  if (submit_num > 0) {
+    io_uring_submit(&loader->ring);
+  }
+}
+void ProcessIoUringCompletion(FileLoader* loader, io_uring_cqe* cqe) {
+  auto request = static_cast<IoUringRequest*>(io_uring_cqe_get_data(cqe));
+  auto batch = request->batch;
+  const auto file_index = request->file_index;
+  auto result = cqe->res;
+  io_uring_cqe_seen(&loader->ring, cqe);
+  if (loader->io_uring_forced_retry_num > 0) {
+    loader->io_uring_forced_retry_num--;
+    result = -EAGAIN;
+  }
+  if (result == -EAGAIN || result == -EINTR) {
+    // transient, retry from where the last read stopped.
+    SubmitIoUringRead(loader, batch, file_index);
+    io_uring_submit(&loader->ring);
+    return;
+  }
+  if (result > 0) {
+    batch->read_size_list[file_index] += static_cast<uint64_t>(result);
+    if (batch->read_size_list[file_index] < batch->file_list[file_index].size) {
+      // short read, request the rest.
+      SubmitIoUringRead(loader, batch, file_index);
+      io_uring_submit(&loader->ring);
+      return;
+    }
+  }
+  loader->io_uring_request_in_flight--;
+  CloseFile(batch->file_handle_list[file_index]);
+  batch->file_handle_list[file_index] = kInvalidFileHandle;
+  CompleteRequest(batch, file_index);
+}
+void DrainIoUringRequests(FileLoader* loader) {
+  // the kernel may still write to buffers of requests in flight, wait for them before the ring is gone.
+  // requests are not resubmitted, their batches are never reported.
+  while (loader->io_uring_request_in_flight > 0) {
+    io_uring_cqe* cqe = nullptr;
+    const auto result = io_uring_wait_cqe(&loader->ring, &cqe);
+    if (result == -EINTR) { continue; }
+    DEBUG_ASSERT(result == 0, DebugAssert{});
+    if (result != 0) { return; }
+    auto request = static_cast<IoUringRequest*>(io_uring_cqe_get_data(cqe));
+    io_uring_cqe_seen(&loader->ring, cqe);
+    loader->io_uring_request_in_flight--;
+    CloseFile(request->batch->file_handle_list[request->file_index]);
+    request->batch->file_handle_list[request->file_index] = kInvalidFileHandle;
+  }
+}
+void PrepareIoUringBatch(FileLoadBatch* batch) {
+  // files are opened and buffers are allocated on the submitting thread since the engine allocator is not thread-safe.
+  batch->heap_buffer = true;
+  batch->file_handle_list = AllocateArray<FileHandle>(batch->file_num);
+  batch->read_size_list = AllocateArray<uint64_t>(batch->file_num);
+  batch->request_list = AllocateArray<IoUringRequest>(batch->file_num);
+  for (uint32_t i = 0; i < batch->file_num; i++) {
+    batch->file_handle_list[i] = kInvalidFileHandle;
+    batch->read_size_list[i] = 0;
+    batch->request_list[i] = {
+      .batch = batch,
+      .file_index = i,
+    };
+    auto file = OpenFile(batch->filepath_list[i]);
+    if (file == kInvalidFileHandle) { continue; }
+    const auto file_size = GetFileSize(file);
+    if (file_size == 0 || file_size >= std::numeric_limits<uint32_t>::max()) {
+      CloseFile(file);
+      continue;
+    }
+    auto buffer = AllocateArray<char>(static_cast<uint32_t>(file_size) + 1);
+    buffer[file_size] = '\0';
+    batch->file_handle_list[i] = file;
+    batch->file_list[i] = {
+      .buffer = buffer,
+      .size = file_size,
+    };
+  }
+}
+#endif
+void ReportLoadedFile(FileLoadBatch* batch, const uint32_t file_index, FileLoadCallback callback, void* user_data) {
+  auto& file = batch->file_list[file_index];
+#if defined(BOKE_ENABLE_IO_URING)
+  if (batch->heap_buffer && file.buffer && batch->read_size_list[file_index] != file.size) {
+    // failed or truncated read.
+    Deallocate(const_cast<char*>(file.buffer));
+    file = {};
+  }
+#endif
+  batch->reported_num++;
+  if (callback) {
+    callback(user_data, file_index, file);
+  }
+}
+void WaitWorkerThreadBatch(FileLoader* loader, FileLoadBatch* batch, FileLoadCallback callback, void* user_data) {
+  std::unique_lock<std::mutex> lock(loader->mutex);
+  while (batch->reported_num < batch->file_num) {
+    if (batch->reported_num < batch->completed_num) {
+      const auto file_index = batch->completed_index_list[batch->reported_num];
+      lock.unlock();
+      ReportLoadedFile(batch, file_index, callback, user_data);
+      lock.lock();
+      continue;
+    }
+    if (batch->next_request_index < batch->file_num) {
+      // help workers instead of idling.
+      const auto file_index = batch->next_request_index;
+      batch->next_request_index++;
+      if (batch->next_request_index == batch->file_num) {
+        RemovePendingBatch(loader, batch);
+      }
+      lock.unlock();
+      LoadFileMapped(batch, file_index);
+      lock.lock();
+      CompleteRequest(batch, file_index);
+      continue;
+    }
+    loader->completion_cv.wait(lock, [batch]() { return batch->reported_num < batch->completed_num; });
+  }
+}
+#if defined(BOKE_ENABLE_IO_URING)
+void WaitIoUringBatch(FileLoader* loader, FileLoadBatch* batch, FileLoadCallback callback, void* user_data) {
+  [[maybe_unused]] const auto another_thread_waiting = loader->io_uring_waiting.exchange(true, std::memory_order_acquire);
+  DEBUG_ASSERT(!another_thread_waiting, DebugAssert{});
+  while (batch->reported_num < batch->file_num) {
+    if (batch->reported_num < batch->completed_num) {
+      ReportLoadedFile(batch, batch->completed_index_list[batch->reported_num], callback, user_data);
+      continue;
+    }
+    SubmitIoUringRequests(loader, batch);
+    if (batch->reported_num < batch->completed_num) { continue; }
+    io_uring_cqe* cqe = nullptr;
+    const auto result = io_uring_wait_cqe(&loader->ring, &cqe);
+    DEBUG_ASSERT(result == 0, DebugAssert{});
+    if (result != 0) { continue; }
+    // completions may belong to other batches, which are recorded and reported when they are waited.
+    ProcessIoUringCompletion(loader, cqe);
+  }
+  loader->io_uring_waiting.store(false, std::memory_order_release);
+}
+#endif
+} // namespace
+namespace boke {
+FileLoader* CreateFileLoader(const uint32_t worker_thread_num) {
+  auto loader = New<FileLoader>();
+#if defined(BOKE_ENABLE_IO_URING)
+  if (io_uring_queue_init(kIoUringQueueDepth, &loader->ring, 0) == 0) {
+    loader->io_uring_enabled = true;
+    return loader;
+  }
+  spdlog::warn("io_uring unavailable, falling back to worker threads.");
+#endif
+  loader->worker_thread_num = worker_thread_num;
+  if (worker_thread_num == 0) { return loader; }
+  loader->worker_thread_list = AllocateArray<std::thread>(worker_thread_num);
+  for (uint32_t i = 0; i < worker_thread_num; i++) {
+    new (&loader->worker_thread_list[i]) std::thread(WorkerThreadLoop, loader);
+  }
+  return loader;
+}
+void ReleaseFileLoader(FileLoader* loader) {
+  {
+    std::lock_guard<std::mutex> lock(loader->mutex);
+    loader->terminate = true;
+  }
+  loader->job_cv.notify_all();
+  for (uint32_t i = 0; i < loader->worker_thread_num; i++) {
+    loader->worker_thread_list[i].join();
+    loader->worker_thread_list[i].~thread();
+  }
+  if (loader->worker_thread_list) {
+    Deallocate(loader->worker_thread_list);
+  }
+#if defined(BOKE_ENABLE_IO_URING)
+  if (loader->io_uring_enabled) {
+    DrainIoUringRequests(loader);
+    io_uring_queue_exit(&loader->ring);
+  }
+#endif
+  loader->~FileLoader();
+  Deallocate(loader);
+}
+FileLoadBatch* SubmitFileLoadBatch(FileLoader* loader, const uint32_t file_num, const char* const* filepath_list) {
+  auto batch = New<FileLoadBatch>();
+  batch->file_num = file_num;
+  batch->filepath_list = filepath_list;
+  batch->file_list = AllocateArray<LoadedFile>(file_num);
+  batch->completed_index_list = AllocateArray<uint32_t>(file_num);
+  for (uint32_t i = 0; i < file_num; i++) {
+    batch->file_list[i] = {};
+  }
+  if (file_num == 0) { return batch; }
+#if defined(BOKE_ENABLE_IO_URING)
+  if (loader->io_uring_enabled) {
+    PrepareIoUringBatch(batch);
+    SubmitIoUringRequests(loader, batch);
+    return batch;
+  }
+#endif
+  {
+    std::lock_guard<std::mutex> lock(loader->mutex);
+    PushPendingBatch(loader, batch);
+  }
+  loader->job_cv.notify_all();
+  return batch;
+}
+void WaitFileLoadBatch(FileLoader* loader, FileLoadBatch* batch, FileLoadCallback callback, void* user_data) {
+#if defined(BOKE_ENABLE_IO_URING)
+  if (loader->io_uring_enabled) {
+    WaitIoUringBatch(loader, batch, callback, user_data);
+    return;
+  }
+#endif
+  WaitWorkerThreadBatch(loader, batch, callback, user_data);
+}
+LoadedFile GetLoadedFile(const FileLoadBatch* batch, const uint32_t file_index) {
+  return batch->file_list[file_index];
+}
+void ReleaseFileLoadBatch(FileLoadBatch* batch) {
+  DEBUG_ASSERT(batch->reported_num == batch->file_num, DebugAssert{});
+  for (uint32_t i = 0; i < batch->file_num; i++) {
+    auto& file = batch->file_list[i];
+    if (file.buffer == nullptr) { continue; }
+    if (batch->heap_buffer) {
+      Deallocate(const_cast<char*>(file.buffer));
+      continue;
+    }
+    MappedFile mapped_file{
+      .buffer = file.buffer,
+      .size = file.size,
+    };
+    UnmapFile(mapped_file);
+  }
+#if defined(BOKE_ENABLE_IO_URING)
+  if (batch->heap_buffer) {
+    Deallocate(batch->file_handle_list);
+    Deallocate(batch->read_size_list);
+    Deallocate(batch->request_list);
+  }
+#endif
+  Deallocate(batch->file_list);
+  Deallocate(batch->completed_index_list);
+  Deallocate(batch);
+}
+} // namespace boke
+#include "doctest/doctest.h"
+namespace {
+struct FileLoadTestAsset {
+  uint32_t loaded_num{};
+  uint32_t failed_num{};
+  bool reported[3]{};
+};
+void CountLoadedFile(void* user_data, const uint32_t file_index, const boke::LoadedFile& file) {
+  auto asset = static_cast<FileLoadTestAsset*>(user_data);
+  asset->reported[file_index] = true;
+  if (file.buffer) {
+    asset->loaded_num++;
+  } else {
+    asset->failed_num++;
+  }
+}
+} // namespace
+TEST_CASE("file loader") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 64 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  const char* filepath_list[] = {
+    "tests/test.json",
+    "tests/file-not-exist.json",
+    "tests/resources.json",
+  };
+  const uint32_t file_num = sizeof(filepath_list) / sizeof(filepath_list[0]);
+  uint32_t worker_thread_num = 0;
+  SUBCASE("no worker thread") {
+    worker_thread_num = 0;
+  }
+  SUBCASE("with worker threads") {
+    worker_thread_num = 2;
+  }
+  auto loader = CreateFileLoader(worker_thread_num);
+  auto batch = SubmitFileLoadBatch(loader, file_num, filepath_list);
+  FileLoadTestAsset asset{};
+  WaitFileLoadBatch(loader, batch, CountLoadedFile, &asset);
+  CHECK_EQ(asset.loaded_num, 2);
+  CHECK_EQ(asset.failed_num, 1);
+  CHECK_UNARY(asset.reported[0]);
+  CHECK_UNARY(asset.reported[1]);
+  CHECK_UNARY(asset.reported[2]);
+  CHECK_EQ(GetLoadedFile(batch, 1).buffer, nullptr);
+  for (uint32_t i = 0; i < file_num; i++) {
+    if (i == 1) { continue; }
+    CAPTURE(i);
+    uint32_t bytes_read = 0;
+    auto expected = LoadFileToBuffer(filepath_list[i], &bytes_read);
+    REQUIRE_NE(expected, nullptr);
+    const auto file = GetLoadedFile(batch, i);
+    REQUIRE_NE(file.buffer, nullptr);
+    CHECK_EQ(file.size, bytes_read);
+    CHECK_EQ(memcmp(file.buffer, expected, bytes_read), 0);
+    Deallocate(expected);
+  }
+  ReleaseFileLoadBatch(batch);
+  ReleaseFileLoader(loader);
+}
+TEST_CASE("file loader multiple batches") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 64 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  const char* filepath_list_a[] = {"tests/test.json",};
+  const char* filepath_list_b[] = {"tests/resources.json", "tests/test.json",};
+  auto loader = CreateFileLoader(1);
+  auto batch_a = SubmitFileLoadBatch(loader, 1, filepath_list_a);
+  auto batch_b = SubmitFileLoadBatch(loader, 2, filepath_list_b);
+  FileLoadTestAsset asset_b{};
+  WaitFileLoadBatch(loader, batch_b, CountLoadedFile, &asset_b);
+  CHECK_EQ(asset_b.loaded_num, 2);
+  FileLoadTestAsset asset_a{};
+  WaitFileLoadBatch(loader, batch_a, CountLoadedFile, &asset_a);
+  CHECK_EQ(asset_a.loaded_num, 1);
+  CHECK_EQ(GetLoadedFile(batch_a, 0).size, GetLoadedFile(batch_b, 1).size);
+  ReleaseFileLoadBatch(batch_b);
+  ReleaseFileLoadBatch(batch_a);
+  ReleaseFileLoader(loader);
+}
+#if defined(BOKE_ENABLE_IO_URING)
+TEST_CASE("file loader io_uring short reads and retries") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 64 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  const char* filepath_list[] = {"tests/test.json", "tests/resources.json",};
+  const uint32_t file_num = sizeof(filepath_list) / sizeof(filepath_list[0]);
+  auto loader = CreateFileLoader(0);
+  if (!loader->io_uring_enabled) {
+    // e.g. blocked in containers, the other tests cover the worker thread path.
+    MESSAGE("io_uring unavailable");
+    ReleaseFileLoader(loader);
+    return;
+  }
+  // files are read a few bytes per request and some completions are handled as transient errors.
+  loader->io_uring_max_read_size = 7;
+  loader->io_uring_forced_retry_num = 5;
+  auto batch = SubmitFileLoadBatch(loader, file_num, filepath_list);
+  FileLoadTestAsset asset{};
+  WaitFileLoadBatch(loader, batch, CountLoadedFile, &asset);
+  CHECK_EQ(asset.loaded_num, file_num);
+  CHECK_EQ(loader->io_uring_forced_retry_num, 0);
+  for (uint32_t i = 0; i < file_num; i++) {
+    CAPTURE(i);
+    uint32_t bytes_read = 0;
+    auto expected = LoadFileToBuffer(filepath_list[i], &bytes_read);
+    REQUIRE_NE(expected, nullptr);
+    const auto file = GetLoadedFile(batch, i);
+    REQUIRE_NE(file.buffer, nullptr);
+    CHECK_GT(file.size, loader->io_uring_max_read_size);
+    CHECK_EQ(file.size, bytes_read);
+    CHECK_EQ(memcmp(file.buffer, expected, bytes_read), 0);
+    Deallocate(expected);
+  }
+  ReleaseFileLoadBatch(batch);
+  ReleaseFileLoader(loader);
+}
+#endif
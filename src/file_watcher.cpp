@@ -0,0 +1,185 @@
+#include "boke/file_watcher.h"
+#include <cstring>
+#include "boke/allocator.h"
+#include "platform/file_io.h"
+namespace boke {
+struct FileWatcher {
+  uint32_t file_num{};
+  const char* const* filepath_list{};
+  const char** filename_list{};
+  uint32_t* directory_index_list{};
+  bool* changed{};
+  uint32_t directory_num{};
+  DirectoryWatch** directory_watch_list{};
+};
+} // namespace boke
+namespace {
+using namespace boke;
+auto GetFilenameOffset(const char* const filepath) {
+  uint32_t offset = 0;
+  for (uint32_t i = 0; filepath[i] != '\0'; i++) {
+    if (filepath[i] == '/' || filepath[i] == '\\') {
+      offset = i + 1;
+    }
+  }
+  return offset;
+}
+/**
+ * directory part of filepath_list[file_index] (without separator) is compared in place,
+ * "." is used for files without a directory.
+ **/
+auto IsSameDirectory(const char* const* filepath_list, const uint32_t file_index_a, const uint32_t file_index_b) {
+  const auto len_a = GetFilenameOffset(filepath_list[file_index_a]);
+  const auto len_b = GetFilenameOffset(filepath_list[file_index_b]);
+  return len_a == len_b && strncmp(filepath_list[file_index_a], filepath_list[file_index_b], len_a) == 0;
+}
+auto CreateDirectoryWatchOfFile(const char* const filepath) {
+  const auto len = GetFilenameOffset(filepath);
+  if (len == 0) {
+    return CreateDirectoryWatch(".");
+  }
+  auto directory = AllocateArray<char>(len + 1);
+  memcpy(directory, filepath, len);
+  directory[len] = '\0';
+  auto watch = CreateDirectoryWatch(directory);
+  Deallocate(directory);
+  return watch;
+}
+struct DirectoryChangeAsset {
+  FileWatcher* watcher{};
+  uint32_t directory_index{};
+};
+void MarkChangedFile(void* user_data, const char* const filename) {
+  auto asset = static_cast<DirectoryChangeAsset*>(user_data);
+  auto watcher = asset->watcher;
+  for (uint32_t i = 0; i < watcher->file_num; i++) {
+    if (watcher->directory_index_list[i] != asset->directory_index) { continue; }
+    // nullptr when changes were dropped, every file in the directory is reported.
+    if (filename != nullptr && strcmp(watcher->filename_list[i], filename) != 0) { continue; }
+    watcher->changed[i] = true;
+  }
+}
+} // namespace
+namespace boke {
+FileWatcher* CreateFileWatcher(const uint32_t file_num, const char* const* filepath_list) {
+  auto watcher = New<FileWatcher>();
+  watcher->file_num = file_num;
+  watcher->filepath_list = filepath_list;
+  watcher->filename_list = AllocateArray<const char*>(file_num);
+  watcher->directory_index_list = AllocateArray<uint32_t>(file_num);
+  watcher->changed = AllocateArray<bool>(file_num);
+  watcher->directory_watch_list = AllocateArray<DirectoryWatch*>(file_num);
+  // file index of the first file in each directory.
+  auto directory_file_index = AllocateArray<uint32_t>(file_num);
+  for (uint32_t i = 0; i < file_num; i++) {
+    watcher->filename_list[i] = filepath_list[i] + GetFilenameOffset(filepath_list[i]);
+    watcher->changed[i] = false;
+    uint32_t directory_index = 0;
+    while (directory_index < watcher->directory_num && !IsSameDirectory(filepath_list, directory_file_index[directory_index], i)) {
+      directory_index++;
+    }
+    if (directory_index == watcher->directory_num) {
+      directory_file_index[directory_index] = i;
+      // nullptr if the directory does not exist, its files are never reported.
+      watcher->directory_watch_list[directory_index] = CreateDirectoryWatchOfFile(filepath_list[i]);
+      watcher->directory_num++;
+    }
+    watcher->directory_index_list[i] = directory_index;
+  }
+  Deallocate(directory_file_index);
+  return watcher;
+}
+void ReleaseFileWatcher(FileWatcher* watcher) {
+  for (uint32_t i = 0; i < watcher->directory_num; i++) {
+    ReleaseDirectoryWatch(watcher->directory_watch_list[i]);
+  }
+  Deallocate(watcher->directory_watch_list);
+  Deallocate(watcher->changed);
+  Deallocate(watcher->directory_index_list);
+  Deallocate(watcher->filename_list);
+  Deallocate(watcher);
+}
+void PollFileWatcher(FileWatcher* watcher, FileChangeCallback callback, void* user_data) {
+  for (uint32_t i = 0; i < watcher->directory_num; i++) {
+    DirectoryChangeAsset asset{.watcher = watcher, .directory_index = i,};
+    ReadDirectoryChanges(watcher->directory_watch_list[i], MarkChangedFile, &asset);
+  }
+  for (uint32_t i = 0; i < watcher->file_num; i++) {
+    if (!watcher->changed[i]) { continue; }
+    watcher->changed[i] = false;
+    callback(user_data, i);
+  }
+}
+} // namespace boke
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include "boke/file.h"
+#include "doctest/doctest.h"
+namespace {
+struct FileChangeTestAsset {
+  uint32_t changed_num[3]{};
+};
+void CountChangedFile(void* user_data, const uint32_t file_index) {
+  static_cast<FileChangeTestAsset*>(user_data)->changed_num[file_index]++;
+}
+/**
+ * change notifications are delivered asynchronously on some platforms.
+ **/
+auto PollFileWatcherUntilChanged(boke::FileWatcher* watcher, FileChangeTestAsset* asset, const uint32_t file_index) {
+  for (uint32_t i = 0; i < 1000 && asset->changed_num[file_index] == 0; i++) {
+    boke::PollFileWatcher(watcher, CountChangedFile, asset);
+    if (asset->changed_num[file_index] > 0) { break; }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return asset->changed_num[file_index] > 0;
+}
+} // namespace
+TEST_CASE("file watcher") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 64 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  const char* filepath_list[] = {
+    "tests/file-watcher-a.txt",
+    "tests/file-watcher-b.txt",
+    "tests/dir-not-exist/file-watcher-c.txt",
+  };
+  const char content[] = "file watcher";
+  REQUIRE_UNARY(SaveBufferToFile(filepath_list[0], content, sizeof(content)));
+  REQUIRE_UNARY(SaveBufferToFile(filepath_list[1], content, sizeof(content)));
+  auto watcher = CreateFileWatcher(3, filepath_list);
+  FileChangeTestAsset asset{};
+  PollFileWatcher(watcher, CountChangedFile, &asset);
+  CHECK_EQ(asset.changed_num[0], 0);
+  CHECK_EQ(asset.changed_num[1], 0);
+  SUBCASE("write") {
+    REQUIRE_UNARY(SaveBufferToFile(filepath_list[0], content, sizeof(content)));
+    REQUIRE_UNARY(SaveBufferToFile(filepath_list[0], content, sizeof(content) - 1));
+    CHECK_UNARY(PollFileWatcherUntilChanged(watcher, &asset, 0));
+    CHECK_EQ(asset.changed_num[0], 1);
+    CHECK_EQ(asset.changed_num[1], 0);
+  }
+  SUBCASE("replace via rename") {
+    const char tmp_filepath[] = "tests/file-watcher-b.tmp";
+    REQUIRE_UNARY(SaveBufferToFile(tmp_filepath, content, sizeof(content)));
+    RemoveFile(filepath_list[1]);
+    REQUIRE_EQ(std::rename(tmp_filepath, filepath_list[1]), 0);
+    CHECK_UNARY(PollFileWatcherUntilChanged(watcher, &asset, 1));
+    CHECK_EQ(asset.changed_num[0], 0);
+    CHECK_EQ(asset.changed_num[1], 1);
+  }
+  SUBCASE("dropped changes") {
+    // as reported by ReadDirectoryChanges on a queue overflow.
+    DirectoryChangeAsset directory_asset{.watcher = watcher, .directory_index = 0,};
+    MarkChangedFile(&directory_asset, nullptr);
+    PollFileWatcher(watcher, CountChangedFile, &asset);
+    CHECK_EQ(asset.changed_num[0], 1);
+    CHECK_EQ(asset.changed_num[1], 1);
+  }
+  CHECK_EQ(asset.changed_num[2], 0);
+  ReleaseFileWatcher(watcher);
+  RemoveFile(filepath_list[0]);
+  RemoveFile(filepath_list[1]);
+}
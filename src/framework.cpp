@@ -1,6 +1,13 @@
 #include "boke/framework.h"
 #include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/str_hash.h"
 #include "json.h"
+#include "gfx/render_pass_info.h"
+#include "gfx/resource_info.h"
+#include "gfx/config_loader.h"
+#include "gfx/config_validation.h"
+#include "gfx/baked_config.h"
 namespace {
 static const uint32_t main_buffer_size_in_bytes = 32 * 1024 * 1024;
 static std::byte main_buffer[main_buffer_size_in_bytes];
@@ -11,6 +18,24 @@ int32_t Run(const char* const config_path) {
   auto json = GetJson(config_path);
   return 0;
 }
+int32_t BakeConfig(const char* const config_path, const char* const baked_config_path) {
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  InitStrHashSystem();
+  // sizes given by code at runtime (explicit_buffer_size) are applied when the baked config is loaded.
+  auto config = LoadGfxConfig(config_path, {});
+  auto result = false;
+  {
+    // a broken config is reported here instead of being baked and failing at runtime.
+    const auto error_list = ValidateGfxConfig(config);
+    LogConfigErrors(error_list);
+    if (error_list.empty()) {
+      result = BakeGfxConfig(config, baked_config_path);
+    }
+  }
+  ReleaseGfxConfig(config);
+  TermStrHashSystem();
+  return result ? 0 : 1;
+}
 } // namespace boke
 #include <doctest/doctest.h>
 TEST_CASE("framework") {
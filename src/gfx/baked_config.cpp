@@ -0,0 +1,504 @@
+#include <memory>
+#include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/debug_assert.h"
+#include "boke/file.h"
+#include "boke/str_hash.h"
+#include "boke/util.h"
+#include "json.h"
+#include "render_pass_info.h"
+#include "resource_info.h"
+#include "config_loader.h"
+#include "baked_config.h"
+#include "platform/file_io.h"
+namespace {
+using namespace boke;
+const uint32_t kBakedConfigMagic = 0x454b4f42; // "BOKE"
+const uint32_t kBakedConfigVersion = 3;
+const uint32_t kBakedConfigAlignment = 8;
+/**
+ * pointers in baked records hold offsets from the head of the file (nullptr stays nullptr).
+ * records are the runtime structs themselves, so the layout is only valid for the same build settings,
+ * which the header records.
+ **/
+struct BakedResource {
+  StrHash id{};
+  const char* name{};
+  ResourceInfo info{};
+};
+struct BakedRenderPass {
+  StrHash id{};
+  const char* name{};
+  RenderPassList list{};
+};
+struct BakedConfigHeader {
+  uint32_t magic{};
+  uint32_t version{};
+  uint32_t pointer_size{};
+  uint32_t resource_record_size{};
+  uint32_t render_pass_record_size{};
+  uint32_t render_pass_info_size{};
+  uint32_t material_record_size{};
+  uint32_t material_shader_record_size{};
+  uint64_t file_size{};
+  const char* title{};
+  uint32_t frame_buffer_num{};
+  Size2d swapchain_size{};
+  DXGI_FORMAT swapchain_format{};
+  uint32_t max_loop_num{};
+  uint32_t shader_visible_buffer_num{};
+  uint32_t resource_num{};
+  uint32_t render_pass_num{};
+  uint32_t material_num{};
+  BakedResource* resource_list{};
+  BakedRenderPass* render_pass_list{};
+  MaterialInfo* material_list{};
+};
+auto GetBakedConfigHeaderTemplate() {
+  return BakedConfigHeader{
+    .magic = kBakedConfigMagic,
+    .version = kBakedConfigVersion,
+    .pointer_size = sizeof(void*),
+    .resource_record_size = sizeof(BakedResource),
+    .render_pass_record_size = sizeof(BakedRenderPass),
+    .render_pass_info_size = sizeof(RenderPassInfo),
+    .material_record_size = sizeof(MaterialInfo),
+    .material_shader_record_size = sizeof(MaterialShaderInfo),
+  };
+}
+auto IsCompatibleHeader(const BakedConfigHeader& header, const uint64_t file_size) {
+  const auto expected = GetBakedConfigHeaderTemplate();
+  return header.magic == expected.magic
+      && header.version == expected.version
+      && header.pointer_size == expected.pointer_size
+      && header.resource_record_size == expected.resource_record_size
+      && header.render_pass_record_size == expected.render_pass_record_size
+      && header.render_pass_info_size == expected.render_pass_info_size
+      && header.material_record_size == expected.material_record_size
+      && header.material_shader_record_size == expected.material_shader_record_size
+      && header.file_size == file_size;
+}
+template <typename T>
+T* GetOffsetPointer(const uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<uintptr_t>(offset));
+}
+template <typename T>
+void FixupPointer(char* head, T** ptr) {
+  if (*ptr == nullptr) { return; }
+  *ptr = reinterpret_cast<T*>(head + reinterpret_cast<uintptr_t>(*ptr));
+}
+/**
+ * offsets and counts are read from the file and checked against its size before they are turned into pointers,
+ * so that a corrupted file is rejected like an incompatible one.
+ **/
+template <typename T>
+bool FixupArray(char* head, const uint64_t file_size, const uint32_t num, T** ptr) {
+  const auto offset = reinterpret_cast<uintptr_t>(*ptr);
+  if (offset == 0) { return num == 0; }
+  if (offset % alignof(T) != 0 || offset > file_size) { return false; }
+  if (num > (file_size - offset) / sizeof(T)) { return false; }
+  FixupPointer(head, ptr);
+  return true;
+}
+/**
+ * subresource ranges are either nullptr or one per view.
+ **/
+template <typename T>
+bool FixupOptionalArray(char* head, const uint64_t file_size, const uint32_t num, T** ptr) {
+  if (*ptr == nullptr) { return true; }
+  return num > 0 && FixupArray(head, file_size, num, ptr);
+}
+bool FixupString(char* head, const uint64_t file_size, const char** str) {
+  const auto offset = reinterpret_cast<uintptr_t>(*str);
+  if (offset == 0) { return true; }
+  // the terminator must be within the file.
+  if (offset >= file_size || memchr(head + offset, '\0', file_size - offset) == nullptr) { return false; }
+  FixupPointer(head, str);
+  return true;
+}
+struct BakedConfigWriter {
+  ResizableArray<char>* buffer{};
+  StrHashMap<uint32_t>* string_offset{};
+};
+auto AppendBytes(const void* data, const uint32_t size, const uint32_t alignment, BakedConfigWriter& writer) {
+  auto buffer = writer.buffer;
+  while (buffer->size() % alignment != 0) {
+    buffer->push_back(0);
+  }
+  const auto offset = buffer->size();
+  const auto src = static_cast<const char*>(data);
+  for (uint32_t i = 0; i < size; i++) {
+    buffer->push_back(src[i]);
+  }
+  return offset;
+}
+template <typename T>
+T* AppendArray(const T* array, const uint32_t num, BakedConfigWriter& writer) {
+  if (num == 0) { return nullptr; }
+  return GetOffsetPointer<T>(AppendBytes(array, GetUint32(sizeof(T) * num), kBakedConfigAlignment, writer));
+}
+const char* AppendString(const char* const str, BakedConfigWriter& writer) {
+  // identical strings (e.g. shared shader files) are stored once.
+  if (str == nullptr) { return nullptr; }
+  const auto hash = GetStrHash(str);
+  if (!writer.string_offset->contains(hash)) {
+    writer.string_offset->insert(hash, AppendBytes(str, GetUint32(strlen(str) + 1), 1, writer));
+  }
+  return GetOffsetPointer<const char>((*writer.string_offset)[hash]);
+}
+struct ResourceBakeAsset {
+  BakedConfigWriter& writer;
+  ResizableArray<BakedResource> record_list;
+};
+auto AppendResourceList(const StrHashMap<ResourceInfo>& resource_info, BakedConfigWriter& writer) {
+  ResourceBakeAsset asset{
+    .writer = writer,
+    .record_list = ResizableArray<BakedResource>(resource_info.size()),
+  };
+  resource_info.iterate<ResourceBakeAsset>([](ResourceBakeAsset* asset, const StrHash resource_id, const ResourceInfo* info) {
+    const auto name = GetStr(resource_id);
+    DEBUG_ASSERT(name != nullptr, DebugAssert{});
+    asset->record_list.push_back({
+        .id = resource_id,
+        .name = AppendString(name, asset->writer),
+        .info = *info,
+      });
+  }, &asset);
+  return AppendArray(asset.record_list.begin(), asset.record_list.size(), writer);
+}
+struct RenderPassBakeAsset {
+  BakedConfigWriter& writer;
+  ResizableArray<BakedRenderPass> record_list;
+};
+auto AppendRenderPass(const RenderPassList& render_pass, BakedConfigWriter& writer) {
+  ResizableArray<RenderPassInfo> info_list(render_pass.render_pass_len);
+  for (uint32_t i = 0; i < render_pass.render_pass_len; i++) {
+    auto info = render_pass.render_pass_info[i];
+    info.cbv = AppendArray(info.cbv, info.cbv_num, writer);
+    info.srv = AppendArray(info.srv, info.srv_num, writer);
+    info.uav = AppendArray(info.uav, info.uav_num, writer);
+    info.rtv = AppendArray(info.rtv, info.rtv_num, writer);
+    info.srv_subresource = AppendArray(info.srv_subresource, info.srv_subresource != nullptr ? info.srv_num : 0, writer);
+    info.rtv_subresource = AppendArray(info.rtv_subresource, info.rtv_subresource != nullptr ? info.rtv_num : 0, writer);
+    info.dsv_subresource = AppendArray(info.dsv_subresource, info.dsv_subresource != nullptr ? 1 : 0, writer);
+    info_list.push_back(info);
+  }
+  return RenderPassList{
+    .render_pass_len = render_pass.render_pass_len,
+    .render_pass_info = AppendArray(info_list.begin(), info_list.size(), writer),
+  };
+}
+auto AppendRenderPassList(const StrHashMap<RenderPassList>& render_pass_list, BakedConfigWriter& writer) {
+  RenderPassBakeAsset asset{
+    .writer = writer,
+    .record_list = ResizableArray<BakedRenderPass>(render_pass_list.size()),
+  };
+  render_pass_list.iterate<RenderPassBakeAsset>([](RenderPassBakeAsset* asset, const StrHash render_pass_id, const RenderPassList* render_pass) {
+    const auto name = GetStr(render_pass_id);
+    DEBUG_ASSERT(name != nullptr, DebugAssert{});
+    asset->record_list.push_back({
+        .id = render_pass_id,
+        .name = AppendString(name, asset->writer),
+        .list = AppendRenderPass(*render_pass, asset->writer),
+      });
+  }, &asset);
+  return AppendArray(asset.record_list.begin(), asset.record_list.size(), writer);
+}
+auto AppendMaterialList(const uint32_t material_num, const MaterialInfo* material_list, BakedConfigWriter& writer) {
+  ResizableArray<MaterialInfo> record_list(material_num);
+  for (uint32_t i = 0; i < material_num; i++) {
+    auto material = material_list[i];
+    ResizableArray<MaterialShaderInfo> shader_list(material.shader_num);
+    for (uint32_t j = 0; j < material.shader_num; j++) {
+      shader_list.push_back({
+          .target = AppendString(material.shader_list[j].target, writer),
+          .filename = AppendString(material.shader_list[j].filename, writer),
+        });
+    }
+    material.name = AppendString(material.name, writer);
+    material.rootsig = AppendString(material.rootsig, writer);
+    material.fallback = AppendString(material.fallback, writer);
+    material.shader_list = AppendArray(shader_list.begin(), shader_list.size(), writer);
+    material.rtv_format = AppendArray(material.rtv_format, material.rtv_num, writer);
+    record_list.push_back(material);
+  }
+  return AppendArray(record_list.begin(), record_list.size(), writer);
+}
+auto FixupRenderPassList(char* head, const uint64_t file_size, RenderPassList* render_pass) {
+  if (!FixupArray(head, file_size, render_pass->render_pass_len, &render_pass->render_pass_info)) { return false; }
+  for (uint32_t i = 0; i < render_pass->render_pass_len; i++) {
+    auto& info = render_pass->render_pass_info[i];
+    if (!FixupArray(head, file_size, info.cbv_num, &info.cbv)) { return false; }
+    if (!FixupArray(head, file_size, info.srv_num, &info.srv)) { return false; }
+    if (!FixupArray(head, file_size, info.uav_num, &info.uav)) { return false; }
+    if (!FixupArray(head, file_size, info.rtv_num, &info.rtv)) { return false; }
+    if (!FixupOptionalArray(head, file_size, info.srv_num, &info.srv_subresource)) { return false; }
+    if (!FixupOptionalArray(head, file_size, info.rtv_num, &info.rtv_subresource)) { return false; }
+    if (!FixupOptionalArray(head, file_size, 1, &info.dsv_subresource)) { return false; }
+  }
+  return true;
+}
+auto FixupMaterialInfo(char* head, const uint64_t file_size, MaterialInfo* material) {
+  if (!FixupString(head, file_size, &material->name)) { return false; }
+  if (!FixupString(head, file_size, &material->rootsig)) { return false; }
+  if (!FixupString(head, file_size, &material->fallback)) { return false; }
+  if (!FixupArray(head, file_size, material->shader_num, &material->shader_list)) { return false; }
+  if (!FixupArray(head, file_size, material->rtv_num, &material->rtv_format)) { return false; }
+  for (uint32_t i = 0; i < material->shader_num; i++) {
+    if (!FixupString(head, file_size, &material->shader_list[i].target)) { return false; }
+    if (!FixupString(head, file_size, &material->shader_list[i].filename)) { return false; }
+  }
+  return true;
+}
+/**
+ * turns every offset of the file into a pointer, returns false if any of them is out of the file.
+ **/
+auto FixupBakedConfig(char* head, const uint64_t file_size) {
+  auto header = reinterpret_cast<BakedConfigHeader*>(head);
+  if (!FixupString(head, file_size, &header->title)) { return false; }
+  if (!FixupArray(head, file_size, header->resource_num, &header->resource_list)) { return false; }
+  for (uint32_t i = 0; i < header->resource_num; i++) {
+    auto& record = header->resource_list[i];
+    if (record.name == nullptr || !FixupString(head, file_size, &record.name)) { return false; }
+  }
+  if (!FixupArray(head, file_size, header->render_pass_num, &header->render_pass_list)) { return false; }
+  for (uint32_t i = 0; i < header->render_pass_num; i++) {
+    auto& record = header->render_pass_list[i];
+    if (record.name == nullptr || !FixupString(head, file_size, &record.name)) { return false; }
+    if (!FixupRenderPassList(head, file_size, &record.list)) { return false; }
+  }
+  if (!FixupArray(head, file_size, header->material_num, &header->material_list)) { return false; }
+  for (uint32_t i = 0; i < header->material_num; i++) {
+    if (!FixupMaterialInfo(head, file_size, &header->material_list[i])) { return false; }
+  }
+  return true;
+}
+} // namespace
+namespace boke {
+bool BakeGfxConfig(const GfxConfig* config, const char* const baked_config_path) {
+  ResizableArray<char> buffer(4 * 1024);
+  StrHashMap<uint32_t> string_offset;
+  BakedConfigWriter writer{
+    .buffer = &buffer,
+    .string_offset = &string_offset,
+  };
+  auto header = GetBakedConfigHeaderTemplate();
+  // header is written again once all offsets are known.
+  AppendBytes(&header, sizeof(header), kBakedConfigAlignment, writer);
+  header.title = AppendString(config->title, writer);
+  header.frame_buffer_num = config->frame_buffer_num;
+  header.swapchain_size = config->swapchain_size;
+  header.swapchain_format = config->swapchain_format;
+  header.max_loop_num = config->max_loop_num;
+  header.shader_visible_buffer_num = config->shader_visible_buffer_num;
+  header.resource_num = config->resource_info->size();
+  header.resource_list = AppendResourceList(*config->resource_info, writer);
+  header.render_pass_num = config->render_pass_list->size();
+  header.render_pass_list = AppendRenderPassList(*config->render_pass_list, writer);
+  header.material_num = config->material_num;
+  header.material_list = AppendMaterialList(config->material_num, config->material_list, writer);
+  header.file_size = buffer.size();
+  memcpy(buffer.begin(), &header, sizeof(header));
+  return SaveBufferToFile(baked_config_path, buffer.begin(), buffer.size());
+}
+GfxConfig* LoadBakedGfxConfig(const char* const baked_config_path, const StrHashMap<Size2d>& explicit_buffer_size) {
+  auto file = MapFileCopyOnWrite(baked_config_path);
+  if (file.buffer == nullptr) { return nullptr; }
+  // pages are copied on write, so fixups never reach the file.
+  auto head = const_cast<char*>(file.buffer);
+  auto header = reinterpret_cast<BakedConfigHeader*>(head);
+  if (file.size < sizeof(BakedConfigHeader) || !IsCompatibleHeader(*header, file.size) || !FixupBakedConfig(head, file.size)) {
+    UnmapFile(file);
+    return nullptr;
+  }
+  auto config = New<GfxConfig>();
+  config->baked_config = file.buffer;
+  config->baked_config_size = file.size;
+  config->title = header->title;
+  config->frame_buffer_num = header->frame_buffer_num;
+  config->swapchain_size = header->swapchain_size;
+  config->swapchain_format = header->swapchain_format;
+  config->max_loop_num = header->max_loop_num;
+  config->shader_visible_buffer_num = header->shader_visible_buffer_num;
+  config->resource_info = New<StrHashMap<ResourceInfo>>(header->resource_num);
+  for (uint32_t i = 0; i < header->resource_num; i++) {
+    const auto& record = header->resource_list[i];
+    // names are registered for debug names and gui; ids themselves are not hashed again.
+    [[maybe_unused]] const auto hash = GetStrHash(record.name);
+    DEBUG_ASSERT(hash == record.id, DebugAssert{});
+    auto info = record.info;
+    AdjustResourceSize(record.id, explicit_buffer_size, &info);
+    config->resource_info->insert(record.id, info);
+  }
+  config->render_pass_list = New<StrHashMap<RenderPassList>>(header->render_pass_num);
+  for (uint32_t i = 0; i < header->render_pass_num; i++) {
+    const auto& record = header->render_pass_list[i];
+    config->render_pass_list->insert(record.id, record.list);
+  }
+  config->material_num = header->material_num;
+  config->material_list = header->material_list;
+  return config;
+}
+} // namespace boke
+#include "doctest/doctest.h"
+namespace {
+void CheckGfxConfigEqual(const boke::GfxConfig* config, const boke::GfxConfig* expected) {
+  using namespace boke;
+  CHECK_EQ(strcmp(config->title, expected->title), 0);
+  CHECK_EQ(config->frame_buffer_num, expected->frame_buffer_num);
+  CHECK_EQ(config->swapchain_size.width, expected->swapchain_size.width);
+  CHECK_EQ(config->swapchain_size.height, expected->swapchain_size.height);
+  CHECK_EQ(config->swapchain_format, expected->swapchain_format);
+  CHECK_EQ(config->max_loop_num, expected->max_loop_num);
+  CHECK_EQ(config->shader_visible_buffer_num, expected->shader_visible_buffer_num);
+  REQUIRE_EQ(config->resource_info->size(), expected->resource_info->size());
+  expected->resource_info->iterate<const GfxConfig>([](const GfxConfig* config, const StrHash resource_id, const ResourceInfo* expected_info) {
+    REQUIRE_UNARY(config->resource_info->contains(resource_id));
+    const auto& info = (*config->resource_info)[resource_id];
+    CHECK_EQ(info.creation_type, expected_info->creation_type);
+    CHECK_EQ(info.flags, expected_info->flags);
+    CHECK_EQ(info.format, expected_info->format);
+    CHECK_EQ(info.size.width, expected_info->size.width);
+    CHECK_EQ(info.size.height, expected_info->size.height);
+    CHECK_EQ(info.physical_resource_num, expected_info->physical_resource_num);
+    CHECK_EQ(info.pingpong, expected_info->pingpong);
+    CHECK_EQ(info.mip_levels, expected_info->mip_levels);
+    CHECK_EQ(info.array_size, expected_info->array_size);
+  }, config);
+  REQUIRE_EQ(config->render_pass_list->size(), expected->render_pass_list->size());
+  expected->render_pass_list->iterate<const GfxConfig>([](const GfxConfig* config, const StrHash render_pass_id, const RenderPassList* expected_list) {
+    REQUIRE_UNARY(config->render_pass_list->contains(render_pass_id));
+    const auto& list = (*config->render_pass_list)[render_pass_id];
+    REQUIRE_EQ(list.render_pass_len, expected_list->render_pass_len);
+    for (uint32_t i = 0; i < list.render_pass_len; i++) {
+      const auto& info = list.render_pass_info[i];
+      const auto& expected_info = expected_list->render_pass_info[i];
+      CHECK_EQ(info.queue, expected_info.queue);
+      CHECK_EQ(info.type, expected_info.type);
+      CHECK_EQ(info.material, expected_info.material);
+      REQUIRE_EQ(info.cbv_num, expected_info.cbv_num);
+      CHECK_EQ(memcmp(info.cbv, expected_info.cbv, sizeof(StrHash) * info.cbv_num), 0);
+      REQUIRE_EQ(info.srv_num, expected_info.srv_num);
+      CHECK_EQ(memcmp(info.srv, expected_info.srv, sizeof(StrHash) * info.srv_num), 0);
+      REQUIRE_EQ(info.uav_num, expected_info.uav_num);
+      CHECK_EQ(memcmp(info.uav, expected_info.uav, sizeof(StrHash) * info.uav_num), 0);
+      REQUIRE_EQ(info.rtv_num, expected_info.rtv_num);
+      CHECK_EQ(memcmp(info.rtv, expected_info.rtv, sizeof(StrHash) * info.rtv_num), 0);
+      CHECK_EQ(info.dsv, expected_info.dsv);
+      CHECK_EQ(info.present, expected_info.present);
+      CHECK_EQ(info.material_id, expected_info.material_id);
+      CHECK_EQ(info.stencil_val, expected_info.stencil_val);
+      REQUIRE_EQ(info.srv_subresource == nullptr, expected_info.srv_subresource == nullptr);
+      if (info.srv_subresource != nullptr) {
+        CHECK_EQ(memcmp(info.srv_subresource, expected_info.srv_subresource, sizeof(SubresourceRange) * info.srv_num), 0);
+      }
+      REQUIRE_EQ(info.rtv_subresource == nullptr, expected_info.rtv_subresource == nullptr);
+      if (info.rtv_subresource != nullptr) {
+        CHECK_EQ(memcmp(info.rtv_subresource, expected_info.rtv_subresource, sizeof(SubresourceRange) * info.rtv_num), 0);
+      }
+      REQUIRE_EQ(info.dsv_subresource == nullptr, expected_info.dsv_subresource == nullptr);
+      if (info.dsv_subresource != nullptr) {
+        CHECK_EQ(memcmp(info.dsv_subresource, expected_info.dsv_subresource, sizeof(SubresourceRange)), 0);
+      }
+    }
+  }, config);
+  REQUIRE_EQ(config->material_num, expected->material_num);
+  for (uint32_t i = 0; i < config->material_num; i++) {
+    const auto& material = config->material_list[i];
+    const auto& expected_material = expected->material_list[i];
+    CHECK_EQ(strcmp(material.name, expected_material.name), 0);
+    CHECK_EQ(strcmp(material.rootsig, expected_material.rootsig), 0);
+    REQUIRE_EQ(material.fallback == nullptr, expected_material.fallback == nullptr);
+    if (material.fallback != nullptr) {
+      CHECK_EQ(strcmp(material.fallback, expected_material.fallback), 0);
+    }
+    REQUIRE_EQ(material.shader_num, expected_material.shader_num);
+    for (uint32_t j = 0; j < material.shader_num; j++) {
+      CHECK_EQ(strcmp(material.shader_list[j].target, expected_material.shader_list[j].target), 0);
+      CHECK_EQ(strcmp(material.shader_list[j].filename, expected_material.shader_list[j].filename), 0);
+    }
+    REQUIRE_EQ(material.rtv_num, expected_material.rtv_num);
+    CHECK_EQ(memcmp(material.rtv_format, expected_material.rtv_format, sizeof(DXGI_FORMAT) * material.rtv_num), 0);
+  }
+}
+} // namespace
+TEST_CASE("baked config") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 256 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  InitStrHashSystem();
+  // kept apart from the baked config other tests load.
+  const char baked_config_path[] = "tests/baked-config-test.baked";
+  StrHashMap<Size2d> explicit_buffer_size;
+  explicit_buffer_size["camera"_id] = Size2d{sizeof(float) * 32,1};
+  auto config = LoadGfxConfig("tests/formatted-config-multipass.json", explicit_buffer_size);
+  SUBCASE("round trip") {
+    config->material_list[2].fallback = config->material_list[1].name;
+    // subresource ranges are set by code, not by configs.
+    (*config->resource_info)["gbuffer0"_id].mip_levels = 4;
+    (*config->resource_info)["gbuffer0"_id].array_size = 2;
+    auto& render_pass_info = (*config->render_pass_list)["default"_id].render_pass_info;
+    REQUIRE_EQ(render_pass_info[0].rtv_num, 4);
+    REQUIRE_EQ(render_pass_info[1].srv_num, 4);
+    SubresourceRange gbuffer_range[] = {
+      {.first_mip = 0, .mip_num = 1,},
+      {.first_mip = 1, .mip_num = 1,},
+      {.first_slice = 1, .slice_num = 1,},
+      {.first_mip = 2,},
+    };
+    SubresourceRange depth_range{.first_slice = 0, .slice_num = 1,};
+    render_pass_info[0].rtv_subresource = gbuffer_range;
+    render_pass_info[0].dsv_subresource = &depth_range;
+    render_pass_info[1].srv_subresource = gbuffer_range;
+    REQUIRE_UNARY(BakeGfxConfig(config, baked_config_path));
+    auto baked_config = LoadBakedGfxConfig(baked_config_path, explicit_buffer_size);
+    REQUIRE_NE(baked_config, nullptr);
+    CheckGfxConfigEqual(baked_config, config);
+    ReleaseGfxConfig(baked_config);
+    // loading twice works as fixups are never written back to the file.
+    baked_config = LoadBakedGfxConfig(baked_config_path, explicit_buffer_size);
+    REQUIRE_NE(baked_config, nullptr);
+    CheckGfxConfigEqual(baked_config, config);
+    ReleaseGfxConfig(baked_config);
+    render_pass_info[0].rtv_subresource = nullptr;
+    render_pass_info[0].dsv_subresource = nullptr;
+    render_pass_info[1].srv_subresource = nullptr;
+  }
+  SUBCASE("incompatible file") {
+    const char text[] = "not a baked config";
+    REQUIRE_UNARY(SaveBufferToFile(baked_config_path, text, sizeof(text)));
+    CHECK_EQ(LoadBakedGfxConfig(baked_config_path, explicit_buffer_size), nullptr);
+  }
+  SUBCASE("missing file") {
+    CHECK_EQ(LoadBakedGfxConfig("tests/file-not-exist.baked", explicit_buffer_size), nullptr);
+  }
+  SUBCASE("corrupted offsets and counts") {
+    REQUIRE_UNARY(BakeGfxConfig(config, baked_config_path));
+    uint32_t size = 0;
+    auto buffer = LoadFileToBuffer(baked_config_path, &size);
+    REQUIRE_NE(buffer, nullptr);
+    BakedConfigHeader header{};
+    memcpy(&header, buffer, sizeof(header));
+    const uint32_t corruption_num = 4;
+    for (uint32_t i = 0; i < corruption_num; i++) {
+      CAPTURE(i);
+      auto corrupted_header = header;
+      switch (i) {
+        case 0: { corrupted_header.resource_num = 0x10000000; break; }
+        case 1: { corrupted_header.render_pass_list = GetOffsetPointer<BakedRenderPass>(size); break; }
+        case 2: { corrupted_header.material_list = GetOffsetPointer<MaterialInfo>(1); break; }
+        case 3: { corrupted_header.title = GetOffsetPointer<const char>(size); break; }
+      }
+      // file_size is kept, only offsets and counts are broken.
+      memcpy(buffer, &corrupted_header, sizeof(corrupted_header));
+      REQUIRE_UNARY(SaveBufferToFile(baked_config_path, buffer, size));
+      CHECK_EQ(LoadBakedGfxConfig(baked_config_path, explicit_buffer_size), nullptr);
+    }
+    Deallocate(buffer);
+  }
+  RemoveFile(baked_config_path);
+  ReleaseGfxConfig(config);
+  explicit_buffer_size.~StrHashMap<Size2d>();
+  TermStrHashSystem();
+}
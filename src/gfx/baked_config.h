@@ -0,0 +1,15 @@
+#pragma once
+namespace boke {
+/**
+ * writes config as a versioned binary blob with pre-hashed ids, flattened arrays and a string table.
+ * names are looked up with GetStr, so the str hash system must be initialized before loading config.
+ **/
+bool BakeGfxConfig(const GfxConfig* config, const char* const baked_config_path);
+/**
+ * maps the baked file copy-on-write and fixes up its offsets into pointers in place.
+ * returns nullptr if the file is missing or was baked with another version or layout,
+ * in which case the json config should be loaded instead.
+ * release with ReleaseGfxConfig.
+ **/
+GfxConfig* LoadBakedGfxConfig(const char* const baked_config_path, const StrHashMap<Size2d>& explicit_buffer_size);
+}
@@ -6,16 +6,55 @@
 #include "barrier_config.h"
 #include "json.h"
 #include "render_pass_info.h"
-#include "resources.h"
+#include "resource_info.h"
+#include "resource_set.h"
+#include "config_loader.h"
+#include "dxgi_format.h"
+#include "resource_aliasing.h"
+#include "queue_schedule.h"
 namespace {
 struct BarrierTransitionInfoIndex {
   uint32_t physical_resource_num{};
   uint32_t index{};
+  bool aliased{};
+  bool buffer{}; // buffers have no layout, barriers are issued on access hazards only.
+  uint32_t mip_levels{1};
+  uint32_t array_size{1};
+  uint32_t plane_num{1}; // depth and stencil planes share their transitions.
 };
 struct BarrierTransitionInfoPerResource {
   D3D12_BARRIER_SYNC   sync{D3D12_BARRIER_SYNC_NONE};
   D3D12_BARRIER_ACCESS access{D3D12_BARRIER_ACCESS_NO_ACCESS};
   D3D12_BARRIER_LAYOUT layout{};
+  bool access_barrier{}; // next only, a barrier is needed without a layout change, e.g. uav to uav.
+};
+struct BarrierScheduleResource {
+  boke::StrHash resource_id{};
+  bool read_index{}; // pingpong read index at the pass, write index otherwise
+};
+struct BarrierScheduleFrameState {
+  BarrierScheduleResource resource{};
+  bool all_physical_resources{}; // e.g. swapchain, only one buffer is used per frame
+  uint32_t subresource{};
+  BarrierTransitionInfoPerResource info{};
+};
+struct BarrierScheduleSplit {
+  uint32_t local_index{};
+  uint32_t begin_pass{}; // earliest pass the barrier may begin before, i.e. right after the last use of the resource
+};
+struct BarrierSchedulePass {
+  boke::QueueType queue{};
+  uint32_t barrier_offset{};
+  uint32_t barrier_num{};
+  /**
+   * issued after the pass, transitions to layouts the next user on another queue can access.
+   **/
+  uint32_t release_barrier_offset{};
+  uint32_t release_barrier_num{};
+  uint32_t buffer_barrier_offset{};
+  uint32_t buffer_barrier_num{};
+  uint32_t flip_offset{};
+  uint32_t flip_num{};
 };
 } // namespace
 namespace boke {
@@ -23,10 +62,35 @@ struct BarrierTransitionInfo {
   StrHashMap<BarrierTransitionInfoIndex>* transition_info_index;
   ResizableArray<BarrierTransitionInfoPerResource>* transition_info;
 };
+struct BarrierSchedule {
+  uint32_t pass_num{};
+  BarrierSchedulePass* pass_list{};
+  /**
+   * pResource is patched by current write index when recorded.
+   **/
+  ResizableArray<D3D12_TEXTURE_BARRIER>* barrier_list{};
+  ResizableArray<BarrierScheduleResource>* barrier_resource_list{};
+  ResizableArray<D3D12_BUFFER_BARRIER>* buffer_barrier_list{};
+  ResizableArray<BarrierScheduleResource>* buffer_barrier_resource_list{};
+  ResizableArray<StrHash>* flip_list{};
+  /**
+   * state at frame boundaries, relative to write indices at the boundary.
+   **/
+  ResizableArray<BarrierScheduleFrameState>* frame_state_list{};
+};
 } // namespace boke
 namespace {
 using namespace boke;
 const uint32_t kInvalidIndex = ~0U;
+/**
+ * memory of an aliased resource may have been used by another placement since its last use.
+ * its first barrier in a frame waits for preceding work and discards the contents.
+ **/
+const BarrierTransitionInfoPerResource kAliasedResourceInitialTransitionInfo{
+  .sync = D3D12_BARRIER_SYNC_ALL,
+  .access = D3D12_BARRIER_ACCESS_NO_ACCESS,
+  .layout = D3D12_BARRIER_LAYOUT_UNDEFINED,
+};
 auto FlipPingPongIndexImpl(const uint32_t list_len, const StrHash* flip_list, StrHashMap<uint32_t>& current_write_index_list) {
   for (uint32_t i = 0; i < list_len; i++) {
     const auto& resource_id = flip_list[i];
@@ -37,38 +101,124 @@ auto IsSame(const BarrierTransitionInfoPerResource& a, const BarrierTransitionIn
   if (a.sync != b.sync) { return false; }
   if (a.access != b.access) { return false; }
   if (a.layout != b.layout) { return false; }
+  if (a.access_barrier != b.access_barrier) { return false; }
   return true;
 }
 auto GetTransitionInfoIndex(const StrHash resource_id, const BarrierTransitionInfo* transition_info) {
   return (*transition_info->transition_info_index)[resource_id];
 }
+/**
+ * each physical resource has one entry per subresource (mip + slice * mip_levels),
+ * current entries of all physical resources are followed by next ones.
+ **/
+auto GetSubresourceNum(const BarrierTransitionInfoIndex& transition_info_index) {
+  return transition_info_index.mip_levels * transition_info_index.array_size;
+}
+auto GetEntryNum(const BarrierTransitionInfoIndex& transition_info_index) {
+  return transition_info_index.physical_resource_num * GetSubresourceNum(transition_info_index);
+}
+auto GetEntryIndex(const uint32_t resource_local_index, const uint32_t subresource, const BarrierTransitionInfoIndex& transition_info_index) {
+  return resource_local_index * GetSubresourceNum(transition_info_index) + subresource;
+}
 auto GetCurrentTransitionInfo(const StrHash resource_id, const uint32_t resource_local_index, const BarrierTransitionInfo* transition_info) {
   const auto& transition_info_index = GetTransitionInfoIndex(resource_id, transition_info);
-  return (*transition_info->transition_info)[transition_info_index.index + resource_local_index];
+  return (*transition_info->transition_info)[transition_info_index.index + GetEntryIndex(resource_local_index, 0, transition_info_index)];
 }
-auto GetNextTransitionInfo(const StrHash resource_id, const uint32_t resource_local_index, const BarrierTransitionInfo* transition_info) {
-  const auto& transition_info_index = GetTransitionInfoIndex(resource_id, transition_info);
-  return (*transition_info->transition_info)[transition_info_index.index + transition_info_index.physical_resource_num + resource_local_index];
+auto GetCurrentTransitionInfo(const uint32_t entry_index, const BarrierTransitionInfoIndex& transition_info_index, const BarrierTransitionInfo* transition_info) {
+  return (*transition_info->transition_info)[transition_info_index.index + entry_index];
 }
-auto GetCurrentTransitionInfo(const uint32_t resource_local_index, const BarrierTransitionInfoIndex& transition_info_index, const BarrierTransitionInfo* transition_info) {
-  return (*transition_info->transition_info)[transition_info_index.index + resource_local_index];
+auto GetNextTransitionInfo(const uint32_t entry_index, const BarrierTransitionInfoIndex& transition_info_index, const BarrierTransitionInfo* transition_info) {
+  return (*transition_info->transition_info)[transition_info_index.index + GetEntryNum(transition_info_index) + entry_index];
 }
-auto GetNextTransitionInfo(const uint32_t resource_local_index, const BarrierTransitionInfoIndex& transition_info_index, const BarrierTransitionInfo* transition_info) {
-  return (*transition_info->transition_info)[transition_info_index.index + transition_info_index.physical_resource_num + resource_local_index];
+auto SetNextTransitionInfo(const uint32_t entry_index, const BarrierTransitionInfoPerResource& info, const BarrierTransitionInfoIndex& transition_info_index, BarrierTransitionInfo* transition_info) {
+  (*transition_info->transition_info)[transition_info_index.index + GetEntryNum(transition_info_index) + entry_index] = info;
 }
-auto UpdateNextTransitionInfo(const StrHash resource_id, const uint32_t resource_local_index, const BarrierTransitionInfoPerResource& info, BarrierTransitionInfo* transition_info) {
-  const auto& transition_info_index = GetTransitionInfoIndex(resource_id, transition_info);
-  (*transition_info->transition_info)[transition_info_index.index + transition_info_index.physical_resource_num + resource_local_index] = info;
+auto GetRangeNum(const uint32_t first, const uint32_t num, const uint32_t total) {
+  if (first >= total) { return 0U; }
+  if (num == 0) { return total - first; }
+  return (num < total - first) ? num : total - first;
+}
+auto IsReadOnlyAccess(const D3D12_BARRIER_ACCESS access) {
+  if (access & D3D12_BARRIER_ACCESS_RENDER_TARGET) { return false; }
+  if (access & D3D12_BARRIER_ACCESS_UNORDERED_ACCESS) { return false; }
+  if (access & D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE) { return false; }
+  if (access & D3D12_BARRIER_ACCESS_COPY_DEST) { return false; }
+  if (access & D3D12_BARRIER_ACCESS_RESOLVE_DEST) { return false; }
+  if (access & D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_WRITE) { return false; }
+  return true;
+}
+/**
+ * hazards not resolved by a layout transition.
+ * writes to buffers and uav accesses to a texture in unordered access layout need a barrier of their own.
+ **/
+auto IsAccessBarrierNeeded(const BarrierTransitionInfoPerResource& current, const BarrierTransitionInfoPerResource& next, const bool buffer) {
+  if (current.access == D3D12_BARRIER_ACCESS_NO_ACCESS) { return false; }
+  if (buffer) {
+    return !IsReadOnlyAccess(current.access) || !IsReadOnlyAccess(next.access);
+  }
+  if (current.layout != next.layout) { return false; }
+  return (current.access & D3D12_BARRIER_ACCESS_UNORDERED_ACCESS) && (next.access & D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
+}
+auto IsBarrierNeeded(const BarrierTransitionInfoPerResource& current, const BarrierTransitionInfoPerResource& next) {
+  return next.layout != current.layout || next.access_barrier;
+}
+auto UpdateNextEntryTransitionInfo(const uint32_t entry_index, const BarrierTransitionInfoPerResource& info, const BarrierTransitionInfoIndex& transition_info_index, BarrierTransitionInfo* transition_info) {
+  auto next = info;
+  if (transition_info_index.buffer) {
+    next.layout = D3D12_BARRIER_LAYOUT_UNDEFINED;
+  }
+  next.access_barrier = IsAccessBarrierNeeded(GetCurrentTransitionInfo(entry_index, transition_info_index, transition_info), next, transition_info_index.buffer);
+  SetNextTransitionInfo(entry_index, next, transition_info_index, transition_info);
+}
+auto UpdateNextTransitionInfo(const StrHash resource_id, const uint32_t resource_local_index, const SubresourceRange* range, const BarrierTransitionInfoPerResource& info, BarrierTransitionInfo* transition_info) {
+  // e.g. imgui_font, not transitioned by passes.
+  const auto transition_info_index = transition_info->transition_info_index->get(resource_id);
+  if (transition_info_index == nullptr) { return; }
+  if (range == nullptr) {
+    for (uint32_t i = 0; i < GetSubresourceNum(*transition_info_index); i++) {
+      UpdateNextEntryTransitionInfo(GetEntryIndex(resource_local_index, i, *transition_info_index), info, *transition_info_index, transition_info);
+    }
+    return;
+  }
+  const auto mip_num = GetRangeNum(range->first_mip, range->mip_num, transition_info_index->mip_levels);
+  const auto slice_num = GetRangeNum(range->first_slice, range->slice_num, transition_info_index->array_size);
+  for (uint32_t slice = range->first_slice; slice < range->first_slice + slice_num; slice++) {
+    for (uint32_t mip = range->first_mip; mip < range->first_mip + mip_num; mip++) {
+      UpdateNextEntryTransitionInfo(GetEntryIndex(resource_local_index, mip + slice * transition_info_index->mip_levels, *transition_info_index), info, *transition_info_index, transition_info);
+    }
+  }
+}
+auto GetSubresourceRange(const SubresourceRange* range_list, const uint32_t index) {
+  return range_list == nullptr ? nullptr : &range_list[index];
 }
 auto ConfigureBarriersTextureTransitions(const RenderPassInfo& next_render_pass, const StrHashMap<uint32_t>& current_write_index_list, BarrierTransitionInfo* transition_info) {
-  // srv
+  // cbv, frame buffered and written by cpu unless a pass writes them as uav.
   BarrierTransitionInfoPerResource info{
-    .sync = D3D12_BARRIER_SYNC_PIXEL_SHADING,
+    .sync = D3D12_BARRIER_SYNC_ALL_SHADING,
+    .access = D3D12_BARRIER_ACCESS_CONSTANT_BUFFER,
+    .layout = D3D12_BARRIER_LAYOUT_UNDEFINED,
+  };
+  for (uint32_t i = 0; i < next_render_pass.cbv_num; i++) {
+    UpdateNextTransitionInfo(next_render_pass.cbv[i], GetResourceLocalIndexWrite(current_write_index_list, next_render_pass.cbv[i]), nullptr, info, transition_info);
+  }
+  // srv, read in the layout shared by queues outside the direct queue.
+  const auto direct_queue = GetQueueType(next_render_pass.queue) == QueueType::kDirect;
+  info = BarrierTransitionInfoPerResource{
+    .sync = direct_queue ? D3D12_BARRIER_SYNC_PIXEL_SHADING : D3D12_BARRIER_SYNC_COMPUTE_SHADING,
     .access = D3D12_BARRIER_ACCESS_SHADER_RESOURCE,
-    .layout = D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE
+    .layout = direct_queue ? D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE : D3D12_BARRIER_LAYOUT_SHADER_RESOURCE,
   };
   for (uint32_t i = 0; i < next_render_pass.srv_num; i++) {
-    UpdateNextTransitionInfo(next_render_pass.srv[i], GetResourceLocalIndexRead(current_write_index_list, next_render_pass.srv[i]), info, transition_info);
+    UpdateNextTransitionInfo(next_render_pass.srv[i], GetResourceLocalIndexRead(current_write_index_list, next_render_pass.srv[i]), GetSubresourceRange(next_render_pass.srv_subresource, i), info, transition_info);
+  }
+  // uav, accessed from pixel or compute shaders.
+  info = BarrierTransitionInfoPerResource{
+    .sync = D3D12_BARRIER_SYNC_ALL_SHADING,
+    .access = D3D12_BARRIER_ACCESS_UNORDERED_ACCESS,
+    .layout = D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS,
+  };
+  for (uint32_t i = 0; i < next_render_pass.uav_num; i++) {
+    UpdateNextTransitionInfo(next_render_pass.uav[i], GetResourceLocalIndexWrite(current_write_index_list, next_render_pass.uav[i]), nullptr, info, transition_info);
   }
   // rtv
   info = BarrierTransitionInfoPerResource{
@@ -77,7 +227,7 @@ auto ConfigureBarriersTextureTransitions(const RenderPassInfo& next_render_pass,
     .layout = D3D12_BARRIER_LAYOUT_RENDER_TARGET,
   };
   for (uint32_t i = 0; i < next_render_pass.rtv_num; i++) {
-    UpdateNextTransitionInfo(next_render_pass.rtv[i], GetResourceLocalIndexWrite(current_write_index_list, next_render_pass.rtv[i]), info, transition_info);
+    UpdateNextTransitionInfo(next_render_pass.rtv[i], GetResourceLocalIndexWrite(current_write_index_list, next_render_pass.rtv[i]), GetSubresourceRange(next_render_pass.rtv_subresource, i), info, transition_info);
   }
   // dsv
   if (next_render_pass.dsv != kEmptyStr) {
@@ -86,7 +236,7 @@ auto ConfigureBarriersTextureTransitions(const RenderPassInfo& next_render_pass,
       .access = D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE,
       .layout = D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE,
     };
-    UpdateNextTransitionInfo(next_render_pass.dsv, GetResourceLocalIndexWrite(current_write_index_list, next_render_pass.dsv), info, transition_info);
+    UpdateNextTransitionInfo(next_render_pass.dsv, GetResourceLocalIndexWrite(current_write_index_list, next_render_pass.dsv), next_render_pass.dsv_subresource, info, transition_info);
   }
   // present
   if (next_render_pass.present != kEmptyStr) {
@@ -95,7 +245,7 @@ auto ConfigureBarriersTextureTransitions(const RenderPassInfo& next_render_pass,
       .access = D3D12_BARRIER_ACCESS_NO_ACCESS,
       .layout = D3D12_BARRIER_LAYOUT_PRESENT,
     };
-    UpdateNextTransitionInfo(next_render_pass.present, GetResourceLocalIndexWrite(current_write_index_list, next_render_pass.present), info, transition_info);
+    UpdateNextTransitionInfo(next_render_pass.present, GetResourceLocalIndexWrite(current_write_index_list, next_render_pass.present), nullptr, info, transition_info);
   }
 }
 auto GetPingPongFlippingResourceList(const RenderPassInfo& render_pass, const BarrierTransitionInfo* transition_info, const StrHashMap<ResourceInfo>& resource_info, const StrHashMap<uint32_t>& current_write_index_list, const uint32_t result_len, StrHash* result) {
@@ -122,47 +272,186 @@ auto GetPingPongFlippingResourceList(const RenderPassInfo& render_pass, const Ba
   }
   return result_num;
 }
-auto IsReadOnlyAccess(const D3D12_BARRIER_ACCESS access) {
-  if (access & D3D12_BARRIER_ACCESS_RENDER_TARGET) { return false; }
-  if (access & D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE) { return false; }
-  if (access & D3D12_BARRIER_ACCESS_COPY_DEST) { return false; }
-  if (access & D3D12_BARRIER_ACCESS_RESOLVE_DEST) { return false; }
-  if (access & D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_WRITE) { return false; }
-  return true;
-}
 struct ProcessBarriersImplAsset {
   D3D12_TEXTURE_BARRIER* barriers{};
+  uint32_t barrier_len{};
+  D3D12_BUFFER_BARRIER* buffer_barriers{};
+  uint32_t buffer_barrier_len{};
   const ResourceSet* resource_set;
   const BarrierTransitionInfo* transition_info;
   uint32_t barrier_index{};
+  uint32_t buffer_barrier_index{};
 };
+auto GetBufferBarrier(const BarrierTransitionInfoPerResource& transition_info, const BarrierTransitionInfoPerResource& next_transition_info, ID3D12Resource* resource) {
+  return D3D12_BUFFER_BARRIER{
+    .SyncBefore = transition_info.sync,
+    .SyncAfter  = next_transition_info.sync,
+    .AccessBefore = transition_info.access,
+    .AccessAfter  = next_transition_info.access,
+    .pResource = resource,
+    .Offset = 0,
+    .Size = UINT64_MAX,
+  };
+}
+auto IsBufferBarrierNeeded(const uint32_t resource_local_index, const BarrierTransitionInfoIndex& transition_info_index, const BarrierTransitionInfo* transition_info) {
+  return GetNextTransitionInfo(GetEntryIndex(resource_local_index, 0, transition_info_index), transition_info_index, transition_info).access_barrier;
+}
+auto GetBufferBarrier(const uint32_t resource_local_index, const BarrierTransitionInfoIndex& transition_info_index, const BarrierTransitionInfo* transition_info, ID3D12Resource* resource) {
+  const auto entry_index = GetEntryIndex(resource_local_index, 0, transition_info_index);
+  return GetBufferBarrier(GetCurrentTransitionInfo(entry_index, transition_info_index, transition_info), GetNextTransitionInfo(entry_index, transition_info_index, transition_info), resource);
+}
+/**
+ * texture and buffer barriers are issued as separate groups of a single call.
+ **/
+void IssueBarriers(const uint32_t barrier_num, const D3D12_TEXTURE_BARRIER* barriers, const uint32_t buffer_barrier_num, const D3D12_BUFFER_BARRIER* buffer_barriers, D3d12CommandList* command_list) {
+  D3D12_BARRIER_GROUP barrier_group[2]{};
+  uint32_t barrier_group_num = 0;
+  if (barrier_num > 0) {
+    barrier_group[barrier_group_num] = {
+      .Type = D3D12_BARRIER_TYPE_TEXTURE,
+      .NumBarriers = barrier_num,
+      .pTextureBarriers = barriers,
+    };
+    barrier_group_num++;
+  }
+  if (buffer_barrier_num > 0) {
+    barrier_group[barrier_group_num] = {
+      .Type = D3D12_BARRIER_TYPE_BUFFER,
+      .NumBarriers = buffer_barrier_num,
+      .pBufferBarriers = buffer_barriers,
+    };
+    barrier_group_num++;
+  }
+  if (barrier_group_num == 0) { return; }
+  command_list->Barrier(barrier_group_num, barrier_group);
+}
+auto GetTextureBarrier(const BarrierTransitionInfoPerResource& transition_info, const BarrierTransitionInfoPerResource& next_transition_info, ID3D12Resource* resource) {
+  return D3D12_TEXTURE_BARRIER{
+    .SyncBefore = transition_info.sync,
+    .SyncAfter  = next_transition_info.sync,
+    .AccessBefore = transition_info.access,
+    .AccessAfter  = next_transition_info.access,
+    .LayoutBefore = transition_info.layout,
+    .LayoutAfter  = next_transition_info.layout,
+    .pResource = resource,
+    .Subresources = {
+      .IndexOrFirstMipLevel = 0xffffffff,
+      .NumMipLevels = 0,
+      .FirstArraySlice = 0,
+      .NumArraySlices = 0,
+      .FirstPlane = 0,
+      .NumPlanes = 0,
+    },
+    .Flags = (transition_info.layout == D3D12_BARRIER_LAYOUT_UNDEFINED) ? D3D12_TEXTURE_BARRIER_FLAG_DISCARD : D3D12_TEXTURE_BARRIER_FLAG_NONE,
+  };
+}
+auto IsSameTransition(const D3D12_TEXTURE_BARRIER& a, const D3D12_TEXTURE_BARRIER& b) {
+  if (a.SyncBefore != b.SyncBefore || a.SyncAfter != b.SyncAfter) { return false; }
+  if (a.AccessBefore != b.AccessBefore || a.AccessAfter != b.AccessAfter) { return false; }
+  if (a.LayoutBefore != b.LayoutBefore || a.LayoutAfter != b.LayoutAfter) { return false; }
+  return a.Flags == b.Flags;
+}
+auto IsUniformTransition(const uint32_t entry_index, const BarrierTransitionInfoIndex& transition_info_index, const BarrierTransitionInfo* transition_info) {
+  const auto& current = GetCurrentTransitionInfo(entry_index, transition_info_index, transition_info);
+  const auto& next = GetNextTransitionInfo(entry_index, transition_info_index, transition_info);
+  for (uint32_t i = 1; i < GetSubresourceNum(transition_info_index); i++) {
+    if (!IsSame(GetCurrentTransitionInfo(entry_index + i, transition_info_index, transition_info), current)) { return false; }
+    if (!IsSame(GetNextTransitionInfo(entry_index + i, transition_info_index, transition_info), next)) { return false; }
+  }
+  return true;
+}
+auto MergeSliceBarrier(const D3D12_TEXTURE_BARRIER& barrier, const uint32_t barrier_num, D3D12_TEXTURE_BARRIER* barrier_list) {
+  for (uint32_t i = 0; i < barrier_num; i++) {
+    auto& dst = barrier_list[i];
+    if (dst.Subresources.IndexOrFirstMipLevel != barrier.Subresources.IndexOrFirstMipLevel) { continue; }
+    if (dst.Subresources.NumMipLevels != barrier.Subresources.NumMipLevels) { continue; }
+    if (dst.Subresources.FirstArraySlice + dst.Subresources.NumArraySlices != barrier.Subresources.FirstArraySlice) { continue; }
+    if (!IsSameTransition(dst, barrier)) { continue; }
+    dst.Subresources.NumArraySlices++;
+    return true;
+  }
+  return false;
+}
+/**
+ * barriers of a physical resource, a single one covering all subresources when they share their transition.
+ * otherwise runs of mips with the same transition are merged across contiguous array slices.
+ **/
+uint32_t GetSubresourceBarrierList(const uint32_t resource_local_index, const BarrierTransitionInfoIndex& transition_info_index, const BarrierTransitionInfo* transition_info, ID3D12Resource* resource, const uint32_t barrier_list_len, D3D12_TEXTURE_BARRIER* barrier_list) {
+  const auto entry_index = GetEntryIndex(resource_local_index, 0, transition_info_index);
+  if (IsUniformTransition(entry_index, transition_info_index, transition_info)) {
+    const auto& current = GetCurrentTransitionInfo(entry_index, transition_info_index, transition_info);
+    const auto& next = GetNextTransitionInfo(entry_index, transition_info_index, transition_info);
+    if (!IsBarrierNeeded(current, next)) { return 0; }
+    DEBUG_ASSERT(barrier_list_len > 0, DebugAssert{});
+    barrier_list[0] = GetTextureBarrier(current, next, resource);
+    return 1;
+  }
+  const auto mip_levels = transition_info_index.mip_levels;
+  uint32_t barrier_num = 0;
+  for (uint32_t slice = 0; slice < transition_info_index.array_size; slice++) {
+    uint32_t mip = 0;
+    while (mip < mip_levels) {
+      const auto& current = GetCurrentTransitionInfo(entry_index + mip + slice * mip_levels, transition_info_index, transition_info);
+      const auto& next = GetNextTransitionInfo(entry_index + mip + slice * mip_levels, transition_info_index, transition_info);
+      auto mip_end = mip + 1;
+      while (mip_end < mip_levels
+             && IsSame(GetCurrentTransitionInfo(entry_index + mip_end + slice * mip_levels, transition_info_index, transition_info), current)
+             && IsSame(GetNextTransitionInfo(entry_index + mip_end + slice * mip_levels, transition_info_index, transition_info), next)) {
+        mip_end++;
+      }
+      if (IsBarrierNeeded(current, next)) {
+        auto barrier = GetTextureBarrier(current, next, resource);
+        barrier.Subresources = {
+          .IndexOrFirstMipLevel = mip,
+          .NumMipLevels = mip_end - mip,
+          .FirstArraySlice = slice,
+          .NumArraySlices = 1,
+          .FirstPlane = 0,
+          .NumPlanes = transition_info_index.plane_num,
+        };
+        if (!MergeSliceBarrier(barrier, barrier_num, barrier_list)) {
+          DEBUG_ASSERT(barrier_num < barrier_list_len, DebugAssert{});
+          barrier_list[barrier_num] = barrier;
+          barrier_num++;
+        }
+      }
+      mip = mip_end;
+    }
+  }
+  return barrier_num;
+}
 void ProcessBarriersImpl(ProcessBarriersImplAsset* asset, const StrHash resource_id, const BarrierTransitionInfoIndex* transition_info_index) {
   for (uint32_t i = 0; i < transition_info_index->physical_resource_num; i++) {
-    const auto& transition_info = GetCurrentTransitionInfo(i, *transition_info_index, asset->transition_info);
-    const auto& next_transition_info = GetNextTransitionInfo(i, *transition_info_index, asset->transition_info);
-    if (next_transition_info.layout == transition_info.layout) { continue; }
-    // spdlog::info("{:x} {:x}->{:x}", resource_id, GetUint32(transition_info->layout), GetUint32(next_transition_info->layout));
-    asset->barriers[asset->barrier_index] = D3D12_TEXTURE_BARRIER{
-      .SyncBefore = transition_info.sync,
-      .SyncAfter  = next_transition_info.sync,
-      .AccessBefore = transition_info.access,
-      .AccessAfter  = next_transition_info.access,
-      .LayoutBefore = transition_info.layout,
-      .LayoutAfter  = next_transition_info.layout,
-      .pResource = GetResource(asset->resource_set, resource_id, i),
-      .Subresources = {
-        .IndexOrFirstMipLevel = 0xffffffff,
-        .NumMipLevels = 0,
-        .FirstArraySlice = 0,
-        .NumArraySlices = 0,
-        .FirstPlane = 0,
-        .NumPlanes = 0,
-      },
-      .Flags = D3D12_TEXTURE_BARRIER_FLAG_NONE,
-    };
-    asset->barrier_index++;
+    if (transition_info_index->buffer) {
+      if (!IsBufferBarrierNeeded(i, *transition_info_index, asset->transition_info)) { continue; }
+      DEBUG_ASSERT(asset->buffer_barrier_index < asset->buffer_barrier_len, DebugAssert{});
+      asset->buffer_barriers[asset->buffer_barrier_index] = GetBufferBarrier(i, *transition_info_index, asset->transition_info, GetResource(asset->resource_set, resource_id, i));
+      asset->buffer_barrier_index++;
+      continue;
+    }
+    asset->barrier_index += GetSubresourceBarrierList(i, *transition_info_index, asset->transition_info, GetResource(asset->resource_set, resource_id, i), asset->barrier_len - asset->barrier_index, &asset->barriers[asset->barrier_index]);
   }
 }
+void AddTransitionInfoImpl(const StrHash resource_id, const uint32_t transition_num, const uint32_t mip_levels, const uint32_t array_size, const uint32_t plane_num, const D3D12_BARRIER_LAYOUT layout, const bool buffer, BarrierTransitionInfo* transition_info) {
+  const uint32_t current_size = transition_info->transition_info->size();
+  BarrierTransitionInfoIndex transition_info_index{
+    .physical_resource_num = transition_num,
+    .index = current_size,
+    .buffer = buffer,
+    .mip_levels = mip_levels,
+    .array_size = array_size,
+    .plane_num = plane_num,
+  };
+  BarrierTransitionInfoPerResource info{
+    .sync = D3D12_BARRIER_SYNC_NONE,
+    .access = D3D12_BARRIER_ACCESS_NO_ACCESS,
+    .layout = layout,
+  };
+  while (transition_info->transition_info->size() < transition_info_index.index + GetEntryNum(transition_info_index) * 2) {
+    transition_info->transition_info->push_back(info);
+  }
+  (*transition_info->transition_info_index)[resource_id] = transition_info_index;
+}
 void InitTransitionInfoImpl(BarrierTransitionInfo* transition_info, const StrHash resource_id, const ResourceInfo* resource_info) {
   D3D12_BARRIER_LAYOUT layout{};
   switch (resource_info->creation_type) {
@@ -174,16 +463,376 @@ void InitTransitionInfoImpl(BarrierTransitionInfo* transition_info, const StrHas
       layout = D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE;
       break;
     }
+    case ResourceCreationType::kCbv: {
+      layout = D3D12_BARRIER_LAYOUT_UNDEFINED;
+      break;
+    }
+    case ResourceCreationType::kUav: {
+      layout = IsBufferResource(*resource_info) ? D3D12_BARRIER_LAYOUT_UNDEFINED : D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS;
+      break;
+    }
     case ResourceCreationType::kNone: {
       return;
     }
   }
-  AddTransitionInfo(resource_id, resource_info->physical_resource_num, layout, transition_info);
+  AddTransitionInfoImpl(resource_id, resource_info->physical_resource_num, resource_info->mip_levels, resource_info->array_size, GetPlaneNum(resource_info->format), layout, IsBufferResource(*resource_info), transition_info);
 }
 void UpdateTransitionInfoImpl(BarrierTransitionInfo* transition_info, const StrHash, BarrierTransitionInfoIndex* transition_info_index) {
+  const auto next_index = transition_info_index->index + GetEntryNum(*transition_info_index);
+  for (uint32_t i = 0; i < GetEntryNum(*transition_info_index); i++) {
+    auto& next = (*transition_info->transition_info)[next_index + i];
+    (*transition_info->transition_info)[transition_info_index->index + i] = next;
+    next.access_barrier = false;
+  }
+}
+void ResetAliasedTransitionInfo(const BarrierTransitionInfoIndex& transition_info_index, BarrierTransitionInfo* transition_info) {
+  for (uint32_t i = 0; i < GetEntryNum(transition_info_index) * 2; i++) {
+    (*transition_info->transition_info)[transition_info_index.index + i] = kAliasedResourceInitialTransitionInfo;
+  }
+}
+void ResetAliasedTransitionInfoImpl(BarrierTransitionInfo* transition_info, const StrHash, const BarrierTransitionInfoIndex* transition_info_index) {
+  if (!transition_info_index->aliased) { return; }
+  ResetAliasedTransitionInfo(*transition_info_index, transition_info);
+}
+auto IsPingPong(const StrHashMap<ResourceInfo>& resource_info, const StrHash resource_id) {
+  const auto info = resource_info.get(resource_id);
+  return info != nullptr && info->pingpong;
+}
+auto CopyTransitionInfo(const BarrierTransitionInfo& src) {
+  auto transition_info = New<BarrierTransitionInfo>();
+  transition_info->transition_info_index = New<StrHashMap<BarrierTransitionInfoIndex>>(src.transition_info_index->size());
+  transition_info->transition_info = New<ResizableArray<BarrierTransitionInfoPerResource>>(src.transition_info->size());
+  src.transition_info_index->iterate<StrHashMap<BarrierTransitionInfoIndex>>([](StrHashMap<BarrierTransitionInfoIndex>* dst, const StrHash resource_id, const BarrierTransitionInfoIndex* transition_info_index) {
+    dst->insert(resource_id, *transition_info_index);
+  }, transition_info->transition_info_index);
+  for (const auto& info : *src.transition_info) {
+    transition_info->transition_info->push_back(info);
+  }
+  return transition_info;
+}
+auto CopyWriteIndexList(const StrHashMap<uint32_t>& src) {
+  StrHashMap<uint32_t> current_write_index_list(src.size());
+  src.iterate<StrHashMap<uint32_t>>([](StrHashMap<uint32_t>* dst, const StrHash resource_id, const uint32_t* index) {
+    dst->insert(resource_id, *index);
+  }, &current_write_index_list);
+  return current_write_index_list;
+}
+auto GetScheduledLocalIndex(const BarrierScheduleResource& resource, const StrHashMap<uint32_t>& current_write_index_list) {
+  return resource.read_index ? GetResourceLocalIndexRead(current_write_index_list, resource.resource_id) : GetResourceLocalIndexWrite(current_write_index_list, resource.resource_id);
+}
+struct BarrierScheduleSimulationAsset {
+  const StrHashMap<ResourceInfo>* resource_info{};
+  const StrHashMap<uint32_t>* current_write_index_list{};
+  const BarrierTransitionInfo* transition_info{};
+  ResizableArray<D3D12_TEXTURE_BARRIER>* barrier_list{};
+  ResizableArray<BarrierScheduleResource>* barrier_resource_list{};
+  ResizableArray<D3D12_BUFFER_BARRIER>* buffer_barrier_list{};
+  ResizableArray<BarrierScheduleResource>* buffer_barrier_resource_list{};
+  ResizableArray<BarrierScheduleFrameState>* frame_state_list{};
+  uint32_t pass_index{};
+  uint32_t* last_use_pass{}; // per transition info entry
+  ResizableArray<BarrierScheduleSplit>* split_list{};
+};
+void CollectScheduledBarriers(BarrierScheduleSimulationAsset* asset, const StrHash resource_id, const BarrierTransitionInfoIndex* transition_info_index) {
+  const auto pingpong = IsPingPong(*asset->resource_info, resource_id);
+  const uint32_t barrier_list_len = 32;
+  D3D12_TEXTURE_BARRIER barrier_list[barrier_list_len]{};
   for (uint32_t i = 0; i < transition_info_index->physical_resource_num; i++) {
-    (*transition_info->transition_info)[transition_info_index->index + i] = GetNextTransitionInfo(i, *transition_info_index, transition_info);
+    if (transition_info_index->buffer) {
+      // buffer barriers are not split.
+      if (!IsBufferBarrierNeeded(i, *transition_info_index, asset->transition_info)) { continue; }
+      asset->buffer_barrier_list->push_back(GetBufferBarrier(i, *transition_info_index, asset->transition_info, nullptr));
+      asset->buffer_barrier_resource_list->push_back({
+          .resource_id = resource_id,
+          .read_index = pingpong && i == GetResourceLocalIndexRead(*asset->current_write_index_list, resource_id),
+        });
+      continue;
+    }
+    const auto barrier_num = GetSubresourceBarrierList(i, *transition_info_index, asset->transition_info, nullptr, barrier_list_len, barrier_list);
+    const auto last_use_pass = asset->last_use_pass[transition_info_index->index + GetEntryIndex(i, 0, *transition_info_index)];
+    for (uint32_t j = 0; j < barrier_num; j++) {
+      asset->barrier_list->push_back(barrier_list[j]);
+      asset->barrier_resource_list->push_back({
+          .resource_id = resource_id,
+          .read_index = pingpong && i == GetResourceLocalIndexRead(*asset->current_write_index_list, resource_id),
+        });
+      asset->split_list->push_back({
+          .local_index = i,
+          .begin_pass = (last_use_pass == kInvalidIndex) ? 0 : last_use_pass + 1,
+        });
+    }
+  }
+}
+void MarkResourceUse(const StrHash resource_id, const uint32_t local_index, BarrierScheduleSimulationAsset* asset) {
+  const auto transition_info_index = asset->transition_info->transition_info_index->get(resource_id);
+  if (transition_info_index == nullptr) { return; }
+  // tracked per physical resource, a split barrier of any subresource waits for the last use of the whole resource.
+  asset->last_use_pass[transition_info_index->index + GetEntryIndex(local_index, 0, *transition_info_index)] = asset->pass_index;
+}
+void MarkRenderPassResourceUse(const RenderPassInfo& render_pass_info, BarrierScheduleSimulationAsset* asset) {
+  const auto& current_write_index_list = *asset->current_write_index_list;
+  for (uint32_t i = 0; i < render_pass_info.srv_num; i++) {
+    MarkResourceUse(render_pass_info.srv[i], GetResourceLocalIndexRead(current_write_index_list, render_pass_info.srv[i]), asset);
+  }
+  for (uint32_t i = 0; i < render_pass_info.uav_num; i++) {
+    MarkResourceUse(render_pass_info.uav[i], GetResourceLocalIndexWrite(current_write_index_list, render_pass_info.uav[i]), asset);
+  }
+  for (uint32_t i = 0; i < render_pass_info.rtv_num; i++) {
+    MarkResourceUse(render_pass_info.rtv[i], GetResourceLocalIndexWrite(current_write_index_list, render_pass_info.rtv[i]), asset);
+  }
+  if (render_pass_info.dsv != kEmptyStr) {
+    MarkResourceUse(render_pass_info.dsv, GetResourceLocalIndexWrite(current_write_index_list, render_pass_info.dsv), asset);
+  }
+  if (render_pass_info.present != kEmptyStr) {
+    MarkResourceUse(render_pass_info.present, GetResourceLocalIndexWrite(current_write_index_list, render_pass_info.present), asset);
+  }
+}
+void CollectFrameState(BarrierScheduleSimulationAsset* asset, const StrHash resource_id, const BarrierTransitionInfoIndex* transition_info_index) {
+  // next half holds the latest state between frames.
+  const auto pingpong = IsPingPong(*asset->resource_info, resource_id);
+  BarrierScheduleResource resource{
+    .resource_id = resource_id,
+    .read_index = false,
+  };
+  for (uint32_t i = 0; i < GetSubresourceNum(*transition_info_index); i++) {
+    asset->frame_state_list->push_back({
+        .resource = resource,
+        .all_physical_resources = !pingpong && transition_info_index->physical_resource_num > 1,
+        .subresource = i,
+        .info = GetNextTransitionInfo(GetEntryIndex(GetScheduledLocalIndex(resource, *asset->current_write_index_list), i, *transition_info_index), *transition_info_index, asset->transition_info),
+      });
+  }
+  if (!pingpong) { return; }
+  resource.read_index = true;
+  for (uint32_t i = 0; i < GetSubresourceNum(*transition_info_index); i++) {
+    asset->frame_state_list->push_back({
+        .resource = resource,
+        .subresource = i,
+        .info = GetNextTransitionInfo(GetEntryIndex(GetScheduledLocalIndex(resource, *asset->current_write_index_list), i, *transition_info_index), *transition_info_index, asset->transition_info),
+      });
+  }
+}
+auto IsSameFrameState(const ResizableArray<BarrierScheduleFrameState>& a, const ResizableArray<BarrierScheduleFrameState>& b) {
+  if (a.size() != b.size()) { return false; }
+  for (uint32_t i = 0; i < a.size(); i++) {
+    if (a[i].resource.resource_id != b[i].resource.resource_id) { return false; }
+    if (a[i].resource.read_index != b[i].resource.read_index) { return false; }
+    if (a[i].subresource != b[i].subresource) { return false; }
+    if (!IsSame(a[i].info, b[i].info)) { return false; }
+  }
+  return true;
+}
+auto IsInList(const StrHash resource_id, const uint32_t list_num, const StrHash* list) {
+  for (uint32_t i = 0; i < list_num; i++) {
+    if (list[i] == resource_id) { return true; }
+  }
+  return false;
+}
+auto IsResourceUsed(const RenderPassInfo& render_pass_info, const StrHash resource_id) {
+  if (IsInList(resource_id, render_pass_info.srv_num, render_pass_info.srv)) { return true; }
+  if (IsInList(resource_id, render_pass_info.uav_num, render_pass_info.uav)) { return true; }
+  if (IsInList(resource_id, render_pass_info.rtv_num, render_pass_info.rtv)) { return true; }
+  return render_pass_info.dsv == resource_id || render_pass_info.present == resource_id;
+}
+/**
+ * wraps around to the passes of the next frame, returns pass_index if no other pass uses the resource.
+ **/
+auto FindNextResourceUser(const RenderPassList& render_pass_list, const uint32_t pass_index, const StrHash resource_id) {
+  for (uint32_t i = 1; i < render_pass_list.render_pass_len; i++) {
+    const auto next_pass_index = (pass_index + i) % render_pass_list.render_pass_len;
+    if (IsResourceUsed(render_pass_list.render_pass_info[next_pass_index], resource_id)) { return next_pass_index; }
+  }
+  return pass_index;
+}
+/**
+ * layouts accessible outside the direct queue, undefined if the pass cannot access the resource there.
+ **/
+auto GetQueueSharedLayout(const RenderPassInfo& render_pass_info, const StrHash resource_id) {
+  if (IsInList(resource_id, render_pass_info.uav_num, render_pass_info.uav)) { return D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS; }
+  if (IsInList(resource_id, render_pass_info.srv_num, render_pass_info.srv)) { return D3D12_BARRIER_LAYOUT_SHADER_RESOURCE; }
+  return D3D12_BARRIER_LAYOUT_UNDEFINED;
+}
+auto GetQueueReleaseLayout(const RenderPassList& render_pass_list, const StrHash resource_id, const BarrierScheduleSimulationAsset& asset) {
+  const auto transition_info_index = asset.transition_info->transition_info_index->get(resource_id);
+  if (transition_info_index == nullptr || transition_info_index->buffer) { return D3D12_BARRIER_LAYOUT_UNDEFINED; }
+  // pingpong flips depend on the render target layout, such resources are expected to stay on the direct queue.
+  if (IsPingPong(*asset.resource_info, resource_id)) { return D3D12_BARRIER_LAYOUT_UNDEFINED; }
+  const auto next_pass_index = FindNextResourceUser(render_pass_list, asset.pass_index, resource_id);
+  const auto& next_render_pass = render_pass_list.render_pass_info[next_pass_index];
+  if (next_pass_index == asset.pass_index || GetQueueType(next_render_pass.queue) == QueueType::kDirect) { return D3D12_BARRIER_LAYOUT_UNDEFINED; }
+  return GetQueueSharedLayout(next_render_pass, resource_id);
+}
+auto ReleaseResourceToQueue(const RenderPassList& render_pass_list, const StrHash resource_id, const BarrierScheduleSimulationAsset& asset, BarrierTransitionInfo* transition_info) {
+  const auto layout = GetQueueReleaseLayout(render_pass_list, resource_id, asset);
+  if (layout == D3D12_BARRIER_LAYOUT_UNDEFINED) { return false; }
+  // queues are synchronized by fences, nothing is left to wait for after the transition.
+  const BarrierTransitionInfoPerResource info{
+    .sync = D3D12_BARRIER_SYNC_NONE,
+    .access = D3D12_BARRIER_ACCESS_NO_ACCESS,
+    .layout = layout,
+  };
+  UpdateNextTransitionInfo(resource_id, GetResourceLocalIndexWrite(*asset.current_write_index_list, resource_id), nullptr, info, transition_info);
+  return true;
+}
+/**
+ * direct queue only layouts cannot be transitioned on other queues,
+ * so the direct queue transitions textures after their use to the layout the next user on another queue accesses them in.
+ **/
+void ReleaseResourcesToOtherQueues(const RenderPassList& render_pass_list, BarrierScheduleSimulationAsset* asset, BarrierTransitionInfo* transition_info) {
+  const auto& render_pass_info = render_pass_list.render_pass_info[asset->pass_index];
+  if (GetQueueType(render_pass_info.queue) != QueueType::kDirect) { return; }
+  UpdateTransitionInfo(transition_info);
+  bool released = false;
+  for (uint32_t i = 0; i < render_pass_info.srv_num; i++) {
+    released |= ReleaseResourceToQueue(render_pass_list, render_pass_info.srv[i], *asset, transition_info);
+  }
+  for (uint32_t i = 0; i < render_pass_info.uav_num; i++) {
+    released |= ReleaseResourceToQueue(render_pass_list, render_pass_info.uav[i], *asset, transition_info);
+  }
+  for (uint32_t i = 0; i < render_pass_info.rtv_num; i++) {
+    released |= ReleaseResourceToQueue(render_pass_list, render_pass_info.rtv[i], *asset, transition_info);
+  }
+  if (render_pass_info.dsv != kEmptyStr) {
+    released |= ReleaseResourceToQueue(render_pass_list, render_pass_info.dsv, *asset, transition_info);
+  }
+  if (!released) { return; }
+  transition_info->transition_info_index->iterate<BarrierScheduleSimulationAsset>(CollectScheduledBarriers, asset);
+}
+/**
+ * runs a frame the way it is recorded without a schedule, collecting barriers instead of issuing them.
+ **/
+void SimulateFrame(const RenderPassList& render_pass_list, BarrierScheduleSimulationAsset* asset, StrHashMap<uint32_t>& current_write_index_list, BarrierTransitionInfo* transition_info, BarrierSchedule* schedule) {
+  const uint32_t pingpong_flip_list_len = 8;
+  StrHash pingpong_flip_list[pingpong_flip_list_len]{};
+  for (uint32_t i = 0; i < transition_info->transition_info->size(); i++) {
+    asset->last_use_pass[i] = kInvalidIndex;
+  }
+  for (uint32_t i = 0; i < render_pass_list.render_pass_len; i++) {
+    const auto& render_pass_info = render_pass_list.render_pass_info[i];
+    asset->pass_index = i;
+    UpdateTransitionInfo(transition_info);
+    const auto flip_num = GetPingPongFlippingResourceList(render_pass_info, transition_info, *asset->resource_info, current_write_index_list, pingpong_flip_list_len, pingpong_flip_list);
+    schedule->pass_list[i] = {
+      .queue = GetQueueType(render_pass_info.queue),
+      .barrier_offset = schedule->barrier_list->size(),
+      .buffer_barrier_offset = schedule->buffer_barrier_list->size(),
+      .flip_offset = schedule->flip_list->size(),
+      .flip_num = flip_num,
+    };
+    for (uint32_t j = 0; j < flip_num; j++) {
+      schedule->flip_list->push_back(pingpong_flip_list[j]);
+    }
+    FlipPingPongIndexImpl(flip_num, pingpong_flip_list, current_write_index_list);
+    ConfigureBarriersTextureTransitions(render_pass_info, current_write_index_list, transition_info);
+    transition_info->transition_info_index->iterate<BarrierScheduleSimulationAsset>(CollectScheduledBarriers, asset);
+    MarkRenderPassResourceUse(render_pass_info, asset);
+    schedule->pass_list[i].barrier_num = schedule->barrier_list->size() - schedule->pass_list[i].barrier_offset;
+    schedule->pass_list[i].buffer_barrier_num = schedule->buffer_barrier_list->size() - schedule->pass_list[i].buffer_barrier_offset;
+    schedule->pass_list[i].release_barrier_offset = schedule->barrier_list->size();
+    ReleaseResourcesToOtherQueues(render_pass_list, asset, transition_info);
+    schedule->pass_list[i].release_barrier_num = schedule->barrier_list->size() - schedule->pass_list[i].release_barrier_offset;
   }
+  ResetBarrierSyncAccessStatus(transition_info);
+}
+auto IsSplitBarrier(const BarrierSchedule& schedule, const ResizableArray<BarrierScheduleSplit>& split_list, const uint32_t barrier_index, const uint32_t pass_index) {
+  // aliased resources are not split since other placements may use their memory until their first use.
+  if ((*schedule.barrier_list)[barrier_index].LayoutBefore == D3D12_BARRIER_LAYOUT_UNDEFINED) { return false; }
+  const auto begin_pass = split_list[barrier_index].begin_pass;
+  if (begin_pass >= pass_index) { return false; }
+  // both halves are recorded on the queue of the pass, which must also be the queue of the last use.
+  const auto queue = schedule.pass_list[pass_index].queue;
+  if (schedule.pass_list[begin_pass].queue != queue) { return false; }
+  return begin_pass == 0 || schedule.pass_list[begin_pass - 1].queue == queue;
+}
+struct SplitBarrierAsset {
+  const StrHashMap<ResourceInfo>* resource_info{};
+  const StrHashMap<uint32_t>* current_write_index_list{};
+  const ResizableArray<BarrierScheduleSplit>* split_list{};
+  const BarrierSchedule* schedule{};
+  ResizableArray<D3D12_TEXTURE_BARRIER>* barrier_list{};
+  ResizableArray<BarrierScheduleResource>* barrier_resource_list{};
+};
+void PushSplitBarrier(const uint32_t barrier_index, const D3D12_TEXTURE_BARRIER& barrier, SplitBarrierAsset* asset) {
+  const auto resource_id = (*asset->schedule->barrier_resource_list)[barrier_index].resource_id;
+  const auto local_index = (*asset->split_list)[barrier_index].local_index;
+  asset->barrier_list->push_back(barrier);
+  asset->barrier_resource_list->push_back({
+      .resource_id = resource_id,
+      .read_index = IsPingPong(*asset->resource_info, resource_id) && local_index == GetResourceLocalIndexRead(*asset->current_write_index_list, resource_id),
+    });
+}
+/**
+ * moves the start of each transition right after the last use of the resource, issuing begin and end halves.
+ **/
+void SplitScheduledBarriers(const StrHashMap<ResourceInfo>& resource_info, const ResizableArray<BarrierScheduleSplit>& split_list, StrHashMap<uint32_t>& current_write_index_list, BarrierSchedule* schedule) {
+  SplitBarrierAsset asset{
+    .resource_info = &resource_info,
+    .current_write_index_list = &current_write_index_list,
+    .split_list = &split_list,
+    .schedule = schedule,
+    .barrier_list = New<ResizableArray<D3D12_TEXTURE_BARRIER>>(schedule->barrier_list->size() * 2),
+    .barrier_resource_list = New<ResizableArray<BarrierScheduleResource>>(schedule->barrier_list->size() * 2),
+  };
+  for (uint32_t i = 0; i < schedule->pass_num; i++) {
+    auto& pass = schedule->pass_list[i];
+    // local indices are resolved after flips as they are at record time.
+    FlipPingPongIndexImpl(pass.flip_num, &(*schedule->flip_list)[pass.flip_offset], current_write_index_list);
+    const auto barrier_offset = asset.barrier_list->size();
+    for (uint32_t j = i + 1; j < schedule->pass_num; j++) {
+      const auto& later_pass = schedule->pass_list[j];
+      for (uint32_t k = later_pass.barrier_offset; k < later_pass.barrier_offset + later_pass.barrier_num; k++) {
+        if (!IsSplitBarrier(*schedule, split_list, k, j) || split_list[k].begin_pass != i) { continue; }
+        auto barrier = (*schedule->barrier_list)[k];
+        barrier.SyncAfter = D3D12_BARRIER_SYNC_SPLIT;
+        PushSplitBarrier(k, barrier, &asset);
+      }
+    }
+    for (uint32_t k = pass.barrier_offset; k < pass.barrier_offset + pass.barrier_num; k++) {
+      auto barrier = (*schedule->barrier_list)[k];
+      if (IsSplitBarrier(*schedule, split_list, k, i)) {
+        barrier.SyncBefore = D3D12_BARRIER_SYNC_SPLIT;
+      }
+      PushSplitBarrier(k, barrier, &asset);
+    }
+    pass.barrier_offset = barrier_offset;
+    pass.barrier_num = asset.barrier_list->size() - barrier_offset;
+    const auto release_barrier_offset = asset.barrier_list->size();
+    for (uint32_t k = pass.release_barrier_offset; k < pass.release_barrier_offset + pass.release_barrier_num; k++) {
+      PushSplitBarrier(k, (*schedule->barrier_list)[k], &asset);
+    }
+    pass.release_barrier_offset = release_barrier_offset;
+  }
+  schedule->barrier_list->~ResizableArray<D3D12_TEXTURE_BARRIER>();
+  Deallocate(schedule->barrier_list);
+  schedule->barrier_resource_list->~ResizableArray<BarrierScheduleResource>();
+  Deallocate(schedule->barrier_resource_list);
+  schedule->barrier_list = asset.barrier_list;
+  schedule->barrier_resource_list = asset.barrier_resource_list;
+}
+void BindScheduledBarrierResources(BarrierSchedule* schedule, const uint32_t barrier_offset, const uint32_t barrier_num, const uint32_t buffer_barrier_offset, const uint32_t buffer_barrier_num, const ResourceSet* resource_set, const StrHashMap<uint32_t>& current_write_index_list) {
+  for (uint32_t i = 0; i < barrier_num; i++) {
+    const auto& resource = (*schedule->barrier_resource_list)[barrier_offset + i];
+    (*schedule->barrier_list)[barrier_offset + i].pResource = GetResource(resource_set, resource.resource_id, GetScheduledLocalIndex(resource, current_write_index_list));
+  }
+  for (uint32_t i = 0; i < buffer_barrier_num; i++) {
+    const auto& resource = (*schedule->buffer_barrier_resource_list)[buffer_barrier_offset + i];
+    (*schedule->buffer_barrier_list)[buffer_barrier_offset + i].pResource = GetResource(resource_set, resource.resource_id, GetScheduledLocalIndex(resource, current_write_index_list));
+  }
+}
+void IssueBoundBarriers(const BarrierSchedule* schedule, const uint32_t barrier_offset, const uint32_t barrier_num, const uint32_t buffer_barrier_offset, const uint32_t buffer_barrier_num, D3d12CommandList* command_list) {
+  if (barrier_num == 0 && buffer_barrier_num == 0) { return; }
+  IssueBarriers(barrier_num, &(*schedule->barrier_list)[barrier_offset], buffer_barrier_num, &(*schedule->buffer_barrier_list)[buffer_barrier_offset], command_list);
+}
+void SetFrameState(const BarrierScheduleFrameState& frame_state, const StrHashMap<uint32_t>& current_write_index_list, BarrierTransitionInfo* transition_info) {
+  auto transition_info_index = transition_info->transition_info_index->get(frame_state.resource.resource_id);
+  if (transition_info_index == nullptr) { return; }
+  if (frame_state.all_physical_resources) {
+    for (uint32_t i = 0; i < transition_info_index->physical_resource_num; i++) {
+      SetNextTransitionInfo(GetEntryIndex(i, frame_state.subresource, *transition_info_index), frame_state.info, *transition_info_index, transition_info);
+    }
+    return;
+  }
+  SetNextTransitionInfo(GetEntryIndex(GetScheduledLocalIndex(frame_state.resource, current_write_index_list), frame_state.subresource, *transition_info_index), frame_state.info, *transition_info_index, transition_info);
 }
 } // namespace
 namespace boke {
@@ -195,25 +844,14 @@ BarrierTransitionInfo* InitTransitionInfo(const StrHashMap<ResourceInfo>& resour
   return transition_info;
 }
 void ReleaseTransitionInfo(BarrierTransitionInfo* transition_info) {
+  transition_info->transition_info_index->~StrHashMap<BarrierTransitionInfoIndex>();
   Deallocate(transition_info->transition_info_index);
+  transition_info->transition_info->~ResizableArray<BarrierTransitionInfoPerResource>();
   Deallocate(transition_info->transition_info);
   Deallocate(transition_info);
 }
 void AddTransitionInfo(const StrHash resource_id, const uint32_t transition_num, const D3D12_BARRIER_LAYOUT layout, BarrierTransitionInfo* transition_info) {
-  const uint32_t current_size = transition_info->transition_info->size();
-  BarrierTransitionInfoIndex transition_info_index{
-    .physical_resource_num = transition_num,
-    .index = current_size,
-  };
-  BarrierTransitionInfoPerResource info{
-    .sync = D3D12_BARRIER_SYNC_NONE,
-    .access = D3D12_BARRIER_ACCESS_NO_ACCESS,
-    .layout = layout,
-  };
-  while (transition_info->transition_info->size() < transition_info_index.index + transition_num * 2) {
-    transition_info->transition_info->push_back(info);
-  }
-  (*transition_info->transition_info_index)[resource_id] = transition_info_index;
+  AddTransitionInfoImpl(resource_id, transition_num, 1, 1, 1, layout, false, transition_info);
 }
 void UpdateTransitionInfo(BarrierTransitionInfo* transition_info) {
   transition_info->transition_info_index->iterate<BarrierTransitionInfo>(UpdateTransitionInfoImpl, transition_info);
@@ -229,29 +867,153 @@ void ConfigureRenderPassBarriersTextureTransitions(const RenderPassInfo& render_
   ConfigureBarriersTextureTransitions(render_pass_info, current_write_index_list, transition_info);
 }
 void ProcessBarriers(const BarrierTransitionInfo* transition_info, const ResourceSet* resource_set, D3d12CommandList* command_list) {
-  const uint32_t barrier_num = 16;
+  const uint32_t barrier_num = 64;
   D3D12_TEXTURE_BARRIER barriers[barrier_num]{};
+  const uint32_t buffer_barrier_num = 16;
+  D3D12_BUFFER_BARRIER buffer_barriers[buffer_barrier_num]{};
   ProcessBarriersImplAsset asset{
     .barriers = barriers,
+    .barrier_len = barrier_num,
+    .buffer_barriers = buffer_barriers,
+    .buffer_barrier_len = buffer_barrier_num,
     .resource_set = resource_set,
     .transition_info = transition_info,
     .barrier_index = 0,
+    .buffer_barrier_index = 0,
   };
   transition_info->transition_info_index->iterate<ProcessBarriersImplAsset>(ProcessBarriersImpl, &asset);
-  if (asset.barrier_index == 0) { return; }
   DEBUG_ASSERT(asset.barrier_index <= barrier_num, DebugAssert{});
-  D3D12_BARRIER_GROUP barrier_group {
-    .Type = D3D12_BARRIER_TYPE_TEXTURE,
-    .NumBarriers = asset.barrier_index,
-    .pTextureBarriers = barriers,
-  };
-  command_list->Barrier(1, &barrier_group);
+  IssueBarriers(asset.barrier_index, barriers, asset.buffer_barrier_index, buffer_barriers, command_list);
 }
 void ResetBarrierSyncAccessStatus(BarrierTransitionInfo* transition_info) {
   for (auto& info : (*transition_info->transition_info)) {
     info.sync = D3D12_BARRIER_SYNC_NONE;
     info.access = D3D12_BARRIER_ACCESS_NO_ACCESS;
+    info.access_barrier = false;
+  }
+  transition_info->transition_info_index->iterate<BarrierTransitionInfo>(ResetAliasedTransitionInfoImpl, transition_info);
+}
+void MarkAliasedResources(const ResourceAliasingPlan& aliasing_plan, BarrierTransitionInfo* transition_info) {
+  for (uint32_t i = 0; i < aliasing_plan.placement_num; i++) {
+    auto transition_info_index = transition_info->transition_info_index->get(aliasing_plan.placement_list[i].resource_id);
+    if (transition_info_index == nullptr || transition_info_index->aliased) { continue; }
+    transition_info_index->aliased = true;
+    ResetAliasedTransitionInfo(*transition_info_index, transition_info);
+  }
+}
+BarrierSchedule* CompileBarrierSchedule(const RenderPassList& render_pass_list, const StrHashMap<ResourceInfo>& resource_info, const BarrierTransitionInfo* transition_info, const StrHashMap<uint32_t>& current_write_index_list, const bool split_barriers) {
+  const uint32_t max_simulated_frame_num = 4;
+  auto schedule = New<BarrierSchedule>();
+  schedule->pass_num = render_pass_list.render_pass_len;
+  schedule->pass_list = AllocateArray<BarrierSchedulePass>(render_pass_list.render_pass_len);
+  schedule->barrier_list = New<ResizableArray<D3D12_TEXTURE_BARRIER>>();
+  schedule->barrier_resource_list = New<ResizableArray<BarrierScheduleResource>>();
+  schedule->buffer_barrier_list = New<ResizableArray<D3D12_BUFFER_BARRIER>>();
+  schedule->buffer_barrier_resource_list = New<ResizableArray<BarrierScheduleResource>>();
+  schedule->flip_list = New<ResizableArray<StrHash>>();
+  schedule->frame_state_list = New<ResizableArray<BarrierScheduleFrameState>>();
+  auto simulated_transition_info = CopyTransitionInfo(*transition_info);
+  auto simulated_write_index_list = CopyWriteIndexList(current_write_index_list);
+  auto frame_start_write_index_list = CopyWriteIndexList(current_write_index_list);
+  ResizableArray<BarrierScheduleFrameState> next_frame_state_list;
+  ResizableArray<BarrierScheduleSplit> split_list;
+  BarrierScheduleSimulationAsset asset{
+    .resource_info = &resource_info,
+    .current_write_index_list = &simulated_write_index_list,
+    .transition_info = simulated_transition_info,
+    .barrier_list = schedule->barrier_list,
+    .barrier_resource_list = schedule->barrier_resource_list,
+    .buffer_barrier_list = schedule->buffer_barrier_list,
+    .buffer_barrier_resource_list = schedule->buffer_barrier_resource_list,
+    .frame_state_list = schedule->frame_state_list,
+    .last_use_pass = AllocateArray<uint32_t>(simulated_transition_info->transition_info->size()),
+    .split_list = &split_list,
+  };
+  simulated_transition_info->transition_info_index->iterate<BarrierScheduleSimulationAsset>(CollectFrameState, &asset);
+  // frames repeat once the state at their boundaries does, e.g. after aliased resources are discarded and pingpong flips settle.
+  bool converged = false;
+  for (uint32_t i = 0; i < max_simulated_frame_num && !converged; i++) {
+    schedule->barrier_list->clear();
+    schedule->barrier_resource_list->clear();
+    schedule->buffer_barrier_list->clear();
+    schedule->buffer_barrier_resource_list->clear();
+    schedule->flip_list->clear();
+    split_list.clear();
+    frame_start_write_index_list = CopyWriteIndexList(simulated_write_index_list);
+    SimulateFrame(render_pass_list, &asset, simulated_write_index_list, simulated_transition_info, schedule);
+    next_frame_state_list.clear();
+    asset.frame_state_list = &next_frame_state_list;
+    simulated_transition_info->transition_info_index->iterate<BarrierScheduleSimulationAsset>(CollectFrameState, &asset);
+    asset.frame_state_list = schedule->frame_state_list;
+    converged = IsSameFrameState(*schedule->frame_state_list, next_frame_state_list);
+    std::swap(*schedule->frame_state_list, next_frame_state_list);
+  }
+  DEBUG_ASSERT(converged, DebugAssert{});
+  if (split_barriers) {
+    SplitScheduledBarriers(resource_info, split_list, frame_start_write_index_list, schedule);
+  }
+  Deallocate(asset.last_use_pass);
+  frame_start_write_index_list.~StrHashMap<uint32_t>();
+  simulated_write_index_list.~StrHashMap<uint32_t>();
+  ReleaseTransitionInfo(simulated_transition_info);
+  return schedule;
+}
+void ReleaseBarrierSchedule(BarrierSchedule* schedule) {
+  Deallocate(schedule->pass_list);
+  schedule->barrier_list->~ResizableArray<D3D12_TEXTURE_BARRIER>();
+  Deallocate(schedule->barrier_list);
+  schedule->barrier_resource_list->~ResizableArray<BarrierScheduleResource>();
+  Deallocate(schedule->barrier_resource_list);
+  schedule->buffer_barrier_list->~ResizableArray<D3D12_BUFFER_BARRIER>();
+  Deallocate(schedule->buffer_barrier_list);
+  schedule->buffer_barrier_resource_list->~ResizableArray<BarrierScheduleResource>();
+  Deallocate(schedule->buffer_barrier_resource_list);
+  schedule->flip_list->~ResizableArray<StrHash>();
+  Deallocate(schedule->flip_list);
+  schedule->frame_state_list->~ResizableArray<BarrierScheduleFrameState>();
+  Deallocate(schedule->frame_state_list);
+  Deallocate(schedule);
+}
+void EnterBarrierSchedule(const BarrierSchedule* schedule, const ResourceSet* resource_set, const StrHashMap<uint32_t>& current_write_index_list, BarrierTransitionInfo* transition_info, D3d12CommandList* command_list) {
+  UpdateTransitionInfo(transition_info);
+  for (const auto& frame_state : *schedule->frame_state_list) {
+    // aliased resources are discarded by their first barrier in a frame anyway.
+    if (frame_state.info.layout == D3D12_BARRIER_LAYOUT_UNDEFINED) { continue; }
+    SetFrameState(frame_state, current_write_index_list, transition_info);
+  }
+  ProcessBarriers(transition_info, resource_set, command_list);
+  LeaveBarrierSchedule(schedule, current_write_index_list, transition_info);
+}
+void LeaveBarrierSchedule(const BarrierSchedule* schedule, const StrHashMap<uint32_t>& current_write_index_list, BarrierTransitionInfo* transition_info) {
+  for (const auto& frame_state : *schedule->frame_state_list) {
+    SetFrameState(frame_state, current_write_index_list, transition_info);
   }
+  UpdateTransitionInfo(transition_info);
+}
+void ProcessScheduledBarriers(BarrierSchedule* schedule, const uint32_t pass_index, const ResourceSet* resource_set, StrHashMap<uint32_t>& current_write_index_list, D3d12CommandList* command_list) {
+  const auto& pass = schedule->pass_list[pass_index];
+  FlipPingPongIndexImpl(pass.flip_num, &(*schedule->flip_list)[pass.flip_offset], current_write_index_list);
+  BindScheduledBarrierResources(schedule, pass.barrier_offset, pass.barrier_num, pass.buffer_barrier_offset, pass.buffer_barrier_num, resource_set, current_write_index_list);
+  IssueBoundBarriers(schedule, pass.barrier_offset, pass.barrier_num, pass.buffer_barrier_offset, pass.buffer_barrier_num, command_list);
+}
+void ProcessScheduledReleaseBarriers(BarrierSchedule* schedule, const uint32_t pass_index, const ResourceSet* resource_set, const StrHashMap<uint32_t>& current_write_index_list, D3d12CommandList* command_list) {
+  const auto& pass = schedule->pass_list[pass_index];
+  BindScheduledBarrierResources(schedule, pass.release_barrier_offset, pass.release_barrier_num, 0, 0, resource_set, current_write_index_list);
+  IssueBoundBarriers(schedule, pass.release_barrier_offset, pass.release_barrier_num, 0, 0, command_list);
+}
+void ResolveScheduledBarriers(BarrierSchedule* schedule, const uint32_t pass_index, const ResourceSet* resource_set, StrHashMap<uint32_t>& current_write_index_list) {
+  const auto& pass = schedule->pass_list[pass_index];
+  FlipPingPongIndexImpl(pass.flip_num, &(*schedule->flip_list)[pass.flip_offset], current_write_index_list);
+  BindScheduledBarrierResources(schedule, pass.barrier_offset, pass.barrier_num, pass.buffer_barrier_offset, pass.buffer_barrier_num, resource_set, current_write_index_list);
+  BindScheduledBarrierResources(schedule, pass.release_barrier_offset, pass.release_barrier_num, 0, 0, resource_set, current_write_index_list);
+}
+void IssueResolvedBarriers(const BarrierSchedule* schedule, const uint32_t pass_index, D3d12CommandList* command_list) {
+  const auto& pass = schedule->pass_list[pass_index];
+  IssueBoundBarriers(schedule, pass.barrier_offset, pass.barrier_num, pass.buffer_barrier_offset, pass.buffer_barrier_num, command_list);
+}
+void IssueResolvedReleaseBarriers(const BarrierSchedule* schedule, const uint32_t pass_index, D3d12CommandList* command_list) {
+  const auto& pass = schedule->pass_list[pass_index];
+  IssueBoundBarriers(schedule, pass.release_barrier_offset, pass.release_barrier_num, 0, 0, command_list);
 }
 }
 #include "doctest/doctest.h"
@@ -755,3 +1517,652 @@ TEST_CASE("barrier config") {
   CHECK_EQ((*transition_info->transition_info)[(*transition_info->transition_info_index)["swapchain"_id].index].access, D3D12_BARRIER_ACCESS_NO_ACCESS);
   ReleaseTransitionInfo(transition_info);
 }
+TEST_CASE("barrier config aliased resources") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 16 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  StrHash gbuffers[] = {"gbuffer0"_id, "gbuffer1"_id, "gbuffer2"_id, "gbuffer3"_id,};
+  StrHash primary[] = {"primary"_id,};
+  RenderPassInfo render_pass_info[] = {
+    {
+      // gbuffer
+      .queue = "direct"_id,
+      .rtv = gbuffers,
+      .rtv_num = 4,
+      .dsv = "depth"_id,
+    },
+    {
+      // lighting
+      .queue = "direct"_id,
+      .srv = gbuffers,
+      .srv_num = 4,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+  };
+  auto resource_info = ParseResourceInfo(GetJson("tests/resources.json"), {});
+  auto transition_info = InitTransitionInfo(resource_info);
+  auto current_write_index_list = InitWriteIndexList(resource_info);
+  // depth and primary share memory.
+  AliasedResourcePlacement placement_list[] = {
+    {.resource_id = "primary"_id, .local_index = 0, .heap_offset = 0, .size_in_bytes = kResourcePlacementAlignment,},
+    {.resource_id = "primary"_id, .local_index = 1, .heap_offset = kResourcePlacementAlignment, .size_in_bytes = kResourcePlacementAlignment,},
+    {.resource_id = "depth"_id, .local_index = 0, .heap_offset = 0, .size_in_bytes = kResourcePlacementAlignment,},
+  };
+  ResourceAliasingPlan aliasing_plan{
+    .placement_num = 3,
+    .placement_list = placement_list,
+    .heap_size_in_bytes = kResourcePlacementAlignment * 2,
+    .unaliased_size_in_bytes = kResourcePlacementAlignment * 3,
+  };
+  MarkAliasedResources(aliasing_plan, transition_info);
+  const auto& index_list = *transition_info->transition_info_index;
+  const auto& info_list = *transition_info->transition_info;
+  CHECK_UNARY(index_list["depth"_id].aliased);
+  CHECK_UNARY(index_list["primary"_id].aliased);
+  CHECK_UNARY_FALSE(index_list["gbuffer0"_id].aliased);
+  CHECK_EQ(info_list[index_list["depth"_id].index].layout, D3D12_BARRIER_LAYOUT_UNDEFINED);
+  CHECK_EQ(info_list[index_list["depth"_id].index].sync, D3D12_BARRIER_SYNC_ALL);
+  CHECK_EQ(info_list[index_list["primary"_id].index + 1].layout, D3D12_BARRIER_LAYOUT_UNDEFINED);
+  CHECK_EQ(info_list[index_list["gbuffer0"_id].index].layout, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+  for (uint32_t i = 0; i < 2; i++) {
+    UpdateTransitionInfo(transition_info);
+    FlipPingPongIndex(render_pass_info[i], transition_info, resource_info, current_write_index_list);
+    ConfigureRenderPassBarriersTextureTransitions(render_pass_info[i], current_write_index_list, transition_info);
+  }
+  // undefined until the first use, then transitions with discard.
+  CHECK_EQ(info_list[index_list["depth"_id].index].layout, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE);
+  CHECK_EQ(info_list[index_list["primary"_id].index].layout, D3D12_BARRIER_LAYOUT_UNDEFINED);
+  CHECK_EQ(info_list[index_list["primary"_id].index + 2].layout, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+  // next frame starts from undefined layout again.
+  ResetBarrierSyncAccessStatus(transition_info);
+  CHECK_EQ(info_list[index_list["depth"_id].index].layout, D3D12_BARRIER_LAYOUT_UNDEFINED);
+  CHECK_EQ(info_list[index_list["depth"_id].index + 1].layout, D3D12_BARRIER_LAYOUT_UNDEFINED);
+  CHECK_EQ(info_list[index_list["depth"_id].index].sync, D3D12_BARRIER_SYNC_ALL);
+  CHECK_EQ(info_list[index_list["primary"_id].index + 2].layout, D3D12_BARRIER_LAYOUT_UNDEFINED);
+  CHECK_EQ(info_list[index_list["gbuffer0"_id].index + 1].layout, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+  CHECK_EQ(info_list[index_list["gbuffer0"_id].index + 1].sync, D3D12_BARRIER_SYNC_NONE);
+  ReleaseTransitionInfo(transition_info);
+}
+TEST_CASE("barrier schedule") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 32 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  StrHash gbuffers[] = {"gbuffer0"_id, "gbuffer1"_id, "gbuffer2"_id, "gbuffer3"_id,};
+  StrHash primary[] = {"primary"_id,};
+  StrHash swapchain[] = {"swapchain"_id,};
+  StrHash imgui_font[] = {"imgui_font"_id,};
+  RenderPassInfo render_pass_info[] = {
+    {
+      // gbuffer
+      .queue = "direct"_id,
+      .rtv = gbuffers,
+      .rtv_num = 4,
+      .dsv = "depth"_id,
+    },
+    {
+      // lighting
+      .queue = "direct"_id,
+      .srv = gbuffers,
+      .srv_num = 4,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+    {
+      // tonemap
+      .queue = "direct"_id,
+      .srv = primary,
+      .srv_num = 1,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+    {
+      // oetf
+      .queue = "direct"_id,
+      .srv = primary,
+      .srv_num = 1,
+      .rtv = swapchain,
+      .rtv_num = 1,
+    },
+    {
+      // imgui
+      .queue = "direct"_id,
+      .srv = imgui_font,
+      .srv_num = 1,
+      .rtv = swapchain,
+      .rtv_num = 1,
+    },
+    {
+      // present
+      .queue = "direct"_id,
+      .present = "swapchain"_id,
+    },
+  };
+  RenderPassList render_pass_list{
+    .render_pass_len = 6,
+    .render_pass_info = render_pass_info,
+  };
+  auto resource_info = ParseResourceInfo(GetJson("tests/resources.json"), {});
+  auto transition_info = InitTransitionInfo(resource_info);
+  auto current_write_index_list = InitWriteIndexList(resource_info);
+  AddTransitionInfo("swapchain"_id, 3, D3D12_BARRIER_LAYOUT_PRESENT, transition_info);
+  current_write_index_list["swapchain"_id] = 1;
+  SUBCASE("steady frame") {
+    auto schedule = CompileBarrierSchedule(render_pass_list, resource_info, transition_info, current_write_index_list, false);
+    CHECK_EQ(schedule->pass_num, 6);
+    // the first frame starts with primary in render target layout, later ones with both buffers in srv layout.
+    const uint32_t expected_barrier_num[] = {4, 5, 2, 2, 0, 1,};
+    const uint32_t expected_flip_num[] = {0, 0, 1, 1, 0, 0,};
+    for (uint32_t i = 0; i < 6; i++) {
+      CAPTURE(i);
+      CHECK_EQ(schedule->pass_list[i].barrier_num, expected_barrier_num[i]);
+      CHECK_EQ(schedule->pass_list[i].flip_num, expected_flip_num[i]);
+    }
+    CHECK_EQ(schedule->barrier_list->size(), 14);
+    CHECK_EQ(schedule->flip_list->size(), 2);
+    CHECK_EQ((*schedule->flip_list)[0], "primary"_id);
+    CHECK_EQ((*schedule->flip_list)[1], "primary"_id);
+    for (uint32_t i = 0; i < schedule->pass_list[0].barrier_num; i++) {
+      const auto& barrier = (*schedule->barrier_list)[i];
+      CHECK_EQ(barrier.LayoutBefore, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+      CHECK_EQ(barrier.LayoutAfter, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+      CHECK_EQ(barrier.SyncBefore, D3D12_BARRIER_SYNC_NONE);
+      CHECK_EQ(barrier.pResource, nullptr);
+      CHECK_NE((*schedule->barrier_resource_list)[i].resource_id, "depth"_id);
+    }
+    // tonemap reads the buffer lighting wrote and writes the other one.
+    {
+      const auto offset = schedule->pass_list[2].barrier_offset;
+      for (uint32_t i = offset; i < offset + 2; i++) {
+        const auto& barrier = (*schedule->barrier_list)[i];
+        const auto& resource = (*schedule->barrier_resource_list)[i];
+        CHECK_EQ(resource.resource_id, "primary"_id);
+        if (resource.read_index) {
+          CHECK_EQ(barrier.LayoutBefore, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+          CHECK_EQ(barrier.LayoutAfter, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+          CHECK_EQ(barrier.SyncBefore, D3D12_BARRIER_SYNC_RENDER_TARGET);
+        } else {
+          CHECK_EQ(barrier.LayoutBefore, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+          CHECK_EQ(barrier.LayoutAfter, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+        }
+      }
+      CHECK_NE((*schedule->barrier_resource_list)[offset].read_index, (*schedule->barrier_resource_list)[offset + 1].read_index);
+    }
+    {
+      const auto offset = schedule->pass_list[5].barrier_offset;
+      CHECK_EQ((*schedule->barrier_resource_list)[offset].resource_id, "swapchain"_id);
+      CHECK_UNARY_FALSE((*schedule->barrier_resource_list)[offset].read_index);
+      CHECK_EQ((*schedule->barrier_list)[offset].LayoutBefore, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+      CHECK_EQ((*schedule->barrier_list)[offset].LayoutAfter, D3D12_BARRIER_LAYOUT_PRESENT);
+    }
+    // frame state: 4 gbuffers, depth, 2 primary buffers, swapchain.
+    CHECK_EQ(schedule->frame_state_list->size(), 8);
+    for (const auto& frame_state : *schedule->frame_state_list) {
+      CAPTURE(frame_state.resource.resource_id);
+      CHECK_EQ(frame_state.all_physical_resources, frame_state.resource.resource_id == "swapchain"_id);
+      CHECK_EQ(frame_state.info.sync, D3D12_BARRIER_SYNC_NONE);
+      switch (frame_state.resource.resource_id) {
+        case "depth"_id: { CHECK_EQ(frame_state.info.layout, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE); break; }
+        case "swapchain"_id: { CHECK_EQ(frame_state.info.layout, D3D12_BARRIER_LAYOUT_PRESENT); break; }
+        default: { CHECK_EQ(frame_state.info.layout, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE); break; }
+      }
+    }
+    // compiling leaves the actual state untouched, leaving writes the state between frames.
+    const auto& index_list = *transition_info->transition_info_index;
+    const auto& info_list = *transition_info->transition_info;
+    CHECK_EQ(info_list[index_list["gbuffer0"_id].index].layout, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+    CHECK_EQ(current_write_index_list["primary"_id], 0);
+    LeaveBarrierSchedule(schedule, current_write_index_list, transition_info);
+    CHECK_EQ(info_list[index_list["gbuffer0"_id].index].layout, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+    CHECK_EQ(info_list[index_list["gbuffer0"_id].index + 1].layout, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+    CHECK_EQ(info_list[index_list["primary"_id].index].layout, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+    CHECK_EQ(info_list[index_list["primary"_id].index + 1].layout, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+    CHECK_EQ(info_list[index_list["swapchain"_id].index + 2].layout, D3D12_BARRIER_LAYOUT_PRESENT);
+    ReleaseBarrierSchedule(schedule);
+  }
+  SUBCASE("split barriers") {
+    auto schedule = CompileBarrierSchedule(render_pass_list, resource_info, transition_info, current_write_index_list, true);
+    // primary for lighting and tonemap and swapchain for oetf begin at the frame start.
+    const uint32_t expected_barrier_num[] = {7, 5, 2, 2, 0, 1,};
+    for (uint32_t i = 0; i < 6; i++) {
+      CAPTURE(i);
+      CHECK_EQ(schedule->pass_list[i].barrier_num, expected_barrier_num[i]);
+    }
+    CHECK_EQ(schedule->barrier_list->size(), 17);
+    uint32_t begin_num = 0;
+    uint32_t primary_read_index_num = 0;
+    for (uint32_t i = 0; i < schedule->pass_list[0].barrier_num; i++) {
+      const auto& barrier = (*schedule->barrier_list)[i];
+      const auto& resource = (*schedule->barrier_resource_list)[i];
+      CHECK_NE(barrier.SyncBefore, D3D12_BARRIER_SYNC_SPLIT);
+      if (barrier.SyncAfter != D3D12_BARRIER_SYNC_SPLIT) {
+        CHECK_NE(resource.resource_id, "primary"_id);
+        continue;
+      }
+      begin_num++;
+      if (resource.resource_id == "swapchain"_id) {
+        CHECK_EQ(barrier.LayoutBefore, D3D12_BARRIER_LAYOUT_PRESENT);
+        CHECK_EQ(barrier.LayoutAfter, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+        continue;
+      }
+      CHECK_EQ(resource.resource_id, "primary"_id);
+      CHECK_EQ(barrier.LayoutBefore, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+      CHECK_EQ(barrier.LayoutAfter, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+      // tonemap writes the buffer read at the frame start.
+      if (resource.read_index) {
+        primary_read_index_num++;
+      }
+    }
+    CHECK_EQ(begin_num, 3);
+    CHECK_EQ(primary_read_index_num, 1);
+    // ends keep layouts and wait for the begin.
+    for (const auto pass_index : {1U, 2U, 3U,}) {
+      CAPTURE(pass_index);
+      const auto& pass = schedule->pass_list[pass_index];
+      uint32_t end_num = 0;
+      for (uint32_t i = pass.barrier_offset; i < pass.barrier_offset + pass.barrier_num; i++) {
+        const auto& barrier = (*schedule->barrier_list)[i];
+        CHECK_NE(barrier.SyncAfter, D3D12_BARRIER_SYNC_SPLIT);
+        if (barrier.SyncBefore != D3D12_BARRIER_SYNC_SPLIT) { continue; }
+        end_num++;
+        CHECK_EQ(barrier.LayoutAfter, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+        CHECK_UNARY_FALSE((*schedule->barrier_resource_list)[i].read_index);
+      }
+      CHECK_EQ(end_num, 1);
+    }
+    ReleaseBarrierSchedule(schedule);
+  }
+  SUBCASE("recompile") {
+    // schedules are recompiled on gui changes, releasing one returns all of its memory.
+    const auto free_size = GetAllocatorStats().free_size;
+    for (const auto split_barriers : {false, true,}) {
+      ReleaseBarrierSchedule(CompileBarrierSchedule(render_pass_list, resource_info, transition_info, current_write_index_list, split_barriers));
+    }
+    CHECK_EQ(GetAllocatorStats().free_size, free_size);
+  }
+  SUBCASE("aliased resources") {
+    AliasedResourcePlacement placement_list[] = {
+      {.resource_id = "depth"_id, .local_index = 0, .heap_offset = 0, .size_in_bytes = kResourcePlacementAlignment,},
+    };
+    ResourceAliasingPlan aliasing_plan{
+      .placement_num = 1,
+      .placement_list = placement_list,
+      .heap_size_in_bytes = kResourcePlacementAlignment,
+      .unaliased_size_in_bytes = kResourcePlacementAlignment,
+    };
+    MarkAliasedResources(aliasing_plan, transition_info);
+    auto schedule = CompileBarrierSchedule(render_pass_list, resource_info, transition_info, current_write_index_list, true);
+    // depth is discarded at its first use in every frame and never split.
+    CHECK_EQ(schedule->pass_list[0].barrier_num, 8);
+    bool found_depth = false;
+    for (uint32_t i = 0; i < schedule->pass_list[0].barrier_num; i++) {
+      if ((*schedule->barrier_resource_list)[i].resource_id != "depth"_id) { continue; }
+      const auto& barrier = (*schedule->barrier_list)[i];
+      CHECK_EQ(barrier.LayoutBefore, D3D12_BARRIER_LAYOUT_UNDEFINED);
+      CHECK_EQ(barrier.LayoutAfter, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE);
+      CHECK_EQ(barrier.SyncBefore, D3D12_BARRIER_SYNC_ALL);
+      CHECK_EQ(barrier.Flags, D3D12_TEXTURE_BARRIER_FLAG_DISCARD);
+      found_depth = true;
+    }
+    CHECK_UNARY(found_depth);
+    ReleaseBarrierSchedule(schedule);
+  }
+  current_write_index_list.~StrHashMap<uint32_t>();
+  ReleaseTransitionInfo(transition_info);
+}
+TEST_CASE("barrier schedule subresource ranges") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 32 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  StrHashMap<ResourceInfo> resource_info;
+  resource_info.insert("bloom"_id, {
+      .creation_type = ResourceCreationType::kRtv,
+      .flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET,
+      .format = DXGI_FORMAT_R16G16B16A16_FLOAT,
+      .size = {1920, 1080},
+      .physical_resource_num = 1,
+      .mip_levels = 4,
+      .array_size = 2,
+    });
+  auto transition_info = InitTransitionInfo(resource_info);
+  auto current_write_index_list = InitWriteIndexList(resource_info);
+  StrHash bloom[] = {"bloom"_id,};
+  SUBCASE("mip chain") {
+    SubresourceRange mip_range[] = {
+      {.first_mip = 0, .mip_num = 1,},
+      {.first_mip = 1, .mip_num = 1,},
+      {.first_mip = 2, .mip_num = 1,},
+    };
+    RenderPassInfo render_pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .rtv = bloom,
+        .rtv_num = 1,
+        .rtv_subresource = &mip_range[0],
+      },
+      {
+        .queue = "direct"_id,
+        .srv = bloom,
+        .srv_num = 1,
+        .rtv = bloom,
+        .rtv_num = 1,
+        .srv_subresource = &mip_range[0],
+        .rtv_subresource = &mip_range[1],
+      },
+      {
+        .queue = "direct"_id,
+        .srv = bloom,
+        .srv_num = 1,
+        .rtv = bloom,
+        .rtv_num = 1,
+        .srv_subresource = &mip_range[1],
+        .rtv_subresource = &mip_range[2],
+      },
+      {
+        // whole resource
+        .queue = "direct"_id,
+        .srv = bloom,
+        .srv_num = 1,
+      },
+    };
+    RenderPassList render_pass_list{
+      .render_pass_len = 4,
+      .render_pass_info = render_pass_info,
+    };
+    auto schedule = CompileBarrierSchedule(render_pass_list, resource_info, transition_info, current_write_index_list, false);
+    const auto& barrier_list = *schedule->barrier_list;
+    // each pass reads the mip written by the previous pass and writes the next mip, left readable by the last pass of the previous frame.
+    CHECK_EQ(schedule->pass_list[0].barrier_num, 1);
+    CHECK_EQ(schedule->pass_list[1].barrier_num, 2);
+    CHECK_EQ(schedule->pass_list[2].barrier_num, 2);
+    CHECK_EQ(schedule->pass_list[3].barrier_num, 1);
+    const uint32_t mip_list[] = {0, 0, 1, 1, 2, 2,};
+    const D3D12_BARRIER_LAYOUT layout_after_list[] = {
+      D3D12_BARRIER_LAYOUT_RENDER_TARGET,
+      D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE,
+      D3D12_BARRIER_LAYOUT_RENDER_TARGET,
+      D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE,
+      D3D12_BARRIER_LAYOUT_RENDER_TARGET,
+      D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE,
+    };
+    CHECK_EQ(barrier_list.size(), 6);
+    for (uint32_t i = 0; i < barrier_list.size(); i++) {
+      // both slices of a mip are merged into a single barrier.
+      CHECK_EQ(barrier_list[i].Subresources.IndexOrFirstMipLevel, mip_list[i]);
+      CHECK_EQ(barrier_list[i].Subresources.NumMipLevels, 1);
+      CHECK_EQ(barrier_list[i].Subresources.FirstArraySlice, 0);
+      CHECK_EQ(barrier_list[i].Subresources.NumArraySlices, 2);
+      CHECK_EQ(barrier_list[i].Subresources.NumPlanes, 1);
+      CHECK_EQ(barrier_list[i].LayoutAfter, layout_after_list[i]);
+    }
+    CHECK_EQ(schedule->frame_state_list->size(), 8);
+    ReleaseBarrierSchedule(schedule);
+  }
+  SUBCASE("whole resource") {
+    SubresourceRange slice_range{.first_slice = 1, .slice_num = 1,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .rtv = bloom,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .srv = bloom,
+        .srv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .rtv = bloom,
+        .rtv_num = 1,
+        .rtv_subresource = &slice_range,
+      },
+    };
+    RenderPassList render_pass_list{
+      .render_pass_len = 3,
+      .render_pass_info = render_pass_info,
+    };
+    auto schedule = CompileBarrierSchedule(render_pass_list, resource_info, transition_info, current_write_index_list, false);
+    const auto& barrier_list = *schedule->barrier_list;
+    CHECK_EQ(schedule->pass_list[0].barrier_num, 1);
+    CHECK_EQ(schedule->pass_list[1].barrier_num, 1);
+    CHECK_EQ(schedule->pass_list[2].barrier_num, 1);
+    CHECK_EQ(barrier_list[schedule->pass_list[1].barrier_offset].Subresources.IndexOrFirstMipLevel, 0xffffffff);
+    // all mips of the slice are merged.
+    const auto& subresources = barrier_list[schedule->pass_list[2].barrier_offset].Subresources;
+    CHECK_EQ(subresources.IndexOrFirstMipLevel, 0);
+    CHECK_EQ(subresources.NumMipLevels, 4);
+    CHECK_EQ(subresources.FirstArraySlice, 1);
+    CHECK_EQ(subresources.NumArraySlices, 1);
+    // slice 0 is left in shader resource layout, transitioned back by pass 0 of the next frame.
+    const auto& next_frame_subresources = barrier_list[schedule->pass_list[0].barrier_offset].Subresources;
+    CHECK_EQ(next_frame_subresources.IndexOrFirstMipLevel, 0);
+    CHECK_EQ(next_frame_subresources.NumArraySlices, 1);
+    ReleaseBarrierSchedule(schedule);
+  }
+  SUBCASE("depth stencil planes") {
+    StrHashMap<ResourceInfo> shadow_resource_info;
+    shadow_resource_info.insert("shadow"_id, {
+        .creation_type = ResourceCreationType::kDsv,
+        .flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL,
+        .format = DXGI_FORMAT_D24_UNORM_S8_UINT,
+        .size = {1024, 1024},
+        .physical_resource_num = 1,
+        .array_size = 2,
+      });
+    auto shadow_transition_info = InitTransitionInfo(shadow_resource_info);
+    auto shadow_write_index_list = InitWriteIndexList(shadow_resource_info);
+    StrHash shadow[] = {"shadow"_id,};
+    SubresourceRange slice_range{.first_slice = 1, .slice_num = 1,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .dsv = "shadow"_id,
+        .dsv_subresource = &slice_range,
+      },
+      {
+        .queue = "direct"_id,
+        .srv = shadow,
+        .srv_num = 1,
+      },
+    };
+    RenderPassList render_pass_list{
+      .render_pass_len = 2,
+      .render_pass_info = render_pass_info,
+    };
+    auto schedule = CompileBarrierSchedule(render_pass_list, shadow_resource_info, shadow_transition_info, shadow_write_index_list, false);
+    const auto& barrier_list = *schedule->barrier_list;
+    CHECK_EQ(schedule->pass_list[0].barrier_num, 1);
+    // ranged barriers cover both depth and stencil planes.
+    const auto& subresources = barrier_list[schedule->pass_list[0].barrier_offset].Subresources;
+    CHECK_EQ(subresources.FirstArraySlice, 1);
+    CHECK_EQ(subresources.NumArraySlices, 1);
+    CHECK_EQ(subresources.FirstPlane, 0);
+    CHECK_EQ(subresources.NumPlanes, 2);
+    ReleaseBarrierSchedule(schedule);
+    shadow_write_index_list.~StrHashMap<uint32_t>();
+    ReleaseTransitionInfo(shadow_transition_info);
+    shadow_resource_info.~StrHashMap<ResourceInfo>();
+  }
+  current_write_index_list.~StrHashMap<uint32_t>();
+  ReleaseTransitionInfo(transition_info);
+}
+TEST_CASE("barrier schedule buffers and uav") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 32 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  StrHashMap<ResourceInfo> resource_info;
+  resource_info.insert("scene"_id, {
+      .creation_type = ResourceCreationType::kCbv,
+      .format = DXGI_FORMAT_UNKNOWN,
+      .size = {256, 1},
+      .physical_resource_num = 2,
+    });
+  resource_info.insert("args"_id, {
+      .creation_type = ResourceCreationType::kUav,
+      .flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+      .format = DXGI_FORMAT_UNKNOWN,
+      .size = {256, 1},
+      .physical_resource_num = 1,
+    });
+  resource_info.insert("hiz"_id, {
+      .creation_type = ResourceCreationType::kUav,
+      .flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+      .format = DXGI_FORMAT_R32_FLOAT,
+      .size = {64, 64},
+      .physical_resource_num = 1,
+    });
+  auto transition_info = InitTransitionInfo(resource_info);
+  auto current_write_index_list = InitWriteIndexList(resource_info);
+  StrHash scene[] = {"scene"_id,};
+  StrHash uav[] = {"args"_id, "hiz"_id,};
+  RenderPassInfo render_pass_info[] = {
+    {
+      // cull
+      .queue = "direct"_id,
+      .cbv = scene,
+      .cbv_num = 1,
+      .uav = uav,
+      .uav_num = 2,
+    },
+    {
+      // compact
+      .queue = "direct"_id,
+      .uav = uav,
+      .uav_num = 2,
+    },
+    {
+      // draw
+      .queue = "direct"_id,
+      .cbv = scene,
+      .cbv_num = 1,
+      .srv = uav,
+      .srv_num = 2,
+    },
+  };
+  RenderPassList render_pass_list{
+    .render_pass_len = 3,
+    .render_pass_info = render_pass_info,
+  };
+  auto schedule = CompileBarrierSchedule(render_pass_list, resource_info, transition_info, current_write_index_list, false);
+  const auto& barrier_list = *schedule->barrier_list;
+  const auto& buffer_barrier_list = *schedule->buffer_barrier_list;
+  // buffers start a frame with no access to wait for, cbv written by cpu never need a barrier.
+  CHECK_EQ(schedule->pass_list[0].barrier_num, 1);
+  CHECK_EQ(schedule->pass_list[0].buffer_barrier_num, 0);
+  CHECK_EQ(barrier_list[schedule->pass_list[0].barrier_offset].LayoutAfter, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS);
+  // uav to uav, no layout change.
+  CHECK_EQ(schedule->pass_list[1].barrier_num, 1);
+  CHECK_EQ(schedule->pass_list[1].buffer_barrier_num, 1);
+  const auto& uav_barrier = barrier_list[schedule->pass_list[1].barrier_offset];
+  CHECK_EQ(uav_barrier.LayoutBefore, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS);
+  CHECK_EQ(uav_barrier.LayoutAfter, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS);
+  CHECK_EQ(uav_barrier.AccessBefore, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
+  CHECK_EQ(buffer_barrier_list[schedule->pass_list[1].buffer_barrier_offset].AccessBefore, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
+  CHECK_EQ(buffer_barrier_list[schedule->pass_list[1].buffer_barrier_offset].AccessAfter, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
+  // uav to srv
+  CHECK_EQ(schedule->pass_list[2].barrier_num, 1);
+  CHECK_EQ(schedule->pass_list[2].buffer_barrier_num, 1);
+  CHECK_EQ(barrier_list[schedule->pass_list[2].barrier_offset].LayoutAfter, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+  const auto& buffer_barrier = buffer_barrier_list[schedule->pass_list[2].buffer_barrier_offset];
+  CHECK_EQ(buffer_barrier.AccessBefore, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
+  CHECK_EQ(buffer_barrier.AccessAfter, D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
+  CHECK_EQ(buffer_barrier.Size, UINT64_MAX);
+  ReleaseBarrierSchedule(schedule);
+  current_write_index_list.~StrHashMap<uint32_t>();
+  ReleaseTransitionInfo(transition_info);
+}
+TEST_CASE("barrier schedule queue ownership") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 32 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  StrHashMap<ResourceInfo> resource_info;
+  resource_info.insert("depth"_id, {
+      .creation_type = ResourceCreationType::kDsv,
+      .flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL,
+      .format = DXGI_FORMAT_D24_UNORM_S8_UINT,
+      .size = {64, 64},
+      .physical_resource_num = 1,
+    });
+  resource_info.insert("ao"_id, {
+      .creation_type = ResourceCreationType::kUav,
+      .flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+      .format = DXGI_FORMAT_R32_FLOAT,
+      .size = {64, 64},
+      .physical_resource_num = 1,
+    });
+  resource_info.insert("primary"_id, {
+      .creation_type = ResourceCreationType::kRtv,
+      .flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET,
+      .format = DXGI_FORMAT_R16G16B16A16_FLOAT,
+      .size = {64, 64},
+      .physical_resource_num = 1,
+    });
+  auto transition_info = InitTransitionInfo(resource_info);
+  auto current_write_index_list = InitWriteIndexList(resource_info);
+  StrHash depth[] = {"depth"_id,};
+  StrHash ao[] = {"ao"_id,};
+  StrHash primary[] = {"primary"_id,};
+  RenderPassInfo render_pass_info[] = {
+    {
+      // prepass
+      .queue = "direct"_id,
+      .dsv = "depth"_id,
+    },
+    {
+      // ssao
+      .queue = "compute"_id,
+      .srv = depth,
+      .srv_num = 1,
+      .uav = ao,
+      .uav_num = 1,
+    },
+    {
+      // lighting
+      .queue = "direct"_id,
+      .srv = ao,
+      .srv_num = 1,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+  };
+  RenderPassList render_pass_list{
+    .render_pass_len = 3,
+    .render_pass_info = render_pass_info,
+  };
+  auto schedule = CompileBarrierSchedule(render_pass_list, resource_info, transition_info, current_write_index_list, true);
+  const auto& barrier_list = *schedule->barrier_list;
+  CHECK_EQ(schedule->pass_list[1].queue, QueueType::kCompute);
+  // depth is transitioned back from the shared layout on the direct queue.
+  REQUIRE_EQ(schedule->pass_list[0].barrier_num, 1);
+  CHECK_EQ(barrier_list[schedule->pass_list[0].barrier_offset].LayoutBefore, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE);
+  CHECK_EQ(barrier_list[schedule->pass_list[0].barrier_offset].LayoutAfter, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE);
+  REQUIRE_EQ(schedule->pass_list[0].release_barrier_num, 1);
+  const auto& depth_release = barrier_list[schedule->pass_list[0].release_barrier_offset];
+  CHECK_EQ(depth_release.LayoutBefore, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE);
+  CHECK_EQ(depth_release.LayoutAfter, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE);
+  CHECK_EQ(depth_release.SyncAfter, D3D12_BARRIER_SYNC_NONE);
+  CHECK_EQ(depth_release.AccessAfter, D3D12_BARRIER_ACCESS_NO_ACCESS);
+  // nothing left to transition on the compute queue.
+  CHECK_EQ(schedule->pass_list[1].barrier_num, 0);
+  CHECK_EQ(schedule->pass_list[1].release_barrier_num, 0);
+  REQUIRE_EQ(schedule->pass_list[2].barrier_num, 1);
+  CHECK_EQ(barrier_list[schedule->pass_list[2].barrier_offset].LayoutBefore, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS);
+  CHECK_EQ(barrier_list[schedule->pass_list[2].barrier_offset].LayoutAfter, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+  // ao is read by ssao of the next frame.
+  REQUIRE_EQ(schedule->pass_list[2].release_barrier_num, 1);
+  CHECK_EQ(barrier_list[schedule->pass_list[2].release_barrier_offset].LayoutBefore, D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+  CHECK_EQ(barrier_list[schedule->pass_list[2].release_barrier_offset].LayoutAfter, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS);
+  for (const auto& barrier : barrier_list) {
+    CHECK_NE(barrier.SyncBefore, D3D12_BARRIER_SYNC_SPLIT);
+    CHECK_NE(barrier.SyncAfter, D3D12_BARRIER_SYNC_SPLIT);
+  }
+  ReleaseBarrierSchedule(schedule);
+  current_write_index_list.~StrHashMap<uint32_t>();
+  ReleaseTransitionInfo(transition_info);
+}
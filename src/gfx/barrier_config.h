@@ -5,6 +5,9 @@ struct ResourceInfo;
 struct ResourceSet;
 struct RenderPassInfo;
 struct BarrierTransitionInfo;
+struct ResourceAliasingPlan;
+struct RenderPassList;
+struct BarrierSchedule;
 BarrierTransitionInfo* InitTransitionInfo(const StrHashMap<ResourceInfo>& resource_info);
 void ReleaseTransitionInfo(BarrierTransitionInfo*);
 void AddTransitionInfo(const StrHash resource_id, const uint32_t transition_num, const D3D12_BARRIER_LAYOUT layout, BarrierTransitionInfo* transition_info);
@@ -13,4 +16,43 @@ void FlipPingPongIndex(const RenderPassInfo& render_pass_info, const BarrierTran
 void ConfigureRenderPassBarriersTextureTransitions(const RenderPassInfo& render_pass_info, const StrHashMap<uint32_t>& current_write_index_list, BarrierTransitionInfo* transition_info);
 void ProcessBarriers(const BarrierTransitionInfo* transition_info, const ResourceSet* resource_set, D3d12CommandList* command_list);
 void ResetBarrierSyncAccessStatus(BarrierTransitionInfo* transition_info);
+/**
+ * resources placed by the plan start each frame in undefined layout, their first barrier becomes an aliasing barrier.
+ **/
+void MarkAliasedResources(const ResourceAliasingPlan& aliasing_plan, BarrierTransitionInfo* transition_info);
+/**
+ * barriers of a list compiled once into flat per pass arrays, valid until the list or resources change.
+ * frames are simulated from transition_info (at a frame boundary) until the state between frames repeats.
+ * with split_barriers, transitions begin right after the last use of the resource (SyncAfter = SPLIT)
+ * and end before the pass needing them (SyncBefore = SPLIT).
+ **/
+BarrierSchedule* CompileBarrierSchedule(const RenderPassList& render_pass_list, const StrHashMap<ResourceInfo>& resource_info, const BarrierTransitionInfo* transition_info, const StrHashMap<uint32_t>& current_write_index_list, const bool split_barriers);
+void ReleaseBarrierSchedule(BarrierSchedule*);
+/**
+ * transitions resources from transition_info to the state the schedule begins a frame with.
+ * call before the first frame recorded with the schedule.
+ **/
+void EnterBarrierSchedule(const BarrierSchedule* schedule, const ResourceSet* resource_set, const StrHashMap<uint32_t>& current_write_index_list, BarrierTransitionInfo* transition_info, D3d12CommandList* command_list);
+/**
+ * writes the state between frames back to transition_info, call before switching to another schedule or to ProcessBarriers.
+ **/
+void LeaveBarrierSchedule(const BarrierSchedule* schedule, const StrHashMap<uint32_t>& current_write_index_list, BarrierTransitionInfo* transition_info);
+/**
+ * replaces UpdateTransitionInfo, FlipPingPongIndex, ConfigureRenderPassBarriersTextureTransitions and ProcessBarriers of a pass.
+ * only resources are looked up by current write index (swapchain, pingpong).
+ **/
+void ProcessScheduledBarriers(BarrierSchedule* schedule, const uint32_t pass_index, const ResourceSet* resource_set, StrHashMap<uint32_t>& current_write_index_list, D3d12CommandList* command_list);
+/**
+ * call after recording a pass, before the queue signals other queues.
+ * releases textures from direct queue only layouts when the next user of them runs on another queue.
+ **/
+void ProcessScheduledReleaseBarriers(BarrierSchedule* schedule, const uint32_t pass_index, const ResourceSet* resource_set, const StrHashMap<uint32_t>& current_write_index_list, D3d12CommandList* command_list);
+/**
+ * ProcessScheduledBarriers and ProcessScheduledReleaseBarriers split for recording passes on multiple threads.
+ * resolve every pass in recording order on one thread (flips pingpong indices and binds resources to the barriers of the pass),
+ * then issue barriers of any pass from any thread, passes never share barrier entries.
+ **/
+void ResolveScheduledBarriers(BarrierSchedule* schedule, const uint32_t pass_index, const ResourceSet* resource_set, StrHashMap<uint32_t>& current_write_index_list);
+void IssueResolvedBarriers(const BarrierSchedule* schedule, const uint32_t pass_index, D3d12CommandList* command_list);
+void IssueResolvedReleaseBarriers(const BarrierSchedule* schedule, const uint32_t pass_index, D3d12CommandList* command_list);
 }
@@ -0,0 +1,192 @@
+#include "command_list_state_cache.h"
+namespace {
+using namespace boke;
+auto IsSameViewport(const D3D12_VIEWPORT& a, const D3D12_VIEWPORT& b) {
+  return a.TopLeftX == b.TopLeftX && a.TopLeftY == b.TopLeftY && a.Width == b.Width && a.Height == b.Height
+      && a.MinDepth == b.MinDepth && a.MaxDepth == b.MaxDepth;
+}
+auto IsSameRect(const D3D12_RECT& a, const D3D12_RECT& b) {
+  return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+// command list type is a template parameter so that the cache can be tested against a recording fake.
+template <typename CommandList>
+void SetRootsigCachedImpl(ID3D12RootSignature* rootsig, CommandListStateCache* cache, CommandList* command_list) {
+  if (cache->rootsig == rootsig) {
+    cache->skipped_call_num++;
+    return;
+  }
+  command_list->SetGraphicsRootSignature(rootsig);
+  cache->rootsig = rootsig;
+}
+template <typename CommandList>
+void SetPsoCachedImpl(ID3D12PipelineState* pso, CommandListStateCache* cache, CommandList* command_list) {
+  if (cache->pso == pso) {
+    cache->skipped_call_num++;
+    return;
+  }
+  command_list->SetPipelineState(pso);
+  cache->pso = pso;
+}
+template <typename CommandList>
+void SetStencilRefCachedImpl(const uint32_t stencil_ref, CommandListStateCache* cache, CommandList* command_list) {
+  if (cache->stencil_ref_set && cache->stencil_ref == stencil_ref) {
+    cache->skipped_call_num++;
+    return;
+  }
+  command_list->OMSetStencilRef(stencil_ref);
+  cache->stencil_ref = stencil_ref;
+  cache->stencil_ref_set = true;
+}
+template <typename CommandList>
+void SetViewportCachedImpl(const D3D12_VIEWPORT& viewport, CommandListStateCache* cache, CommandList* command_list) {
+  if (cache->viewport_set && IsSameViewport(cache->viewport, viewport)) {
+    cache->skipped_call_num++;
+    return;
+  }
+  command_list->RSSetViewports(1, &viewport);
+  cache->viewport = viewport;
+  cache->viewport_set = true;
+}
+template <typename CommandList>
+void SetScissorRectCachedImpl(const D3D12_RECT& scissor_rect, CommandListStateCache* cache, CommandList* command_list) {
+  if (cache->scissor_rect_set && IsSameRect(cache->scissor_rect, scissor_rect)) {
+    cache->skipped_call_num++;
+    return;
+  }
+  command_list->RSSetScissorRects(1, &scissor_rect);
+  cache->scissor_rect = scissor_rect;
+  cache->scissor_rect_set = true;
+}
+} // namespace
+namespace boke {
+void ResetCommandListStateCache(CommandListStateCache* cache) {
+  *cache = CommandListStateCache{.skipped_call_num = cache->skipped_call_num,};
+}
+void SetRootsigCached(ID3D12RootSignature* rootsig, CommandListStateCache* cache, D3d12CommandList* command_list) {
+  SetRootsigCachedImpl(rootsig, cache, command_list);
+}
+void SetPsoCached(ID3D12PipelineState* pso, CommandListStateCache* cache, D3d12CommandList* command_list) {
+  SetPsoCachedImpl(pso, cache, command_list);
+}
+void SetStencilRefCached(const uint32_t stencil_ref, CommandListStateCache* cache, D3d12CommandList* command_list) {
+  SetStencilRefCachedImpl(stencil_ref, cache, command_list);
+}
+void SetViewportCached(const D3D12_VIEWPORT& viewport, CommandListStateCache* cache, D3d12CommandList* command_list) {
+  SetViewportCachedImpl(viewport, cache, command_list);
+}
+void SetScissorRectCached(const D3D12_RECT& scissor_rect, CommandListStateCache* cache, D3d12CommandList* command_list) {
+  SetScissorRectCachedImpl(scissor_rect, cache, command_list);
+}
+} // namespace boke
+#include "doctest/doctest.h"
+namespace {
+/**
+ * keeps the state a command list would have and takes a snapshot of it on every draw.
+ **/
+struct RecordedState {
+  ID3D12RootSignature* rootsig{};
+  ID3D12PipelineState* pso{};
+  uint32_t stencil_ref{};
+  D3D12_VIEWPORT viewport{};
+  D3D12_RECT scissor_rect{};
+};
+struct RecordingCommandList {
+  static const uint32_t kMaxDrawNum = 16;
+  RecordedState state{};
+  RecordedState draw_list[kMaxDrawNum]{};
+  uint32_t draw_num{};
+  uint32_t call_num{};
+  void SetGraphicsRootSignature(ID3D12RootSignature* rootsig) { state.rootsig = rootsig; call_num++; }
+  void SetPipelineState(ID3D12PipelineState* pso) { state.pso = pso; call_num++; }
+  void OMSetStencilRef(const UINT stencil_ref) { state.stencil_ref = stencil_ref; call_num++; }
+  void RSSetViewports(const UINT num, const D3D12_VIEWPORT* viewport) { CHECK_EQ(num, 1); state.viewport = viewport[0]; call_num++; }
+  void RSSetScissorRects(const UINT num, const D3D12_RECT* scissor_rect) { CHECK_EQ(num, 1); state.scissor_rect = scissor_rect[0]; call_num++; }
+  void DispatchMesh(const UINT, const UINT, const UINT) {
+    REQUIRE_LT(draw_num, kMaxDrawNum);
+    draw_list[draw_num] = state;
+    draw_num++;
+  }
+};
+struct TestPass {
+  ID3D12RootSignature* rootsig{};
+  ID3D12PipelineState* pso{};
+  uint32_t stencil_ref{};
+  uint32_t width{};
+  uint32_t height{};
+};
+void RecordTestPass(const TestPass& pass, boke::CommandListStateCache* cache, RecordingCommandList* command_list) {
+  const D3D12_VIEWPORT viewport{0.0f, 0.0f, static_cast<float>(pass.width), static_cast<float>(pass.height), D3D12_MIN_DEPTH, D3D12_MAX_DEPTH};
+  const D3D12_RECT scissor_rect{0L, 0L, static_cast<LONG>(pass.width), static_cast<LONG>(pass.height)};
+  if (cache == nullptr) {
+    command_list->RSSetViewports(1, &viewport);
+    command_list->RSSetScissorRects(1, &scissor_rect);
+    command_list->SetGraphicsRootSignature(pass.rootsig);
+    command_list->OMSetStencilRef(pass.stencil_ref);
+    command_list->SetPipelineState(pass.pso);
+  } else {
+    SetViewportCachedImpl(viewport, cache, command_list);
+    SetScissorRectCachedImpl(scissor_rect, cache, command_list);
+    SetRootsigCachedImpl(pass.rootsig, cache, command_list);
+    SetStencilRefCachedImpl(pass.stencil_ref, cache, command_list);
+    SetPsoCachedImpl(pass.pso, cache, command_list);
+  }
+  command_list->DispatchMesh(1, 1, 1);
+}
+auto IsSameRecordedState(const RecordedState& a, const RecordedState& b) {
+  return a.rootsig == b.rootsig && a.pso == b.pso && a.stencil_ref == b.stencil_ref
+      && IsSameViewport(a.viewport, b.viewport) && IsSameRect(a.scissor_rect, b.scissor_rect);
+}
+} // namespace
+TEST_CASE("command list state cache") {
+  using namespace boke;
+  // never dereferenced, only compared.
+  uint32_t object[4]{};
+  auto rootsig_a = reinterpret_cast<ID3D12RootSignature*>(&object[0]);
+  auto rootsig_b = reinterpret_cast<ID3D12RootSignature*>(&object[1]);
+  auto pso_a = reinterpret_cast<ID3D12PipelineState*>(&object[2]);
+  auto pso_b = reinterpret_cast<ID3D12PipelineState*>(&object[3]);
+  const TestPass pass_list[] = {
+    {.rootsig = rootsig_a, .pso = pso_a, .stencil_ref = 0, .width = 1920, .height = 1080,},
+    {.rootsig = rootsig_a, .pso = pso_a, .stencil_ref = 0, .width = 1920, .height = 1080,},
+    {.rootsig = rootsig_a, .pso = pso_b, .stencil_ref = 1, .width = 1920, .height = 1080,},
+    {.rootsig = rootsig_b, .pso = pso_b, .stencil_ref = 1, .width = 960, .height = 540,},
+    {.rootsig = rootsig_b, .pso = pso_a, .stencil_ref = 1, .width = 960, .height = 540,},
+  };
+  const uint32_t pass_num = 5;
+  const uint32_t call_num_per_pass = 5;
+  RecordingCommandList uncached_command_list;
+  for (const auto& pass : pass_list) {
+    RecordTestPass(pass, nullptr, &uncached_command_list);
+  }
+  CHECK_EQ(uncached_command_list.call_num, pass_num * call_num_per_pass);
+  CommandListStateCache cache{};
+  RecordingCommandList command_list;
+  SUBCASE("redundant calls are skipped") {
+    for (const auto& pass : pass_list) {
+      RecordTestPass(pass, &cache, &command_list);
+    }
+    // pass 0: all, pass 1: none, pass 2: pso and stencil ref, pass 3: rootsig, viewport and scissor rect, pass 4: pso.
+    CHECK_EQ(command_list.call_num, 5 + 0 + 2 + 3 + 1);
+  }
+  SUBCASE("reset") {
+    RecordTestPass(pass_list[0], &cache, &command_list);
+    CHECK_EQ(command_list.call_num, call_num_per_pass);
+    ResetCommandListStateCache(&cache);
+    CHECK_EQ(cache.skipped_call_num, 0);
+    RecordTestPass(pass_list[1], &cache, &command_list);
+    CHECK_EQ(command_list.call_num, call_num_per_pass * 2);
+    for (uint32_t i = 2; i < pass_num; i++) {
+      RecordTestPass(pass_list[i], &cache, &command_list);
+    }
+    ResetCommandListStateCache(&cache);
+    CHECK_EQ(cache.rootsig, nullptr);
+    CHECK_UNARY_FALSE(cache.viewport_set);
+  }
+  // skipping never changes the state seen by draws.
+  CHECK_EQ(command_list.call_num + cache.skipped_call_num, uncached_command_list.call_num);
+  REQUIRE_EQ(command_list.draw_num, uncached_command_list.draw_num);
+  for (uint32_t i = 0; i < command_list.draw_num; i++) {
+    CAPTURE(i);
+    CHECK_UNARY(IsSameRecordedState(command_list.draw_list[i], uncached_command_list.draw_list[i]));
+  }
+}
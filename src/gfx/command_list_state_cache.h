@@ -0,0 +1,29 @@
+#pragma once
+#include "d3d12_name_alias.h"
+namespace boke {
+/**
+ * graphics state last set on a command list, calls setting the same state again are skipped and counted.
+ * one cache per command list, reset it whenever state is set behind its back (e.g. by imgui).
+ * command lists start with no state set, so a new cache is needed after Reset() of the command list.
+ **/
+struct CommandListStateCache {
+  ID3D12RootSignature* rootsig{};
+  ID3D12PipelineState* pso{};
+  uint32_t stencil_ref{};
+  D3D12_VIEWPORT viewport{};
+  D3D12_RECT scissor_rect{};
+  bool stencil_ref_set{};
+  bool viewport_set{};
+  bool scissor_rect_set{};
+  uint32_t skipped_call_num{};
+};
+/**
+ * forgets state set so far, skipped_call_num is kept.
+ **/
+void ResetCommandListStateCache(CommandListStateCache*);
+void SetRootsigCached(ID3D12RootSignature* rootsig, CommandListStateCache*, D3d12CommandList*);
+void SetPsoCached(ID3D12PipelineState* pso, CommandListStateCache*, D3d12CommandList*);
+void SetStencilRefCached(const uint32_t stencil_ref, CommandListStateCache*, D3d12CommandList*);
+void SetViewportCached(const D3D12_VIEWPORT& viewport, CommandListStateCache*, D3d12CommandList*);
+void SetScissorRectCached(const D3D12_RECT& scissor_rect, CommandListStateCache*, D3d12CommandList*);
+}
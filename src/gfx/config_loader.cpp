@@ -0,0 +1,969 @@
+#include <memory>
+#include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/debug_assert.h"
+#include "boke/file.h"
+#include "boke/str_hash.h"
+#include "boke/util.h"
+#include "json.h"
+#include "dxgi_format.h"
+#include "render_pass_info.h"
+#include "resource_info.h"
+#include "config_loader.h"
+namespace {
+using namespace boke;
+enum class ConfigContext : uint8_t {
+  kRoot,
+  kSwapchain,
+  kSwapchainSize,
+  kDescriptorHandles,
+  kRenderPassArray,
+  kRenderPass,
+  kRenderPassInfoArray,
+  kRenderPassInfo,
+  kRenderPassInfoStrHashList,
+  kResourceArray,
+  kResource,
+  kResourceSize,
+  kResourceFlags,
+  kMaterialArray,
+  kMaterial,
+  kMaterialShaderArray,
+  kMaterialShader,
+  kMaterialRtvFormats,
+  kSkip,
+};
+struct ConfigContextEntry {
+  ConfigContext context{};
+  StrHash key{kEmptyStr};  // last key read in an object
+  const char* key_name{};  // points into the config text
+  uint32_t index{};        // next element index in an array
+  uint32_t found_keys{};   // bit flags of required keys found in an object
+};
+struct RequiredKey {
+  StrHash key{};
+  const char* name{};
+};
+struct RequiredKeyList {
+  const RequiredKey* list{};
+  uint32_t num{};
+};
+constexpr RequiredKey kRootRequiredKeys[] = {
+  {"title"_id, "title"},
+  {"frame_buffer_num"_id, "frame_buffer_num"},
+  {"swapchain"_id, "swapchain"},
+  {"descriptor_handles"_id, "descriptor_handles"},
+  {"resource"_id, "resource"},
+  {"render_pass"_id, "render_pass"},
+  {"material"_id, "material"},
+};
+constexpr RequiredKey kSwapchainRequiredKeys[] = {
+  {"size"_id, "size"},
+  {"format"_id, "format"},
+};
+constexpr RequiredKey kDescriptorHandlesRequiredKeys[] = {
+  {"shader_visible_buffer_num"_id, "shader_visible_buffer_num"},
+};
+constexpr RequiredKey kRenderPassRequiredKeys[] = {
+  {"name"_id, "name"},
+  {"list"_id, "list"},
+};
+constexpr RequiredKey kRenderPassInfoRequiredKeys[] = {
+  {"queue"_id, "queue"},
+  {"type"_id, "type"},
+};
+constexpr RequiredKey kResourceRequiredKeys[] = {
+  {"name"_id, "name"},
+  {"format"_id, "format"},
+  {"flags"_id, "flags"},
+  {"physical_resource_num"_id, "physical_resource_num"},
+  {"initial_flag"_id, "initial_flag"},
+};
+constexpr RequiredKey kMaterialRequiredKeys[] = {
+  {"name"_id, "name"},
+  {"rootsig"_id, "rootsig"},
+  {"shader_list"_id, "shader_list"},
+};
+constexpr RequiredKey kMaterialShaderRequiredKeys[] = {
+  {"target"_id, "target"},
+  {"filename"_id, "filename"},
+};
+template <uint32_t N>
+constexpr auto GetRequiredKeyList(const RequiredKey (&list)[N]) {
+  return RequiredKeyList{list, N};
+}
+auto GetRequiredKeyList(const ConfigContext context) {
+  switch (context) {
+    case ConfigContext::kRoot: return GetRequiredKeyList(kRootRequiredKeys);
+    case ConfigContext::kSwapchain: return GetRequiredKeyList(kSwapchainRequiredKeys);
+    case ConfigContext::kDescriptorHandles: return GetRequiredKeyList(kDescriptorHandlesRequiredKeys);
+    case ConfigContext::kRenderPass: return GetRequiredKeyList(kRenderPassRequiredKeys);
+    case ConfigContext::kRenderPassInfo: return GetRequiredKeyList(kRenderPassInfoRequiredKeys);
+    case ConfigContext::kResource: return GetRequiredKeyList(kResourceRequiredKeys);
+    case ConfigContext::kMaterial: return GetRequiredKeyList(kMaterialRequiredKeys);
+    case ConfigContext::kMaterialShader: return GetRequiredKeyList(kMaterialShaderRequiredKeys);
+    default: return RequiredKeyList{};
+  }
+}
+enum class ConfigValueType : uint8_t {
+  kAny,    // not read, any value is ignored
+  kBool,
+  kUint,
+  kString,
+  kOther,  // null, negative, 64bit and floating point numbers, never read
+};
+/**
+ * type of the scalar value read at key of an object context or as an element of an array context.
+ **/
+auto GetExpectedValueType(const ConfigContext context, const StrHash key) {
+  switch (context) {
+    case ConfigContext::kRoot: {
+      switch (key) {
+        case "title"_id: return ConfigValueType::kString;
+        case "frame_buffer_num"_id:
+        case "max_loop_num"_id: return ConfigValueType::kUint;
+      }
+      break;
+    }
+    case ConfigContext::kSwapchain: {
+      if (key == "format"_id) { return ConfigValueType::kString; }
+      break;
+    }
+    case ConfigContext::kDescriptorHandles: {
+      if (key == "shader_visible_buffer_num"_id) { return ConfigValueType::kUint; }
+      break;
+    }
+    case ConfigContext::kRenderPass: {
+      if (key == "name"_id) { return ConfigValueType::kString; }
+      break;
+    }
+    case ConfigContext::kRenderPassInfo: {
+      switch (key) {
+        case "queue"_id:
+        case "type"_id:
+        case "material"_id:
+        case "dsv"_id:
+        case "present"_id: return ConfigValueType::kString;
+        case "stencil_val"_id: return ConfigValueType::kUint;
+      }
+      break;
+    }
+    case ConfigContext::kResource: {
+      switch (key) {
+        case "name"_id:
+        case "format"_id:
+        case "initial_flag"_id: return ConfigValueType::kString;
+        case "physical_resource_num"_id:
+        case "mip_levels"_id:
+        case "array_size"_id: return ConfigValueType::kUint;
+        case "pingpong"_id: return ConfigValueType::kBool;
+      }
+      break;
+    }
+    case ConfigContext::kMaterial: {
+      switch (key) {
+        case "name"_id:
+        case "rootsig"_id:
+        case "fallback"_id: return ConfigValueType::kString;
+      }
+      break;
+    }
+    case ConfigContext::kMaterialShader: {
+      switch (key) {
+        case "target"_id:
+        case "filename"_id: return ConfigValueType::kString;
+      }
+      break;
+    }
+    case ConfigContext::kSwapchainSize:
+    case ConfigContext::kResourceSize: {
+      return ConfigValueType::kUint;
+    }
+    case ConfigContext::kRenderPassInfoStrHashList:
+    case ConfigContext::kResourceFlags:
+    case ConfigContext::kMaterialRtvFormats: {
+      return ConfigValueType::kString;
+    }
+    default: {
+      break;
+    }
+  }
+  return ConfigValueType::kAny;
+}
+auto GetKeyHash(const char* const key) {
+  // keys are not registered to the str hash database.
+  return foonathan::string_id::detail::sid_hash(key);
+}
+auto IsKnownShaderTarget(const char* const target) {
+  switch (GetKeyHash(target)) {
+    case "ps"_id:
+    case "cs"_id:
+    case "as"_id:
+    case "ms"_id: {
+      return true;
+    }
+  }
+  return false;
+}
+template <typename T>
+T* CopyToArray(const ResizableArray<T>& list) {
+  if (list.empty()) { return nullptr; }
+  auto array = AllocateArray<T>(list.size());
+  for (uint32_t i = 0; i < list.size(); i++) {
+    array[i] = list[i];
+  }
+  return array;
+}
+/**
+ * rapidjson sax handler filling GfxConfig as values are read.
+ * per-entry data is gathered in scratch arrays and copied to exactly sized arrays when its json array ends.
+ * malformed values are recorded as ConfigError instead of asserting, see ValidateGfxConfig.
+ **/
+class GfxConfigHandler final : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, GfxConfigHandler> {
+ public:
+  GfxConfigHandler(GfxConfig* config, const StrHashMap<Size2d>& explicit_buffer_size)
+      : config_(config)
+      , explicit_buffer_size_(explicit_buffer_size)
+  {}
+  bool Default() {
+    IsExpectedValueType(ConfigValueType::kOther);
+    NextValue();
+    return true;
+  }
+  bool Key(const char* str, rapidjson::SizeType, bool) {
+    auto& top = Top();
+    top.key = GetKeyHash(str);
+    top.key_name = str;
+    const auto required_key_list = GetRequiredKeyList(top.context);
+    for (uint32_t i = 0; i < required_key_list.num; i++) {
+      if (required_key_list.list[i].key == top.key) {
+        top.found_keys |= 1U << i;
+      }
+    }
+    return true;
+  }
+  bool Bool(bool b) {
+    if (IsExpectedValueType(ConfigValueType::kBool)) {
+      SetBool(b);
+    }
+    NextValue();
+    return true;
+  }
+  bool Uint(unsigned u) {
+    if (IsExpectedValueType(ConfigValueType::kUint)) {
+      SetUint(u);
+    }
+    NextValue();
+    return true;
+  }
+  bool String(const char* str, rapidjson::SizeType, bool) {
+    if (IsExpectedValueType(ConfigValueType::kString)) {
+      SetString(str);
+    }
+    NextValue();
+    return true;
+  }
+  void SetBool(const bool b) {
+    const auto& top = Top();
+    if (top.context == ConfigContext::kResource && top.key == "pingpong"_id) {
+      resource_info_.pingpong = b;
+    }
+  }
+  void SetUint(const uint32_t u) {
+    const auto& top = Top();
+    switch (top.context) {
+      case ConfigContext::kRoot: {
+        switch (top.key) {
+          case "frame_buffer_num"_id: { config_->frame_buffer_num = u; break; }
+          case "max_loop_num"_id: { config_->max_loop_num = u; break; }
+        }
+        break;
+      }
+      case ConfigContext::kSwapchainSize: {
+        SetSize2dElement(top.index, u, &config_->swapchain_size);
+        break;
+      }
+      case ConfigContext::kDescriptorHandles: {
+        if (top.key == "shader_visible_buffer_num"_id) {
+          config_->shader_visible_buffer_num = u;
+        }
+        break;
+      }
+      case ConfigContext::kRenderPassInfo: {
+        if (top.key == "stencil_val"_id) {
+          render_pass_info_.stencil_val = static_cast<uint8_t>(u);
+        }
+        break;
+      }
+      case ConfigContext::kResource: {
+        if (top.key == "physical_resource_num"_id) {
+          resource_info_.physical_resource_num = u;
+        }
+        if (top.key == "mip_levels"_id) {
+          resource_info_.mip_levels = u;
+        }
+        if (top.key == "array_size"_id) {
+          resource_info_.array_size = u;
+        }
+        break;
+      }
+      case ConfigContext::kResourceSize: {
+        SetSize2dElement(top.index, u, &resource_info_.size);
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+  void SetString(const char* const str) {
+    const auto& top = Top();
+    switch (top.context) {
+      case ConfigContext::kRoot: {
+        if (top.key == "title"_id) {
+          config_->title = str;
+        }
+        break;
+      }
+      case ConfigContext::kSwapchain: {
+        if (top.key == "format"_id) {
+          config_->swapchain_format = FindFormat(str);
+        }
+        break;
+      }
+      case ConfigContext::kRenderPass: {
+        if (top.key == "name"_id) {
+          render_pass_name_ = GetStrHash(str);
+        }
+        break;
+      }
+      case ConfigContext::kRenderPassInfo: {
+        switch (top.key) {
+          case "queue"_id: { render_pass_info_.queue = GetStrHash(str); break; }
+          case "type"_id: { render_pass_info_.type = GetStrHash(str); break; }
+          case "material"_id: {
+            render_pass_info_.material = GetStrHash(str);
+            render_pass_info_.material_id = render_pass_info_.material;
+            break;
+          }
+          case "dsv"_id: { render_pass_info_.dsv = GetStrHash(str); break; }
+          case "present"_id: { render_pass_info_.present = GetStrHash(str); break; }
+        }
+        break;
+      }
+      case ConfigContext::kRenderPassInfoStrHashList: {
+        str_hash_list_.push_back(GetStrHash(str));
+        break;
+      }
+      case ConfigContext::kResource: {
+        switch (top.key) {
+          case "name"_id: { resource_name_ = GetStrHash(str); break; }
+          case "format"_id: { resource_info_.format = FindFormat(str); break; }
+          case "initial_flag"_id: {
+            if (!FindResourceCreationType(str, &resource_info_.creation_type)) {
+              AddError(ConfigErrorCode::kUnknownInitialFlag, str);
+            }
+            break;
+          }
+        }
+        break;
+      }
+      case ConfigContext::kResourceFlags: {
+        if (!IsResourceFlagName(str)) {
+          AddError(ConfigErrorCode::kUnknownResourceFlag, str);
+          break;
+        }
+        resource_info_.flags = AddResourceFlag(resource_info_.flags, str);
+        break;
+      }
+      case ConfigContext::kMaterial: {
+        switch (top.key) {
+          case "name"_id: { material_.name = str; break; }
+          case "rootsig"_id: { material_.rootsig = str; break; }
+          case "fallback"_id: { material_.fallback = str; break; }
+        }
+        break;
+      }
+      case ConfigContext::kMaterialShader: {
+        switch (top.key) {
+          case "target"_id: {
+            if (!IsKnownShaderTarget(str)) {
+              AddError(ConfigErrorCode::kUnknownShaderTarget, str);
+            }
+            material_shader_.target = str;
+            break;
+          }
+          case "filename"_id: { material_shader_.filename = str; break; }
+        }
+        break;
+      }
+      case ConfigContext::kMaterialRtvFormats: {
+        format_list_.push_back(FindFormat(str));
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+  bool StartObject() {
+    if (depth_ == 0) {
+      Push(ConfigContext::kRoot);
+      return true;
+    }
+    const auto& top = Top();
+    switch (top.context) {
+      case ConfigContext::kRoot: {
+        switch (top.key) {
+          case "swapchain"_id: { Push(ConfigContext::kSwapchain); return true; }
+          case "descriptor_handles"_id: { Push(ConfigContext::kDescriptorHandles); return true; }
+        }
+        break;
+      }
+      case ConfigContext::kRenderPassArray: {
+        render_pass_name_ = kEmptyStr;
+        render_pass_ = {};
+        Push(ConfigContext::kRenderPass);
+        return true;
+      }
+      case ConfigContext::kRenderPassInfoArray: {
+        render_pass_info_ = {};
+        Push(ConfigContext::kRenderPassInfo);
+        return true;
+      }
+      case ConfigContext::kResourceArray: {
+        resource_name_ = kEmptyStr;
+        resource_info_ = {.flags = kDefaultResourceFlags,};
+        Push(ConfigContext::kResource);
+        return true;
+      }
+      case ConfigContext::kMaterialArray: {
+        material_ = {};
+        Push(ConfigContext::kMaterial);
+        return true;
+      }
+      case ConfigContext::kMaterialShaderArray: {
+        material_shader_ = {};
+        Push(ConfigContext::kMaterialShader);
+        return true;
+      }
+      default: {
+        break;
+      }
+    }
+    Push(ConfigContext::kSkip);
+    return true;
+  }
+  bool EndObject(rapidjson::SizeType) {
+    CheckRequiredKeys(Top());
+    const auto context = Pop();
+    // entries are reset once handed over, so that ReleasePendingEntries never frees an array twice.
+    switch (context) {
+      case ConfigContext::kRenderPass: {
+        if (auto prev_render_pass = config_->render_pass_list->get(render_pass_name_); prev_render_pass != nullptr) {
+          AddError(ConfigErrorCode::kDuplicateName, nullptr);
+          ReleaseRenderPassList(*prev_render_pass);
+        }
+        config_->render_pass_list->insert(render_pass_name_, render_pass_);
+        render_pass_ = {};
+        break;
+      }
+      case ConfigContext::kRenderPassInfo: {
+        render_pass_info_list_.push_back(render_pass_info_);
+        render_pass_info_ = {};
+        break;
+      }
+      case ConfigContext::kResource: {
+        AdjustResourceSize(resource_name_, explicit_buffer_size_, &resource_info_);
+        if (config_->resource_info->contains(resource_name_)) {
+          AddError(ConfigErrorCode::kDuplicateName, nullptr);
+        }
+        config_->resource_info->insert(resource_name_, resource_info_);
+        break;
+      }
+      case ConfigContext::kMaterial: {
+        material_list_.push_back(material_);
+        material_ = {};
+        break;
+      }
+      case ConfigContext::kMaterialShader: {
+        material_shader_list_.push_back(material_shader_);
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+    if (depth_ > 0 && IsArrayContext(Top().context)) {
+      Top().index++;
+    }
+    return true;
+  }
+  bool StartArray() {
+    if (depth_ == 0) {
+      Push(ConfigContext::kSkip);
+      return true;
+    }
+    const auto& top = Top();
+    switch (top.context) {
+      case ConfigContext::kRoot: {
+        switch (top.key) {
+          case "render_pass"_id: { Push(ConfigContext::kRenderPassArray); return true; }
+          case "resource"_id: { Push(ConfigContext::kResourceArray); return true; }
+          case "material"_id: {
+            material_list_.clear();
+            Push(ConfigContext::kMaterialArray);
+            return true;
+          }
+        }
+        break;
+      }
+      case ConfigContext::kSwapchain: {
+        if (top.key == "size"_id) {
+          Push(ConfigContext::kSwapchainSize);
+          return true;
+        }
+        break;
+      }
+      case ConfigContext::kRenderPass: {
+        if (top.key == "list"_id) {
+          render_pass_info_list_.clear();
+          Push(ConfigContext::kRenderPassInfoArray);
+          return true;
+        }
+        break;
+      }
+      case ConfigContext::kRenderPassInfo: {
+        switch (top.key) {
+          case "cbv"_id:
+          case "srv"_id:
+          case "uav"_id:
+          case "rtv"_id: {
+            str_hash_list_.clear();
+            Push(ConfigContext::kRenderPassInfoStrHashList);
+            return true;
+          }
+        }
+        break;
+      }
+      case ConfigContext::kResource: {
+        switch (top.key) {
+          case "size"_id: { Push(ConfigContext::kResourceSize); return true; }
+          case "flags"_id: { Push(ConfigContext::kResourceFlags); return true; }
+        }
+        break;
+      }
+      case ConfigContext::kMaterial: {
+        switch (top.key) {
+          case "shader_list"_id: {
+            material_shader_list_.clear();
+            Push(ConfigContext::kMaterialShaderArray);
+            return true;
+          }
+          case "rtv"_id: {
+            format_list_.clear();
+            Push(ConfigContext::kMaterialRtvFormats);
+            return true;
+          }
+        }
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+    Push(ConfigContext::kSkip);
+    return true;
+  }
+  bool EndArray(rapidjson::SizeType) {
+    const auto context = Pop();
+    if (depth_ == 0) { return true; }
+    auto& top = Top();
+    switch (context) {
+      case ConfigContext::kRenderPassInfoStrHashList: {
+        auto list = CopyToArray(str_hash_list_);
+        // arrays of a duplicated key are replaced.
+        switch (top.key) {
+          case "cbv"_id: {
+            Deallocate(render_pass_info_.cbv);
+            render_pass_info_.cbv = list;
+            render_pass_info_.cbv_num = str_hash_list_.size();
+            break;
+          }
+          case "srv"_id: {
+            Deallocate(render_pass_info_.srv);
+            render_pass_info_.srv = list;
+            render_pass_info_.srv_num = str_hash_list_.size();
+            break;
+          }
+          case "uav"_id: {
+            Deallocate(render_pass_info_.uav);
+            render_pass_info_.uav = list;
+            render_pass_info_.uav_num = str_hash_list_.size();
+            break;
+          }
+          case "rtv"_id: {
+            Deallocate(render_pass_info_.rtv);
+            render_pass_info_.rtv = list;
+            render_pass_info_.rtv_num = str_hash_list_.size();
+            break;
+          }
+        }
+        break;
+      }
+      case ConfigContext::kRenderPassInfoArray: {
+        ReleaseRenderPassList(render_pass_);
+        render_pass_.render_pass_info = CopyToArray(render_pass_info_list_);
+        render_pass_.render_pass_len = render_pass_info_list_.size();
+        render_pass_info_list_.clear();
+        break;
+      }
+      case ConfigContext::kMaterialShaderArray: {
+        Deallocate(material_.shader_list);
+        material_.shader_list = CopyToArray(material_shader_list_);
+        material_.shader_num = material_shader_list_.size();
+        break;
+      }
+      case ConfigContext::kMaterialRtvFormats: {
+        Deallocate(material_.rtv_format);
+        material_.rtv_format = CopyToArray(format_list_);
+        material_.rtv_num = format_list_.size();
+        break;
+      }
+      case ConfigContext::kMaterialArray: {
+        for (uint32_t i = 0; i < config_->material_num; i++) {
+          ReleaseMaterialArrays(config_->material_list[i]);
+        }
+        Deallocate(config_->material_list);
+        config_->material_list = CopyToArray(material_list_);
+        config_->material_num = material_list_.size();
+        material_list_.clear();
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+    if (IsArrayContext(top.context)) {
+      top.index++;
+    }
+    return true;
+  }
+  void AddSyntaxError(const uint32_t text_offset) {
+    error_list_.push_back({
+        .code = ConfigErrorCode::kSyntaxError,
+        .index = text_offset,
+      });
+  }
+  const ResizableArray<ConfigError>& GetErrorList() const { return error_list_; }
+  /**
+   * frees arrays of entries not yet handed over to config when parsing stopped halfway.
+   **/
+  void ReleasePendingEntries() {
+    ReleaseStrHashLists(render_pass_info_);
+    for (auto& info : render_pass_info_list_) {
+      ReleaseStrHashLists(info);
+    }
+    ReleaseRenderPassList(render_pass_);
+    ReleaseMaterialArrays(material_);
+    for (auto& material : material_list_) {
+      ReleaseMaterialArrays(material);
+    }
+    render_pass_info_ = {};
+    render_pass_info_list_.clear();
+    render_pass_ = {};
+    material_ = {};
+    material_list_.clear();
+  }
+ private:
+  static const uint32_t kMaxDepth = 16;
+  static void ReleaseStrHashLists(RenderPassInfo& info) {
+    Deallocate(info.cbv);
+    Deallocate(info.srv);
+    Deallocate(info.uav);
+    Deallocate(info.rtv);
+  }
+  static void ReleaseRenderPassList(RenderPassList& render_pass) {
+    for (uint32_t i = 0; i < render_pass.render_pass_len; i++) {
+      ReleaseStrHashLists(render_pass.render_pass_info[i]);
+    }
+    Deallocate(render_pass.render_pass_info);
+    render_pass = {};
+  }
+  static void ReleaseMaterialArrays(MaterialInfo& material) {
+    Deallocate(material.shader_list);
+    Deallocate(material.rtv_format);
+  }
+  DXGI_FORMAT FindFormat(const char* const format) {
+    auto dxgi_format = DXGI_FORMAT_UNKNOWN;
+    if (!FindDxgiFormat(format, &dxgi_format)) {
+      AddError(ConfigErrorCode::kUnknownFormat, format);
+    }
+    return dxgi_format;
+  }
+  void AddError(const ConfigErrorCode code, const char* const value) {
+    ConfigError error{
+      .code = code,
+      .value = value,
+    };
+    // the innermost entry array tells where the error is.
+    for (uint32_t i = depth_; i > 0; i--) {
+      const auto& entry = context_stack_[i - 1];
+      if (entry.context == ConfigContext::kRenderPassInfoArray || entry.context == ConfigContext::kRenderPassArray) {
+        error.section = ConfigSection::kRenderPass;
+        error.owner = render_pass_name_;
+        error.index = entry.index;
+        break;
+      }
+      if (entry.context == ConfigContext::kResourceArray) {
+        error.section = ConfigSection::kResource;
+        error.owner = resource_name_;
+        error.index = entry.index;
+        break;
+      }
+      if (entry.context == ConfigContext::kMaterialArray) {
+        error.section = ConfigSection::kMaterial;
+        error.owner = material_.name ? GetStrHash(material_.name) : kEmptyStr;
+        error.index = entry.index;
+        break;
+      }
+    }
+    error_list_.push_back(error);
+  }
+  /**
+   * records a type error if value_type is not what the current key or array takes.
+   **/
+  bool IsExpectedValueType(const ConfigValueType value_type) {
+    if (depth_ == 0) { return false; }
+    const auto& top = Top();
+    const auto expected_value_type = GetExpectedValueType(top.context, top.key);
+    if (expected_value_type == value_type) { return true; }
+    if (expected_value_type == ConfigValueType::kAny) { return false; }
+    // elements of an array are named by the key of the array.
+    const auto& named_entry = (IsArrayContext(top.context) && depth_ > 1) ? context_stack_[depth_ - 2] : top;
+    AddError(ConfigErrorCode::kInvalidType, named_entry.key_name);
+    return false;
+  }
+  void NextValue() {
+    if (depth_ > 0 && IsArrayContext(Top().context)) {
+      Top().index++;
+    }
+  }
+  void CheckRequiredKeys(const ConfigContextEntry& entry) {
+    const auto required_key_list = GetRequiredKeyList(entry.context);
+    for (uint32_t i = 0; i < required_key_list.num; i++) {
+      if ((entry.found_keys & (1U << i)) == 0) {
+        AddError(ConfigErrorCode::kMissingKey, required_key_list.list[i].name);
+      }
+    }
+  }
+  static bool IsArrayContext(const ConfigContext context) {
+    switch (context) {
+      case ConfigContext::kSwapchainSize:
+      case ConfigContext::kRenderPassArray:
+      case ConfigContext::kRenderPassInfoArray:
+      case ConfigContext::kRenderPassInfoStrHashList:
+      case ConfigContext::kResourceArray:
+      case ConfigContext::kResourceSize:
+      case ConfigContext::kResourceFlags:
+      case ConfigContext::kMaterialArray:
+      case ConfigContext::kMaterialShaderArray:
+      case ConfigContext::kMaterialRtvFormats:
+        return true;
+      default:
+        return false;
+    }
+  }
+  void SetSize2dElement(const uint32_t index, const uint32_t val, Size2d* size) {
+    if (index == 0) {
+      size->width = val;
+      return;
+    }
+    if (index == 1) {
+      size->height = val;
+      return;
+    }
+    AddError(ConfigErrorCode::kInvalidSize, nullptr);
+  }
+  ConfigContextEntry& Top() {
+    return context_stack_[depth_ - 1];
+  }
+  void Push(const ConfigContext context) {
+    // everything below an unknown value is skipped and only counted, so unknown values can nest deeper than kMaxDepth.
+    if (depth_ > 0 && Top().context == ConfigContext::kSkip) {
+      skip_depth_++;
+      return;
+    }
+    DEBUG_ASSERT(depth_ < kMaxDepth, DebugAssert{});
+    context_stack_[depth_] = {.context = context,};
+    depth_++;
+  }
+  ConfigContext Pop() {
+    if (skip_depth_ > 0) {
+      skip_depth_--;
+      return ConfigContext::kSkip;
+    }
+    DEBUG_ASSERT(depth_ > 0, DebugAssert{});
+    depth_--;
+    return context_stack_[depth_].context;
+  }
+  GfxConfig* config_{};
+  const StrHashMap<Size2d>& explicit_buffer_size_;
+  ConfigContextEntry context_stack_[kMaxDepth]{};
+  uint32_t depth_{};
+  uint32_t skip_depth_{};
+  ResizableArray<ConfigError> error_list_;
+  StrHash render_pass_name_{kEmptyStr};
+  RenderPassList render_pass_{};
+  RenderPassInfo render_pass_info_{};
+  ResizableArray<RenderPassInfo> render_pass_info_list_;
+  ResizableArray<StrHash> str_hash_list_;
+  StrHash resource_name_{kEmptyStr};
+  ResourceInfo resource_info_{};
+  MaterialInfo material_{};
+  ResizableArray<MaterialInfo> material_list_;
+  MaterialShaderInfo material_shader_{};
+  ResizableArray<MaterialShaderInfo> material_shader_list_;
+  ResizableArray<DXGI_FORMAT> format_list_;
+};
+void ReleaseGfxConfigArrays(GfxConfig* config) {
+  for (uint32_t i = 0; i < config->material_num; i++) {
+    Deallocate(config->material_list[i].shader_list);
+    Deallocate(config->material_list[i].rtv_format);
+  }
+  Deallocate(config->material_list);
+  config->render_pass_list->iterate([](const StrHash, RenderPassList* render_pass) {
+    for (uint32_t i = 0; i < render_pass->render_pass_len; i++) {
+      Deallocate(render_pass->render_pass_info[i].cbv);
+      Deallocate(render_pass->render_pass_info[i].srv);
+      Deallocate(render_pass->render_pass_info[i].uav);
+      Deallocate(render_pass->render_pass_info[i].rtv);
+    }
+    Deallocate(render_pass->render_pass_info);
+  });
+}
+} // namespace
+namespace boke {
+GfxConfig* LoadGfxConfig(const char* const config_path, const StrHashMap<Size2d>& explicit_buffer_size) {
+  auto config = New<GfxConfig>();
+  config->resource_info = New<StrHashMap<ResourceInfo>>();
+  config->render_pass_list = New<StrHashMap<RenderPassList>>();
+  config->text = LoadFileToBuffer(config_path);
+  DEBUG_ASSERT(config->text != nullptr, DebugAssert{});
+  if (config->text == nullptr) { return config; }
+  {
+    // handler and reader are scoped so that their scratch buffers are freed before returning.
+    GfxConfigHandler handler(config, explicit_buffer_size);
+    JsonAllocator stack_allocator;
+    rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, JsonAllocator> reader(&stack_allocator, JsonPoolAllocator::kChunkCapacity);
+    rapidjson::InsituStringStream stream(config->text);
+    const auto result = reader.Parse<rapidjson::kParseInsituFlag>(stream, handler);
+    if (result.IsError()) {
+      handler.AddSyntaxError(GetUint32(result.Offset()));
+      handler.ReleasePendingEntries();
+    }
+    config->parse_error_list = CopyToArray(handler.GetErrorList());
+    config->parse_error_num = handler.GetErrorList().size();
+  }
+  return config;
+}
+void ReleaseGfxConfig(GfxConfig* config) {
+  if (config->baked_config == nullptr) {
+    ReleaseGfxConfigArrays(config);
+  }
+  config->render_pass_list->~StrHashMap<RenderPassList>();
+  Deallocate(config->render_pass_list);
+  config->resource_info->~StrHashMap<ResourceInfo>();
+  Deallocate(config->resource_info);
+  Deallocate(config->text);
+  Deallocate(config->parse_error_list);
+  MappedFile baked_config{
+    .buffer = config->baked_config,
+    .size = config->baked_config_size,
+  };
+  UnmapFile(baked_config);
+  Deallocate(config);
+}
+} // namespace boke
+#include "doctest/doctest.h"
+TEST_CASE("gfx config") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 256 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  const auto initial_stats = GetAllocatorStats();
+  StrHashMap<Size2d> explicit_buffer_size;
+  explicit_buffer_size["camera"_id] = Size2d{sizeof(float) * 32,1};
+  auto config = LoadGfxConfig("tests/formatted-config-multipass.json", explicit_buffer_size);
+  CHECK_EQ(strcmp(config->title, "boke multi-pass test"), 0);
+  CHECK_EQ(config->frame_buffer_num, 2);
+  CHECK_EQ(config->swapchain_size.width, 1920);
+  CHECK_EQ(config->swapchain_size.height, 1080);
+  CHECK_EQ(config->swapchain_format, DXGI_FORMAT_R8G8B8A8_UNORM);
+  CHECK_GT(config->max_loop_num, 0);
+  CHECK_GT(config->shader_visible_buffer_num, 0);
+  CHECK_EQ(config->parse_error_num, 0);
+  SUBCASE("resource info matches dom parser") {
+    const auto json = GetJson("tests/formatted-config-multipass.json");
+    auto resource_info = ParseResourceInfo(json["resource"], explicit_buffer_size);
+    CHECK_EQ(config->resource_info->size(), resource_info.size());
+    for (const auto& resource : json["resource"].GetArray()) {
+      const auto id = GetStrHash(resource["name"].GetString());
+      REQUIRE_UNARY(config->resource_info->contains(id));
+      const auto& expected = resource_info[id];
+      const auto& info = (*config->resource_info)[id];
+      CHECK_EQ(info.creation_type, expected.creation_type);
+      CHECK_EQ(info.flags, expected.flags);
+      CHECK_EQ(info.format, expected.format);
+      CHECK_EQ(info.size.width, expected.size.width);
+      CHECK_EQ(info.size.height, expected.size.height);
+      CHECK_EQ(info.physical_resource_num, expected.physical_resource_num);
+      CHECK_EQ(info.pingpong, expected.pingpong);
+    }
+    resource_info.~StrHashMap<ResourceInfo>();
+  }
+  SUBCASE("render pass and material match dom") {
+    const auto json = GetJson("tests/formatted-config-multipass.json");
+    CHECK_EQ(config->render_pass_list->size(), json["render_pass"].Size());
+    for (const auto& render_pass_json : json["render_pass"].GetArray()) {
+      const auto id = GetStrHash(render_pass_json["name"].GetString());
+      REQUIRE_UNARY(config->render_pass_list->contains(id));
+      const auto& render_pass = (*config->render_pass_list)[id];
+      const auto& list = render_pass_json["list"];
+      REQUIRE_EQ(render_pass.render_pass_len, list.Size());
+      for (uint32_t i = 0; i < render_pass.render_pass_len; i++) {
+        const auto& info = render_pass.render_pass_info[i];
+        CHECK_EQ(info.type, GetStrHash(list[i]["type"].GetString()));
+        CHECK_EQ(info.queue, GetStrHash(list[i]["queue"].GetString()));
+        CHECK_EQ(info.material_id, list[i].HasMember("material") ? GetStrHash(list[i]["material"].GetString()) : kEmptyStr);
+        CHECK_EQ(info.rtv_num, list[i].HasMember("rtv") ? list[i]["rtv"].Size() : 0);
+        for (uint32_t j = 0; j < info.rtv_num; j++) {
+          CHECK_EQ(info.rtv[j], GetStrHash(list[i]["rtv"][j].GetString()));
+        }
+        CHECK_EQ(info.srv_num, list[i].HasMember("srv") ? list[i]["srv"].Size() : 0);
+        CHECK_EQ(info.cbv_num, list[i].HasMember("cbv") ? list[i]["cbv"].Size() : 0);
+        CHECK_EQ(info.uav_num, list[i].HasMember("uav") ? list[i]["uav"].Size() : 0);
+      }
+    }
+    REQUIRE_EQ(config->material_num, json["material"].Size());
+    for (uint32_t i = 0; i < config->material_num; i++) {
+      const auto& material = config->material_list[i];
+      const auto& material_json = json["material"][i];
+      CHECK_EQ(strcmp(material.name, material_json["name"].GetString()), 0);
+      CHECK_EQ(strcmp(material.rootsig, material_json["rootsig"].GetString()), 0);
+      REQUIRE_EQ(material.shader_num, material_json["shader_list"].Size());
+      for (uint32_t j = 0; j < material.shader_num; j++) {
+        CHECK_EQ(strcmp(material.shader_list[j].target, material_json["shader_list"][j]["target"].GetString()), 0);
+        CHECK_EQ(strcmp(material.shader_list[j].filename, material_json["shader_list"][j]["filename"].GetString()), 0);
+      }
+      REQUIRE_EQ(material.rtv_num, material_json.HasMember("rtv") ? material_json["rtv"].Size() : 0);
+      for (uint32_t j = 0; j < material.rtv_num; j++) {
+        CHECK_EQ(material.rtv_format[j], GetDxgiFormat(material_json["rtv"][j].GetString()));
+      }
+    }
+  }
+  ReleaseGfxConfig(config);
+  explicit_buffer_size.~StrHashMap<Size2d>();
+  // no allocation is left behind once the config is released.
+  CHECK_EQ(GetAllocatorStats().free_size, initial_stats.free_size);
+}
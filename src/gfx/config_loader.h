@@ -0,0 +1,89 @@
+#pragma once
+namespace boke {
+struct MaterialShaderInfo {
+  const char* target{};
+  const char* filename{};
+};
+struct MaterialInfo {
+  const char* name{};
+  const char* rootsig{};
+  uint32_t shader_num{};
+  MaterialShaderInfo* shader_list{};
+  uint32_t rtv_num{};
+  DXGI_FORMAT* rtv_format{};
+  const char* fallback{}; // material used while the pso is compiling, nullptr if none
+};
+enum class ConfigErrorCode : uint8_t {
+  kSyntaxError,
+  kMissingKey,
+  kUnknownFormat,
+  kUnknownResourceFlag,
+  kUnknownInitialFlag,
+  kUnknownShaderTarget,
+  kInvalidValue,
+  kInvalidType,
+  kInvalidSize,
+  kInvalidPhysicalResourceNum,
+  kDuplicateName,
+  kDanglingResource,
+  kDanglingMaterial,
+  kRtvDsvConflict,
+  kMissingRtvFlag,
+  kMissingDsvFlag,
+  kMissingUavFlag,
+  kReadWriteConflict,
+  kRtvNumMismatch,
+  kUnknownQueue,
+  kUnsupportedQueueAccess,
+  kFallbackMismatch,
+};
+enum class ConfigSection : uint8_t {
+  kRoot,
+  kResource,
+  kRenderPass,
+  kMaterial,
+};
+struct ConfigError {
+  ConfigErrorCode code{};
+  ConfigSection section{};
+  StrHash owner{kEmptyStr}; // resource, render pass or material name if known
+  uint32_t index{};         // entry index in its json array (pass index for render passes, text offset for syntax errors)
+  StrHash ref{kEmptyStr};   // referred resource or material
+  const char* value{};      // offending string or missing key
+};
+struct RenderPassList {
+  uint32_t render_pass_len{};
+  RenderPassInfo* render_pass_info{};
+};
+/**
+ * engine structures streamed directly from a config json without building a dom.
+ * strings point into text, which is owned by the config.
+ **/
+struct GfxConfig {
+  char* text{};
+  /**
+   * set instead of text when loaded by LoadBakedGfxConfig.
+   * arrays and strings then point into the mapped file.
+   **/
+  const char* baked_config{};
+  uint64_t baked_config_size{};
+  const char* title{};
+  uint32_t frame_buffer_num{};
+  Size2d swapchain_size{};
+  DXGI_FORMAT swapchain_format{};
+  uint32_t max_loop_num{};
+  uint32_t shader_visible_buffer_num{};
+  StrHashMap<ResourceInfo>* resource_info{};
+  StrHashMap<RenderPassList>* render_pass_list{};
+  uint32_t material_num{};
+  MaterialInfo* material_list{};
+  /**
+   * unknown names, missing keys and syntax errors found while parsing.
+   * checked along with the rest by ValidateGfxConfig.
+   **/
+  uint32_t parse_error_num{};
+  ConfigError* parse_error_list{};
+};
+GfxConfig* LoadGfxConfig(const char* const config_path, const StrHashMap<Size2d>& explicit_buffer_size);
+void ReleaseGfxConfig(GfxConfig*);
+}
@@ -0,0 +1,511 @@
+#include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/debug_assert.h"
+#include "boke/str_hash.h"
+#include "boke/util.h"
+#include "json.h"
+#include "render_pass_info.h"
+#include "resource_info.h"
+#include "config_loader.h"
+#include "config_validation.h"
+#include "queue_schedule.h"
+namespace {
+using namespace boke;
+struct ValidationContext {
+  const GfxConfig* config{};
+  StrHashMap<uint32_t> material_index;
+  ResizableArray<ConfigError> error_list;
+};
+auto IsPingpong(const StrHashMap<ResourceInfo>& resource_info, const StrHash resource_id) {
+  const auto info = resource_info.get(resource_id);
+  return info != nullptr && info->pingpong;
+}
+void ValidateRoot(const GfxConfig* config, ResizableArray<ConfigError>* error_list) {
+  if (config->frame_buffer_num == 0) {
+    error_list->push_back({.code = ConfigErrorCode::kInvalidValue, .value = "frame_buffer_num",});
+  }
+  if (config->swapchain_size.width == 0 || config->swapchain_size.height == 0) {
+    error_list->push_back({.code = ConfigErrorCode::kInvalidSize, .value = "swapchain",});
+  }
+}
+void ValidateResource(ResizableArray<ConfigError>* error_list, const StrHash resource_id, const ResourceInfo* info) {
+  const auto add_error = [&](const ConfigErrorCode code) {
+    error_list->push_back({.code = code, .section = ConfigSection::kResource, .owner = resource_id,});
+  };
+  const auto allow_rtv = (info->flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) != 0;
+  const auto allow_dsv = (info->flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) != 0;
+  if (allow_rtv && allow_dsv) {
+    add_error(ConfigErrorCode::kRtvDsvConflict);
+  }
+  if (info->creation_type == ResourceCreationType::kRtv && !allow_rtv) {
+    add_error(ConfigErrorCode::kMissingRtvFlag);
+  }
+  if (info->creation_type == ResourceCreationType::kDsv && !allow_dsv) {
+    add_error(ConfigErrorCode::kMissingDsvFlag);
+  }
+  if (info->creation_type == ResourceCreationType::kUav && (info->flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS) == 0) {
+    add_error(ConfigErrorCode::kMissingUavFlag);
+  }
+  if (info->creation_type == ResourceCreationType::kNone) {
+    // swapchain and externally provided resources are not created from config.
+    return;
+  }
+  if ((info->creation_type == ResourceCreationType::kRtv || info->creation_type == ResourceCreationType::kDsv)
+      && (info->size.width == 0 || info->size.height == 0)) {
+    add_error(ConfigErrorCode::kInvalidSize);
+  }
+  if (info->physical_resource_num == 0 || (info->pingpong && info->physical_resource_num != 2)) {
+    add_error(ConfigErrorCode::kInvalidPhysicalResourceNum);
+  }
+}
+void ValidateResourceRef(const GfxConfig* config, const StrHash resource_id, ConfigError error, ResizableArray<ConfigError>* error_list) {
+  if (config->resource_info->contains(resource_id)) { return; }
+  error.code = ConfigErrorCode::kDanglingResource;
+  error.ref = resource_id;
+  error_list->push_back(error);
+}
+void ValidateRenderPass(ValidationContext* context, const StrHash render_pass_id, const RenderPassList* render_pass) {
+  const auto config = context->config;
+  const auto& resource_info = *config->resource_info;
+  auto error_list = &context->error_list;
+  for (uint32_t i = 0; i < render_pass->render_pass_len; i++) {
+    const auto& pass = render_pass->render_pass_info[i];
+    const ConfigError error{
+      .section = ConfigSection::kRenderPass,
+      .owner = render_pass_id,
+      .index = i,
+    };
+    const auto add_error = [&](const ConfigErrorCode code, const StrHash ref) {
+      auto e = error;
+      e.code = code;
+      e.ref = ref;
+      error_list->push_back(e);
+    };
+    if (pass.queue != kEmptyStr && !IsQueueName(pass.queue)) {
+      add_error(ConfigErrorCode::kUnknownQueue, pass.queue);
+    }
+    // compute queues cannot render, copy queues only copy.
+    const auto queue = GetQueueType(pass.queue);
+    if (queue != QueueType::kDirect) {
+      for (uint32_t j = 0; j < pass.rtv_num; j++) {
+        add_error(ConfigErrorCode::kUnsupportedQueueAccess, pass.rtv[j]);
+      }
+      if (pass.dsv != kEmptyStr) {
+        add_error(ConfigErrorCode::kUnsupportedQueueAccess, pass.dsv);
+      }
+      if (pass.present != kEmptyStr) {
+        add_error(ConfigErrorCode::kUnsupportedQueueAccess, pass.present);
+      }
+    }
+    if (queue == QueueType::kCopy) {
+      for (uint32_t j = 0; j < pass.srv_num; j++) {
+        add_error(ConfigErrorCode::kUnsupportedQueueAccess, pass.srv[j]);
+      }
+      for (uint32_t j = 0; j < pass.uav_num; j++) {
+        add_error(ConfigErrorCode::kUnsupportedQueueAccess, pass.uav[j]);
+      }
+    }
+    for (uint32_t j = 0; j < pass.cbv_num; j++) {
+      ValidateResourceRef(config, pass.cbv[j], error, error_list);
+    }
+    for (uint32_t j = 0; j < pass.srv_num; j++) {
+      ValidateResourceRef(config, pass.srv[j], error, error_list);
+    }
+    for (uint32_t j = 0; j < pass.uav_num; j++) {
+      const auto uav = pass.uav[j];
+      if (!resource_info.contains(uav)) {
+        add_error(ConfigErrorCode::kDanglingResource, uav);
+        continue;
+      }
+      if ((resource_info[uav].flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS) == 0) {
+        add_error(ConfigErrorCode::kMissingUavFlag, uav);
+      }
+    }
+    for (uint32_t j = 0; j < pass.rtv_num; j++) {
+      const auto rtv = pass.rtv[j];
+      if (!resource_info.contains(rtv)) {
+        add_error(ConfigErrorCode::kDanglingResource, rtv);
+        continue;
+      }
+      const auto& info = resource_info[rtv];
+      if (info.creation_type != ResourceCreationType::kNone && (info.flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) == 0) {
+        add_error(ConfigErrorCode::kMissingRtvFlag, rtv);
+      }
+      if (rtv == pass.dsv) {
+        add_error(ConfigErrorCode::kRtvDsvConflict, rtv);
+      }
+      // pingpong resources are read from one buffer and written to the other.
+      for (uint32_t k = 0; k < pass.srv_num; k++) {
+        if (pass.srv[k] == rtv && !IsPingpong(resource_info, rtv)) {
+          add_error(ConfigErrorCode::kReadWriteConflict, rtv);
+        }
+      }
+    }
+    if (pass.dsv != kEmptyStr) {
+      if (!resource_info.contains(pass.dsv)) {
+        add_error(ConfigErrorCode::kDanglingResource, pass.dsv);
+      } else if (resource_info[pass.dsv].creation_type != ResourceCreationType::kNone && (resource_info[pass.dsv].flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) == 0) {
+        add_error(ConfigErrorCode::kMissingDsvFlag, pass.dsv);
+      }
+    }
+    if (pass.present != kEmptyStr) {
+      ValidateResourceRef(config, pass.present, error, error_list);
+    }
+    if (pass.material_id == kEmptyStr || pass.material_id == ""_id) { continue; }
+    if (!context->material_index.contains(pass.material_id)) {
+      add_error(ConfigErrorCode::kDanglingMaterial, pass.material_id);
+      continue;
+    }
+    const auto& material = config->material_list[context->material_index[pass.material_id]];
+    if (material.rtv_num != pass.rtv_num) {
+      add_error(ConfigErrorCode::kRtvNumMismatch, pass.material_id);
+    }
+  }
+}
+/**
+ * a fallback is bound to the same render targets as its material.
+ **/
+void ValidateMaterialFallback(ValidationContext* context, const uint32_t material_index) {
+  const auto& material = context->config->material_list[material_index];
+  if (material.fallback == nullptr) { return; }
+  ConfigError error{
+    .section = ConfigSection::kMaterial,
+    .owner = GetStrHash(material.name),
+    .index = material_index,
+    .ref = GetStrHash(material.fallback),
+  };
+  const auto fallback_index = context->material_index.get(error.ref);
+  if (fallback_index == nullptr) {
+    error.code = ConfigErrorCode::kDanglingMaterial;
+    context->error_list.push_back(error);
+    return;
+  }
+  const auto& fallback = context->config->material_list[*fallback_index];
+  if (fallback.rtv_num != material.rtv_num
+      || (material.rtv_num > 0 && memcmp(fallback.rtv_format, material.rtv_format, sizeof(DXGI_FORMAT) * material.rtv_num) != 0)) {
+    error.code = ConfigErrorCode::kFallbackMismatch;
+    context->error_list.push_back(error);
+  }
+}
+} // namespace
+namespace boke {
+ResizableArray<ConfigError> ValidateGfxConfig(const GfxConfig* config) {
+  ValidationContext context{
+    .config = config,
+    .material_index = StrHashMap<uint32_t>(config->material_num + 1),
+    .error_list = ResizableArray<ConfigError>(config->parse_error_num + 4),
+  };
+  for (uint32_t i = 0; i < config->parse_error_num; i++) {
+    context.error_list.push_back(config->parse_error_list[i]);
+  }
+  // semantic checks on a partially parsed config would only repeat the syntax error.
+  for (const auto& error : context.error_list) {
+    if (error.code == ConfigErrorCode::kSyntaxError) {
+      return std::move(context.error_list);
+    }
+  }
+  ValidateRoot(config, &context.error_list);
+  config->resource_info->iterate<ResizableArray<ConfigError>>(ValidateResource, &context.error_list);
+  for (uint32_t i = 0; i < config->material_num; i++) {
+    const auto& material = config->material_list[i];
+    if (material.name == nullptr) { continue; }
+    context.material_index.insert(GetStrHash(material.name), i);
+  }
+  for (uint32_t i = 0; i < config->material_num; i++) {
+    if (config->material_list[i].name == nullptr) { continue; }
+    ValidateMaterialFallback(&context, i);
+  }
+  config->render_pass_list->iterate<ValidationContext>(ValidateRenderPass, &context);
+  return std::move(context.error_list);
+}
+const char* GetConfigErrorCodeName(const ConfigErrorCode code) {
+  switch (code) {
+    case ConfigErrorCode::kSyntaxError: return "syntax error";
+    case ConfigErrorCode::kMissingKey: return "missing key";
+    case ConfigErrorCode::kUnknownFormat: return "unknown format";
+    case ConfigErrorCode::kUnknownResourceFlag: return "unknown resource flag";
+    case ConfigErrorCode::kUnknownInitialFlag: return "unknown initial flag";
+    case ConfigErrorCode::kUnknownShaderTarget: return "unknown shader target";
+    case ConfigErrorCode::kInvalidValue: return "invalid value";
+    case ConfigErrorCode::kInvalidType: return "invalid value type";
+    case ConfigErrorCode::kInvalidSize: return "invalid size";
+    case ConfigErrorCode::kInvalidPhysicalResourceNum: return "invalid physical_resource_num";
+    case ConfigErrorCode::kDuplicateName: return "duplicate name";
+    case ConfigErrorCode::kDanglingResource: return "undefined resource";
+    case ConfigErrorCode::kDanglingMaterial: return "undefined material";
+    case ConfigErrorCode::kRtvDsvConflict: return "rtv and dsv on the same resource";
+    case ConfigErrorCode::kMissingRtvFlag: return "rtv flag missing";
+    case ConfigErrorCode::kMissingDsvFlag: return "dsv flag missing";
+    case ConfigErrorCode::kMissingUavFlag: return "uav flag missing";
+    case ConfigErrorCode::kReadWriteConflict: return "resource read and written in the same pass";
+    case ConfigErrorCode::kRtvNumMismatch: return "rtv num differs from material";
+    case ConfigErrorCode::kUnknownQueue: return "unknown queue";
+    case ConfigErrorCode::kUnsupportedQueueAccess: return "resource access unsupported on the queue";
+    case ConfigErrorCode::kFallbackMismatch: return "fallback material differs in rtv formats";
+  }
+  return "unknown error";
+}
+const char* GetConfigSectionName(const ConfigSection section) {
+  switch (section) {
+    case ConfigSection::kRoot: return "root";
+    case ConfigSection::kResource: return "resource";
+    case ConfigSection::kRenderPass: return "render_pass";
+    case ConfigSection::kMaterial: return "material";
+  }
+  return "unknown";
+}
+void LogConfigErrors(const ResizableArray<ConfigError>& error_list) {
+  for (const auto& error : error_list) {
+    const auto owner = error.owner == kEmptyStr ? "" : GetStr(error.owner);
+    const auto ref = error.ref == kEmptyStr ? "" : GetStr(error.ref);
+    spdlog::error("config {}: {} {}[{}] {} {}",
+                  GetConfigErrorCodeName(error.code),
+                  GetConfigSectionName(error.section),
+                  owner ? owner : "",
+                  error.index,
+                  ref ? ref : "",
+                  error.value ? error.value : "");
+  }
+}
+} // namespace boke
+#include <memory>
+#include "doctest/doctest.h"
+#include "boke/file.h"
+#include "platform/file_io.h"
+namespace {
+auto CountConfigError(const boke::ResizableArray<boke::ConfigError>& error_list, const boke::ConfigErrorCode code) {
+  uint32_t count = 0;
+  for (const auto& error : error_list) {
+    if (error.code == code) { count++; }
+  }
+  return count;
+}
+auto ValidateConfigText(const char* const text) {
+  using namespace boke;
+  const char path[] = "tests/_config_validation.json";
+  CHECK_UNARY(SaveBufferToFile(path, text, GetUint32(strlen(text))));
+  auto config = LoadGfxConfig(path, {});
+  auto error_list = ValidateGfxConfig(config);
+  ReleaseGfxConfig(config);
+  RemoveFile(path);
+  return error_list;
+}
+} // namespace
+TEST_CASE("config validation") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 256 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  InitStrHashSystem();
+  SUBCASE("valid config") {
+    auto config = LoadGfxConfig("tests/formatted-config-multipass.json", {});
+    const auto error_list = ValidateGfxConfig(config);
+    CHECK_EQ(error_list.size(), 0);
+    ReleaseGfxConfig(config);
+  }
+  SUBCASE("syntax error") {
+    const auto error_list = ValidateConfigText(R"({"title": "test", "frame_buffer_num": )");
+    REQUIRE_EQ(error_list.size(), 1);
+    CHECK_EQ(error_list[0].code, ConfigErrorCode::kSyntaxError);
+  }
+  SUBCASE("unknown names and missing keys") {
+    const auto error_list = ValidateConfigText(R"({
+  "title": "test",
+  "frame_buffer_num": 2,
+  "swapchain": {"size": [8, 8, 1], "format": "R8G8B8A8_UNROM"},
+  "descriptor_handles": {"shader_visible_buffer_num": 8},
+  "resource": [
+    {"name": "a", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["rtv", "vrs"], "physical_resource_num": 1, "initial_flag": "rtv"},
+    {"name": "b", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["srv"], "physical_resource_num": 1, "initial_flag": "copy_dst"}
+  ],
+  "render_pass": [{"name": "default", "list": [{"type": "postprocess", "rtv": ["a"]}]}],
+  "material": [{"name": "m", "rootsig": "m.rs", "shader_list": [{"target": "vs", "filename": "m.cso"}]}]
+})");
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kUnknownFormat), 1);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kInvalidSize), 1);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kUnknownResourceFlag), 1);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kUnknownInitialFlag), 1);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kUnknownShaderTarget), 1);
+    REQUIRE_EQ(CountConfigError(error_list, ConfigErrorCode::kMissingKey), 1);
+    for (const auto& error : error_list) {
+      if (error.code == ConfigErrorCode::kUnknownResourceFlag) {
+        CHECK_EQ(error.section, ConfigSection::kResource);
+        CHECK_EQ(error.owner, GetStrHash("a"));
+        CHECK_EQ(error.index, 0);
+        CHECK_EQ(strcmp(error.value, "vrs"), 0);
+      }
+      if (error.code == ConfigErrorCode::kMissingKey) {
+        CHECK_EQ(error.section, ConfigSection::kRenderPass);
+        CHECK_EQ(error.owner, GetStrHash("default"));
+        CHECK_EQ(error.index, 0);
+        CHECK_EQ(strcmp(error.value, "queue"), 0);
+      }
+    }
+  }
+  SUBCASE("value types and duplicates") {
+    const auto free_size = GetAllocatorStats().free_size;
+    {
+      const auto error_list = ValidateConfigText(R"({
+  "title": "test",
+  "frame_buffer_num": -1,
+  "swapchain": {"size": [1.5, 8], "format": "R8G8B8A8_UNORM"},
+  "descriptor_handles": {"shader_visible_buffer_num": 8},
+  "resource": [
+    {"name": "a", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["rtv", "srv"], "pingpong": 1, "physical_resource_num": 1, "initial_flag": "rtv"},
+    {"name": "a", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["rtv", "srv"], "physical_resource_num": 1, "initial_flag": "rtv"}
+  ],
+  "render_pass": [
+    {"name": "default", "list": [{"queue": "direct", "type": "postprocess", "rtv": ["a"], "rtv": ["a"], "stencil_val": true}]},
+    {"name": "default", "list": [{"queue": "direct", "type": "postprocess", "rtv": ["a"]}]}
+  ],
+  "material": []
+})");
+      REQUIRE_EQ(CountConfigError(error_list, ConfigErrorCode::kInvalidType), 4);
+      CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kDuplicateName), 2);
+      // frame_buffer_num stays 0.
+      CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kInvalidValue), 1);
+      // swapchain width stays 0 and 8 is still read as height.
+      CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kInvalidSize), 1);
+      CHECK_EQ(error_list.size(), 8);
+      const char* const invalid_type_value_list[] = {"frame_buffer_num", "size", "pingpong", "stencil_val",};
+      uint32_t invalid_type_index = 0;
+      for (const auto& error : error_list) {
+        if (error.code != ConfigErrorCode::kInvalidType) { continue; }
+        CHECK_EQ(strcmp(error.value, invalid_type_value_list[invalid_type_index]), 0);
+        invalid_type_index++;
+      }
+    }
+    // arrays of duplicated keys and names are released.
+    CHECK_EQ(GetAllocatorStats().free_size, free_size);
+  }
+  SUBCASE("inconsistent references") {
+    const auto error_list = ValidateConfigText(R"({
+  "title": "test",
+  "frame_buffer_num": 2,
+  "swapchain": {"size": [8, 8], "format": "R8G8B8A8_UNORM"},
+  "descriptor_handles": {"shader_visible_buffer_num": 8},
+  "resource": [
+    {"name": "color", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["rtv", "srv"], "physical_resource_num": 1, "initial_flag": "rtv"},
+    {"name": "depth", "format": "D24_UNORM_S8_UINT", "size": [8, 8], "flags": ["srv"], "physical_resource_num": 1, "initial_flag": "dsv"},
+    {"name": "both", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["rtv", "dsv"], "physical_resource_num": 1, "initial_flag": "rtv"},
+    {"name": "pingpong", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["rtv", "srv"], "pingpong": true, "physical_resource_num": 1, "initial_flag": "rtv"},
+    {"name": "swapchain", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["srv"], "physical_resource_num": 0, "initial_flag": "present"}
+  ],
+  "render_pass": [{"name": "default", "list": [
+    {"queue": "direct", "type": "postprocess", "material": "m", "srv": ["color", "missing"], "rtv": ["color", "swapchain"]},
+    {"queue": "direct", "type": "geometry", "material": "undefined", "rtv": ["color"], "dsv": "depth"},
+    {"queue": "direct", "type": "no-op", "present": "swapchain", "material": ""}
+  ]}],
+  "material": [{"name": "m", "rootsig": "m.rs", "shader_list": [{"target": "ps", "filename": "m.cso"}], "rtv": ["R8G8B8A8_UNORM"]}]
+})");
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kMissingDsvFlag), 2);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kRtvDsvConflict), 1);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kInvalidPhysicalResourceNum), 1);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kReadWriteConflict), 1);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kRtvNumMismatch), 1);
+    REQUIRE_EQ(CountConfigError(error_list, ConfigErrorCode::kDanglingResource), 1);
+    REQUIRE_EQ(CountConfigError(error_list, ConfigErrorCode::kDanglingMaterial), 1);
+    CHECK_EQ(error_list.size(), 8);
+    for (const auto& error : error_list) {
+      if (error.code == ConfigErrorCode::kDanglingResource) {
+        CHECK_EQ(error.section, ConfigSection::kRenderPass);
+        CHECK_EQ(error.owner, GetStrHash("default"));
+        CHECK_EQ(error.index, 0);
+        CHECK_EQ(error.ref, GetStrHash("missing"));
+      }
+      if (error.code == ConfigErrorCode::kDanglingMaterial) {
+        CHECK_EQ(error.index, 1);
+        CHECK_EQ(error.ref, GetStrHash("undefined"));
+      }
+    }
+  }
+  SUBCASE("uav") {
+    const auto error_list = ValidateConfigText(R"({
+  "title": "test",
+  "frame_buffer_num": 2,
+  "swapchain": {"size": [8, 8], "format": "R8G8B8A8_UNORM"},
+  "descriptor_handles": {"shader_visible_buffer_num": 8},
+  "resource": [
+    {"name": "args", "format": "UNKNOWN", "size": [256, 1], "flags": ["uav"], "physical_resource_num": 1, "initial_flag": "uav"},
+    {"name": "hiz", "format": "R32_FLOAT", "size": [8, 8], "flags": ["srv"], "physical_resource_num": 1, "initial_flag": "uav"},
+    {"name": "color", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["rtv", "srv"], "physical_resource_num": 1, "initial_flag": "rtv"},
+    {"name": "swapchain", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["srv"], "physical_resource_num": 0, "initial_flag": "present"}
+  ],
+  "render_pass": [{"name": "default", "list": [
+    {"queue": "direct", "type": "compute", "uav": ["args", "color", "missing"]},
+    {"queue": "direct", "type": "no-op", "present": "swapchain"}
+  ]}],
+  "material": []
+})");
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kMissingUavFlag), 2);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kDanglingResource), 1);
+    CHECK_EQ(error_list.size(), 3);
+  }
+  SUBCASE("queues") {
+    const auto error_list = ValidateConfigText(R"({
+  "title": "test",
+  "frame_buffer_num": 2,
+  "swapchain": {"size": [8, 8], "format": "R8G8B8A8_UNORM"},
+  "descriptor_handles": {"shader_visible_buffer_num": 8},
+  "resource": [
+    {"name": "ao", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["uav", "srv"], "physical_resource_num": 1, "initial_flag": "uav"},
+    {"name": "color", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["rtv", "srv"], "physical_resource_num": 1, "initial_flag": "rtv"},
+    {"name": "swapchain", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["srv"], "physical_resource_num": 0, "initial_flag": "present"}
+  ],
+  "render_pass": [{"name": "default", "list": [
+    {"queue": "compute", "type": "no-op", "srv": ["color"], "uav": ["ao"]},
+    {"queue": "compute", "type": "no-op", "rtv": ["color"]},
+    {"queue": "copy", "type": "no-op", "uav": ["ao"]},
+    {"queue": "graphics", "type": "no-op", "srv": ["ao"], "rtv": ["color"]},
+    {"queue": "direct", "type": "no-op", "present": "swapchain"}
+  ]}],
+  "material": []
+})");
+    REQUIRE_EQ(CountConfigError(error_list, ConfigErrorCode::kUnknownQueue), 1);
+    CHECK_EQ(CountConfigError(error_list, ConfigErrorCode::kUnsupportedQueueAccess), 2);
+    CHECK_EQ(error_list.size(), 3);
+    for (const auto& error : error_list) {
+      if (error.code == ConfigErrorCode::kUnknownQueue) {
+        CHECK_EQ(error.index, 3);
+        CHECK_EQ(error.ref, GetStrHash("graphics"));
+      }
+      if (error.code == ConfigErrorCode::kUnsupportedQueueAccess) {
+        CHECK_NE(error.index, 0);
+      }
+    }
+  }
+  SUBCASE("material fallbacks") {
+    const auto error_list = ValidateConfigText(R"({
+  "title": "test",
+  "frame_buffer_num": 2,
+  "swapchain": {"size": [8, 8], "format": "R8G8B8A8_UNORM"},
+  "descriptor_handles": {"shader_visible_buffer_num": 8},
+  "resource": [
+    {"name": "swapchain", "format": "R8G8B8A8_UNORM", "size": [8, 8], "flags": ["srv"], "physical_resource_num": 0, "initial_flag": "present"}
+  ],
+  "render_pass": [{"name": "default", "list": [{"queue": "direct", "type": "no-op", "present": "swapchain"}]}],
+  "material": [
+    {"name": "simple", "rootsig": "m.rs", "shader_list": [{"target": "ps", "filename": "simple.cso"}], "rtv": ["R8G8B8A8_UNORM"]},
+    {"name": "complex", "rootsig": "m.rs", "shader_list": [{"target": "ps", "filename": "complex.cso"}], "rtv": ["R8G8B8A8_UNORM"], "fallback": "simple"},
+    {"name": "hdr", "rootsig": "m.rs", "shader_list": [{"target": "ps", "filename": "hdr.cso"}], "rtv": ["R16G16B16A16_FLOAT"], "fallback": "simple"},
+    {"name": "dangling", "rootsig": "m.rs", "shader_list": [{"target": "ps", "filename": "dangling.cso"}], "rtv": ["R8G8B8A8_UNORM"], "fallback": "undefined"}
+  ]
+})");
+    REQUIRE_EQ(CountConfigError(error_list, ConfigErrorCode::kFallbackMismatch), 1);
+    REQUIRE_EQ(CountConfigError(error_list, ConfigErrorCode::kDanglingMaterial), 1);
+    CHECK_EQ(error_list.size(), 2);
+    for (const auto& error : error_list) {
+      CHECK_EQ(error.section, ConfigSection::kMaterial);
+      if (error.code == ConfigErrorCode::kFallbackMismatch) {
+        CHECK_EQ(error.owner, GetStrHash("hdr"));
+        CHECK_EQ(error.index, 2);
+        CHECK_EQ(error.ref, GetStrHash("simple"));
+      }
+      if (error.code == ConfigErrorCode::kDanglingMaterial) {
+        CHECK_EQ(error.owner, GetStrHash("dangling"));
+        CHECK_EQ(error.ref, GetStrHash("undefined"));
+      }
+    }
+  }
+  TermStrHashSystem();
+}
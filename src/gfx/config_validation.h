@@ -0,0 +1,12 @@
+#pragma once
+namespace boke {
+/**
+ * checks a parsed config before any gpu object is created.
+ * returns parse errors of the config followed by dangling references and inconsistent resource settings.
+ * an empty list means the config is safe to pass to PrepareGfxCore and CreateMaterialSet.
+ **/
+ResizableArray<ConfigError> ValidateGfxConfig(const GfxConfig* config);
+const char* GetConfigErrorCodeName(const ConfigErrorCode code);
+const char* GetConfigSectionName(const ConfigSection section);
+void LogConfigErrors(const ResizableArray<ConfigError>& error_list);
+}
@@ -8,3 +8,4 @@ using D3d12Device = ID3D12Device10;
 using D3d12Fence = ID3D12Fence1;
 using D3d12CommandAllocator = ID3D12CommandAllocator;
 using D3d12CommandList = ID3D12GraphicsCommandList7;
+using D3d12PipelineLibrary = ID3D12PipelineLibrary1;
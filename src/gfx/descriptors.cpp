@@ -6,6 +6,7 @@
 #include "boke/util.h"
 #include "core.h"
 #include "descriptors.h"
+#include "dxgi_format.h"
 #include "json.h"
 #include "render_pass_info.h"
 #include "resources.h"
@@ -16,6 +17,7 @@ struct HandleIndex {
     uint32_t rtv;
     uint32_t dsv;
     uint32_t cbv;
+    uint32_t uav;
   };
   uint32_t srv;
 };
@@ -48,6 +50,10 @@ void CountDescriptorHandleNumImpl(DescriptorHandleNum* descriptor_handle_num, co
   if (resource_info->flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) {
     descriptor_handle_num->dsv += resource_info->physical_resource_num;
   }
+  if (resource_info->flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS) {
+    descriptor_handle_num->cbv_srv_uav += resource_info->physical_resource_num;
+  }
+  if (IsBufferResource(*resource_info)) { return; }
   if (!(resource_info->flags & D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE)) {
     descriptor_handle_num->cbv_srv_uav += resource_info->physical_resource_num;
   }
@@ -95,14 +101,6 @@ auto GetDsvDesc2d(const DXGI_FORMAT format) {
     },
   };
 }
-auto GetSrvValidFormat(const DXGI_FORMAT format) {
-  switch (format) {
-    case DXGI_FORMAT_D24_UNORM_S8_UINT:
-      return DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
-    default:
-      return format;
-  }
-}
 auto GetSrvDesc2d(const DXGI_FORMAT format) {
   return D3D12_SHADER_RESOURCE_VIEW_DESC{
     .Format = GetSrvValidFormat(format),
@@ -116,6 +114,30 @@ auto GetSrvDesc2d(const DXGI_FORMAT format) {
     },
   };
 }
+auto GetUavDesc(const DXGI_FORMAT format, const uint32_t buffer_size_in_bytes) {
+  if (format == DXGI_FORMAT_UNKNOWN) {
+    // raw buffer
+    return D3D12_UNORDERED_ACCESS_VIEW_DESC{
+      .Format = DXGI_FORMAT_R32_TYPELESS,
+      .ViewDimension = D3D12_UAV_DIMENSION_BUFFER,
+      .Buffer = {
+        .FirstElement = 0,
+        .NumElements = buffer_size_in_bytes / 4,
+        .StructureByteStride = 0,
+        .CounterOffsetInBytes = 0,
+        .Flags = D3D12_BUFFER_UAV_FLAG_RAW,
+      },
+    };
+  }
+  return D3D12_UNORDERED_ACCESS_VIEW_DESC{
+    .Format = format,
+    .ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D,
+    .Texture2D = {
+      .MipSlice = 0,
+      .PlaneSlice = 0,
+    },
+  };
+}
 auto GetDescriptorHandle(const D3D12_CPU_DESCRIPTOR_HANDLE& head_addr, const uint32_t increment_size, const uint32_t index) {
   return D3D12_CPU_DESCRIPTOR_HANDLE{
     .ptr = head_addr.ptr + increment_size * index,
@@ -148,7 +170,12 @@ void PrepareDescriptorHandlesImpl(DescriptorHandleImplAsset* asset, const StrHas
       AddDescriptorHandlesCbv(resource_id, resource, resource_info->physical_resource_num, resource_info->size.width, asset->device, asset->descriptor_heap_head_addr, asset->descriptor_handle_increment_size, asset->descriptor_handles);
       break;
     }
+    case ResourceCreationType::kUav: {
+      AddDescriptorHandlesUav(resource_id, resource_info->format, resource, resource_info->physical_resource_num, resource_info->size.width, asset->device, asset->descriptor_heap_head_addr, asset->descriptor_handle_increment_size, asset->descriptor_handles);
+      break;
+    }
   }
+  if (IsBufferResource(*resource_info)) { return; }
   if (!(resource_info->flags & D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE)) {
     AddDescriptorHandlesSrv(resource_id, resource_info->format, resource, resource_info->physical_resource_num, asset->device, asset->descriptor_heap_head_addr, asset->descriptor_handle_increment_size, asset->descriptor_handles);
   }
@@ -245,6 +272,17 @@ void AddDescriptorHandlesCbv(const StrHash resource_id, ID3D12Resource** resourc
     descriptor_handles->cbv_srv_uav_handles->push_back(handle);
   }
 }
+void AddDescriptorHandlesUav(const StrHash resource_id, DXGI_FORMAT format, ID3D12Resource** resources, const uint32_t resource_num, const uint32_t buffer_size_in_bytes, D3d12Device* device, const DescriptorHeapHeadAddr& descriptor_heap_head_addr, const DescriptorHandleIncrementSize& descriptor_handle_increment_size, DescriptorHandles* descriptor_handles) {
+  (*descriptor_handles->handle_index)[resource_id].uav = descriptor_handles->cbv_srv_uav_handles->size();
+  const auto desc = GetUavDesc(format, buffer_size_in_bytes);
+  for (uint32_t i = 0; i < resource_num; i++) {
+    const auto handle = GetDescriptorHandle(descriptor_heap_head_addr.cbv_srv_uav, descriptor_handle_increment_size.cbv_srv_uav, descriptor_handles->cbv_srv_uav_handles->size());
+    if (resources && resources[i]) {
+      device->CreateUnorderedAccessView(resources[i], nullptr, &desc, handle);
+    }
+    descriptor_handles->cbv_srv_uav_handles->push_back(handle);
+  }
+}
 ID3D12DescriptorHeap* CreateDescriptorHeap(D3d12Device* device, const D3D12_DESCRIPTOR_HEAP_TYPE descriptor_heap_type, const uint32_t descriptor_handle_num, const D3D12_DESCRIPTOR_HEAP_FLAGS descriptor_heap_flag) {
   ID3D12DescriptorHeap* descriptor_heap{};
   const D3D12_DESCRIPTOR_HEAP_DESC desc = {
@@ -268,6 +306,9 @@ D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorHandleSrv(const StrHash resource_id, co
 D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorHandleCbv(const StrHash resource_id, const uint32_t index, const DescriptorHandles* descriptor_handles) {
   return (*descriptor_handles->cbv_srv_uav_handles)[(*descriptor_handles->handle_index)[resource_id].cbv + index];
 }
+D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorHandleUav(const StrHash resource_id, const uint32_t index, const DescriptorHandles* descriptor_handles) {
+  return (*descriptor_handles->cbv_srv_uav_handles)[(*descriptor_handles->handle_index)[resource_id].uav + index];
+}
 } // namespace boke
 #include "doctest/doctest.h"
 TEST_CASE("descriptors") {
@@ -13,7 +13,7 @@
 namespace {
 using namespace boke;
 uint32_t GetShaderVisibleDescriptorNum(const RenderPassInfo& render_pass_info) {
-  return render_pass_info.cbv_num + render_pass_info.srv_num;
+  return render_pass_info.cbv_num + render_pass_info.srv_num + render_pass_info.uav_num;
 }
 void CopyDescriptorsToShaderVisibleDescriptor(const RenderPassInfo& render_pass_info, const DescriptorHandles* descriptor_handles, const StrHashMap<uint32_t>& current_write_index_list, const uint32_t increment_size, D3d12Device* device, const D3D12_CPU_DESCRIPTOR_HANDLE& dst_handle, const uint32_t dst_handle_num) {
   const uint32_t src_descriptor_num_len = 16;
@@ -46,6 +46,19 @@ void CopyDescriptorsToShaderVisibleDescriptor(const RenderPassInfo& render_pass_
     src_descriptor_num[src_descriptor_num_index] = 1;
     DEBUG_ASSERT(src_descriptor_num_index <= src_descriptor_num_len, DebugAssert{});
   }
+  for (uint32_t i = 0; i < render_pass_info.uav_num; i++) {
+    const auto handle = GetDescriptorHandleUav(render_pass_info.uav[i], GetResourceLocalIndexWrite(current_write_index_list, render_pass_info.uav[i]), descriptor_handles);
+    if (src_descriptor_handles[src_descriptor_num_index].ptr + src_descriptor_num[src_descriptor_num_index] * increment_size == handle.ptr) {
+      src_descriptor_num[src_descriptor_num_index]++;
+      continue;
+    }
+    if (src_descriptor_handles[src_descriptor_num_index].ptr != 0) {
+      src_descriptor_num_index++;
+    }
+    src_descriptor_handles[src_descriptor_num_index].ptr = handle.ptr;
+    src_descriptor_num[src_descriptor_num_index] = 1;
+    DEBUG_ASSERT(src_descriptor_num_index <= src_descriptor_num_len, DebugAssert{});
+  }
   device->CopyDescriptors(1, &dst_handle, &dst_handle_num, src_descriptor_num_index + 1, src_descriptor_handles, src_descriptor_num, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 }
 } // namespace
@@ -0,0 +1,279 @@
+#include "boke/debug_assert.h"
+#include "boke/str_hash.h"
+#include "dxgi_format.h"
+namespace {
+using namespace boke;
+constexpr DxgiFormatInfo kDxgiFormatInfoList[] = {
+  {"UNKNOWN"_id, DXGI_FORMAT_UNKNOWN, 0, false, false, DXGI_FORMAT_UNKNOWN, DXGI_FORMAT_UNKNOWN},
+  {"R32G32B32A32_TYPELESS"_id, DXGI_FORMAT_R32G32B32A32_TYPELESS, 128, false, false, DXGI_FORMAT_R32G32B32A32_TYPELESS, DXGI_FORMAT_R32G32B32A32_TYPELESS},
+  {"R32G32B32A32_FLOAT"_id, DXGI_FORMAT_R32G32B32A32_FLOAT, 128, false, false, DXGI_FORMAT_R32G32B32A32_TYPELESS, DXGI_FORMAT_R32G32B32A32_FLOAT},
+  {"R32G32B32A32_UINT"_id, DXGI_FORMAT_R32G32B32A32_UINT, 128, false, false, DXGI_FORMAT_R32G32B32A32_TYPELESS, DXGI_FORMAT_R32G32B32A32_UINT},
+  {"R32G32B32A32_SINT"_id, DXGI_FORMAT_R32G32B32A32_SINT, 128, false, false, DXGI_FORMAT_R32G32B32A32_TYPELESS, DXGI_FORMAT_R32G32B32A32_SINT},
+  {"R32G32B32_TYPELESS"_id, DXGI_FORMAT_R32G32B32_TYPELESS, 96, false, false, DXGI_FORMAT_R32G32B32_TYPELESS, DXGI_FORMAT_R32G32B32_TYPELESS},
+  {"R32G32B32_FLOAT"_id, DXGI_FORMAT_R32G32B32_FLOAT, 96, false, false, DXGI_FORMAT_R32G32B32_TYPELESS, DXGI_FORMAT_R32G32B32_FLOAT},
+  {"R32G32B32_UINT"_id, DXGI_FORMAT_R32G32B32_UINT, 96, false, false, DXGI_FORMAT_R32G32B32_TYPELESS, DXGI_FORMAT_R32G32B32_UINT},
+  {"R32G32B32_SINT"_id, DXGI_FORMAT_R32G32B32_SINT, 96, false, false, DXGI_FORMAT_R32G32B32_TYPELESS, DXGI_FORMAT_R32G32B32_SINT},
+  {"R16G16B16A16_TYPELESS"_id, DXGI_FORMAT_R16G16B16A16_TYPELESS, 64, false, false, DXGI_FORMAT_R16G16B16A16_TYPELESS, DXGI_FORMAT_R16G16B16A16_TYPELESS},
+  {"R16G16B16A16_FLOAT"_id, DXGI_FORMAT_R16G16B16A16_FLOAT, 64, false, false, DXGI_FORMAT_R16G16B16A16_TYPELESS, DXGI_FORMAT_R16G16B16A16_FLOAT},
+  {"R16G16B16A16_UNORM"_id, DXGI_FORMAT_R16G16B16A16_UNORM, 64, false, false, DXGI_FORMAT_R16G16B16A16_TYPELESS, DXGI_FORMAT_R16G16B16A16_UNORM},
+  {"R16G16B16A16_UINT"_id, DXGI_FORMAT_R16G16B16A16_UINT, 64, false, false, DXGI_FORMAT_R16G16B16A16_TYPELESS, DXGI_FORMAT_R16G16B16A16_UINT},
+  {"R16G16B16A16_SNORM"_id, DXGI_FORMAT_R16G16B16A16_SNORM, 64, false, false, DXGI_FORMAT_R16G16B16A16_TYPELESS, DXGI_FORMAT_R16G16B16A16_SNORM},
+  {"R16G16B16A16_SINT"_id, DXGI_FORMAT_R16G16B16A16_SINT, 64, false, false, DXGI_FORMAT_R16G16B16A16_TYPELESS, DXGI_FORMAT_R16G16B16A16_SINT},
+  {"R32G32_TYPELESS"_id, DXGI_FORMAT_R32G32_TYPELESS, 64, false, false, DXGI_FORMAT_R32G32_TYPELESS, DXGI_FORMAT_R32G32_TYPELESS},
+  {"R32G32_FLOAT"_id, DXGI_FORMAT_R32G32_FLOAT, 64, false, false, DXGI_FORMAT_R32G32_TYPELESS, DXGI_FORMAT_R32G32_FLOAT},
+  {"R32G32_UINT"_id, DXGI_FORMAT_R32G32_UINT, 64, false, false, DXGI_FORMAT_R32G32_TYPELESS, DXGI_FORMAT_R32G32_UINT},
+  {"R32G32_SINT"_id, DXGI_FORMAT_R32G32_SINT, 64, false, false, DXGI_FORMAT_R32G32_TYPELESS, DXGI_FORMAT_R32G32_SINT},
+  {"R32G8X24_TYPELESS"_id, DXGI_FORMAT_R32G8X24_TYPELESS, 64, false, false, DXGI_FORMAT_R32G8X24_TYPELESS, DXGI_FORMAT_R32G8X24_TYPELESS},
+  {"D32_FLOAT_S8X24_UINT"_id, DXGI_FORMAT_D32_FLOAT_S8X24_UINT, 64, true, true, DXGI_FORMAT_R32G8X24_TYPELESS, DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS},
+  {"R32_FLOAT_X8X24_TYPELESS"_id, DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS, 64, false, false, DXGI_FORMAT_R32G8X24_TYPELESS, DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS},
+  {"X32_TYPELESS_G8X24_UINT"_id, DXGI_FORMAT_X32_TYPELESS_G8X24_UINT, 64, false, false, DXGI_FORMAT_R32G8X24_TYPELESS, DXGI_FORMAT_X32_TYPELESS_G8X24_UINT},
+  {"R10G10B10A2_TYPELESS"_id, DXGI_FORMAT_R10G10B10A2_TYPELESS, 32, false, false, DXGI_FORMAT_R10G10B10A2_TYPELESS, DXGI_FORMAT_R10G10B10A2_TYPELESS},
+  {"R10G10B10A2_UNORM"_id, DXGI_FORMAT_R10G10B10A2_UNORM, 32, false, false, DXGI_FORMAT_R10G10B10A2_TYPELESS, DXGI_FORMAT_R10G10B10A2_UNORM},
+  {"R10G10B10A2_UINT"_id, DXGI_FORMAT_R10G10B10A2_UINT, 32, false, false, DXGI_FORMAT_R10G10B10A2_TYPELESS, DXGI_FORMAT_R10G10B10A2_UINT},
+  {"R11G11B10_FLOAT"_id, DXGI_FORMAT_R11G11B10_FLOAT, 32, false, false, DXGI_FORMAT_R11G11B10_FLOAT, DXGI_FORMAT_R11G11B10_FLOAT},
+  {"R8G8B8A8_TYPELESS"_id, DXGI_FORMAT_R8G8B8A8_TYPELESS, 32, false, false, DXGI_FORMAT_R8G8B8A8_TYPELESS, DXGI_FORMAT_R8G8B8A8_TYPELESS},
+  {"R8G8B8A8_UNORM"_id, DXGI_FORMAT_R8G8B8A8_UNORM, 32, false, false, DXGI_FORMAT_R8G8B8A8_TYPELESS, DXGI_FORMAT_R8G8B8A8_UNORM},
+  {"R8G8B8A8_UNORM_SRGB"_id, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 32, false, false, DXGI_FORMAT_R8G8B8A8_TYPELESS, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB},
+  {"R8G8B8A8_UINT"_id, DXGI_FORMAT_R8G8B8A8_UINT, 32, false, false, DXGI_FORMAT_R8G8B8A8_TYPELESS, DXGI_FORMAT_R8G8B8A8_UINT},
+  {"R8G8B8A8_SNORM"_id, DXGI_FORMAT_R8G8B8A8_SNORM, 32, false, false, DXGI_FORMAT_R8G8B8A8_TYPELESS, DXGI_FORMAT_R8G8B8A8_SNORM},
+  {"R8G8B8A8_SINT"_id, DXGI_FORMAT_R8G8B8A8_SINT, 32, false, false, DXGI_FORMAT_R8G8B8A8_TYPELESS, DXGI_FORMAT_R8G8B8A8_SINT},
+  {"R16G16_TYPELESS"_id, DXGI_FORMAT_R16G16_TYPELESS, 32, false, false, DXGI_FORMAT_R16G16_TYPELESS, DXGI_FORMAT_R16G16_TYPELESS},
+  {"R16G16_FLOAT"_id, DXGI_FORMAT_R16G16_FLOAT, 32, false, false, DXGI_FORMAT_R16G16_TYPELESS, DXGI_FORMAT_R16G16_FLOAT},
+  {"R16G16_UNORM"_id, DXGI_FORMAT_R16G16_UNORM, 32, false, false, DXGI_FORMAT_R16G16_TYPELESS, DXGI_FORMAT_R16G16_UNORM},
+  {"R16G16_UINT"_id, DXGI_FORMAT_R16G16_UINT, 32, false, false, DXGI_FORMAT_R16G16_TYPELESS, DXGI_FORMAT_R16G16_UINT},
+  {"R16G16_SNORM"_id, DXGI_FORMAT_R16G16_SNORM, 32, false, false, DXGI_FORMAT_R16G16_TYPELESS, DXGI_FORMAT_R16G16_SNORM},
+  {"R16G16_SINT"_id, DXGI_FORMAT_R16G16_SINT, 32, false, false, DXGI_FORMAT_R16G16_TYPELESS, DXGI_FORMAT_R16G16_SINT},
+  {"R32_TYPELESS"_id, DXGI_FORMAT_R32_TYPELESS, 32, false, false, DXGI_FORMAT_R32_TYPELESS, DXGI_FORMAT_R32_TYPELESS},
+  {"D32_FLOAT"_id, DXGI_FORMAT_D32_FLOAT, 32, true, false, DXGI_FORMAT_R32_TYPELESS, DXGI_FORMAT_R32_FLOAT},
+  {"R32_FLOAT"_id, DXGI_FORMAT_R32_FLOAT, 32, false, false, DXGI_FORMAT_R32_TYPELESS, DXGI_FORMAT_R32_FLOAT},
+  {"R32_UINT"_id, DXGI_FORMAT_R32_UINT, 32, false, false, DXGI_FORMAT_R32_TYPELESS, DXGI_FORMAT_R32_UINT},
+  {"R32_SINT"_id, DXGI_FORMAT_R32_SINT, 32, false, false, DXGI_FORMAT_R32_TYPELESS, DXGI_FORMAT_R32_SINT},
+  {"R24G8_TYPELESS"_id, DXGI_FORMAT_R24G8_TYPELESS, 32, false, false, DXGI_FORMAT_R24G8_TYPELESS, DXGI_FORMAT_R24G8_TYPELESS},
+  {"D24_UNORM_S8_UINT"_id, DXGI_FORMAT_D24_UNORM_S8_UINT, 32, true, true, DXGI_FORMAT_R24G8_TYPELESS, DXGI_FORMAT_R24_UNORM_X8_TYPELESS},
+  {"R24_UNORM_X8_TYPELESS"_id, DXGI_FORMAT_R24_UNORM_X8_TYPELESS, 32, false, false, DXGI_FORMAT_R24G8_TYPELESS, DXGI_FORMAT_R24_UNORM_X8_TYPELESS},
+  {"X24_TYPELESS_G8_UINT"_id, DXGI_FORMAT_X24_TYPELESS_G8_UINT, 32, false, false, DXGI_FORMAT_R24G8_TYPELESS, DXGI_FORMAT_X24_TYPELESS_G8_UINT},
+  {"R8G8_TYPELESS"_id, DXGI_FORMAT_R8G8_TYPELESS, 16, false, false, DXGI_FORMAT_R8G8_TYPELESS, DXGI_FORMAT_R8G8_TYPELESS},
+  {"R8G8_UNORM"_id, DXGI_FORMAT_R8G8_UNORM, 16, false, false, DXGI_FORMAT_R8G8_TYPELESS, DXGI_FORMAT_R8G8_UNORM},
+  {"R8G8_UINT"_id, DXGI_FORMAT_R8G8_UINT, 16, false, false, DXGI_FORMAT_R8G8_TYPELESS, DXGI_FORMAT_R8G8_UINT},
+  {"R8G8_SNORM"_id, DXGI_FORMAT_R8G8_SNORM, 16, false, false, DXGI_FORMAT_R8G8_TYPELESS, DXGI_FORMAT_R8G8_SNORM},
+  {"R8G8_SINT"_id, DXGI_FORMAT_R8G8_SINT, 16, false, false, DXGI_FORMAT_R8G8_TYPELESS, DXGI_FORMAT_R8G8_SINT},
+  {"R16_TYPELESS"_id, DXGI_FORMAT_R16_TYPELESS, 16, false, false, DXGI_FORMAT_R16_TYPELESS, DXGI_FORMAT_R16_TYPELESS},
+  {"R16_FLOAT"_id, DXGI_FORMAT_R16_FLOAT, 16, false, false, DXGI_FORMAT_R16_TYPELESS, DXGI_FORMAT_R16_FLOAT},
+  {"D16_UNORM"_id, DXGI_FORMAT_D16_UNORM, 16, true, false, DXGI_FORMAT_R16_TYPELESS, DXGI_FORMAT_R16_UNORM},
+  {"R16_UNORM"_id, DXGI_FORMAT_R16_UNORM, 16, false, false, DXGI_FORMAT_R16_TYPELESS, DXGI_FORMAT_R16_UNORM},
+  {"R16_UINT"_id, DXGI_FORMAT_R16_UINT, 16, false, false, DXGI_FORMAT_R16_TYPELESS, DXGI_FORMAT_R16_UINT},
+  {"R16_SNORM"_id, DXGI_FORMAT_R16_SNORM, 16, false, false, DXGI_FORMAT_R16_TYPELESS, DXGI_FORMAT_R16_SNORM},
+  {"R16_SINT"_id, DXGI_FORMAT_R16_SINT, 16, false, false, DXGI_FORMAT_R16_TYPELESS, DXGI_FORMAT_R16_SINT},
+  {"R8_TYPELESS"_id, DXGI_FORMAT_R8_TYPELESS, 8, false, false, DXGI_FORMAT_R8_TYPELESS, DXGI_FORMAT_R8_TYPELESS},
+  {"R8_UNORM"_id, DXGI_FORMAT_R8_UNORM, 8, false, false, DXGI_FORMAT_R8_TYPELESS, DXGI_FORMAT_R8_UNORM},
+  {"R8_UINT"_id, DXGI_FORMAT_R8_UINT, 8, false, false, DXGI_FORMAT_R8_TYPELESS, DXGI_FORMAT_R8_UINT},
+  {"R8_SNORM"_id, DXGI_FORMAT_R8_SNORM, 8, false, false, DXGI_FORMAT_R8_TYPELESS, DXGI_FORMAT_R8_SNORM},
+  {"R8_SINT"_id, DXGI_FORMAT_R8_SINT, 8, false, false, DXGI_FORMAT_R8_TYPELESS, DXGI_FORMAT_R8_SINT},
+  {"A8_UNORM"_id, DXGI_FORMAT_A8_UNORM, 8, false, false, DXGI_FORMAT_A8_UNORM, DXGI_FORMAT_A8_UNORM},
+  {"R1_UNORM"_id, DXGI_FORMAT_R1_UNORM, 1, false, false, DXGI_FORMAT_R1_UNORM, DXGI_FORMAT_R1_UNORM},
+  {"R9G9B9E5_SHAREDEXP"_id, DXGI_FORMAT_R9G9B9E5_SHAREDEXP, 32, false, false, DXGI_FORMAT_R9G9B9E5_SHAREDEXP, DXGI_FORMAT_R9G9B9E5_SHAREDEXP},
+  {"R8G8_B8G8_UNORM"_id, DXGI_FORMAT_R8G8_B8G8_UNORM, 16, false, false, DXGI_FORMAT_R8G8_B8G8_UNORM, DXGI_FORMAT_R8G8_B8G8_UNORM},
+  {"G8R8_G8B8_UNORM"_id, DXGI_FORMAT_G8R8_G8B8_UNORM, 16, false, false, DXGI_FORMAT_G8R8_G8B8_UNORM, DXGI_FORMAT_G8R8_G8B8_UNORM},
+  {"BC1_TYPELESS"_id, DXGI_FORMAT_BC1_TYPELESS, 4, false, false, DXGI_FORMAT_BC1_TYPELESS, DXGI_FORMAT_BC1_TYPELESS},
+  {"BC1_UNORM"_id, DXGI_FORMAT_BC1_UNORM, 4, false, false, DXGI_FORMAT_BC1_TYPELESS, DXGI_FORMAT_BC1_UNORM},
+  {"BC1_UNORM_SRGB"_id, DXGI_FORMAT_BC1_UNORM_SRGB, 4, false, false, DXGI_FORMAT_BC1_TYPELESS, DXGI_FORMAT_BC1_UNORM_SRGB},
+  {"BC2_TYPELESS"_id, DXGI_FORMAT_BC2_TYPELESS, 8, false, false, DXGI_FORMAT_BC2_TYPELESS, DXGI_FORMAT_BC2_TYPELESS},
+  {"BC2_UNORM"_id, DXGI_FORMAT_BC2_UNORM, 8, false, false, DXGI_FORMAT_BC2_TYPELESS, DXGI_FORMAT_BC2_UNORM},
+  {"BC2_UNORM_SRGB"_id, DXGI_FORMAT_BC2_UNORM_SRGB, 8, false, false, DXGI_FORMAT_BC2_TYPELESS, DXGI_FORMAT_BC2_UNORM_SRGB},
+  {"BC3_TYPELESS"_id, DXGI_FORMAT_BC3_TYPELESS, 8, false, false, DXGI_FORMAT_BC3_TYPELESS, DXGI_FORMAT_BC3_TYPELESS},
+  {"BC3_UNORM"_id, DXGI_FORMAT_BC3_UNORM, 8, false, false, DXGI_FORMAT_BC3_TYPELESS, DXGI_FORMAT_BC3_UNORM},
+  {"BC3_UNORM_SRGB"_id, DXGI_FORMAT_BC3_UNORM_SRGB, 8, false, false, DXGI_FORMAT_BC3_TYPELESS, DXGI_FORMAT_BC3_UNORM_SRGB},
+  {"BC4_TYPELESS"_id, DXGI_FORMAT_BC4_TYPELESS, 4, false, false, DXGI_FORMAT_BC4_TYPELESS, DXGI_FORMAT_BC4_TYPELESS},
+  {"BC4_UNORM"_id, DXGI_FORMAT_BC4_UNORM, 4, false, false, DXGI_FORMAT_BC4_TYPELESS, DXGI_FORMAT_BC4_UNORM},
+  {"BC4_SNORM"_id, DXGI_FORMAT_BC4_SNORM, 4, false, false, DXGI_FORMAT_BC4_TYPELESS, DXGI_FORMAT_BC4_SNORM},
+  {"BC5_TYPELESS"_id, DXGI_FORMAT_BC5_TYPELESS, 8, false, false, DXGI_FORMAT_BC5_TYPELESS, DXGI_FORMAT_BC5_TYPELESS},
+  {"BC5_UNORM"_id, DXGI_FORMAT_BC5_UNORM, 8, false, false, DXGI_FORMAT_BC5_TYPELESS, DXGI_FORMAT_BC5_UNORM},
+  {"BC5_SNORM"_id, DXGI_FORMAT_BC5_SNORM, 8, false, false, DXGI_FORMAT_BC5_TYPELESS, DXGI_FORMAT_BC5_SNORM},
+  {"B5G6R5_UNORM"_id, DXGI_FORMAT_B5G6R5_UNORM, 16, false, false, DXGI_FORMAT_B5G6R5_UNORM, DXGI_FORMAT_B5G6R5_UNORM},
+  {"B5G5R5A1_UNORM"_id, DXGI_FORMAT_B5G5R5A1_UNORM, 16, false, false, DXGI_FORMAT_B5G5R5A1_UNORM, DXGI_FORMAT_B5G5R5A1_UNORM},
+  {"B8G8R8A8_UNORM"_id, DXGI_FORMAT_B8G8R8A8_UNORM, 32, false, false, DXGI_FORMAT_B8G8R8A8_TYPELESS, DXGI_FORMAT_B8G8R8A8_UNORM},
+  {"B8G8R8X8_UNORM"_id, DXGI_FORMAT_B8G8R8X8_UNORM, 32, false, false, DXGI_FORMAT_B8G8R8X8_TYPELESS, DXGI_FORMAT_B8G8R8X8_UNORM},
+  {"R10G10B10_XR_BIAS_A2_UNORM"_id, DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM, 32, false, false, DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM, DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM},
+  {"B8G8R8A8_TYPELESS"_id, DXGI_FORMAT_B8G8R8A8_TYPELESS, 32, false, false, DXGI_FORMAT_B8G8R8A8_TYPELESS, DXGI_FORMAT_B8G8R8A8_TYPELESS},
+  {"B8G8R8A8_UNORM_SRGB"_id, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, 32, false, false, DXGI_FORMAT_B8G8R8A8_TYPELESS, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB},
+  {"B8G8R8X8_TYPELESS"_id, DXGI_FORMAT_B8G8R8X8_TYPELESS, 32, false, false, DXGI_FORMAT_B8G8R8X8_TYPELESS, DXGI_FORMAT_B8G8R8X8_TYPELESS},
+  {"B8G8R8X8_UNORM_SRGB"_id, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB, 32, false, false, DXGI_FORMAT_B8G8R8X8_TYPELESS, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB},
+  {"BC6H_TYPELESS"_id, DXGI_FORMAT_BC6H_TYPELESS, 8, false, false, DXGI_FORMAT_BC6H_TYPELESS, DXGI_FORMAT_BC6H_TYPELESS},
+  {"BC6H_UF16"_id, DXGI_FORMAT_BC6H_UF16, 8, false, false, DXGI_FORMAT_BC6H_TYPELESS, DXGI_FORMAT_BC6H_UF16},
+  {"BC6H_SF16"_id, DXGI_FORMAT_BC6H_SF16, 8, false, false, DXGI_FORMAT_BC6H_TYPELESS, DXGI_FORMAT_BC6H_SF16},
+  {"BC7_TYPELESS"_id, DXGI_FORMAT_BC7_TYPELESS, 8, false, false, DXGI_FORMAT_BC7_TYPELESS, DXGI_FORMAT_BC7_TYPELESS},
+  {"BC7_UNORM"_id, DXGI_FORMAT_BC7_UNORM, 8, false, false, DXGI_FORMAT_BC7_TYPELESS, DXGI_FORMAT_BC7_UNORM},
+  {"BC7_UNORM_SRGB"_id, DXGI_FORMAT_BC7_UNORM_SRGB, 8, false, false, DXGI_FORMAT_BC7_TYPELESS, DXGI_FORMAT_BC7_UNORM_SRGB},
+  {"AYUV"_id, DXGI_FORMAT_AYUV, 32, false, false, DXGI_FORMAT_AYUV, DXGI_FORMAT_AYUV},
+  {"Y410"_id, DXGI_FORMAT_Y410, 32, false, false, DXGI_FORMAT_Y410, DXGI_FORMAT_Y410},
+  {"Y416"_id, DXGI_FORMAT_Y416, 64, false, false, DXGI_FORMAT_Y416, DXGI_FORMAT_Y416},
+  {"NV12"_id, DXGI_FORMAT_NV12, 12, false, false, DXGI_FORMAT_NV12, DXGI_FORMAT_NV12},
+  {"P010"_id, DXGI_FORMAT_P010, 24, false, false, DXGI_FORMAT_P010, DXGI_FORMAT_P010},
+  {"P016"_id, DXGI_FORMAT_P016, 24, false, false, DXGI_FORMAT_P016, DXGI_FORMAT_P016},
+  {"420_OPAQUE"_id, DXGI_FORMAT_420_OPAQUE, 12, false, false, DXGI_FORMAT_420_OPAQUE, DXGI_FORMAT_420_OPAQUE},
+  {"YUY2"_id, DXGI_FORMAT_YUY2, 16, false, false, DXGI_FORMAT_YUY2, DXGI_FORMAT_YUY2},
+  {"Y210"_id, DXGI_FORMAT_Y210, 32, false, false, DXGI_FORMAT_Y210, DXGI_FORMAT_Y210},
+  {"Y216"_id, DXGI_FORMAT_Y216, 32, false, false, DXGI_FORMAT_Y216, DXGI_FORMAT_Y216},
+  {"NV11"_id, DXGI_FORMAT_NV11, 12, false, false, DXGI_FORMAT_NV11, DXGI_FORMAT_NV11},
+  {"AI44"_id, DXGI_FORMAT_AI44, 8, false, false, DXGI_FORMAT_AI44, DXGI_FORMAT_AI44},
+  {"IA44"_id, DXGI_FORMAT_IA44, 8, false, false, DXGI_FORMAT_IA44, DXGI_FORMAT_IA44},
+  {"P8"_id, DXGI_FORMAT_P8, 8, false, false, DXGI_FORMAT_P8, DXGI_FORMAT_P8},
+  {"A8P8"_id, DXGI_FORMAT_A8P8, 16, false, false, DXGI_FORMAT_A8P8, DXGI_FORMAT_A8P8},
+  {"B4G4R4A4_UNORM"_id, DXGI_FORMAT_B4G4R4A4_UNORM, 16, false, false, DXGI_FORMAT_B4G4R4A4_UNORM, DXGI_FORMAT_B4G4R4A4_UNORM},
+  {"P208"_id, DXGI_FORMAT_P208, 16, false, false, DXGI_FORMAT_P208, DXGI_FORMAT_P208},
+  {"V208"_id, DXGI_FORMAT_V208, 16, false, false, DXGI_FORMAT_V208, DXGI_FORMAT_V208},
+  {"V408"_id, DXGI_FORMAT_V408, 24, false, false, DXGI_FORMAT_V408, DXGI_FORMAT_V408},
+  {"SAMPLER_FEEDBACK_MIN_MIP_OPAQUE"_id, DXGI_FORMAT_SAMPLER_FEEDBACK_MIN_MIP_OPAQUE, 0, false, false, DXGI_FORMAT_SAMPLER_FEEDBACK_MIN_MIP_OPAQUE, DXGI_FORMAT_SAMPLER_FEEDBACK_MIN_MIP_OPAQUE},
+  {"SAMPLER_FEEDBACK_MIP_REGION_USED_OPAQUE"_id, DXGI_FORMAT_SAMPLER_FEEDBACK_MIP_REGION_USED_OPAQUE, 0, false, false, DXGI_FORMAT_SAMPLER_FEEDBACK_MIP_REGION_USED_OPAQUE, DXGI_FORMAT_SAMPLER_FEEDBACK_MIP_REGION_USED_OPAQUE},
+  {"A4B4G4R4_UNORM"_id, DXGI_FORMAT_A4B4G4R4_UNORM, 16, false, false, DXGI_FORMAT_A4B4G4R4_UNORM, DXGI_FORMAT_A4B4G4R4_UNORM},
+};
+constexpr uint32_t kDxgiFormatInfoNum = sizeof(kDxgiFormatInfoList) / sizeof(kDxgiFormatInfoList[0]);
+constexpr uint32_t kDxgiFormatValueNum = DXGI_FORMAT_A4B4G4R4_UNORM + 1;
+constexpr uint32_t kNameTableSize = 512; // power of two, about four times kDxgiFormatInfoNum to keep probing short.
+constexpr uint8_t kInvalidIndex = 0xFF;
+static_assert(kDxgiFormatInfoNum < kInvalidIndex);
+/**
+ * open addressing table from name hash to kDxgiFormatInfoList index.
+ **/
+struct NameTable {
+  uint8_t index[kNameTableSize]{};
+};
+/**
+ * kDxgiFormatInfoList index for each DXGI_FORMAT value.
+ **/
+struct FormatTable {
+  uint8_t index[kDxgiFormatValueNum]{};
+};
+constexpr auto CreateNameTable() {
+  NameTable table{};
+  for (auto& index : table.index) {
+    index = kInvalidIndex;
+  }
+  for (uint32_t i = 0; i < kDxgiFormatInfoNum; i++) {
+    auto slot = static_cast<uint32_t>(kDxgiFormatInfoList[i].name & (kNameTableSize - 1));
+    while (table.index[slot] != kInvalidIndex) {
+      slot = (slot + 1) & (kNameTableSize - 1);
+    }
+    table.index[slot] = static_cast<uint8_t>(i);
+  }
+  return table;
+}
+constexpr auto CreateFormatTable() {
+  FormatTable table{};
+  for (auto& index : table.index) {
+    index = kInvalidIndex;
+  }
+  for (uint32_t i = 0; i < kDxgiFormatInfoNum; i++) {
+    table.index[kDxgiFormatInfoList[i].format] = static_cast<uint8_t>(i);
+  }
+  return table;
+}
+constexpr auto kNameTable = CreateNameTable();
+constexpr auto kFormatTable = CreateFormatTable();
+constexpr auto FindDxgiFormatInfo(const StrHash name) {
+  auto slot = static_cast<uint32_t>(name & (kNameTableSize - 1));
+  while (kNameTable.index[slot] != kInvalidIndex) {
+    const auto& info = kDxgiFormatInfoList[kNameTable.index[slot]];
+    if (info.name == name) { return &info; }
+    slot = (slot + 1) & (kNameTableSize - 1);
+  }
+  return static_cast<const DxgiFormatInfo*>(nullptr);
+}
+constexpr auto IsDxgiFormatTableValid() {
+  // fails on duplicated names or formats and on typeless/srv variants missing from the table.
+  for (uint32_t i = 0; i < kDxgiFormatInfoNum; i++) {
+    const auto& info = kDxgiFormatInfoList[i];
+    if (FindDxgiFormatInfo(info.name) != &info) { return false; }
+    if (kFormatTable.index[info.format] != i) { return false; }
+    if (kFormatTable.index[info.typeless_format] == kInvalidIndex) { return false; }
+    if (kFormatTable.index[info.srv_format] == kInvalidIndex) { return false; }
+  }
+  return true;
+}
+static_assert(IsDxgiFormatTableValid());
+} // namespace
+namespace boke {
+bool FindDxgiFormat(const StrHash name, DXGI_FORMAT* dxgi_format) {
+  const auto info = FindDxgiFormatInfo(name);
+  if (info == nullptr) { return false; }
+  *dxgi_format = info->format;
+  return true;
+}
+bool FindDxgiFormat(const char* const name, DXGI_FORMAT* dxgi_format) {
+  // names are not registered to the str hash database.
+  return FindDxgiFormat(foonathan::string_id::detail::sid_hash(name), dxgi_format);
+}
+DXGI_FORMAT GetDxgiFormat(const char* const name) {
+  auto dxgi_format = DXGI_FORMAT_UNKNOWN;
+  if (FindDxgiFormat(name, &dxgi_format)) {
+    return dxgi_format;
+  }
+  DEBUG_ASSERT(false, DebugAssert{});
+  return DXGI_FORMAT_R8G8B8A8_UNORM;
+}
+const DxgiFormatInfo* GetDxgiFormatInfo(const DXGI_FORMAT format) {
+  const auto value = static_cast<uint32_t>(format);
+  if (value >= kDxgiFormatValueNum || kFormatTable.index[value] == kInvalidIndex) { return nullptr; }
+  return &kDxgiFormatInfoList[kFormatTable.index[value]];
+}
+DXGI_FORMAT GetTypelessFormat(const DXGI_FORMAT format) {
+  const auto info = GetDxgiFormatInfo(format);
+  DEBUG_ASSERT(info != nullptr, DebugAssert{});
+  return info ? info->typeless_format : format;
+}
+DXGI_FORMAT GetSrvValidFormat(const DXGI_FORMAT format) {
+  const auto info = GetDxgiFormatInfo(format);
+  DEBUG_ASSERT(info != nullptr, DebugAssert{});
+  return info ? info->srv_format : format;
+}
+bool IsDepthStencilFormat(const DXGI_FORMAT format) {
+  const auto info = GetDxgiFormatInfo(format);
+  return info != nullptr && (info->depth || info->stencil);
+}
+uint32_t GetPlaneNum(const DXGI_FORMAT format) {
+  const auto info = GetDxgiFormatInfo(format);
+  if (info == nullptr) { return 1; }
+  return (info->typeless_format == DXGI_FORMAT_R24G8_TYPELESS || info->typeless_format == DXGI_FORMAT_R32G8X24_TYPELESS) ? 2 : 1;
+}
+} // namespace boke
+#include "doctest/doctest.h"
+TEST_CASE("dxgi format") {
+  using namespace boke;
+  DXGI_FORMAT format{};
+  CHECK_UNARY(FindDxgiFormat("R8G8B8A8_UNORM"_id, &format));
+  CHECK_EQ(format, DXGI_FORMAT_R8G8B8A8_UNORM);
+  CHECK_UNARY(FindDxgiFormat("UNKNOWN"_id, &format));
+  CHECK_EQ(format, DXGI_FORMAT_UNKNOWN);
+  CHECK_UNARY(FindDxgiFormat("BC7_UNORM_SRGB"_id, &format));
+  CHECK_EQ(format, DXGI_FORMAT_BC7_UNORM_SRGB);
+  CHECK_UNARY(FindDxgiFormat("420_OPAQUE"_id, &format));
+  CHECK_EQ(format, DXGI_FORMAT_420_OPAQUE);
+  format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+  CHECK_UNARY_FALSE(FindDxgiFormat("R8G8B8A8_UNROM"_id, &format));
+  CHECK_UNARY_FALSE(FindDxgiFormat("DXGI_FORMAT_R8G8B8A8_UNORM"_id, &format));
+  CHECK_EQ(format, DXGI_FORMAT_R16G16B16A16_FLOAT);
+  CHECK_UNARY(FindDxgiFormat("D24_UNORM_S8_UINT", &format));
+  CHECK_EQ(format, DXGI_FORMAT_D24_UNORM_S8_UINT);
+  CHECK_EQ(GetDxgiFormat("R10G10B10A2_UNORM"), DXGI_FORMAT_R10G10B10A2_UNORM);
+  CHECK_EQ(GetDxgiFormatInfo(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)->bits_per_pixel, 32);
+  CHECK_EQ(GetDxgiFormatInfo(DXGI_FORMAT_R16G16B16A16_FLOAT)->bits_per_pixel, 64);
+  CHECK_EQ(GetDxgiFormatInfo(DXGI_FORMAT_BC1_UNORM)->bits_per_pixel, 4);
+  CHECK_EQ(GetDxgiFormatInfo(static_cast<DXGI_FORMAT>(120)), nullptr);
+  CHECK_EQ(GetTypelessFormat(DXGI_FORMAT_D24_UNORM_S8_UINT), DXGI_FORMAT_R24G8_TYPELESS);
+  CHECK_EQ(GetSrvValidFormat(DXGI_FORMAT_D24_UNORM_S8_UINT), DXGI_FORMAT_R24_UNORM_X8_TYPELESS);
+  CHECK_EQ(GetTypelessFormat(DXGI_FORMAT_D32_FLOAT), DXGI_FORMAT_R32_TYPELESS);
+  CHECK_EQ(GetSrvValidFormat(DXGI_FORMAT_D32_FLOAT), DXGI_FORMAT_R32_FLOAT);
+  CHECK_EQ(GetTypelessFormat(DXGI_FORMAT_B8G8R8A8_UNORM_SRGB), DXGI_FORMAT_B8G8R8A8_TYPELESS);
+  CHECK_EQ(GetTypelessFormat(DXGI_FORMAT_R11G11B10_FLOAT), DXGI_FORMAT_R11G11B10_FLOAT);
+  CHECK_EQ(GetSrvValidFormat(DXGI_FORMAT_R10G10B10A2_UNORM), DXGI_FORMAT_R10G10B10A2_UNORM);
+  CHECK_UNARY(IsDepthStencilFormat(DXGI_FORMAT_D16_UNORM));
+  CHECK_UNARY(IsDepthStencilFormat(DXGI_FORMAT_D32_FLOAT_S8X24_UINT));
+  CHECK_UNARY_FALSE(IsDepthStencilFormat(DXGI_FORMAT_R24_UNORM_X8_TYPELESS));
+  CHECK_UNARY(GetDxgiFormatInfo(DXGI_FORMAT_D32_FLOAT_S8X24_UINT)->stencil);
+  CHECK_UNARY_FALSE(GetDxgiFormatInfo(DXGI_FORMAT_D32_FLOAT)->stencil);
+  CHECK_EQ(GetPlaneNum(DXGI_FORMAT_D24_UNORM_S8_UINT), 2);
+  CHECK_EQ(GetPlaneNum(DXGI_FORMAT_R24G8_TYPELESS), 2);
+  CHECK_EQ(GetPlaneNum(DXGI_FORMAT_D32_FLOAT_S8X24_UINT), 2);
+  CHECK_EQ(GetPlaneNum(DXGI_FORMAT_D32_FLOAT), 1);
+  CHECK_EQ(GetPlaneNum(DXGI_FORMAT_R8G8B8A8_UNORM), 1);
+}
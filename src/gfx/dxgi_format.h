@@ -0,0 +1,29 @@
+#pragma once
+namespace boke {
+struct DxgiFormatInfo {
+  StrHash name{};                  // hash of the name without "DXGI_FORMAT_" used in configs
+  DXGI_FORMAT format{};
+  uint16_t bits_per_pixel{};       // averaged per pixel for block compressed and packed formats
+  bool depth{};
+  bool stencil{};
+  DXGI_FORMAT typeless_format{};   // format itself if it has no typeless family
+  DXGI_FORMAT srv_format{};        // format to read depth formats in shaders, format itself otherwise
+};
+/**
+ * lookups go through constexpr tables keyed by str hash or by format value, no string is compared.
+ **/
+bool FindDxgiFormat(const StrHash name, DXGI_FORMAT* dxgi_format);
+bool FindDxgiFormat(const char* const name, DXGI_FORMAT* dxgi_format);
+DXGI_FORMAT GetDxgiFormat(const char* const name);
+/**
+ * returns nullptr for formats not in the table.
+ **/
+const DxgiFormatInfo* GetDxgiFormatInfo(const DXGI_FORMAT format);
+DXGI_FORMAT GetTypelessFormat(const DXGI_FORMAT format);
+DXGI_FORMAT GetSrvValidFormat(const DXGI_FORMAT format);
+bool IsDepthStencilFormat(const DXGI_FORMAT format);
+/**
+ * 2 for formats of the depth stencil families (depth and stencil planes), 1 otherwise.
+ **/
+uint32_t GetPlaneNum(const DXGI_FORMAT format);
+}
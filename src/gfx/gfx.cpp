@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <memory>
 #include <numeric>
 #include <wchar.h>
 #include <Windows.h>
@@ -9,17 +10,28 @@
 #include "boke/allocator.h"
 #include "boke/container.h"
 #include "boke/debug_assert.h"
+#include "boke/file_loader.h"
+#include "boke/job_system.h"
 #include "boke/str_hash.h"
 #include "boke/util.h"
 #include "barrier_config.h"
+#include "command_list_state_cache.h"
 #include "core.h"
 #include "descriptors.h"
 #include "descriptors_shader_visible.h"
+#include "dxgi_format.h"
 #include "imgui_util.h"
 #include "json.h"
 #include "material.h"
 #include "render_pass_info.h"
 #include "resources.h"
+#include "config_loader.h"
+#include "config_validation.h"
+#include "baked_config.h"
+#include "render_graph.h"
+#include "render_pass_scheduler.h"
+#include "resource_aliasing.h"
+#include "queue_schedule.h"
 #include "string_util.h"
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 namespace {
@@ -55,19 +67,12 @@ LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
   }
   return ::DefWindowProcW(hWnd, msg, wParam, lParam);
 }
-auto GetPrimarybufferSize(const rapidjson::Value& json) {
+auto GetPrimarybufferSize(const JsonValue& json) {
   return Size2d{
     .width = json["screen_width"].GetUint(),
     .height = json["screen_height"].GetUint(),
   };
 }
-auto GetSwapchainBufferSize(const rapidjson::Value& json) {
-  const auto& swapchain_size = json["swapchain"]["size"];
-  return Size2d{
-    .width = swapchain_size[0].GetUint(),
-    .height = swapchain_size[1].GetUint(),
-  };
-}
 struct WindowInfo {
   HWND hwnd{};
   LPWSTR class_name{};
@@ -184,6 +189,7 @@ auto CreateCommandList(D3d12Device* device, const D3D12_COMMAND_LIST_TYPE type)
 auto StartCommandListRecording(D3d12CommandList* command_list, D3d12CommandAllocator* command_allocator, const uint32_t descriptor_heap_num, ID3D12DescriptorHeap** descriptor_heaps) {
   const auto hr = command_list->Reset(command_allocator, nullptr);
   DEBUG_ASSERT(SUCCEEDED(hr), DebugAssert{});
+  if (descriptor_heap_num == 0) { return; } // copy queue
   command_list->SetDescriptorHeaps(descriptor_heap_num, descriptor_heaps);
 }
 auto EndCommandListRecording(D3d12CommandList* command_list) {
@@ -286,7 +292,6 @@ auto ReleaseGfxCore(GfxCoreUnit& core) {
   ReleaseWin32Window(core.window_info);
 }
 struct RenderPassFuncCommonParams {
-  StrHashMap<uint32_t>& current_write_index_list;
   ResourceSet* resource_set;
   DescriptorHandles* descriptor_handles;
   MaterialSet* material_set;
@@ -295,59 +300,60 @@ struct RenderPassFuncCommonParams {
 struct RenderPassFuncIndividualParams {
   RenderPassInfo& render_pass_info;
   D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle;
+  // resolved by write indices at the pass, passes are recorded after every pass is resolved.
+  const D3D12_CPU_DESCRIPTOR_HANDLE* rtv_handles;
+  D3D12_CPU_DESCRIPTOR_HANDLE dsv_handle;
+  // shared by passes recorded to the same command list.
+  CommandListStateCache* state_cache;
 };
-void SetViewportAndScissor(const Size2d& size, D3d12CommandList* command_list) {
+void SetViewportAndScissor(const Size2d& size, CommandListStateCache* state_cache, D3d12CommandList* command_list) {
   {
     D3D12_VIEWPORT viewport{0.0f, 0.0f, static_cast<float>(size.width), static_cast<float>(size.height), D3D12_MIN_DEPTH, D3D12_MAX_DEPTH};
-    command_list->RSSetViewports(1, &viewport);
+    SetViewportCached(viewport, state_cache, command_list);
   }
   {
     D3D12_RECT scissor_rect{0L, 0L, static_cast<LONG>(size.width), static_cast<LONG>(size.height)};
-    command_list->RSSetScissorRects(1, &scissor_rect);
+    SetScissorRectCached(scissor_rect, state_cache, command_list);
   }
 }
-void SetRtvAndDsv(const RenderPassFuncCommonParams& common_params, const RenderPassFuncIndividualParams& pass_params, D3d12CommandList* command_list) {
-  const uint32_t max_rtv_num = 8;
-  D3D12_CPU_DESCRIPTOR_HANDLE rtv_handles[max_rtv_num]{};
-  for (uint32_t i = 0; i < pass_params.render_pass_info.rtv_num; i++) {
-    rtv_handles[i] = GetDescriptorHandleRtv(pass_params.render_pass_info.rtv[i], GetResourceLocalIndexWrite(common_params.current_write_index_list, pass_params.render_pass_info.rtv[i]), common_params.descriptor_handles);
-  }
+void SetRtvAndDsv(const RenderPassFuncIndividualParams& pass_params, D3d12CommandList* command_list) {
   if (pass_params.render_pass_info.dsv == kEmptyStr) {
-    command_list->OMSetRenderTargets(pass_params.render_pass_info.rtv_num, rtv_handles, false, nullptr);
+    command_list->OMSetRenderTargets(pass_params.render_pass_info.rtv_num, pass_params.rtv_handles, false, nullptr);
     return;
   }
-  const auto dsv_handle = GetDescriptorHandleDsv(pass_params.render_pass_info.dsv, GetResourceLocalIndexWrite(common_params.current_write_index_list, pass_params.render_pass_info.dsv), common_params.descriptor_handles);
-  command_list->OMSetRenderTargets(pass_params.render_pass_info.rtv_num, rtv_handles, false, &dsv_handle);
+  command_list->OMSetRenderTargets(pass_params.render_pass_info.rtv_num, pass_params.rtv_handles, false, &pass_params.dsv_handle);
 }
 void RenderPassGeometry(const RenderPassFuncCommonParams& common_params, const RenderPassFuncIndividualParams& pass_params, D3d12CommandList* command_list) {
-  SetViewportAndScissor(common_params.primarybuffer_size, command_list);
-  SetRtvAndDsv(common_params, pass_params, command_list);
-  const auto& material_id = pass_params.render_pass_info.material_id;
-  command_list->SetGraphicsRootSignature(GetRootsig(common_params.material_set, material_id));
+  const auto material_id = GetReadyMaterial(common_params.material_set, pass_params.render_pass_info.material_id);
+  if (material_id == kEmptyStr) { return; } // neither the material nor its fallback is compiled yet.
+  SetViewportAndScissor(common_params.primarybuffer_size, pass_params.state_cache, command_list);
+  SetRtvAndDsv(pass_params, command_list);
+  SetRootsigCached(GetRootsig(common_params.material_set, material_id), pass_params.state_cache, command_list);
   if (pass_params.gpu_handle.ptr) {
     command_list->SetGraphicsRootDescriptorTable(0, pass_params.gpu_handle);
   }
-  command_list->OMSetStencilRef(pass_params.render_pass_info.stencil_val);
-  command_list->SetPipelineState(GetPso(common_params.material_set, material_id));
+  SetStencilRefCached(pass_params.render_pass_info.stencil_val, pass_params.state_cache, command_list);
+  SetPsoCached(GetPso(common_params.material_set, material_id), pass_params.state_cache, command_list);
   command_list->DispatchMesh(1, 1, 1);
 }
 void RenderPassPostProcess(const RenderPassFuncCommonParams& common_params, const RenderPassFuncIndividualParams& pass_params, D3d12CommandList* command_list) {
-  SetViewportAndScissor(common_params.primarybuffer_size, command_list);
-  SetRtvAndDsv(common_params, pass_params, command_list);
-  const auto& material_id = pass_params.render_pass_info.material_id;
-  command_list->SetGraphicsRootSignature(GetRootsig(common_params.material_set, material_id));
+  const auto material_id = GetReadyMaterial(common_params.material_set, pass_params.render_pass_info.material_id);
+  if (material_id == kEmptyStr) { return; } // neither the material nor its fallback is compiled yet.
+  SetViewportAndScissor(common_params.primarybuffer_size, pass_params.state_cache, command_list);
+  SetRtvAndDsv(pass_params, command_list);
+  SetRootsigCached(GetRootsig(common_params.material_set, material_id), pass_params.state_cache, command_list);
   if (pass_params.gpu_handle.ptr) {
     command_list->SetGraphicsRootDescriptorTable(0, pass_params.gpu_handle);
   }
-  command_list->OMSetStencilRef(pass_params.render_pass_info.stencil_val);
-  command_list->SetPipelineState(GetPso(common_params.material_set, material_id));
+  SetStencilRefCached(pass_params.render_pass_info.stencil_val, pass_params.state_cache, command_list);
+  SetPsoCached(GetPso(common_params.material_set, material_id), pass_params.state_cache, command_list);
   command_list->DispatchMesh(1, 1, 1);
 }
 void RenderPassNoOp(const RenderPassFuncCommonParams&, const RenderPassFuncIndividualParams&, D3d12CommandList*) {}
-void RenderPassImgui(const RenderPassFuncCommonParams& common_params, const RenderPassFuncIndividualParams& pass_params, D3d12CommandList* command_list) {
-  RenderImgui(command_list, GetDescriptorHandleRtv(pass_params.render_pass_info.rtv[0],
-                                                   GetResourceLocalIndexWrite(common_params.current_write_index_list, pass_params.render_pass_info.rtv[0]),
-                                                   common_params.descriptor_handles));
+void RenderPassImgui(const RenderPassFuncCommonParams&, const RenderPassFuncIndividualParams& pass_params, D3d12CommandList* command_list) {
+  RenderImgui(command_list, pass_params.rtv_handles[0]);
+  // imgui sets its own rootsig, pso and viewport.
+  ResetCommandListStateCache(pass_params.state_cache);
 }
 using RenderPassFunc = void (*)(const RenderPassFuncCommonParams&, const RenderPassFuncIndividualParams&, D3d12CommandList*);
 auto GatherRenderPassFunc(const uint32_t render_pass_info_len, const RenderPassInfo* render_pass_info, RenderPassFunc* render_pass_func) {
@@ -377,55 +383,22 @@ auto GatherRenderPassFunc(const uint32_t render_pass_info_len, const RenderPassI
     }
   }
 }
-auto GetJsonStrHash(const rapidjson::Value& json, const char* const name) {
-  if (!json.HasMember(name)) { return kEmptyStr; }
-  return GetStrHash(json[name].GetString());
-}
-StrHash* GetJsonStrHashList(const rapidjson::Value& json, const char* const name, uint32_t* len) {
-  if (!json.HasMember(name)) {
-    *len = 0;
-    return nullptr;
-  }
-  *len = json[name].Size();
-  auto list = AllocateArray<StrHash>(*len);
-  for (uint32_t i = 0; i < *len; i++) {
-    const auto& elem = json[name][i];
-    list[i] = GetStrHash(elem.GetString());
-  }
-  return list;
-}
-auto ParseRenderPass(const rapidjson::Value& json, uint32_t* render_pass_info_len) {
-  *render_pass_info_len = json.Size();
-  auto render_pass_info = AllocateArray<RenderPassInfo>(*render_pass_info_len);
-  for (uint32_t i = 0; i < *render_pass_info_len; i++) {
-    const auto& pass = json[i];
-    render_pass_info[i].queue = GetJsonStrHash(pass, "queue");
-    render_pass_info[i].type = GetJsonStrHash(pass, "type");
-    render_pass_info[i].material = GetJsonStrHash(pass, "material");
-    render_pass_info[i].cbv = GetJsonStrHashList(pass, "cbv", &render_pass_info[i].cbv_num);
-    render_pass_info[i].srv = GetJsonStrHashList(pass, "srv", &render_pass_info[i].srv_num);
-    render_pass_info[i].rtv = GetJsonStrHashList(pass, "rtv", &render_pass_info[i].rtv_num);
-    render_pass_info[i].dsv = GetJsonStrHash(pass, "dsv");
-    render_pass_info[i].present = GetJsonStrHash(pass, "present");
-    render_pass_info[i].material_id = GetJsonStrHash(pass, "material");
-    render_pass_info[i].stencil_val = pass.HasMember("stencil_val") ? static_cast<uint8_t>(pass["stencil_val"].GetUint()) : 0;
-  }
-  return render_pass_info;
-}
 struct RenderPass {
   uint32_t render_pass_len{};
   RenderPassInfo* render_pass_info{};
   RenderPassFunc* render_pass_func{};
 };
-auto ParseRenderPassList(const rapidjson::Value& json) {
-  StrHashMap<RenderPass> render_pass_list;
-  for (const auto& render_pass_json : json.GetArray()) {
-    RenderPass render_pass{};
-    render_pass.render_pass_info = ParseRenderPass(render_pass_json["list"], &render_pass.render_pass_len);
-    render_pass.render_pass_func = AllocateArray<RenderPassFunc>(render_pass.render_pass_len);
+auto CreateRenderPassList(const StrHashMap<RenderPassList>& config_render_pass_list) {
+  StrHashMap<RenderPass> render_pass_list(config_render_pass_list.size());
+  config_render_pass_list.iterate<StrHashMap<RenderPass>>([](StrHashMap<RenderPass>* render_pass_list, const StrHash render_pass_id, const RenderPassList* config_render_pass) {
+    RenderPass render_pass{
+      .render_pass_len = config_render_pass->render_pass_len,
+      .render_pass_info = config_render_pass->render_pass_info,
+      .render_pass_func = AllocateArray<RenderPassFunc>(config_render_pass->render_pass_len),
+    };
     GatherRenderPassFunc(render_pass.render_pass_len, render_pass.render_pass_info, render_pass.render_pass_func);
-    render_pass_list[GetStrHash(render_pass_json["name"].GetString())] = std::move(render_pass);
-  }
+    render_pass_list->insert(render_pass_id, render_pass);
+  }, &render_pass_list);
   return render_pass_list;
 }
 struct FillDebugBufferViewParamsAsset {
@@ -489,12 +462,15 @@ auto ShowDebugBufferSelector(const StrHashMap<ResourceInfo>& resource_info, StrH
 }
 struct DataSetForShowGuiFunc {
   const StrHashMap<ResourceInfo>& resource_info;
+  // of the previous frame.
+  const uint32_t* skipped_state_call_num;
 };
 struct GuiParam {
   StrHash debug_view_buffer_resource_id;
 };
 void ShowGui(const DataSetForShowGuiFunc& data, GuiParam& param) {
   ShowDebugBufferSelector(data.resource_info, &param.debug_view_buffer_resource_id);
+  ImGui::Text("skipped state calls: %u", *data.skipped_state_call_num);
 }
 void UpdateCameraBuffers(const ResourceSet* resource_set, const StrHashMap<uint32_t>& current_write_index_list) {
   const auto camera_id = "camera"_id;
@@ -535,6 +511,259 @@ void UpdateCameraBuffers(const ResourceSet* resource_set, const StrHashMap<uint3
   dst[31] = 1.0f;
   Unmap(resource, GetUint32(sizeof(float) * 32));
 }
+auto GetRenderPassListArray(const StrHashMap<RenderPassList>& render_pass_list_map) {
+  ResizableArray<RenderPassList> render_pass_list(render_pass_list_map.size());
+  render_pass_list_map.iterate<ResizableArray<RenderPassList>>([](ResizableArray<RenderPassList>* render_pass_list, const StrHash, const RenderPassList* config_render_pass) {
+    render_pass_list->push_back(*config_render_pass);
+  }, &render_pass_list);
+  return render_pass_list;
+}
+struct CullRenderPassListAsset {
+  StrHashMap<RenderPassList>* render_pass_list{};
+  uint32_t* kept_pass_index{};
+  uint32_t* pass_order{};
+};
+/**
+ * culls and reorders lists the way CompileRenderGraph does with cull_passes and reorder_passes.
+ * resources and material permutations come from the config, so only the pass lists are compiled here.
+ **/
+auto CullConfigRenderPassList(const StrHashMap<RenderPassList>& config_render_pass_list) {
+  uint32_t max_render_pass_len = 0;
+  config_render_pass_list.iterate<uint32_t>([](uint32_t* max_render_pass_len, const StrHash, const RenderPassList* config_render_pass) {
+    *max_render_pass_len = std::max(*max_render_pass_len, config_render_pass->render_pass_len);
+  }, &max_render_pass_len);
+  StrHashMap<RenderPassList> render_pass_list(config_render_pass_list.size());
+  CullRenderPassListAsset asset{
+    .render_pass_list = &render_pass_list,
+    .kept_pass_index = AllocateArray<uint32_t>(max_render_pass_len),
+    .pass_order = AllocateArray<uint32_t>(max_render_pass_len),
+  };
+  config_render_pass_list.iterate<CullRenderPassListAsset>([](CullRenderPassListAsset* asset, const StrHash render_pass_id, const RenderPassList* config_render_pass) {
+    const auto kept_pass_num = CullRenderPassList(*config_render_pass, 0, nullptr, asset->kept_pass_index);
+    auto render_pass_info = AllocateArray<RenderPassInfo>(kept_pass_num);
+    for (uint32_t i = 0; i < kept_pass_num; i++) {
+      render_pass_info[i] = config_render_pass->render_pass_info[asset->kept_pass_index[i]];
+    }
+    // fewest layout transitions first, then passes sharing a material (hence rootsig) are grouped to skip state calls.
+    ScheduleRenderPassList({.render_pass_len = kept_pass_num, .render_pass_info = render_pass_info,}, asset->pass_order);
+    for (uint32_t i = 0; i < kept_pass_num; i++) {
+      render_pass_info[i] = config_render_pass->render_pass_info[asset->kept_pass_index[asset->pass_order[i]]];
+    }
+    asset->render_pass_list->insert(render_pass_id, {.render_pass_len = kept_pass_num, .render_pass_info = render_pass_info,});
+  }, &asset);
+  Deallocate(asset.pass_order);
+  Deallocate(asset.kept_pass_index);
+  return render_pass_list;
+}
+void ReleaseCulledRenderPassList(StrHashMap<RenderPassList>& render_pass_list) {
+  render_pass_list.iterate([](const StrHash, RenderPassList* render_pass) {
+    Deallocate(render_pass->render_pass_info);
+  });
+  render_pass_list.~StrHashMap<RenderPassList>();
+}
+auto PlanConfigResourceAliasing(const StrHashMap<RenderPassList>& render_pass_list_map, const StrHashMap<ResourceInfo>& resource_info, D3d12Device* device) {
+  auto render_pass_list = GetRenderPassListArray(render_pass_list_map);
+  // debug buffer view shows buffers written in previous frames, they must not be aliased.
+  FillDebugBufferViewParamsAsset debug_buffer_view_asset{};
+  if (render_pass_list_map.contains("debug_buffer_view"_id)) {
+    resource_info.iterate<FillDebugBufferViewParamsAsset>(FillDebugBufferViewParams, &debug_buffer_view_asset);
+  }
+  auto resource_size_list = GetResourceAllocationSizeList(resource_info, device);
+  auto aliasing_plan = PlanResourceAliasing({
+      .render_pass_list_num = render_pass_list.size(),
+      .render_pass_list = render_pass_list.begin(),
+      .resource_info = &resource_info,
+      .resource_size_in_bytes = &resource_size_list,
+      .persistent_resource_num = GetUint32(debug_buffer_view_asset.buffer_num),
+      .persistent_resource_list = debug_buffer_view_asset.buffer_id,
+    });
+  LogResourceAliasingPlan(*aliasing_plan);
+  return aliasing_plan;
+}
+struct CompileBarrierScheduleAsset {
+  const StrHashMap<ResourceInfo>* resource_info{};
+  const BarrierTransitionInfo* transition_info{};
+  const StrHashMap<uint32_t>* current_write_index_list{};
+  StrHashMap<BarrierSchedule*>* barrier_schedule_list{};
+};
+auto CompileBarrierScheduleList(const StrHashMap<RenderPass>& render_pass_list, const StrHashMap<ResourceInfo>& resource_info, const BarrierTransitionInfo* transition_info, const StrHashMap<uint32_t>& current_write_index_list) {
+  StrHashMap<BarrierSchedule*> barrier_schedule_list(render_pass_list.size());
+  CompileBarrierScheduleAsset asset{
+    .resource_info = &resource_info,
+    .transition_info = transition_info,
+    .current_write_index_list = &current_write_index_list,
+    .barrier_schedule_list = &barrier_schedule_list,
+  };
+  render_pass_list.iterate<CompileBarrierScheduleAsset>([](CompileBarrierScheduleAsset* asset, const StrHash render_pass_id, const RenderPass* render_pass) {
+    const RenderPassList list{.render_pass_len = render_pass->render_pass_len, .render_pass_info = render_pass->render_pass_info,};
+    asset->barrier_schedule_list->insert(render_pass_id, CompileBarrierSchedule(list, *asset->resource_info, asset->transition_info, *asset->current_write_index_list, true));
+  }, &asset);
+  return barrier_schedule_list;
+}
+void ReleaseBarrierScheduleList(StrHashMap<BarrierSchedule*>& barrier_schedule_list) {
+  barrier_schedule_list.iterate([](const StrHash, BarrierSchedule** barrier_schedule) {
+    ReleaseBarrierSchedule(*barrier_schedule);
+  });
+  barrier_schedule_list.~StrHashMap<BarrierSchedule*>();
+}
+auto CompileQueueScheduleList(const StrHashMap<RenderPass>& render_pass_list) {
+  StrHashMap<QueueSchedule*> queue_schedule_list(render_pass_list.size());
+  render_pass_list.iterate<StrHashMap<QueueSchedule*>>([](StrHashMap<QueueSchedule*>* queue_schedule_list, const StrHash render_pass_id, const RenderPass* render_pass) {
+    const RenderPassList list{.render_pass_len = render_pass->render_pass_len, .render_pass_info = render_pass->render_pass_info,};
+    queue_schedule_list->insert(render_pass_id, CompileQueueSchedule(list));
+  }, &queue_schedule_list);
+  return queue_schedule_list;
+}
+void ReleaseQueueScheduleList(StrHashMap<QueueSchedule*>& queue_schedule_list) {
+  queue_schedule_list.iterate([](const StrHash, QueueSchedule** queue_schedule) {
+    ReleaseQueueSchedule(*queue_schedule);
+  });
+  queue_schedule_list.~StrHashMap<QueueSchedule*>();
+}
+const D3D12_COMMAND_LIST_TYPE kQueueCommandListType[kQueueTypeNum] = {
+  D3D12_COMMAND_LIST_TYPE_DIRECT,
+  D3D12_COMMAND_LIST_TYPE_COMPUTE,
+  D3D12_COMMAND_LIST_TYPE_COPY,
+};
+auto GetMaxRenderPassLen(const StrHashMap<RenderPass>& render_pass_list) {
+  uint32_t max_render_pass_len = 0;
+  render_pass_list.iterate<uint32_t>([](uint32_t* max_render_pass_len, const StrHash, const RenderPass* render_pass) {
+    *max_render_pass_len = std::max(*max_render_pass_len, render_pass->render_pass_len);
+  }, &max_render_pass_len);
+  return max_render_pass_len;
+}
+/**
+ * a command list and an allocator per frame for each pass group recorded in a frame, created on first use.
+ * a queue never has more groups in a frame than passes.
+ **/
+struct CommandListPool {
+  uint32_t frame_buffer_num{};
+  uint32_t slot_num{}; // per queue
+  D3d12CommandList** command_list{};
+  D3d12CommandAllocator** command_allocator{};
+};
+struct PooledCommandList {
+  D3d12CommandList* command_list{};
+  D3d12CommandAllocator* command_allocator{};
+};
+auto CreateCommandListPool(const uint32_t frame_buffer_num, const uint32_t slot_num) {
+  CommandListPool pool{
+    .frame_buffer_num = frame_buffer_num,
+    .slot_num = slot_num,
+    .command_list = AllocateArray<D3d12CommandList*>(kQueueTypeNum * slot_num),
+    .command_allocator = AllocateArray<D3d12CommandAllocator*>(frame_buffer_num * kQueueTypeNum * slot_num),
+  };
+  std::fill(pool.command_list, pool.command_list + kQueueTypeNum * slot_num, nullptr);
+  std::fill(pool.command_allocator, pool.command_allocator + frame_buffer_num * kQueueTypeNum * slot_num, nullptr);
+  return pool;
+}
+auto GetPooledCommandList(const QueueType queue, const uint32_t slot, const uint32_t frame_index, D3d12Device* device, CommandListPool* pool) {
+  DEBUG_ASSERT(slot < pool->slot_num, DebugAssert{});
+  const auto queue_index = static_cast<uint32_t>(queue);
+  const auto list_index = queue_index * pool->slot_num + slot;
+  auto& command_list = pool->command_list[list_index];
+  if (command_list == nullptr) {
+    command_list = CreateCommandList(device, kQueueCommandListType[queue_index]);
+  }
+  auto& command_allocator = pool->command_allocator[frame_index * kQueueTypeNum * pool->slot_num + list_index];
+  if (command_allocator == nullptr) {
+    command_allocator = CreateCommandAllocator(device, kQueueCommandListType[queue_index]);
+  }
+  return PooledCommandList{
+    .command_list = command_list,
+    .command_allocator = command_allocator,
+  };
+}
+void ReleaseCommandListPool(CommandListPool& pool) {
+  for (uint32_t i = 0; i < kQueueTypeNum * pool.slot_num; i++) {
+    if (pool.command_list[i] == nullptr) { continue; }
+    pool.command_list[i]->Release();
+  }
+  for (uint32_t i = 0; i < pool.frame_buffer_num * kQueueTypeNum * pool.slot_num; i++) {
+    if (pool.command_allocator[i] == nullptr) { continue; }
+    pool.command_allocator[i]->Release();
+  }
+  Deallocate(pool.command_list);
+  Deallocate(pool.command_allocator);
+}
+const uint32_t kMaxRtvNum = 8;
+/**
+ * pass states depending on current write indices, resolved in recording order on the main thread.
+ **/
+struct ResolvedRenderPass {
+  D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle{};
+  D3D12_CPU_DESCRIPTOR_HANDLE rtv_handles[kMaxRtvNum]{};
+  D3D12_CPU_DESCRIPTOR_HANDLE dsv_handle{};
+};
+auto ResolveRenderPassTargets(const RenderPassInfo& render_pass_info, const DescriptorHandles* descriptor_handles, const StrHashMap<uint32_t>& current_write_index_list, ResolvedRenderPass* resolved_render_pass) {
+  DEBUG_ASSERT(render_pass_info.rtv_num <= kMaxRtvNum, DebugAssert{});
+  for (uint32_t i = 0; i < render_pass_info.rtv_num; i++) {
+    resolved_render_pass->rtv_handles[i] = GetDescriptorHandleRtv(render_pass_info.rtv[i], GetResourceLocalIndexWrite(current_write_index_list, render_pass_info.rtv[i]), descriptor_handles);
+  }
+  if (render_pass_info.dsv == kEmptyStr) { return; }
+  resolved_render_pass->dsv_handle = GetDescriptorHandleDsv(render_pass_info.dsv, GetResourceLocalIndexWrite(current_write_index_list, render_pass_info.dsv), descriptor_handles);
+}
+/**
+ * consecutive passes of a queue batch recorded into one command list.
+ **/
+struct PassGroup {
+  QueueType queue{};
+  uint32_t pass_offset{}; // in QueueSchedule::pass_index_list
+  uint32_t pass_num{};
+  D3d12CommandAllocator* command_allocator{};
+};
+/**
+ * splits a batch evenly by pass count into as many groups as recording threads.
+ **/
+auto GetPassGroupNum(const QueueBatch& batch, const uint32_t thread_num) {
+  return std::min(batch.pass_num, thread_num);
+}
+auto GetPassGroup(const QueueBatch& batch, const uint32_t group_num, const uint32_t group_index) {
+  const auto begin = batch.pass_num * group_index / group_num;
+  const auto end = batch.pass_num * (group_index + 1) / group_num;
+  return PassGroup{
+    .queue = batch.queue,
+    .pass_offset = batch.pass_offset + begin,
+    .pass_num = end - begin,
+  };
+}
+struct PassGroupRecordingAsset {
+  const PassGroup* pass_group_list{};
+  D3d12CommandList** command_list{};
+  const QueueSchedule* queue_schedule{};
+  const BarrierSchedule* barrier_schedule{};
+  const RenderPass* render_pass{};
+  const ResolvedRenderPass* resolved_render_pass_list{};
+  const RenderPassFuncCommonParams* common_params{};
+  ID3D12DescriptorHeap* shader_visible_descriptor_heap{};
+  uint32_t* skipped_state_call_num{}; // per group
+};
+/**
+ * groups run concurrently on job system threads and must not share mutable state (including the allocator).
+ **/
+void RecordPassGroup(const PassGroupRecordingAsset* asset, const uint32_t group_index) {
+  const auto& pass_group = asset->pass_group_list[group_index];
+  auto command_list = asset->command_list[group_index];
+  auto descriptor_heap = asset->shader_visible_descriptor_heap;
+  const uint32_t descriptor_heap_num = (pass_group.queue == QueueType::kCopy) ? 0 : 1;
+  StartCommandListRecording(command_list, pass_group.command_allocator, descriptor_heap_num, &descriptor_heap);
+  CommandListStateCache state_cache{};
+  for (uint32_t i = 0; i < pass_group.pass_num; i++) {
+    const auto pass_index = asset->queue_schedule->pass_index_list[pass_group.pass_offset + i];
+    const auto& resolved_render_pass = asset->resolved_render_pass_list[pass_index];
+    IssueResolvedBarriers(asset->barrier_schedule, pass_index, command_list);
+    asset->render_pass->render_pass_func[pass_index](*asset->common_params, {asset->render_pass->render_pass_info[pass_index], resolved_render_pass.gpu_handle, resolved_render_pass.rtv_handles, resolved_render_pass.dsv_handle, &state_cache,}, command_list);
+    IssueResolvedReleaseBarriers(asset->barrier_schedule, pass_index, command_list);
+  }
+  EndCommandListRecording(command_list);
+  asset->skipped_state_call_num[group_index] = state_cache.skipped_call_num;
+}
+void RecordPassGroupRange(void* user_data, const uint32_t begin, const uint32_t end) {
+  const auto asset = static_cast<const PassGroupRecordingAsset*>(user_data);
+  for (uint32_t i = begin; i < end; i++) {
+    RecordPassGroup(asset, i);
+  }
+}
 } // namespace
 #include "doctest/doctest.h"
 TEST_CASE("imgui") {
@@ -726,29 +955,53 @@ TEST_CASE("multiple render pass") {
   using namespace boke;
   // allocator
   const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
-  auto main_buffer = new std::byte[main_buffer_size_in_bytes];
-  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
   InitStrHashSystem();
-  const auto json = GetJson("tests/formatted-config-multipass.json");
-  const uint32_t frame_buffer_num = json["frame_buffer_num"].GetUint();
+  // config
+  StrHashMap<Size2d> explicit_buffer_size;
+  explicit_buffer_size["camera"_id] = Size2d{sizeof(float) * 32,1};
+  // json is parsed only when the baked config is missing or was baked by another version, and baked for the next run then.
+  // remove the baked file after editing the json.
+  const char baked_config_path[] = "tests/formatted-config-multipass.baked";
+  auto config = LoadBakedGfxConfig(baked_config_path, explicit_buffer_size);
+  const auto config_baked = (config != nullptr);
+  if (!config_baked) {
+    config = LoadGfxConfig("tests/formatted-config-multipass.json", explicit_buffer_size);
+  }
+  {
+    // fail before any gpu object is created.
+    const auto config_error_list = ValidateGfxConfig(config);
+    LogConfigErrors(config_error_list);
+    REQUIRE_UNARY(config_error_list.empty());
+  }
+  if (!config_baked) {
+    CHECK_UNARY(BakeGfxConfig(config, baked_config_path));
+  }
+  // passes and resources not contributing to present cost nothing from here, kept passes are reordered.
+  auto culled_render_pass_list = CullConfigRenderPassList(*config->render_pass_list);
+  {
+    auto render_pass_list = GetRenderPassListArray(culled_render_pass_list);
+    CullUnusedResources(render_pass_list.size(), render_pass_list.begin(), config->resource_info);
+  }
+  const uint32_t frame_buffer_num = config->frame_buffer_num;
   // core units
-  const auto primarybuffer_size = GetSwapchainBufferSize(json);
-  auto core = PrepareGfxCore(json["title"].GetString(), primarybuffer_size, AdapterType::kHighPerformance);
+  const auto primarybuffer_size = config->swapchain_size;
+  auto core = PrepareGfxCore(config->title, primarybuffer_size, AdapterType::kHighPerformance);
   auto device = CreateDevice(core.gfx_libraries.d3d12_library, core.dxgi_core.adapter);
   // resource info
-  StrHashMap<Size2d> explicit_buffer_size;
-  explicit_buffer_size["camera"_id] = Size2d{sizeof(float) * 32,1};
-  auto resource_info = ParseResourceInfo(json["resource"], explicit_buffer_size);
+  const auto& resource_info = *config->resource_info;
   auto current_write_index_list = InitWriteIndexList(resource_info);
   // resources
   auto gpu_memory_allocator = CreateGpuMemoryAllocator(core.dxgi_core.adapter, device);
-  auto resource_set = CreateResources(resource_info, gpu_memory_allocator);
+  auto aliasing_plan = PlanConfigResourceAliasing(culled_render_pass_list, resource_info, device);
+  auto resource_set = CreateResources(resource_info, aliasing_plan, gpu_memory_allocator);
   // descriptor handles
   const auto swapchain_buffer_num = frame_buffer_num + 1;
   auto descriptor_heaps = CreateDescriptorHeaps(resource_info, device, {swapchain_buffer_num, 0, 1/*imgui_font*/});
   auto descriptor_handles = PrepareDescriptorHandles(resource_info, resource_set, device, descriptor_heaps.head_addr, descriptor_heaps.increment_size);
   // descriptor handles (gpu)
-  const uint32_t shader_visible_descriptor_handle_num = json["descriptor_handles"]["shader_visible_buffer_num"].GetUint();
+  const uint32_t shader_visible_descriptor_handle_num = config->shader_visible_buffer_num;
   auto shader_visible_descriptor_heap = CreateDescriptorHeap(device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shader_visible_descriptor_handle_num, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
   ShaderVisibleDescriptorHandleInfo shader_visible_descriptor_handle_info{
     .head_addr_cpu = shader_visible_descriptor_heap->GetCPUDescriptorHandleForHeapStart(),
@@ -760,21 +1013,29 @@ TEST_CASE("multiple render pass") {
   uint32_t shader_visible_descriptor_handle_occupied_handle_num = 0;
   // barrier resources
   auto transition_info = InitTransitionInfo(resource_info);
-  // command queue & fence
-  auto command_queue = CreateCommandQueue(device, D3D12_COMMAND_LIST_TYPE_DIRECT, D3D12_COMMAND_QUEUE_PRIORITY_NORMAL, D3D12_COMMAND_QUEUE_FLAG_NONE);
-  auto fence = CreateFence(device);
+  MarkAliasedResources(*aliasing_plan, transition_info);
+  // command queue & fence per queue type, fence values advance by signal_num of the queue schedule every frame.
+  ID3D12CommandQueue* queue_list[kQueueTypeNum]{};
+  D3d12Fence* queue_fence[kQueueTypeNum]{};
+  uint64_t queue_fence_base[kQueueTypeNum]{};
+  for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+    queue_list[i] = CreateCommandQueue(device, kQueueCommandListType[i], D3D12_COMMAND_QUEUE_PRIORITY_NORMAL, D3D12_COMMAND_QUEUE_FLAG_NONE);
+    queue_fence[i] = CreateFence(device);
+  }
+  const auto direct_queue_index = static_cast<uint32_t>(QueueType::kDirect);
+  auto command_queue = queue_list[direct_queue_index];
+  auto fence = queue_fence[direct_queue_index];
   auto fence_event = CreateEvent(nullptr, false, false, nullptr);
   auto fence_signal_val_list = AllocateArray<uint64_t>(frame_buffer_num);
   std::fill(fence_signal_val_list, fence_signal_val_list + frame_buffer_num, 0);
-  uint64_t fence_signal_val = 0;
-  // command allocator & list
+  // command allocator & list (for entering barrier schedules, passes are recorded to pooled lists)
   auto command_allocator = AllocateArray<D3d12CommandAllocator*>(frame_buffer_num);
   for (uint32_t i = 0; i < frame_buffer_num; i++) {
     command_allocator[i] = CreateCommandAllocator(device, D3D12_COMMAND_LIST_TYPE_DIRECT);
   }
   auto command_list = CreateCommandList(device, D3D12_COMMAND_LIST_TYPE_DIRECT);
   // swapchain
-  const auto swapchain_format = GetDxgiFormat(json["swapchain"]["format"].GetString());
+  const auto swapchain_format = config->swapchain_format;
   auto swapchain = CreateSwapchain(core.dxgi_core.factory, command_queue, core.window_info.hwnd, swapchain_format, swapchain_buffer_num);
   {
     const auto hr = swapchain->SetMaximumFrameLatency(frame_buffer_num);
@@ -796,9 +1057,28 @@ TEST_CASE("multiple render pass") {
     Deallocate(swapchain_resources);
   }
   // materials
-  auto material_set = CreateMaterialSet(json["material"], device);
+  const uint32_t file_loader_worker_thread_num = 2;
+  auto file_loader = CreateFileLoader(file_loader_worker_thread_num);
+  const uint32_t job_system_worker_thread_num = 3;
+  auto job_system = CreateJobSystem(job_system_worker_thread_num);
+  auto material_set = CreateMaterialSet(config->material_num, config->material_list, device, file_loader, job_system, "tests/formatted-config-multipass.psocache");
+  // recompiled shaders and rootsigs are picked up without restarting.
+  EnableMaterialHotReload(material_set, file_loader, job_system);
   // render pass
-  auto render_pass_list = ParseRenderPassList(json["render_pass"]);
+  auto render_pass_list = CreateRenderPassList(culled_render_pass_list);
+  // barriers are compiled once per list and recompiled only when a list changes.
+  current_write_index_list["swapchain"_id] = swapchain->GetCurrentBackBufferIndex();
+  auto barrier_schedule_list = CompileBarrierScheduleList(render_pass_list, resource_info, transition_info, current_write_index_list);
+  BarrierSchedule* current_barrier_schedule = nullptr;
+  auto queue_schedule_list = CompileQueueScheduleList(render_pass_list);
+  // pass groups
+  const auto max_render_pass_len = GetMaxRenderPassLen(render_pass_list);
+  auto command_list_pool = CreateCommandListPool(frame_buffer_num, max_render_pass_len);
+  auto resolved_render_pass_list = AllocateArray<ResolvedRenderPass>(max_render_pass_len);
+  auto pass_group_list = AllocateArray<PassGroup>(max_render_pass_len);
+  auto pass_group_command_list = AllocateArray<D3d12CommandList*>(max_render_pass_len);
+  auto pass_group_skipped_state_call_num = AllocateArray<uint32_t>(max_render_pass_len);
+  uint32_t skipped_state_call_num = 0;
   // init imgui
   {
     AddDescriptorHandlesSrv("imgui_font"_id, DXGI_FORMAT_UNKNOWN, nullptr, 1,  device, descriptor_heaps.head_addr, descriptor_heaps.increment_size, descriptor_handles);
@@ -812,12 +1092,12 @@ TEST_CASE("multiple render pass") {
   }
   DataSetForShowGuiFunc data_set_for_gui{
     .resource_info = resource_info,
+    .skipped_state_call_num = &skipped_state_call_num,
   };
   GuiParam gui_params{};
   // frame loop
-  const uint32_t max_loop_num = json["max_loop_num"].GetUint();
+  const uint32_t max_loop_num = config->max_loop_num;
   RenderPassFuncCommonParams render_pass_common_params {
-    .current_write_index_list = current_write_index_list,
     .resource_set = resource_set,
     .descriptor_handles = descriptor_handles,
     .material_set = material_set,
@@ -830,6 +1110,9 @@ TEST_CASE("multiple render pass") {
     ShowGui(data_set_for_gui, gui_params);
     if (!WaitForSwapchain(swapchain_latency_object)) { break; }
     WaitForFence(fence_event, fence, fence_signal_val_list[frame_index]);
+    // psos compiled in background since the last frame become available,
+    // psos replaced by hot reload are kept until the frames submitted so far complete.
+    UpdateMaterialSet(material_set, queue_fence_base[direct_queue_index], fence->GetCompletedValue());
     // bind current swapchain backbuffer
     const auto swapchain_backbuffer_index = swapchain->GetCurrentBackBufferIndex();
     current_write_index_list["swapchain"_id] = swapchain_backbuffer_index;
@@ -839,55 +1122,143 @@ TEST_CASE("multiple render pass") {
     // process debug buffer view pass
     const auto current_render_pass_name = (gui_params.debug_view_buffer_resource_id != kEmptyStr) ? "debug_buffer_view"_id : "default"_id;
     const auto& current_render_pass = render_pass_list[current_render_pass_name];
-    if (current_render_pass_name == "debug_buffer_view"_id) {
+    auto& barrier_schedule = barrier_schedule_list[current_render_pass_name];
+    auto& queue_schedule = queue_schedule_list[current_render_pass_name];
+    if (current_render_pass_name == "debug_buffer_view"_id && current_render_pass.render_pass_info[0].srv[0] != gui_params.debug_view_buffer_resource_id) {
+      if (current_barrier_schedule != nullptr) {
+        LeaveBarrierSchedule(current_barrier_schedule, current_write_index_list, transition_info);
+        current_barrier_schedule = nullptr;
+      }
       current_render_pass.render_pass_info[0].srv[0] = gui_params.debug_view_buffer_resource_id;
+      ReleaseBarrierSchedule(barrier_schedule);
+      barrier_schedule = CompileBarrierSchedule({.render_pass_len = current_render_pass.render_pass_len, .render_pass_info = current_render_pass.render_pass_info,}, resource_info, transition_info, current_write_index_list, true);
+      ReleaseQueueSchedule(queue_schedule);
+      queue_schedule = CompileQueueSchedule({.render_pass_len = current_render_pass.render_pass_len, .render_pass_info = current_render_pass.render_pass_info,});
     }
-    // record commands
-    StartCommandListRecording(command_list, command_allocator[frame_index], 1, &shader_visible_descriptor_heap);
-    for (uint32_t i = 0; i < current_render_pass.render_pass_len; i++) {
-      UpdateTransitionInfo(transition_info);
-      FlipPingPongIndex(current_render_pass.render_pass_info[i], transition_info, resource_info, current_write_index_list);
-      ConfigureRenderPassBarriersTextureTransitions(current_render_pass.render_pass_info[i], current_write_index_list, transition_info);
-      ProcessBarriers(transition_info, resource_set, command_list);
-      const auto gpu_handle = PrepareRenderPassShaderVisibleDescriptorHandles(current_render_pass.render_pass_info[i],
-                                                                              descriptor_handles,
-                                                                              current_write_index_list,
-                                                                              device,
-                                                                              shader_visible_descriptor_handle_info,
-                                                                              &shader_visible_descriptor_handle_occupied_handle_num);
-      current_render_pass.render_pass_func[i](render_pass_common_params, {current_render_pass.render_pass_info[i], gpu_handle,}, command_list);
+    if (current_barrier_schedule != barrier_schedule) {
+      if (current_barrier_schedule != nullptr) {
+        LeaveBarrierSchedule(current_barrier_schedule, current_write_index_list, transition_info);
+      }
+      // signaled as the last direct signal of the previous frame, i.e. what signal_index 0 waits for.
+      StartCommandListRecording(command_list, command_allocator[frame_index], 0, nullptr);
+      EnterBarrierSchedule(barrier_schedule, resource_set, current_write_index_list, transition_info, command_list);
+      EndCommandListRecording(command_list);
+      command_queue->ExecuteCommandLists(1, reinterpret_cast<ID3D12CommandList**>(&command_list));
+      queue_fence_base[direct_queue_index]++;
+      command_queue->Signal(fence, queue_fence_base[direct_queue_index]);
+      current_barrier_schedule = barrier_schedule;
+    }
+    // resolve passes in recording order
+    for (uint32_t i = 0; i < queue_schedule->batch_num; i++) {
+      const auto& batch = queue_schedule->batch_list[i];
+      for (uint32_t j = 0; j < batch.pass_num; j++) {
+        const auto pass_index = queue_schedule->pass_index_list[batch.pass_offset + j];
+        const auto& render_pass_info = current_render_pass.render_pass_info[pass_index];
+        auto& resolved_render_pass = resolved_render_pass_list[pass_index];
+        ResolveScheduledBarriers(barrier_schedule, pass_index, resource_set, current_write_index_list);
+        resolved_render_pass.gpu_handle = PrepareRenderPassShaderVisibleDescriptorHandles(render_pass_info,
+                                                                                          descriptor_handles,
+                                                                                          current_write_index_list,
+                                                                                          device,
+                                                                                          shader_visible_descriptor_handle_info,
+                                                                                          &shader_visible_descriptor_handle_occupied_handle_num);
+        ResolveRenderPassTargets(render_pass_info, descriptor_handles, current_write_index_list, &resolved_render_pass);
+      }
+    }
+    // record pass groups on job system threads
+    const auto recording_thread_num = GetJobSystemThreadNum(job_system);
+    uint32_t pass_group_num = 0;
+    uint32_t queue_pass_group_num[kQueueTypeNum]{};
+    for (uint32_t i = 0; i < queue_schedule->batch_num; i++) {
+      const auto& batch = queue_schedule->batch_list[i];
+      const auto queue_index = static_cast<uint32_t>(batch.queue);
+      const auto group_num = GetPassGroupNum(batch, recording_thread_num);
+      for (uint32_t j = 0; j < group_num; j++) {
+        const auto pooled_command_list = GetPooledCommandList(batch.queue, queue_pass_group_num[queue_index], frame_index, device, &command_list_pool);
+        queue_pass_group_num[queue_index]++;
+        pass_group_list[pass_group_num] = GetPassGroup(batch, group_num, j);
+        pass_group_list[pass_group_num].command_allocator = pooled_command_list.command_allocator;
+        pass_group_command_list[pass_group_num] = pooled_command_list.command_list;
+        pass_group_num++;
+      }
+    }
+    {
+      PassGroupRecordingAsset asset{
+        .pass_group_list = pass_group_list,
+        .command_list = pass_group_command_list,
+        .queue_schedule = queue_schedule,
+        .barrier_schedule = barrier_schedule,
+        .render_pass = &current_render_pass,
+        .resolved_render_pass_list = resolved_render_pass_list,
+        .common_params = &render_pass_common_params,
+        .shader_visible_descriptor_heap = shader_visible_descriptor_heap,
+        .skipped_state_call_num = pass_group_skipped_state_call_num,
+      };
+      // pso compiles are low priority jobs, waiting for the recording never picks them up.
+      ParallelFor(job_system, pass_group_num, 1, RecordPassGroupRange, &asset);
+      skipped_state_call_num = std::accumulate(pass_group_skipped_state_call_num, pass_group_skipped_state_call_num + pass_group_num, 0U);
+    }
+    // submit pass groups of a batch in order with one call
+    uint32_t pass_group_offset = 0;
+    for (uint32_t i = 0; i < queue_schedule->batch_num; i++) {
+      const auto& batch = queue_schedule->batch_list[i];
+      const auto queue_index = static_cast<uint32_t>(batch.queue);
+      const auto group_num = GetPassGroupNum(batch, recording_thread_num);
+      for (uint32_t j = 0; j < batch.wait_num; j++) {
+        const auto& wait = queue_schedule->wait_list[batch.wait_offset + j];
+        const auto wait_queue_index = static_cast<uint32_t>(wait.queue);
+        queue_list[queue_index]->Wait(queue_fence[wait_queue_index], queue_fence_base[wait_queue_index] + wait.signal_index);
+      }
+      if (group_num > 0) {
+        queue_list[queue_index]->ExecuteCommandLists(group_num, reinterpret_cast<ID3D12CommandList**>(&pass_group_command_list[pass_group_offset]));
+        pass_group_offset += group_num;
+      }
+      if (batch.signal_index > 0) {
+        queue_list[queue_index]->Signal(queue_fence[queue_index], queue_fence_base[queue_index] + batch.signal_index);
+      }
     }
-    EndCommandListRecording(command_list);
-    command_queue->ExecuteCommandLists(1, reinterpret_cast<ID3D12CommandList**>(&command_list));
-    ResetBarrierSyncAccessStatus(transition_info);
     swapchain->Present(1, 0);
-    fence_signal_val++;
-    command_queue->Signal(fence, fence_signal_val);
-    fence_signal_val_list[frame_index] = fence_signal_val;
+    for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+      queue_fence_base[i] += queue_schedule->signal_num[i];
+    }
+    // the last direct batch waits for all other queues.
+    fence_signal_val_list[frame_index] = queue_fence_base[direct_queue_index];
   }
   // terminate
+  ReleaseBarrierScheduleList(barrier_schedule_list);
+  ReleaseQueueScheduleList(queue_schedule_list);
   render_pass_list.~StrHashMap<RenderPass>();
-  WaitForFence(fence_event, fence, fence_signal_val);
+  ReleaseCulledRenderPassList(culled_render_pass_list);
+  WaitForFence(fence_event, fence, queue_fence_base[direct_queue_index]);
   ReleaseMaterialSet(material_set);
+  ReleaseJobSystem(job_system);
+  ReleaseFileLoader(file_loader);
   TermImgui();
   swapchain->Release();
+  Deallocate(pass_group_skipped_state_call_num);
+  Deallocate(pass_group_command_list);
+  Deallocate(pass_group_list);
+  Deallocate(resolved_render_pass_list);
+  ReleaseCommandListPool(command_list_pool);
   command_list->Release();
   for (uint32_t i = 0; i < frame_buffer_num; i++) {
     command_allocator[i]->Release();
   }
-  fence->Release();
-  command_queue->Release();
+  for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+    queue_fence[i]->Release();
+    queue_list[i]->Release();
+  }
   ReleaseTransitionInfo(transition_info);
   shader_visible_descriptor_heap->Release();
   ReleaseDescriptorHandles(descriptor_handles);
   ReleaseDescriptorHeaps(descriptor_heaps);
   ReleaseResources(resource_set);
+  ReleaseResourceAliasingPlan(aliasing_plan);
   ReleaseGpuMemoryAllocator(gpu_memory_allocator);
   current_write_index_list.~StrHashMap<uint32_t>();
-  explicit_buffer_size.~StrHashMap<Size2d>();
-  resource_info.~StrHashMap<ResourceInfo>();
   device->Release();
   ReleaseGfxCore(core);
+  ReleaseGfxConfig(config);
+  explicit_buffer_size.~StrHashMap<Size2d>();
   TermStrHashSystem();
-  delete[] main_buffer;
 }
@@ -1,171 +1,1259 @@
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <thread>
 #include "directx/d3dx12_pipeline_state_stream.h"
 #include "dxgi1_6.h"
 #include "boke/allocator.h"
 #include "boke/container.h"
 #include "boke/debug_assert.h"
-#include "boke/file.h"
+#include "boke/file_loader.h"
+#include "boke/file_watcher.h"
+#include "boke/job_system.h"
 #include "boke/str_hash.h"
 #include "boke/util.h"
 #include "core.h"
 #include "json.h"
 #include "d3d12_util.h"
-#include "material.h"
 #include "resources.h"
+#include "render_pass_info.h"
+#include "config_loader.h"
+#include "pso_cache.h"
+#include "material.h"
 namespace {
 using namespace boke;
-std::pair<StrHash, ID3D12RootSignature*> LoadRootsig(const rapidjson::Value& rootsig_json, D3d12Device* device, StrHashMap<ID3D12RootSignature*>& rootsig_list) {
-  const auto filename = rootsig_json.GetString();
+struct MaterialFileList {
+  StrHashMap<uint32_t>* file_index_map{};
+  ResizableArray<const char*>* filepath_list{};
+};
+auto AddMaterialFile(const char* const filepath, MaterialFileList& file_list) {
+  const auto file_id = GetStrHash(filepath);
+  if (file_list.file_index_map->contains(file_id)) { return; }
+  file_list.file_index_map->insert(file_id, file_list.filepath_list->size());
+  file_list.filepath_list->push_back(filepath);
+}
+auto AddMaterialFileList(const MaterialInfo& material, MaterialFileList& file_list) {
+  AddMaterialFile(material.rootsig, file_list);
+  for (uint32_t i = 0; i < material.shader_num; i++) {
+    AddMaterialFile(material.shader_list[i].filename, file_list);
+  }
+}
+auto CreateMaterialFileList() {
+  return MaterialFileList{
+    .file_index_map = New<StrHashMap<uint32_t>>(),
+    .filepath_list = New<ResizableArray<const char*>>(),
+  };
+}
+auto GatherMaterialFileList(const uint32_t material_num, const MaterialInfo* material_list) {
+  auto file_list = CreateMaterialFileList();
+  for (uint32_t i = 0; i < material_num; i++) {
+    AddMaterialFileList(material_list[i], file_list);
+  }
+  return file_list;
+}
+auto ReleaseMaterialFileList(MaterialFileList& file_list) {
+  file_list.file_index_map->~StrHashMap<uint32_t>();
+  Deallocate(file_list.file_index_map);
+  file_list.filepath_list->~ResizableArray<const char*>();
+  Deallocate(file_list.filepath_list);
+}
+auto GetMaterialFileIndex(const char* const filepath, const MaterialFileList& file_list) {
+  return (*file_list.file_index_map)[GetStrHash(filepath)];
+}
+auto GetMaterialFile(const char* const filepath, const MaterialFileList& file_list, const FileLoadBatch* batch) {
+  const auto file = GetLoadedFile(batch, GetMaterialFileIndex(filepath, file_list));
+  DEBUG_ASSERT(file.buffer != nullptr, DebugAssert{});
+  return file;
+}
+/**
+ * returns nullptr on failure, psos and rootsigs rebuilt on hot reload may be broken while being edited.
+ **/
+template <typename Device>
+ID3D12RootSignature* CreateRootsig(Device* device, const LoadedFile& file) {
+  ID3D12RootSignature* rootsig = nullptr;
+  const auto hr = device->CreateRootSignature(0, file.buffer, file.size, IID_PPV_ARGS(&rootsig));
+  if (FAILED(hr)) { return nullptr; }
+  return rootsig;
+}
+template <typename Device>
+std::pair<StrHash, ID3D12RootSignature*> LoadRootsig(const char* const filename, const MaterialFileList& file_list, const FileLoadBatch* batch, Device* device, StrHashMap<ID3D12RootSignature*>& rootsig_list) {
   const auto rootsig_id = GetStrHash(filename);
   if (rootsig_list.contains(rootsig_id)) { return {rootsig_id, rootsig_list[rootsig_id]}; }
-  uint32_t len = 0;
-  const auto buffer = LoadFileToBuffer(filename, &len);
-  DEBUG_ASSERT(buffer != nullptr, DebugAssert{});
-  DEBUG_ASSERT(len > 0, DebugAssert{});
-  ID3D12RootSignature* rootsig = nullptr;
-  const auto hr = device->CreateRootSignature(0, buffer, len, IID_PPV_ARGS(&rootsig));
-  DEBUG_ASSERT(SUCCEEDED(hr), DebugAssert{});
+  const auto file = GetMaterialFile(filename, file_list, batch);
+  auto rootsig = CreateRootsig(device, file);
+  DEBUG_ASSERT(rootsig != nullptr, DebugAssert{});
   rootsig_list[rootsig_id] = rootsig;
-  Deallocate(buffer);
   SetD3d12Name(rootsig, filename);
   return {rootsig_id, rootsig};
 }
-auto LoadShaderObjectList(const rapidjson::Value& json, CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
-  for (auto& shader : json.GetArray()) {
-    uint32_t len = 0;
-    const auto buffer = LoadFileToBuffer(shader["filename"].GetString(), &len);
-    DEBUG_ASSERT(buffer != nullptr, DebugAssert{});
-    DEBUG_ASSERT(len > 0, DebugAssert{});
+auto LoadShaderObjectList(const uint32_t shader_num, const MaterialShaderInfo* shader_list, const MaterialFileList& file_list, const FileLoadBatch* batch, CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
+  for (uint32_t i = 0; i < shader_num; i++) {
+    const auto& shader = shader_list[i];
+    // bytecode is owned by the batch and must outlive pso creation.
+    const auto file = GetMaterialFile(shader.filename, file_list, batch);
     D3D12_SHADER_BYTECODE shader_bytecode{
-      .pShaderBytecode = buffer,
-      .BytecodeLength = len,
+      .pShaderBytecode = file.buffer,
+      .BytecodeLength = file.size,
     };
-    const auto target = shader["target"].GetString();
-    if (strcmp(target, "ps") == 0) {
-      stream.PSCb(shader_bytecode);
-      continue;
-    }
-    if (strcmp(target, "cs") == 0) {
-      stream.CSCb(shader_bytecode);
-      continue;
+    // targets are not registered to the str hash database.
+    switch (foonathan::string_id::detail::sid_hash(shader.target)) {
+      case "ps"_id: { stream.PSCb(shader_bytecode); break; }
+      case "cs"_id: { stream.CSCb(shader_bytecode); break; }
+      case "as"_id: { stream.ASCb(shader_bytecode); break; }
+      case "ms"_id: { stream.MSCb(shader_bytecode); break; }
+      default: { DEBUG_ASSERT(false, DebugAssert{}); break; }
     }
-    if (strcmp(target, "as") == 0) {
-      stream.ASCb(shader_bytecode);
-      continue;
-    }
-    if (strcmp(target, "ms") == 0) {
-      stream.MSCb(shader_bytecode);
-      continue;
-    }
-    DEBUG_ASSERT(false, DebugAssert{});
-  }
-}
-auto DeallocateShaderBytecode(D3D12_SHADER_BYTECODE& bytecode) {
-  if (bytecode.pShaderBytecode) {
-    Deallocate(const_cast<void*>(bytecode.pShaderBytecode));
   }
 }
-auto CleanupShaderObject(CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
-  DeallocateShaderBytecode(stream.PipelineStream.PS);
-  DeallocateShaderBytecode(stream.PipelineStream.CS);
-  DeallocateShaderBytecode(stream.PipelineStream.AS);
-  DeallocateShaderBytecode(stream.PipelineStream.MS);
-}
-auto SetRtvFormat(const rapidjson::Value& rtv_json, CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
+auto SetRtvFormat(const uint32_t rtv_num, const DXGI_FORMAT* rtv_format, CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
   D3D12_RT_FORMAT_ARRAY array{};
-  array.NumRenderTargets = rtv_json.Size();
+  array.NumRenderTargets = rtv_num;
   for (uint32_t i = 0; i < array.NumRenderTargets; i++) {
-    array.RTFormats[i] = GetDxgiFormat(rtv_json[i].GetString());
+    array.RTFormats[i] = rtv_format[i];
   }
   stream.RTVFormatsCb(array);
 }
-auto CreatePsoDesc(const rapidjson::Value& json, ID3D12RootSignature* rootsig) {
+auto CreatePsoDesc(const MaterialInfo& material, ID3D12RootSignature* rootsig, const MaterialFileList& file_list, const FileLoadBatch* batch) {
   CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER stream;
   stream.RootSignatureCb(rootsig);
-  LoadShaderObjectList(json["shader_list"], stream);
-  if (json.HasMember("rtv")) {
-    SetRtvFormat(json["rtv"], stream);
+  LoadShaderObjectList(material.shader_num, material.shader_list, file_list, batch, stream);
+  if (material.rtv_num > 0) {
+    SetRtvFormat(material.rtv_num, material.rtv_format, stream);
   }
   return stream;
 }
-auto CreatePso(D3d12Device* device, CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
-  D3D12_PIPELINE_STATE_STREAM_DESC desc = {
+auto GetPsoStreamDesc(CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
+  return D3D12_PIPELINE_STATE_STREAM_DESC{
     .SizeInBytes = sizeof(stream.PipelineStream),
     .pPipelineStateSubobjectStream = &stream.PipelineStream,
   };
+}
+template <typename Device>
+auto CreatePso(Device* device, CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
+  const auto desc = GetPsoStreamDesc(stream);
   ID3D12PipelineState* pso = nullptr;
   const auto hr = device->CreatePipelineState(&desc, IID_PPV_ARGS(&pso));
-  DEBUG_ASSERT(SUCCEEDED(hr), DebugAssert{});
+  if (FAILED(hr)) { return nullptr; }
+  return pso;
+}
+ID3D12PipelineState* LoadCachedPso(D3d12PipelineLibrary* pipeline_library, const wchar_t* const entry_name, CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
+  const auto desc = GetPsoStreamDesc(stream);
+  ID3D12PipelineState* pso = nullptr;
+  const auto hr = pipeline_library->LoadPipeline(entry_name, &desc, IID_PPV_ARGS(&pso));
+  // E_INVALIDARG if the entry is missing or was stored with another desc.
+  if (FAILED(hr)) { return nullptr; }
   return pso;
 }
+template <typename Device>
+D3d12PipelineLibrary* CreatePipelineLibrary(Device* device, const void* blob, const uint64_t blob_size) {
+  D3d12PipelineLibrary* pipeline_library = nullptr;
+  const auto hr = device->CreatePipelineLibrary(blob, blob_size, IID_PPV_ARGS(&pipeline_library));
+  // blobs from another driver or adapter fail with D3D12_ERROR_DRIVER_VERSION_MISMATCH or D3D12_ERROR_ADAPTER_NOT_FOUND.
+  if (FAILED(hr)) { return nullptr; }
+  return pipeline_library;
+}
+auto CalcMaterialPsoCacheKey(const MaterialInfo& material, const MaterialFileList& file_list, const FileLoadBatch* batch) {
+  auto shader_file_list = AllocateArray<LoadedFile>(material.shader_num);
+  for (uint32_t i = 0; i < material.shader_num; i++) {
+    shader_file_list[i] = GetMaterialFile(material.shader_list[i].filename, file_list, batch);
+  }
+  const auto key = CalcPsoCacheKey(GetMaterialFile(material.rootsig, file_list, batch), material.shader_num, shader_file_list, material.rtv_num, material.rtv_format);
+  Deallocate(shader_file_list);
+  return key;
+}
+// device type is erased as job data outlives the creation call and is kept in MaterialSet.
+using CreateRootsigFunc = ID3D12RootSignature* (*)(void* device, const LoadedFile& file);
+using CreatePsoFunc = ID3D12PipelineState* (*)(void* device, CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream);
+template <typename Device>
+ID3D12RootSignature* CreateRootsigWithDevice(void* device, const LoadedFile& file) {
+  return CreateRootsig(static_cast<Device*>(device), file);
+}
+template <typename Device>
+ID3D12PipelineState* CreatePsoWithDevice(void* device, CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER& stream) {
+  return CreatePso(static_cast<Device*>(device), stream);
+}
+/**
+ * a pso compiled on a job, writing only to its own slot until ready is set.
+ **/
+struct PsoCreationJobData {
+  void* device{};
+  CreatePsoFunc create_pso{};
+  CD3DX12_PIPELINE_STATE_STREAM5_PARSE_HELPER stream;
+  const char* name{};
+  D3d12PipelineLibrary* pipeline_library{}; // nullptr unless the cache file has an entry for key
+  PsoCacheKey key{};
+  wchar_t entry_name[kPsoCacheEntryNameLen]{};
+  ID3D12PipelineState* pso{}; // nullptr if compilation failed
+  bool loaded_from_cache{};
+  std::atomic<bool> ready{};
+};
+struct PsoSource {
+  uint32_t index{};
+  StrHash rootsig_id{};
+};
+/**
+ * materials with identical bytecode, rtv formats and rootsig share the pso compiled for the first of them.
+ * key covers rootsig contents only, so materials with distinct rootsig objects never share.
+ * returns index of the material the pso is compiled for.
+ **/
+auto FindPsoSource(const PsoCacheKey key, const StrHash rootsig_id, const uint32_t index, StrHashMap<PsoSource>& pso_source_map) {
+  const auto pso_source = pso_source_map.get(key);
+  if (pso_source == nullptr) {
+    pso_source_map.insert(key, {.index = index, .rootsig_id = rootsig_id,});
+    return index;
+  }
+  return (pso_source->rootsig_id == rootsig_id) ? pso_source->index : index;
+}
+void CreatePsoJob(JobSystem*, Job*, void* user_data) {
+  auto data = static_cast<PsoCreationJobData*>(user_data);
+  // pipeline libraries are free-threaded for loads.
+  if (data->pipeline_library) {
+    data->pso = LoadCachedPso(data->pipeline_library, data->entry_name, data->stream);
+    data->loaded_from_cache = (data->pso != nullptr);
+  }
+  if (data->pso == nullptr) {
+    data->pso = data->create_pso(data->device, data->stream);
+  }
+  if (data->pso) {
+    SetD3d12Name(data->pso, data->name);
+  }
+  data->ready.store(true, std::memory_order_release);
+}
 } // namespace
 namespace boke {
+/**
+ * kept until every pso of the set is ready, jobs reference bytecode in batch and their job data until then.
+ **/
+struct PendingPsoList {
+  uint32_t material_num{};
+  const MaterialInfo* material_list{};
+  PsoCreationJobData* job_data{}; // jobs run for materials compiling their own pso only
+  uint32_t* pso_source_list{}; // index of the material whose pso is used
+  bool* published{}; // set once the job finished, also when its pso failed
+  uint32_t published_num{};
+  MaterialFileList file_list{};
+  FileLoadBatch* batch{};
+  PsoCacheFile pso_cache_file{};
+  D3d12PipelineLibrary* pipeline_library{}; // created from pso_cache_file
+  D3d12PipelineLibrary* store_pipeline_library{}; // nullptr if the cache is disabled
+  const char* pso_cache_path{};
+};
+/**
+ * psos of materials whose files changed, compiled on jobs against freshly loaded files
+ * and swapped into MaterialSet together once all of them are ready.
+ **/
+struct PsoRebuild {
+  uint32_t material_num{};
+  uint32_t* material_index_list{};
+  PsoCreationJobData* job_data{};
+  uint32_t* pso_source_list{}; // indexed like material_index_list
+  MaterialFileList file_list{};
+  FileLoadBatch* batch{};
+  // rootsigs recreated from changed files, keyed by filename like MaterialSet::rootsig_list.
+  StrHashMap<ID3D12RootSignature*>* rootsig_list{};
+};
+/**
+ * replaced psos and rootsigs, released once the gpu passed fence_val.
+ **/
+struct RetiredD3d12Object {
+  IUnknown* object{};
+  uint64_t fence_val{};
+};
+struct MaterialHotReload {
+  FileLoader* file_loader{};
+  JobSystem* job_system{};
+  MaterialFileList file_list{};
+  FileWatcher* file_watcher{};
+  // indexed like file_list, kept until no rebuild is in flight.
+  bool* file_changed{};
+  PsoRebuild* pso_rebuild{}; // nullptr unless psos are being rebuilt
+  ResizableArray<RetiredD3d12Object>* retired_list{};
+};
 struct MaterialSet {
+  uint32_t material_num{};
+  const MaterialInfo* material_list{};
+  void* device{};
+  CreateRootsigFunc create_rootsig{};
+  CreatePsoFunc create_pso{};
   StrHashMap<StrHash>* material_rootsig_map{};
   StrHashMap<ID3D12RootSignature*>* rootsig_list{};
+  // only psos ready to use are registered.
   StrHashMap<ID3D12PipelineState*>* pso_list{};
+  StrHashMap<StrHash>* fallback_map{};
+  PendingPsoList* pending_pso_list{}; // nullptr once every pso is ready
+  MaterialHotReload* hot_reload{}; // nullptr unless EnableMaterialHotReload is called
+};
+} // namespace boke
+namespace {
+template <typename Device>
+struct MaterialSetCreationAsset {
+  uint32_t material_num{};
+  const MaterialInfo* material_list{};
+  Device* device{};
+  MaterialSet* material_set{};
+  const MaterialFileList& file_list;
+  const FileLoadBatch* batch{};
+  bool* file_loaded{};
+  uint32_t next_material_index{};
+  JobSystem* job_system{};
+  Job* pso_creation_job{};
+  PendingPsoList* pending_pso_list{};
+  StrHashMap<PsoSource>* pso_source_map{};
+};
+template <typename Device>
+auto IsMaterialFileLoaded(const char* const filepath, const MaterialSetCreationAsset<Device>& asset) {
+  return asset.file_loaded[GetMaterialFileIndex(filepath, asset.file_list)];
+}
+template <typename Device>
+auto AreMaterialFilesLoaded(const MaterialInfo& material, const MaterialSetCreationAsset<Device>& asset) {
+  if (!IsMaterialFileLoaded(material.rootsig, asset)) { return false; }
+  for (uint32_t i = 0; i < material.shader_num; i++) {
+    if (!IsMaterialFileLoaded(material.shader_list[i].filename, asset)) { return false; }
+  }
+  return true;
+}
+/**
+ * rootsigs (deduplicated by filename), pso descs and hash maps are handled on the calling thread,
+ * only pso compilation runs on jobs.
+ **/
+template <typename Device>
+auto CreateMaterial(const uint32_t material_index, MaterialSetCreationAsset<Device>& asset) {
+  const auto& material = asset.material_list[material_index];
+  auto material_set = asset.material_set;
+  auto pending_pso_list = asset.pending_pso_list;
+  auto [rootsig_id, rootsig] = LoadRootsig(material.rootsig, asset.file_list, asset.batch, asset.device, *material_set->rootsig_list);
+  material_set->material_rootsig_map->insert(GetStrHash(material.name), rootsig_id);
+  const auto key = CalcMaterialPsoCacheKey(material, asset.file_list, asset.batch);
+  auto job_data = &pending_pso_list->job_data[material_index];
+  const auto pso_source = FindPsoSource(key, rootsig_id, material_index, *asset.pso_source_map);
+  pending_pso_list->pso_source_list[material_index] = pso_source;
+  if (pso_source != material_index) {
+    new (job_data) PsoCreationJobData{.name = material.name, .key = key,};
+    return;
+  }
+  new (job_data) PsoCreationJobData{
+    .device = asset.device,
+    .create_pso = material_set->create_pso,
+    .stream = CreatePsoDesc(material, rootsig, asset.file_list, asset.batch),
+    .name = material.name,
+    .pipeline_library = ContainsPsoCacheEntry(pending_pso_list->pso_cache_file, key) ? pending_pso_list->pipeline_library : nullptr,
+    .key = key,
+  };
+  GetPsoCacheEntryName(key, job_data->entry_name);
+  // low priority keeps compiles out of waits for frame jobs, e.g. pass group recording.
+  RunLowPriorityJob(asset.job_system, CreateChildJob(asset.job_system, asset.pso_creation_job, CreatePsoJob, job_data));
+}
+template <typename Device>
+void CreateReadyMaterials(void* user_data, const uint32_t file_index, const LoadedFile&) {
+  // materials are dispatched in order as soon as all of their files are loaded, overlapping pso creation with file loading.
+  auto asset = static_cast<MaterialSetCreationAsset<Device>*>(user_data);
+  asset->file_loaded[file_index] = true;
+  while (asset->next_material_index < asset->material_num) {
+    const auto& material = asset->material_list[asset->next_material_index];
+    if (!AreMaterialFilesLoaded(material, *asset)) { break; }
+    CreateMaterial(asset->next_material_index, *asset);
+    asset->next_material_index++;
+  }
+}
+void EmptyJob(JobSystem*, Job*, void*) {}
+/**
+ * the cache file is rewritten from scratch when any pso was compiled or an entry went stale,
+ * so it holds exactly the psos of the current material list.
+ **/
+auto SavePsoCache(const PendingPsoList& pending_pso_list) {
+  const auto material_num = pending_pso_list.material_num;
+  StrHashMap<uint32_t> entry_index_map;
+  auto entry_list = AllocateArray<PsoCacheKey>(material_num);
+  uint32_t entry_num = 0;
+  bool all_loaded_from_cache = true;
+  for (uint32_t i = 0; i < material_num; i++) {
+    const auto& job_data = pending_pso_list.job_data[pending_pso_list.pso_source_list[i]];
+    // failed psos are left out of pso_list and have nothing to store.
+    if (job_data.pso == nullptr) { continue; }
+    all_loaded_from_cache = all_loaded_from_cache && job_data.loaded_from_cache;
+    // identical materials share a key and are stored once.
+    if (entry_index_map.contains(job_data.key)) { continue; }
+    entry_index_map.insert(job_data.key, i);
+    entry_list[entry_num] = job_data.key;
+    entry_num++;
+  }
+  if (all_loaded_from_cache && entry_num == pending_pso_list.pso_cache_file.entry_num) {
+    Deallocate(entry_list);
+    return;
+  }
+  auto pipeline_library = pending_pso_list.store_pipeline_library;
+  for (uint32_t i = 0; i < entry_num; i++) {
+    const auto& job_data = pending_pso_list.job_data[entry_index_map[entry_list[i]]];
+    [[maybe_unused]] const auto hr = pipeline_library->StorePipeline(job_data.entry_name, job_data.pso);
+    DEBUG_ASSERT(SUCCEEDED(hr), DebugAssert{});
+  }
+  const auto library_size = pipeline_library->GetSerializedSize();
+  auto library = AllocateArray<char>(GetUint32(library_size));
+  if (SUCCEEDED(pipeline_library->Serialize(library, library_size))) {
+    SavePsoCacheFile(pending_pso_list.pso_cache_path, entry_num, entry_list, library, library_size);
+  }
+  Deallocate(library);
+  Deallocate(entry_list);
+}
+void PublishReadyPsos(MaterialSet* material_set) {
+  auto pending_pso_list = material_set->pending_pso_list;
+  for (uint32_t i = 0; i < pending_pso_list->material_num; i++) {
+    if (pending_pso_list->published[i]) { continue; }
+    const auto pso_source = pending_pso_list->pso_source_list[i];
+    auto& job_data = pending_pso_list->job_data[pso_source];
+    if (!job_data.ready.load(std::memory_order_acquire)) { continue; }
+    pending_pso_list->published[i] = true;
+    pending_pso_list->published_num++;
+    if (job_data.pso == nullptr) {
+      // a failed material is left out of pso_list, GetReadyMaterial falls back or skips its passes.
+      spdlog::error("pso creation failed. {}", pending_pso_list->material_list[i].name);
+      continue;
+    }
+    // every material holds a reference, so that psos are released and replaced per material.
+    if (pso_source != i) {
+      job_data.pso->AddRef();
+    }
+    material_set->pso_list->insert(GetStrHash(pending_pso_list->material_list[i].name), job_data.pso);
+  }
+}
+void ReleasePendingPsoList(PendingPsoList* pending_pso_list) {
+  if (pending_pso_list->pipeline_library) {
+    pending_pso_list->pipeline_library->Release();
+  }
+  if (pending_pso_list->store_pipeline_library) {
+    SavePsoCache(*pending_pso_list);
+    pending_pso_list->store_pipeline_library->Release();
+  }
+  ReleasePsoCacheFile(pending_pso_list->pso_cache_file);
+  for (uint32_t i = 0; i < pending_pso_list->material_num; i++) {
+    pending_pso_list->job_data[i].~PsoCreationJobData();
+  }
+  Deallocate(pending_pso_list->job_data);
+  Deallocate(pending_pso_list->pso_source_list);
+  Deallocate(pending_pso_list->published);
+  ReleaseFileLoadBatch(pending_pso_list->batch);
+  ReleaseMaterialFileList(pending_pso_list->file_list);
+  pending_pso_list->~PendingPsoList();
+  Deallocate(pending_pso_list);
+}
+void UpdatePendingPsoList(MaterialSet* material_set) {
+  auto pending_pso_list = material_set->pending_pso_list;
+  if (pending_pso_list == nullptr) { return; }
+  PublishReadyPsos(material_set);
+  if (pending_pso_list->published_num < pending_pso_list->material_num) { return; }
+  ReleasePendingPsoList(pending_pso_list);
+  material_set->pending_pso_list = nullptr;
+}
+void MarkChangedMaterialFile(void* user_data, const uint32_t file_index) {
+  static_cast<MaterialHotReload*>(user_data)->file_changed[file_index] = true;
+}
+auto IsMaterialFileChanged(const char* const filepath, const MaterialHotReload& hot_reload) {
+  return hot_reload.file_changed[GetMaterialFileIndex(filepath, hot_reload.file_list)];
+}
+auto IsMaterialChanged(const MaterialInfo& material, const MaterialHotReload& hot_reload) {
+  if (IsMaterialFileChanged(material.rootsig, hot_reload)) { return true; }
+  for (uint32_t i = 0; i < material.shader_num; i++) {
+    if (IsMaterialFileChanged(material.shader_list[i].filename, hot_reload)) { return true; }
+  }
+  return false;
+}
+auto AreMaterialFilesLoaded(const MaterialFileList& file_list, const FileLoadBatch* batch) {
+  for (uint32_t i = 0; i < file_list.filepath_list->size(); i++) {
+    if (GetLoadedFile(batch, i).buffer == nullptr) {
+      // files may be missing for a moment while being replaced, the next write triggers another rebuild.
+      spdlog::warn("material file reload failed. {}", (*file_list.filepath_list)[i]);
+      return false;
+    }
+  }
+  return true;
+}
+auto GetRebuiltRootsig(const MaterialInfo& material, const MaterialSet* material_set, const PsoRebuild* pso_rebuild) {
+  const auto rootsig_id = GetStrHash(material.rootsig);
+  const auto rootsig = pso_rebuild->rootsig_list->get(rootsig_id);
+  return (rootsig != nullptr) ? *rootsig : (*material_set->rootsig_list)[rootsig_id];
+}
+auto CreateRebuiltRootsigs(const MaterialSet* material_set, PsoRebuild* pso_rebuild) {
+  const auto& hot_reload = *material_set->hot_reload;
+  for (uint32_t i = 0; i < pso_rebuild->material_num; i++) {
+    const auto& material = material_set->material_list[pso_rebuild->material_index_list[i]];
+    if (!IsMaterialFileChanged(material.rootsig, hot_reload)) { continue; }
+    const auto rootsig_id = GetStrHash(material.rootsig);
+    if (pso_rebuild->rootsig_list->contains(rootsig_id)) { continue; }
+    auto rootsig = material_set->create_rootsig(material_set->device, GetMaterialFile(material.rootsig, pso_rebuild->file_list, pso_rebuild->batch));
+    if (rootsig == nullptr) {
+      spdlog::error("rootsig rebuild failed. {}", material.rootsig);
+      return false;
+    }
+    SetD3d12Name(rootsig, material.rootsig);
+    pso_rebuild->rootsig_list->insert(rootsig_id, rootsig);
+  }
+  return true;
+}
+void ReleasePsoRebuild(PsoRebuild* pso_rebuild) {
+  if (pso_rebuild->job_data) {
+    for (uint32_t i = 0; i < pso_rebuild->material_num; i++) {
+      pso_rebuild->job_data[i].~PsoCreationJobData();
+    }
+    Deallocate(pso_rebuild->job_data);
+    Deallocate(pso_rebuild->pso_source_list);
+  }
+  pso_rebuild->rootsig_list->~StrHashMap<ID3D12RootSignature*>();
+  Deallocate(pso_rebuild->rootsig_list);
+  ReleaseFileLoadBatch(pso_rebuild->batch);
+  ReleaseMaterialFileList(pso_rebuild->file_list);
+  Deallocate(pso_rebuild->material_index_list);
+  Deallocate(pso_rebuild);
+}
+/**
+ * psos and rootsigs of a rebuild which is discarded have never been used by the gpu.
+ **/
+void DiscardPsoRebuild(PsoRebuild* pso_rebuild) {
+  if (pso_rebuild->job_data) {
+    for (uint32_t i = 0; i < pso_rebuild->material_num; i++) {
+      if (pso_rebuild->job_data[i].pso) {
+        pso_rebuild->job_data[i].pso->Release();
+      }
+    }
+  }
+  pso_rebuild->rootsig_list->iterate([](const StrHash, ID3D12RootSignature** rootsig) { (*rootsig)->Release(); });
+  ReleasePsoRebuild(pso_rebuild);
+}
+/**
+ * files are loaded and rootsigs are created on the calling thread, only pso compilation runs on jobs.
+ * returns nullptr if a file or rootsig is broken, current psos are kept then.
+ **/
+PsoRebuild* StartPsoRebuild(const MaterialSet* material_set) {
+  const auto& hot_reload = *material_set->hot_reload;
+  auto pso_rebuild = New<PsoRebuild>();
+  pso_rebuild->material_index_list = AllocateArray<uint32_t>(material_set->material_num);
+  pso_rebuild->file_list = CreateMaterialFileList();
+  for (uint32_t i = 0; i < material_set->material_num; i++) {
+    const auto& material = material_set->material_list[i];
+    if (!IsMaterialChanged(material, hot_reload)) { continue; }
+    pso_rebuild->material_index_list[pso_rebuild->material_num] = i;
+    pso_rebuild->material_num++;
+    // unchanged files of the material are loaded again as batches are released once psos are created.
+    AddMaterialFileList(material, pso_rebuild->file_list);
+  }
+  pso_rebuild->rootsig_list = New<StrHashMap<ID3D12RootSignature*>>();
+  const auto& file_list = pso_rebuild->file_list;
+  pso_rebuild->batch = SubmitFileLoadBatch(hot_reload.file_loader, file_list.filepath_list->size(), file_list.filepath_list->begin());
+  WaitFileLoadBatch(hot_reload.file_loader, pso_rebuild->batch, nullptr, nullptr);
+  if (!AreMaterialFilesLoaded(file_list, pso_rebuild->batch) || !CreateRebuiltRootsigs(material_set, pso_rebuild)) {
+    DiscardPsoRebuild(pso_rebuild);
+    return nullptr;
+  }
+  auto job_system = hot_reload.job_system;
+  auto pso_creation_job = CreateJob(job_system, EmptyJob, nullptr);
+  pso_rebuild->job_data = AllocateArray<PsoCreationJobData>(pso_rebuild->material_num);
+  pso_rebuild->pso_source_list = AllocateArray<uint32_t>(pso_rebuild->material_num);
+  StrHashMap<PsoSource> pso_source_map;
+  for (uint32_t i = 0; i < pso_rebuild->material_num; i++) {
+    const auto& material = material_set->material_list[pso_rebuild->material_index_list[i]];
+    auto job_data = &pso_rebuild->job_data[i];
+    const auto key = CalcMaterialPsoCacheKey(material, file_list, pso_rebuild->batch);
+    pso_rebuild->pso_source_list[i] = FindPsoSource(key, GetStrHash(material.rootsig), i, pso_source_map);
+    if (pso_rebuild->pso_source_list[i] != i) {
+      new (job_data) PsoCreationJobData{.name = material.name,};
+      continue;
+    }
+    new (job_data) PsoCreationJobData{
+      .device = material_set->device,
+      .create_pso = material_set->create_pso,
+      .stream = CreatePsoDesc(material, GetRebuiltRootsig(material, material_set, pso_rebuild), file_list, pso_rebuild->batch),
+      .name = material.name,
+    };
+    RunLowPriorityJob(job_system, CreateChildJob(job_system, pso_creation_job, CreatePsoJob, job_data));
+  }
+  // same as material set creation, the parent job is only waited for without worker threads.
+  RunLowPriorityJob(job_system, pso_creation_job);
+  if (GetJobSystemThreadNum(job_system) == 1) {
+    WaitJob(job_system, pso_creation_job);
+  }
+  return pso_rebuild;
+}
+auto IsPsoRebuildReady(const PsoRebuild* pso_rebuild) {
+  for (uint32_t i = 0; i < pso_rebuild->material_num; i++) {
+    if (pso_rebuild->pso_source_list[i] != i) { continue; }
+    if (!pso_rebuild->job_data[i].ready.load(std::memory_order_acquire)) { return false; }
+  }
+  return true;
+}
+void RetireD3d12Object(IUnknown* object, const uint64_t fence_val, MaterialHotReload* hot_reload) {
+  hot_reload->retired_list->push_back({.object = object, .fence_val = fence_val,});
+}
+void ReleaseRetiredD3d12Objects(const uint64_t completed_fence_val, MaterialHotReload* hot_reload) {
+  auto& retired_list = *hot_reload->retired_list;
+  for (auto& retired : retired_list) {
+    if (retired.object == nullptr || retired.fence_val > completed_fence_val) { continue; }
+    retired.object->Release();
+    retired.object = nullptr;
+  }
+  // fence values never decrease, so the list is empty once its last object is released.
+  if (!retired_list.empty() && retired_list.back().object == nullptr) {
+    retired_list.clear();
+  }
+}
+struct RootsigSwapAsset {
+  MaterialSet* material_set{};
+  uint64_t fence_val{};
 };
-MaterialSet* CreateMaterialSet(const rapidjson::Value& json, D3d12Device* device) {
+/**
+ * psos and rootsigs of the rebuild replace current ones all at once,
+ * so that a material never pairs a new pso with an old rootsig.
+ **/
+void SwapRebuiltPsos(MaterialSet* material_set, PsoRebuild* pso_rebuild, const uint64_t submitted_fence_val) {
+  for (uint32_t i = 0; i < pso_rebuild->material_num; i++) {
+    if (pso_rebuild->pso_source_list[i] != i || pso_rebuild->job_data[i].pso != nullptr) { continue; }
+    spdlog::error("pso rebuild failed. {}", pso_rebuild->job_data[i].name);
+    DiscardPsoRebuild(pso_rebuild);
+    return;
+  }
+  auto hot_reload = material_set->hot_reload;
+  for (uint32_t i = 0; i < pso_rebuild->material_num; i++) {
+    const auto material_id = GetStrHash(material_set->material_list[pso_rebuild->material_index_list[i]].name);
+    // materials whose initial pso failed have nothing to retire.
+    RetireD3d12Object(GetPso(material_set, material_id), submitted_fence_val, hot_reload);
+    const auto pso_source = pso_rebuild->pso_source_list[i];
+    auto pso = pso_rebuild->job_data[pso_source].pso;
+    if (pso_source != i) {
+      pso->AddRef();
+    }
+    material_set->pso_list->insert(material_id, pso);
+  }
+  RootsigSwapAsset asset{
+    .material_set = material_set,
+    .fence_val = submitted_fence_val,
+  };
+  pso_rebuild->rootsig_list->iterate<RootsigSwapAsset>([](RootsigSwapAsset* asset, const StrHash rootsig_id, ID3D12RootSignature** rootsig) {
+    auto material_set = asset->material_set;
+    RetireD3d12Object((*material_set->rootsig_list)[rootsig_id], asset->fence_val, material_set->hot_reload);
+    material_set->rootsig_list->insert(rootsig_id, *rootsig);
+  }, &asset);
+  ReleasePsoRebuild(pso_rebuild);
+}
+void UpdateMaterialHotReload(MaterialSet* material_set, const uint64_t submitted_fence_val, const uint64_t completed_fence_val) {
+  auto hot_reload = material_set->hot_reload;
+  ReleaseRetiredD3d12Objects(completed_fence_val, hot_reload);
+  PollFileWatcher(hot_reload->file_watcher, MarkChangedMaterialFile, hot_reload);
+  if (hot_reload->pso_rebuild) {
+    if (!IsPsoRebuildReady(hot_reload->pso_rebuild)) { return; }
+    SwapRebuiltPsos(material_set, hot_reload->pso_rebuild, submitted_fence_val);
+    hot_reload->pso_rebuild = nullptr;
+  }
+  // changes during a rebuild or before every pso is created are picked up afterwards.
+  if (material_set->pending_pso_list) { return; }
+  const auto file_num = hot_reload->file_list.filepath_list->size();
+  bool file_changed = false;
+  for (uint32_t i = 0; i < file_num; i++) {
+    file_changed = file_changed || hot_reload->file_changed[i];
+  }
+  if (!file_changed) { return; }
+  hot_reload->pso_rebuild = StartPsoRebuild(material_set);
+  for (uint32_t i = 0; i < file_num; i++) {
+    hot_reload->file_changed[i] = false;
+  }
+}
+void ReleaseMaterialHotReload(MaterialHotReload* hot_reload) {
+  if (hot_reload->pso_rebuild) {
+    // nothing else refers to jobs in flight, wait for worker threads to finish them.
+    while (!IsPsoRebuildReady(hot_reload->pso_rebuild)) {
+      std::this_thread::yield();
+    }
+    DiscardPsoRebuild(hot_reload->pso_rebuild);
+  }
+  // the gpu is idle once the material set is released.
+  ReleaseRetiredD3d12Objects(std::numeric_limits<uint64_t>::max(), hot_reload);
+  hot_reload->retired_list->~ResizableArray<RetiredD3d12Object>();
+  Deallocate(hot_reload->retired_list);
+  Deallocate(hot_reload->file_changed);
+  ReleaseFileWatcher(hot_reload->file_watcher);
+  ReleaseMaterialFileList(hot_reload->file_list);
+  Deallocate(hot_reload);
+}
+template <typename Device>
+MaterialSet* CreateMaterialSetImpl(const uint32_t material_num, const MaterialInfo* material_list, Device* device, FileLoader* file_loader, JobSystem* job_system, const char* const pso_cache_path) {
   auto material_set = New<MaterialSet>();
+  material_set->material_num = material_num;
+  material_set->material_list = material_list;
+  material_set->device = device;
+  material_set->create_rootsig = CreateRootsigWithDevice<Device>;
+  material_set->create_pso = CreatePsoWithDevice<Device>;
   material_set->material_rootsig_map = New<StrHashMap<StrHash>>();
   material_set->rootsig_list = New<StrHashMap<ID3D12RootSignature*>>();
   material_set->pso_list = New<StrHashMap<ID3D12PipelineState*>>();
-  for (const auto& material : json.GetArray()) {
-    auto [rootsig_id, rootsig] = LoadRootsig(material["rootsig"], device, *material_set->rootsig_list);
-    auto stream = CreatePsoDesc(material, rootsig);
-    auto pso = CreatePso(device, stream);
-    CleanupShaderObject(stream);
-    SetD3d12Name(pso, material["name"].GetString());
-    const auto material_id = GetStrHash(material["name"].GetString());
-    material_set->pso_list->insert(material_id, pso);
-    material_set->material_rootsig_map->insert(material_id, rootsig_id);
+  material_set->fallback_map = New<StrHashMap<StrHash>>();
+  for (uint32_t i = 0; i < material_num; i++) {
+    if (material_list[i].fallback == nullptr) { continue; }
+    material_set->fallback_map->insert(GetStrHash(material_list[i].name), GetStrHash(material_list[i].fallback));
   }
+  auto pending_pso_list = New<PendingPsoList>();
+  material_set->pending_pso_list = pending_pso_list;
+  pending_pso_list->material_num = material_num;
+  pending_pso_list->material_list = material_list;
+  pending_pso_list->job_data = AllocateArray<PsoCreationJobData>(material_num);
+  pending_pso_list->pso_source_list = AllocateArray<uint32_t>(material_num);
+  pending_pso_list->published = AllocateArray<bool>(material_num);
+  for (uint32_t i = 0; i < material_num; i++) {
+    pending_pso_list->published[i] = false;
+  }
+  // load every rootsig and shader object in a single batch instead of one blocking read per file.
+  pending_pso_list->file_list = GatherMaterialFileList(material_num, material_list);
+  const auto& file_list = pending_pso_list->file_list;
+  const auto file_num = file_list.filepath_list->size();
+  pending_pso_list->batch = SubmitFileLoadBatch(file_loader, file_num, file_list.filepath_list->begin());
+  auto file_loaded = AllocateArray<bool>(file_num);
+  for (uint32_t i = 0; i < file_num; i++) {
+    file_loaded[i] = false;
+  }
+  if (pso_cache_path != nullptr) {
+    // the library references the mapped file, both are released once every pso is ready.
+    pending_pso_list->pso_cache_file = LoadPsoCacheFile(pso_cache_path);
+    auto& pso_cache_file = pending_pso_list->pso_cache_file;
+    pending_pso_list->pipeline_library = (pso_cache_file.library != nullptr) ? CreatePipelineLibrary(device, pso_cache_file.library, pso_cache_file.library_size) : nullptr;
+    if (pending_pso_list->pipeline_library == nullptr) {
+      ReleasePsoCacheFile(pso_cache_file);
+    }
+    pending_pso_list->store_pipeline_library = CreatePipelineLibrary(device, nullptr, 0);
+    pending_pso_list->pso_cache_path = pso_cache_path;
+  }
+  StrHashMap<PsoSource> pso_source_map;
+  MaterialSetCreationAsset<Device> asset{
+    .material_num = material_num,
+    .material_list = material_list,
+    .device = device,
+    .material_set = material_set,
+    .file_list = file_list,
+    .batch = pending_pso_list->batch,
+    .file_loaded = file_loaded,
+    .job_system = job_system,
+    .pso_creation_job = CreateJob(job_system, EmptyJob, nullptr),
+    .pending_pso_list = pending_pso_list,
+    .pso_source_map = &pso_source_map,
+  };
+  WaitFileLoadBatch(file_loader, pending_pso_list->batch, CreateReadyMaterials<Device>, &asset);
+  DEBUG_ASSERT(asset.next_material_index == material_num, DebugAssert{});
+  Deallocate(file_loaded);
+  // the parent job only lets a thread without workers wait for all psos,
+  // otherwise it is never waited for and completion is tracked by the ready flag of each pso.
+  RunLowPriorityJob(job_system, asset.pso_creation_job);
+  if (GetJobSystemThreadNum(job_system) == 1) {
+    WaitJob(job_system, asset.pso_creation_job);
+  }
+  UpdatePendingPsoList(material_set);
   return material_set;
 }
+} // namespace
+namespace boke {
+MaterialSet* CreateMaterialSet(const uint32_t material_num, const MaterialInfo* material_list, D3d12Device* device, FileLoader* file_loader, JobSystem* job_system, const char* const pso_cache_path) {
+  return CreateMaterialSetImpl(material_num, material_list, device, file_loader, job_system, pso_cache_path);
+}
 void ReleaseMaterialSet(MaterialSet* material_set) {
+  // nothing else refers to jobs in flight, wait for worker threads to finish them.
+  while (material_set->pending_pso_list != nullptr) {
+    std::this_thread::yield();
+    UpdatePendingPsoList(material_set);
+  }
+  if (material_set->hot_reload) {
+    ReleaseMaterialHotReload(material_set->hot_reload);
+  }
   material_set->rootsig_list->iterate([](const StrHash, ID3D12RootSignature** rootsig) { (*rootsig)->Release(); });
   material_set->pso_list->iterate([](const StrHash, ID3D12PipelineState** pso) { (*pso)->Release(); });
   material_set->rootsig_list->~StrHashMap<ID3D12RootSignature*>();
   material_set->pso_list->~StrHashMap<ID3D12PipelineState*>();
   material_set->material_rootsig_map->~StrHashMap<StrHash>();
+  material_set->fallback_map->~StrHashMap<StrHash>();
+}
+void EnableMaterialHotReload(MaterialSet* material_set, FileLoader* file_loader, JobSystem* job_system) {
+  DEBUG_ASSERT(material_set->hot_reload == nullptr, DebugAssert{});
+  auto hot_reload = New<MaterialHotReload>();
+  hot_reload->file_loader = file_loader;
+  hot_reload->job_system = job_system;
+  hot_reload->file_list = GatherMaterialFileList(material_set->material_num, material_set->material_list);
+  const auto& filepath_list = *hot_reload->file_list.filepath_list;
+  hot_reload->file_watcher = CreateFileWatcher(filepath_list.size(), filepath_list.begin());
+  hot_reload->file_changed = AllocateArray<bool>(filepath_list.size());
+  for (uint32_t i = 0; i < filepath_list.size(); i++) {
+    hot_reload->file_changed[i] = false;
+  }
+  hot_reload->retired_list = New<ResizableArray<RetiredD3d12Object>>();
+  material_set->hot_reload = hot_reload;
+}
+void UpdateMaterialSet(MaterialSet* material_set, const uint64_t submitted_fence_val, const uint64_t completed_fence_val) {
+  UpdatePendingPsoList(material_set);
+  if (material_set->hot_reload) {
+    UpdateMaterialHotReload(material_set, submitted_fence_val, completed_fence_val);
+  }
+}
+bool IsMaterialReady(const MaterialSet* material_set, const StrHash material_id) {
+  return material_set->pso_list->contains(material_id);
+}
+StrHash GetReadyMaterial(const MaterialSet* material_set, const StrHash material_id) {
+  if (IsMaterialReady(material_set, material_id)) { return material_id; }
+  // fallbacks are not chained.
+  const auto fallback = material_set->fallback_map->get(material_id);
+  if (fallback != nullptr && IsMaterialReady(material_set, *fallback)) { return *fallback; }
+  return kEmptyStr;
 }
 ID3D12RootSignature* GetRootsig(const MaterialSet* material_set, const StrHash material_id) {
   const auto& rootsig_id = (*material_set->material_rootsig_map)[material_id];
   return (*material_set->rootsig_list)[rootsig_id];
 }
 ID3D12PipelineState* GetPso(const MaterialSet* material_set, const StrHash material_id) {
-  return (*material_set->pso_list)[material_id];
+  const auto pso = material_set->pso_list->get(material_id);
+  return (pso != nullptr) ? *pso : nullptr;
 }
 } // namespace boke
+#include <algorithm>
+#include <chrono>
 #include "doctest/doctest.h"
+#include "platform/file_io.h"
+namespace {
+/**
+ * stands in for d3d12 objects so that material set creation runs without a gpu.
+ **/
+template <typename T>
+class StubDeviceChild : public T {
+ public:
+  HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, void** object) override { *object = nullptr; return E_NOINTERFACE; }
+  ULONG STDMETHODCALLTYPE AddRef() override { return ++ref_count_; }
+  ULONG STDMETHODCALLTYPE Release() override {
+    const auto ref_count = --ref_count_;
+    if (ref_count == 0) { delete this; }
+    return ref_count;
+  }
+  HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID, UINT*, void*) override { return E_NOTIMPL; }
+  HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID, UINT, const void*) override { return E_NOTIMPL; }
+  HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID, const IUnknown*) override { return E_NOTIMPL; }
+  HRESULT STDMETHODCALLTYPE SetName(LPCWSTR) override { return S_OK; }
+  HRESULT STDMETHODCALLTYPE GetDevice(REFIID, void** device) override { *device = nullptr; return E_NOTIMPL; }
+ private:
+  std::atomic<ULONG> ref_count_{1};
+};
+class StubPipelineState final : public StubDeviceChild<ID3D12PipelineState> {
+ public:
+  HRESULT STDMETHODCALLTYPE GetCachedBlob(ID3DBlob** blob) override { *blob = nullptr; return E_NOTIMPL; }
+};
+class StubRootSignature final : public StubDeviceChild<ID3D12RootSignature> {};
+/**
+ * serializes entry names only, loading an entry returns a new stub pso.
+ **/
+class StubPipelineLibrary final : public StubDeviceChild<D3d12PipelineLibrary> {
+ public:
+  StubPipelineLibrary(const void* blob, const SIZE_T blob_size, std::atomic<uint32_t>* loaded_pso_num)
+      : entry_num_(std::min(static_cast<uint32_t>(blob_size / sizeof(EntryName)), kMaxEntryNum))
+      , loaded_pso_num_(loaded_pso_num) {
+    if (entry_num_ > 0) {
+      memcpy(entry_name_list_, blob, sizeof(EntryName) * entry_num_);
+    }
+  }
+  HRESULT STDMETHODCALLTYPE StorePipeline(LPCWSTR name, ID3D12PipelineState*) override {
+    if (FindEntry(name) || entry_num_ == kMaxEntryNum) { return E_INVALIDARG; }
+    wcscpy_s(entry_name_list_[entry_num_], boke::kPsoCacheEntryNameLen, name);
+    entry_num_++;
+    return S_OK;
+  }
+  HRESULT STDMETHODCALLTYPE LoadGraphicsPipeline(LPCWSTR, const D3D12_GRAPHICS_PIPELINE_STATE_DESC*, REFIID, void**) override { return E_NOTIMPL; }
+  HRESULT STDMETHODCALLTYPE LoadComputePipeline(LPCWSTR, const D3D12_COMPUTE_PIPELINE_STATE_DESC*, REFIID, void**) override { return E_NOTIMPL; }
+  SIZE_T STDMETHODCALLTYPE GetSerializedSize() override { return sizeof(EntryName) * entry_num_; }
+  HRESULT STDMETHODCALLTYPE Serialize(void* data, SIZE_T data_size) override {
+    if (data_size < GetSerializedSize()) { return E_INVALIDARG; }
+    memcpy(data, entry_name_list_, GetSerializedSize());
+    return S_OK;
+  }
+  HRESULT STDMETHODCALLTYPE LoadPipeline(LPCWSTR name, const D3D12_PIPELINE_STATE_STREAM_DESC*, REFIID, void** pso) override {
+    if (!FindEntry(name)) { return E_INVALIDARG; }
+    (*loaded_pso_num_)++;
+    *pso = static_cast<ID3D12PipelineState*>(new StubPipelineState);
+    return S_OK;
+  }
+ private:
+  static const uint32_t kMaxEntryNum = 16;
+  using EntryName = wchar_t[boke::kPsoCacheEntryNameLen];
+  bool FindEntry(LPCWSTR name) const {
+    for (uint32_t i = 0; i < entry_num_; i++) {
+      if (wcscmp(entry_name_list_[i], name) == 0) { return true; }
+    }
+    return false;
+  }
+  EntryName entry_name_list_[kMaxEntryNum]{};
+  uint32_t entry_num_{};
+  std::atomic<uint32_t>* loaded_pso_num_{};
+};
+/**
+ * implements the device calls material set creation makes, compiling a pso takes compile_latency,
+ * waits while compile_blocked is set and fails while compile_failing is set.
+ **/
+struct StubPsoDevice {
+  std::chrono::milliseconds compile_latency{};
+  std::atomic<bool> compile_blocked{};
+  std::atomic<bool> compile_failing{};
+  std::atomic<uint32_t> failed_pso_num{};
+  std::atomic<uint32_t> rootsig_num{};
+  std::atomic<uint32_t> pso_num{};
+  std::atomic<uint32_t> compiling_pso_num{};
+  std::atomic<uint32_t> max_compiling_pso_num{};
+  std::atomic<uint32_t> loaded_pso_num{};
+  HRESULT CreateRootSignature(UINT, const void*, SIZE_T, REFIID, void** rootsig) {
+    rootsig_num++;
+    *rootsig = static_cast<ID3D12RootSignature*>(new StubRootSignature);
+    return S_OK;
+  }
+  HRESULT CreatePipelineState(const D3D12_PIPELINE_STATE_STREAM_DESC*, REFIID, void** pso) {
+    while (compile_blocked.load()) {
+      std::this_thread::yield();
+    }
+    if (compile_failing.load()) {
+      failed_pso_num++;
+      return E_INVALIDARG;
+    }
+    const auto compiling_pso_num_now = ++compiling_pso_num;
+    auto max_num = max_compiling_pso_num.load();
+    while (max_num < compiling_pso_num_now && !max_compiling_pso_num.compare_exchange_weak(max_num, compiling_pso_num_now)) {}
+    std::this_thread::sleep_for(compile_latency);
+    compiling_pso_num--;
+    pso_num++;
+    *pso = static_cast<ID3D12PipelineState*>(new StubPipelineState);
+    return S_OK;
+  }
+  HRESULT CreatePipelineLibrary(const void* blob, SIZE_T blob_size, REFIID, void** pipeline_library) {
+    *pipeline_library = static_cast<D3d12PipelineLibrary*>(new StubPipelineLibrary(blob, blob_size, &loaded_pso_num));
+    return S_OK;
+  }
+};
+void WaitForMaterials(boke::MaterialSet* material_set, const uint32_t material_num, const boke::MaterialInfo* material_list) {
+  using namespace boke;
+  for (uint32_t i = 0; i < material_num; i++) {
+    const auto material_id = GetStrHash(material_list[i].name);
+    while (!IsMaterialReady(material_set, material_id)) {
+      std::this_thread::yield();
+      UpdateMaterialSet(material_set, 0, 0);
+    }
+  }
+}
+/**
+ * file change notifications and rebuilt psos arrive asynchronously.
+ **/
+template <typename F>
+auto UpdateMaterialSetUntil(boke::MaterialSet* material_set, const uint64_t submitted_fence_val, const uint64_t completed_fence_val, F&& condition) {
+  for (uint32_t i = 0; i < 5000 && !condition(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    boke::UpdateMaterialSet(material_set, submitted_fence_val, completed_fence_val);
+  }
+  return condition();
+}
+} // namespace
 TEST_CASE("create rootsig&pso") {
   using namespace boke;
   // allocator
   const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
-  auto main_buffer = new std::byte[main_buffer_size_in_bytes];
-  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
   // core units
   auto gfx_libraries = LoadGfxLibraries();
   auto dxgi = InitDxgi(gfx_libraries.dxgi_library, AdapterType::kHighPerformance);
   auto device = CreateDevice(gfx_libraries.d3d12_library, dxgi.adapter);
   // rootsig container
   StrHashMap<ID3D12RootSignature*> rootsig_list;
-  // parse json
-  const auto json = GetJson("tests/test-material-list.json");
-  for (const auto& material : json.GetArray()) {
-    auto rootsig = LoadRootsig(material["rootsig"], device, rootsig_list);
-    auto stream = CreatePsoDesc(material, rootsig.second);
+  // parse config
+  auto config = LoadGfxConfig("tests/formatted-config-multipass.json", {});
+  // load files
+  auto file_loader = CreateFileLoader(0);
+  auto file_list = GatherMaterialFileList(config->material_num, config->material_list);
+  auto batch = SubmitFileLoadBatch(file_loader, file_list.filepath_list->size(), file_list.filepath_list->begin());
+  WaitFileLoadBatch(file_loader, batch, nullptr, nullptr);
+  for (uint32_t i = 0; i < config->material_num; i++) {
+    const auto& material = config->material_list[i];
+    auto rootsig = LoadRootsig(material.rootsig, file_list, batch, device, rootsig_list);
+    auto stream = CreatePsoDesc(material, rootsig.second, file_list, batch);
     auto pso = CreatePso(device, stream);
-    CleanupShaderObject(stream);
     CHECK_NE(pso, nullptr);
     pso->Release();
   }
   // terminate
+  ReleaseFileLoadBatch(batch);
+  ReleaseMaterialFileList(file_list);
+  ReleaseFileLoader(file_loader);
+  ReleaseGfxConfig(config);
   rootsig_list.iterate([](const StrHash, ID3D12RootSignature** rootsig) {(*rootsig)->Release();});
   rootsig_list.~StrHashMap<ID3D12RootSignature*>();
   device->Release();
   TermDxgi(dxgi);
   ReleaseGfxLibraries(gfx_libraries);
-  delete[] main_buffer;
 }
 TEST_CASE("create materials") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  auto config = LoadGfxConfig("tests/formatted-config-multipass.json", {});
+  auto file_loader = CreateFileLoader(0);
+  uint32_t worker_thread_num = 0;
+  SUBCASE("no worker thread") {
+    worker_thread_num = 0;
+  }
+  SUBCASE("with worker threads") {
+    worker_thread_num = 3;
+  }
+  auto job_system = CreateJobSystem(worker_thread_num);
+  StubPsoDevice device{.compile_latency = std::chrono::milliseconds(20),};
+  auto material_set = CreateMaterialSetImpl(config->material_num, config->material_list, &device, file_loader, job_system, nullptr);
+  WaitForMaterials(material_set, config->material_num, config->material_list);
+  // lighting and tonemap are permutations with identical inputs and share a pso.
+  CHECK_EQ(device.pso_num.load(), config->material_num - 1);
+  CHECK_EQ(GetPso(material_set, GetStrHash(config->material_list[1].name)), GetPso(material_set, GetStrHash(config->material_list[2].name)));
+  // rootsigs shared among materials are created once.
+  CHECK_EQ(device.rootsig_num.load(), material_set->rootsig_list->size());
+  CHECK_LT(device.rootsig_num.load(), config->material_num);
+  if (worker_thread_num > 0) {
+    CHECK_GT(device.max_compiling_pso_num.load(), 1);
+  } else {
+    CHECK_EQ(device.max_compiling_pso_num.load(), 1);
+  }
+  for (uint32_t i = 0; i < config->material_num; i++) {
+    CAPTURE(i);
+    const auto material_id = GetStrHash(config->material_list[i].name);
+    CHECK_NE(GetPso(material_set, material_id), nullptr);
+    CHECK_NE(GetRootsig(material_set, material_id), nullptr);
+  }
+  ReleaseMaterialSet(material_set);
+  ReleaseJobSystem(job_system);
+  ReleaseFileLoader(file_loader);
+  ReleaseGfxConfig(config);
+}
+TEST_CASE("pso cache") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  auto config = LoadGfxConfig("tests/formatted-config-multipass.json", {});
+  auto file_loader = CreateFileLoader(0);
+  auto job_system = CreateJobSystem(2);
+  const char pso_cache_path[] = "tests/pso-cache-material-test.psocache";
+  RemoveFile(pso_cache_path);
+  auto create_material_set = [&](const MaterialInfo* material_list) {
+    StubPsoDevice device;
+    auto material_set = CreateMaterialSetImpl(config->material_num, material_list, &device, file_loader, job_system, pso_cache_path);
+    WaitForMaterials(material_set, config->material_num, material_list);
+    for (uint32_t i = 0; i < config->material_num; i++) {
+      CHECK_NE(GetPso(material_set, GetStrHash(material_list[i].name)), nullptr);
+    }
+    ReleaseMaterialSet(material_set);
+    return std::make_pair(device.pso_num.load(), device.loaded_pso_num.load());
+  };
+  // lighting and tonemap share a pso.
+  const auto pso_num = config->material_num - 1;
+  // cold start compiles every pso and writes the cache.
+  auto [compiled_num, loaded_num] = create_material_set(config->material_list);
+  CHECK_EQ(compiled_num, pso_num);
+  CHECK_EQ(loaded_num, 0);
+  // warm start skips compilation entirely.
+  std::tie(compiled_num, loaded_num) = create_material_set(config->material_list);
+  CHECK_EQ(compiled_num, 0);
+  CHECK_EQ(loaded_num, pso_num);
+  // a change in inputs invalidates the entry of that material only.
+  auto material_list = AllocateArray<MaterialInfo>(config->material_num);
+  for (uint32_t i = 0; i < config->material_num; i++) {
+    material_list[i] = config->material_list[i];
+  }
+  REQUIRE_GT(material_list[0].rtv_num, 0);
+  material_list[0].rtv_num--;
+  std::tie(compiled_num, loaded_num) = create_material_set(material_list);
+  CHECK_EQ(compiled_num, 1);
+  CHECK_EQ(loaded_num, pso_num - 1);
+  std::tie(compiled_num, loaded_num) = create_material_set(material_list);
+  CHECK_EQ(compiled_num, 0);
+  CHECK_EQ(loaded_num, pso_num);
+  Deallocate(material_list);
+  RemoveFile(pso_cache_path);
+  ReleaseJobSystem(job_system);
+  ReleaseFileLoader(file_loader);
+  ReleaseGfxConfig(config);
+}
+TEST_CASE("deferred materials") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  auto config = LoadGfxConfig("tests/formatted-config-multipass.json", {});
+  auto file_loader = CreateFileLoader(0);
+  auto job_system = CreateJobSystem(2);
+  const char pso_cache_path[] = "tests/pso-cache-deferred-test.psocache";
+  RemoveFile(pso_cache_path);
+  // copy-texture is cached and dispatched first, so it becomes ready while the other psos are blocked.
+  const uint32_t material_num = 5;
+  REQUIRE_EQ(config->material_num, material_num);
+  const auto& gbuffer = config->material_list[0];
+  const auto& lighting = config->material_list[1];
+  const auto& tonemap = config->material_list[2];
+  const auto& oetf = config->material_list[3];
+  const auto& copy_texture = config->material_list[4];
+  {
+    StubPsoDevice device;
+    auto material_set = CreateMaterialSetImpl(1, &copy_texture, &device, file_loader, job_system, pso_cache_path);
+    ReleaseMaterialSet(material_set);
+  }
+  MaterialInfo material_list[material_num] = {copy_texture, gbuffer, lighting, tonemap, oetf,};
+  material_list[3].fallback = lighting.name;
+  material_list[4].fallback = copy_texture.name;
+  StubPsoDevice device;
+  device.compile_blocked = true;
+  auto material_set = CreateMaterialSetImpl(material_num, material_list, &device, file_loader, job_system, pso_cache_path);
+  const auto copy_texture_id = GetStrHash(copy_texture.name);
+  while (!IsMaterialReady(material_set, copy_texture_id)) {
+    std::this_thread::yield();
+    UpdateMaterialSet(material_set, 0, 0);
+  }
+  CHECK_EQ(device.pso_num.load(), 0);
+  CHECK_EQ(GetReadyMaterial(material_set, copy_texture_id), copy_texture_id);
+  CHECK_NE(GetPso(material_set, copy_texture_id), nullptr);
+  for (const auto& material : {gbuffer, lighting, tonemap, oetf}) {
+    const auto material_id = GetStrHash(material.name);
+    CHECK_UNARY_FALSE(IsMaterialReady(material_set, material_id));
+    CHECK_EQ(GetPso(material_set, material_id), nullptr);
+  }
+  // passes with neither the material nor its fallback ready are skipped.
+  CHECK_EQ(GetReadyMaterial(material_set, GetStrHash(gbuffer.name)), kEmptyStr);
+  CHECK_EQ(GetReadyMaterial(material_set, GetStrHash(tonemap.name)), kEmptyStr);
+  CHECK_EQ(GetReadyMaterial(material_set, GetStrHash(oetf.name)), copy_texture_id);
+  device.compile_blocked = false;
+  WaitForMaterials(material_set, material_num, material_list);
+  // copy-texture is cached, tonemap shares the pso of lighting.
+  CHECK_EQ(device.pso_num.load(), material_num - 2);
+  for (const auto& material : material_list) {
+    const auto material_id = GetStrHash(material.name);
+    CHECK_EQ(GetReadyMaterial(material_set, material_id), material_id);
+    CHECK_NE(GetRootsig(material_set, material_id), nullptr);
+  }
+  ReleaseMaterialSet(material_set);
+  RemoveFile(pso_cache_path);
+  ReleaseJobSystem(job_system);
+  ReleaseFileLoader(file_loader);
+  ReleaseGfxConfig(config);
+}
+TEST_CASE("failed materials") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  auto config = LoadGfxConfig("tests/formatted-config-multipass.json", {});
+  auto file_loader = CreateFileLoader(0);
+  auto job_system = CreateJobSystem(2);
+  const char pso_cache_path[] = "tests/pso-cache-failed-test.psocache";
+  RemoveFile(pso_cache_path);
+  const auto& gbuffer = config->material_list[0];
+  const auto& oetf = config->material_list[3];
+  const auto& copy_texture = config->material_list[4];
+  {
+    StubPsoDevice device;
+    auto material_set = CreateMaterialSetImpl(1, &copy_texture, &device, file_loader, job_system, pso_cache_path);
+    ReleaseMaterialSet(material_set);
+  }
+  const uint32_t material_num = 3;
+  MaterialInfo material_list[material_num] = {copy_texture, gbuffer, oetf,};
+  material_list[2].fallback = copy_texture.name;
+  StubPsoDevice device;
+  device.compile_failing = true;
+  auto material_set = CreateMaterialSetImpl(material_num, material_list, &device, file_loader, job_system, pso_cache_path);
+  CHECK_UNARY(UpdateMaterialSetUntil(material_set, 0, 0, [&]() { return material_set->pending_pso_list == nullptr; }));
+  CHECK_EQ(device.failed_pso_num.load(), 2);
+  // failed materials are never published, their passes fall back or are skipped.
+  const auto copy_texture_id = GetStrHash(copy_texture.name);
+  CHECK_UNARY(IsMaterialReady(material_set, copy_texture_id));
+  CHECK_UNARY_FALSE(IsMaterialReady(material_set, GetStrHash(gbuffer.name)));
+  CHECK_EQ(GetPso(material_set, GetStrHash(gbuffer.name)), nullptr);
+  CHECK_EQ(GetReadyMaterial(material_set, GetStrHash(gbuffer.name)), kEmptyStr);
+  CHECK_EQ(GetReadyMaterial(material_set, GetStrHash(oetf.name)), copy_texture_id);
+  ReleaseMaterialSet(material_set);
+  // the cache keeps the pso that was created only.
+  auto cache_file = LoadPsoCacheFile(pso_cache_path);
+  CHECK_EQ(cache_file.entry_num, 1);
+  ReleasePsoCacheFile(cache_file);
+  RemoveFile(pso_cache_path);
+  ReleaseJobSystem(job_system);
+  ReleaseFileLoader(file_loader);
+  ReleaseGfxConfig(config);
+}
+TEST_CASE("material hot reload") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  const char* filepath_list[] = {
+    "tests/hot-reload-a.rs",
+    "tests/hot-reload-b.rs",
+    "tests/hot-reload-ms.cso",
+    "tests/hot-reload-a-ps.cso",
+    "tests/hot-reload-b-ps.cso",
+  };
+  const char content[] = "hot reload";
+  auto save_file = [&](const char* const filepath) { return SaveBufferToFile(filepath, content, sizeof(content)); };
+  for (const auto& filepath : filepath_list) {
+    REQUIRE_UNARY(save_file(filepath));
+  }
+  MaterialShaderInfo shader_list_a[] = {{.target = "ms", .filename = filepath_list[2],}, {.target = "ps", .filename = filepath_list[3],},};
+  MaterialShaderInfo shader_list_b[] = {{.target = "ms", .filename = filepath_list[2],}, {.target = "ps", .filename = filepath_list[4],},};
+  const MaterialInfo material_list[] = {
+    {.name = "hot-reload-a", .rootsig = filepath_list[0], .shader_num = 2, .shader_list = shader_list_a,},
+    {.name = "hot-reload-b", .rootsig = filepath_list[1], .shader_num = 2, .shader_list = shader_list_b,},
+  };
+  const auto material_a = GetStrHash(material_list[0].name);
+  const auto material_b = GetStrHash(material_list[1].name);
+  auto file_loader = CreateFileLoader(0);
+  auto job_system = CreateJobSystem(2);
+  StubPsoDevice device;
+  auto material_set = CreateMaterialSetImpl(2, material_list, &device, file_loader, job_system, nullptr);
+  EnableMaterialHotReload(material_set, file_loader, job_system);
+  WaitForMaterials(material_set, 2, material_list);
+  REQUIRE_EQ(device.pso_num.load(), 2);
+  REQUIRE_EQ(device.rootsig_num.load(), 2);
+  auto pso_a = GetPso(material_set, material_a);
+  auto pso_b = GetPso(material_set, material_b);
+  auto rootsig_a = GetRootsig(material_set, material_a);
+  auto rootsig_b = GetRootsig(material_set, material_b);
+  auto is_rebuilt = [&](const uint32_t pso_num) { return device.pso_num.load() == pso_num && material_set->hot_reload->pso_rebuild == nullptr; };
+  // only the material using the shader is rebuilt.
+  pso_a->AddRef();
+  REQUIRE_UNARY(save_file(filepath_list[3]));
+  CHECK_UNARY(UpdateMaterialSetUntil(material_set, 1, 0, [&]() { return is_rebuilt(3); }));
+  CHECK_NE(GetPso(material_set, material_a), pso_a);
+  CHECK_EQ(device.rootsig_num.load(), 2);
+  CHECK_EQ(GetPso(material_set, material_b), pso_b);
+  CHECK_EQ(GetRootsig(material_set, material_a), rootsig_a);
+  // the replaced pso is kept until the gpu passes the frame submitted before the swap.
+  UpdateMaterialSet(material_set, 1, 0);
+  CHECK_EQ(pso_a->AddRef(), 3);
+  pso_a->Release();
+  UpdateMaterialSet(material_set, 2, 1);
+  CHECK_EQ(pso_a->Release(), 0);
+  pso_a = GetPso(material_set, material_a);
+  // a shader shared by both materials, replaced objects are kept from here on so that their addresses are not reused.
+  REQUIRE_UNARY(save_file(filepath_list[2]));
+  CHECK_UNARY(UpdateMaterialSetUntil(material_set, 2, 1, [&]() { return is_rebuilt(5); }));
+  CHECK_NE(GetPso(material_set, material_a), pso_a);
+  CHECK_NE(GetPso(material_set, material_b), pso_b);
+  CHECK_EQ(device.rootsig_num.load(), 2);
+  pso_a = GetPso(material_set, material_a);
+  pso_b = GetPso(material_set, material_b);
+  // a rootsig is recreated along with psos of materials using it.
+  REQUIRE_UNARY(save_file(filepath_list[1]));
+  CHECK_UNARY(UpdateMaterialSetUntil(material_set, 3, 1, [&]() { return is_rebuilt(6); }));
+  CHECK_NE(GetPso(material_set, material_b), pso_b);
+  CHECK_EQ(device.rootsig_num.load(), 3);
+  CHECK_NE(GetRootsig(material_set, material_b), rootsig_b);
+  CHECK_EQ(GetRootsig(material_set, material_a), rootsig_a);
+  CHECK_EQ(GetPso(material_set, material_a), pso_a);
+  pso_b = GetPso(material_set, material_b);
+  // psos failing to compile leave the current ones in place.
+  device.compile_failing = true;
+  REQUIRE_UNARY(save_file(filepath_list[4]));
+  CHECK_UNARY(UpdateMaterialSetUntil(material_set, 4, 1, [&]() { return device.failed_pso_num.load() > 0 && material_set->hot_reload->pso_rebuild == nullptr; }));
+  CHECK_EQ(GetPso(material_set, material_b), pso_b);
+  CHECK_UNARY(IsMaterialReady(material_set, material_b));
+  ReleaseMaterialSet(material_set);
+  ReleaseJobSystem(job_system);
+  ReleaseFileLoader(file_loader);
+  for (const auto& filepath : filepath_list) {
+    RemoveFile(filepath);
+  }
 }
@@ -1,8 +1,41 @@
 #pragma once
 namespace boke {
+struct FileLoader;
+struct JobSystem;
+struct MaterialInfo;
 struct MaterialSet;
-MaterialSet* CreateMaterialSet(const rapidjson::Value& json, D3d12Device* device);
+/**
+ * returns once material files are loaded, psos keep compiling on worker threads of job_system
+ * (or are compiled before returning if it has none). the calling thread must be a worker of job_system.
+ * psos found in the pipeline library at pso_cache_path are loaded instead of compiled,
+ * the file is rewritten if any pso was compiled. pass nullptr to disable the cache.
+ * material_list and pso_cache_path must stay valid until every material is ready.
+ **/
+MaterialSet* CreateMaterialSet(const uint32_t material_num, const MaterialInfo* material_list, D3d12Device* device, FileLoader* file_loader, JobSystem* job_system, const char* const pso_cache_path);
+/**
+ * waits for psos still being compiled.
+ **/
 void ReleaseMaterialSet(MaterialSet* material_set);
+/**
+ * watches rootsigs and shader objects of the set, psos of materials whose files changed are rebuilt
+ * on worker threads of job_system and swapped in by UpdateMaterialSet, the rest are kept as they are.
+ * material_list passed to CreateMaterialSet must stay valid until the set is released.
+ **/
+void EnableMaterialHotReload(MaterialSet* material_set, FileLoader* file_loader, JobSystem* job_system);
+/**
+ * makes psos compiled since the last call available, call at a frame boundary while no pass is recorded.
+ * psos and rootsigs replaced by hot reload are released once completed_fence_val reaches
+ * submitted_fence_val of the call which replaced them, i.e. once no submitted frame uses them.
+ **/
+void UpdateMaterialSet(MaterialSet* material_set, const uint64_t submitted_fence_val, const uint64_t completed_fence_val);
+bool IsMaterialReady(const MaterialSet*, const StrHash material_id);
+/**
+ * material_id if ready, otherwise its fallback material if that is ready, otherwise kEmptyStr.
+ **/
+StrHash GetReadyMaterial(const MaterialSet*, const StrHash material_id);
 ID3D12RootSignature* GetRootsig(const MaterialSet*, const StrHash material_id);
+/**
+ * nullptr until the material is ready.
+ **/
 ID3D12PipelineState* GetPso(const MaterialSet*, const StrHash material_id);
 }
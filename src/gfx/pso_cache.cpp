@@ -0,0 +1,255 @@
+#include <limits>
+#include "boke/allocator.h"
+#include "boke/debug_assert.h"
+#include "boke/file.h"
+#include "boke/file_loader.h"
+#include "boke/util.h"
+#include "pso_cache.h"
+namespace {
+using namespace boke;
+const uint32_t kPsoCacheMagic = 0x4c505342; // "BSPL"
+/**
+ * bump when pso desc creation changes, keys and libraries of older versions are discarded.
+ **/
+const uint32_t kPsoCacheVersion = 1;
+const uint32_t kPsoCacheAlignment = 8;
+struct PsoCacheFileHeader {
+  uint32_t magic{};
+  uint32_t version{};
+  uint32_t entry_num{};
+  uint32_t library_offset{};
+  uint64_t library_size{};
+  uint64_t file_size{};
+};
+const uint64_t kFnv1aOffsetBasis = 0xcbf29ce484222325ULL;
+const uint64_t kFnv1aPrime = 0x100000001b3ULL;
+auto HashBytes(const void* data, const uint64_t size, const uint64_t hash) {
+  auto bytes = static_cast<const uint8_t*>(data);
+  auto result = hash;
+  for (uint64_t i = 0; i < size; i++) {
+    result = (result ^ bytes[i]) * kFnv1aPrime;
+  }
+  return result;
+}
+template <typename T>
+auto HashValue(const T& value, const uint64_t hash) {
+  return HashBytes(&value, sizeof(value), hash);
+}
+auto HashFile(const LoadedFile& file, const uint64_t hash) {
+  // size is hashed too so that concatenated inputs cannot collide by shifting bytes between files.
+  return HashBytes(file.buffer, file.size, HashValue(file.size, hash));
+}
+auto GetLibraryOffset(const uint32_t entry_num) {
+  return Align(GetUint32(sizeof(PsoCacheFileHeader) + sizeof(PsoCacheKey) * entry_num), kPsoCacheAlignment);
+}
+auto IsValidHeader(const PsoCacheFileHeader& header, const uint64_t file_size) {
+  // entry_num is checked before GetLibraryOffset, which wraps around for large counts.
+  return header.magic == kPsoCacheMagic
+      && header.version == kPsoCacheVersion
+      && header.file_size == file_size
+      && header.entry_num <= (file_size - sizeof(PsoCacheFileHeader)) / sizeof(PsoCacheKey)
+      && header.library_offset == GetLibraryOffset(header.entry_num)
+      && header.library_offset <= file_size
+      && header.library_size == file_size - header.library_offset;
+}
+} // namespace
+namespace boke {
+PsoCacheKey CalcPsoCacheKey(const LoadedFile& rootsig, const uint32_t shader_num, const LoadedFile* shader_list, const uint32_t rtv_num, const DXGI_FORMAT* rtv_format) {
+  auto hash = HashValue(kPsoCacheVersion, kFnv1aOffsetBasis);
+  hash = HashFile(rootsig, hash);
+  hash = HashValue(shader_num, hash);
+  for (uint32_t i = 0; i < shader_num; i++) {
+    hash = HashFile(shader_list[i], hash);
+  }
+  hash = HashValue(rtv_num, hash);
+  return HashBytes(rtv_format, sizeof(DXGI_FORMAT) * rtv_num, hash);
+}
+void GetPsoCacheEntryName(const PsoCacheKey key, wchar_t* name) {
+  const wchar_t digits[] = L"0123456789abcdef";
+  const uint32_t digit_num = kPsoCacheEntryNameLen - 1;
+  for (uint32_t i = 0; i < digit_num; i++) {
+    name[i] = digits[(key >> ((digit_num - 1 - i) * 4)) & 0xf];
+  }
+  name[digit_num] = L'\0';
+}
+PsoCacheFile LoadPsoCacheFile(const char* const filepath) {
+  auto file = MapFile(filepath);
+  if (file.buffer == nullptr) { return {}; }
+  if (file.size < sizeof(PsoCacheFileHeader)) {
+    UnmapFile(file);
+    return {};
+  }
+  const auto& header = *reinterpret_cast<const PsoCacheFileHeader*>(file.buffer);
+  if (!IsValidHeader(header, file.size)) {
+    UnmapFile(file);
+    return {};
+  }
+  return {
+    .file = file,
+    .entry_num = header.entry_num,
+    .entry_list = reinterpret_cast<const PsoCacheKey*>(file.buffer + sizeof(PsoCacheFileHeader)),
+    .library = (header.library_size > 0) ? file.buffer + header.library_offset : nullptr,
+    .library_size = header.library_size,
+  };
+}
+void ReleasePsoCacheFile(PsoCacheFile& cache_file) {
+  UnmapFile(cache_file.file);
+  cache_file = {};
+}
+bool ContainsPsoCacheEntry(const PsoCacheFile& cache_file, const PsoCacheKey key) {
+  for (uint32_t i = 0; i < cache_file.entry_num; i++) {
+    if (cache_file.entry_list[i] == key) { return true; }
+  }
+  return false;
+}
+bool SavePsoCacheFile(const char* const filepath, const uint32_t entry_num, const PsoCacheKey* entry_list, const void* library, const uint64_t library_size) {
+  const auto library_offset = GetLibraryOffset(entry_num);
+  const auto file_size = library_offset + library_size;
+  // SaveBufferToFile takes uint32_t.
+  DEBUG_ASSERT(file_size < std::numeric_limits<uint32_t>::max(), DebugAssert{});
+  if (file_size >= std::numeric_limits<uint32_t>::max()) { return false; }
+  const PsoCacheFileHeader header{
+    .magic = kPsoCacheMagic,
+    .version = kPsoCacheVersion,
+    .entry_num = entry_num,
+    .library_offset = library_offset,
+    .library_size = library_size,
+    .file_size = file_size,
+  };
+  auto buffer = AllocateArray<char>(GetUint32(file_size));
+  memset(buffer, 0, library_offset);
+  memcpy(buffer, &header, sizeof(header));
+  if (entry_num > 0) {
+    memcpy(buffer + sizeof(header), entry_list, sizeof(PsoCacheKey) * entry_num);
+  }
+  if (library_size > 0) {
+    memcpy(buffer + library_offset, library, library_size);
+  }
+  const auto result = SaveBufferToFile(filepath, buffer, GetUint32(file_size));
+  Deallocate(buffer);
+  return result;
+}
+} // namespace boke
+#include <memory>
+#include "doctest/doctest.h"
+#include "platform/file_io.h"
+TEST_CASE("pso cache key") {
+  using namespace boke;
+  const char rootsig_data[] = "rootsig";
+  const char vs_data[] = "vertex shader";
+  const char ps_data[] = "pixel shader";
+  const LoadedFile rootsig{.buffer = rootsig_data, .size = sizeof(rootsig_data),};
+  const LoadedFile shader_list[] = {
+    {.buffer = vs_data, .size = sizeof(vs_data),},
+    {.buffer = ps_data, .size = sizeof(ps_data),},
+  };
+  const DXGI_FORMAT rtv_format[] = {DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT,};
+  const auto key = CalcPsoCacheKey(rootsig, 2, shader_list, 2, rtv_format);
+  CHECK_EQ(CalcPsoCacheKey(rootsig, 2, shader_list, 2, rtv_format), key);
+  SUBCASE("bytecode change") {
+    const char ps_modified_data[] = "pixel shadex";
+    const LoadedFile modified_shader_list[] = {
+      shader_list[0],
+      {.buffer = ps_modified_data, .size = sizeof(ps_modified_data),},
+    };
+    CHECK_NE(CalcPsoCacheKey(rootsig, 2, modified_shader_list, 2, rtv_format), key);
+  }
+  SUBCASE("rootsig change") {
+    const LoadedFile modified_rootsig{.buffer = rootsig_data, .size = sizeof(rootsig_data) - 1,};
+    CHECK_NE(CalcPsoCacheKey(modified_rootsig, 2, shader_list, 2, rtv_format), key);
+  }
+  SUBCASE("rtv format change") {
+    const DXGI_FORMAT modified_rtv_format[] = {DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM,};
+    CHECK_NE(CalcPsoCacheKey(rootsig, 2, shader_list, 2, modified_rtv_format), key);
+    CHECK_NE(CalcPsoCacheKey(rootsig, 2, shader_list, 1, rtv_format), key);
+  }
+  SUBCASE("bytes moved between shaders") {
+    const LoadedFile moved_shader_list[] = {
+      {.buffer = vs_data, .size = sizeof(vs_data) - 1,},
+      {.buffer = ps_data, .size = sizeof(ps_data),},
+    };
+    CHECK_NE(CalcPsoCacheKey(rootsig, 2, moved_shader_list, 2, rtv_format), key);
+    CHECK_NE(CalcPsoCacheKey(rootsig, 1, shader_list, 2, rtv_format), key);
+  }
+}
+TEST_CASE("pso cache entry name") {
+  using namespace boke;
+  wchar_t name[kPsoCacheEntryNameLen];
+  GetPsoCacheEntryName(0x0123456789abcdefULL, name);
+  CHECK_EQ(wcscmp(name, L"0123456789abcdef"), 0);
+  GetPsoCacheEntryName(0, name);
+  CHECK_EQ(wcscmp(name, L"0000000000000000"), 0);
+}
+TEST_CASE("pso cache file") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 16 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  const char cache_path[] = "tests/pso-cache-test.bin";
+  const PsoCacheKey entry_list[] = {1, 0xffffffffffffffffULL, 3,};
+  const char library[] = "serialized pipeline library";
+  SUBCASE("round trip") {
+    REQUIRE_UNARY(SavePsoCacheFile(cache_path, 3, entry_list, library, sizeof(library)));
+    auto cache_file = LoadPsoCacheFile(cache_path);
+    REQUIRE_NE(cache_file.library, nullptr);
+    CHECK_EQ(cache_file.entry_num, 3);
+    CHECK_EQ(cache_file.library_size, sizeof(library));
+    CHECK_EQ(memcmp(cache_file.library, library, sizeof(library)), 0);
+    CHECK_EQ(reinterpret_cast<uintptr_t>(cache_file.library) % alignof(uint64_t), 0);
+    for (const auto& key : entry_list) {
+      CHECK_UNARY(ContainsPsoCacheEntry(cache_file, key));
+    }
+    CHECK_UNARY_FALSE(ContainsPsoCacheEntry(cache_file, 2));
+    ReleasePsoCacheFile(cache_file);
+    CHECK_EQ(cache_file.library, nullptr);
+  }
+  SUBCASE("empty") {
+    REQUIRE_UNARY(SavePsoCacheFile(cache_path, 0, nullptr, nullptr, 0));
+    auto cache_file = LoadPsoCacheFile(cache_path);
+    CHECK_EQ(cache_file.entry_num, 0);
+    CHECK_EQ(cache_file.library, nullptr);
+    CHECK_UNARY_FALSE(ContainsPsoCacheEntry(cache_file, 1));
+    ReleasePsoCacheFile(cache_file);
+  }
+  SUBCASE("truncated file") {
+    REQUIRE_UNARY(SavePsoCacheFile(cache_path, 3, entry_list, library, sizeof(library)));
+    uint32_t size = 0;
+    auto buffer = LoadFileToBuffer(cache_path, &size);
+    REQUIRE_NE(buffer, nullptr);
+    REQUIRE_UNARY(SaveBufferToFile(cache_path, buffer, size - 1));
+    Deallocate(buffer);
+    auto cache_file = LoadPsoCacheFile(cache_path);
+    CHECK_EQ(cache_file.library, nullptr);
+    CHECK_EQ(cache_file.entry_num, 0);
+  }
+  SUBCASE("incompatible file") {
+    const char text[] = "not a pso cache, long enough for a header";
+    REQUIRE_UNARY(SaveBufferToFile(cache_path, text, sizeof(text)));
+    auto cache_file = LoadPsoCacheFile(cache_path);
+    CHECK_EQ(cache_file.library, nullptr);
+    CHECK_EQ(cache_file.entry_num, 0);
+  }
+  SUBCASE("entry num out of file") {
+    REQUIRE_UNARY(SavePsoCacheFile(cache_path, 3, entry_list, library, sizeof(library)));
+    uint32_t size = 0;
+    auto buffer = LoadFileToBuffer(cache_path, &size);
+    REQUIRE_NE(buffer, nullptr);
+    PsoCacheFileHeader header{};
+    memcpy(&header, buffer, sizeof(header));
+    // the key list size wraps to 0, leaving the library offset valid.
+    header.entry_num = 0x20000000;
+    header.library_offset = GetLibraryOffset(header.entry_num);
+    header.library_size = size - header.library_offset;
+    memcpy(buffer, &header, sizeof(header));
+    REQUIRE_UNARY(SaveBufferToFile(cache_path, buffer, size));
+    Deallocate(buffer);
+    auto cache_file = LoadPsoCacheFile(cache_path);
+    CHECK_EQ(cache_file.library, nullptr);
+    CHECK_EQ(cache_file.entry_num, 0);
+  }
+  SUBCASE("missing file") {
+    auto cache_file = LoadPsoCacheFile("tests/file-not-exist.bin");
+    CHECK_EQ(cache_file.library, nullptr);
+  }
+  RemoveFile(cache_path);
+}
@@ -0,0 +1,33 @@
+#pragma once
+namespace boke {
+struct LoadedFile;
+/**
+ * identifies a compiled pso by its inputs,
+ * any change in rootsig, shader bytecode or rtv formats results in another key.
+ **/
+using PsoCacheKey = uint64_t;
+PsoCacheKey CalcPsoCacheKey(const LoadedFile& rootsig, const uint32_t shader_num, const LoadedFile* shader_list, const uint32_t rtv_num, const DXGI_FORMAT* rtv_format);
+/**
+ * name of the entry in ID3D12PipelineLibrary, key in hex.
+ **/
+constexpr uint32_t kPsoCacheEntryNameLen = 17; // including terminator
+void GetPsoCacheEntryName(const PsoCacheKey key, wchar_t* name);
+/**
+ * header, keys of stored psos and serialized pipeline library, in this order.
+ * library is a read-only view of the mapped file and must outlive the pipeline library created from it.
+ **/
+struct PsoCacheFile {
+  MappedFile file{};
+  uint32_t entry_num{};
+  const PsoCacheKey* entry_list{};
+  const void* library{};
+  uint64_t library_size{};
+};
+/**
+ * returns an empty PsoCacheFile (library is nullptr) if the file is missing, truncated or was saved with another version.
+ **/
+PsoCacheFile LoadPsoCacheFile(const char* const filepath);
+void ReleasePsoCacheFile(PsoCacheFile&);
+bool ContainsPsoCacheEntry(const PsoCacheFile&, const PsoCacheKey key);
+bool SavePsoCacheFile(const char* const filepath, const uint32_t entry_num, const PsoCacheKey* entry_list, const void* library, const uint64_t library_size);
+}
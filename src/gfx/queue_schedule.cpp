@@ -0,0 +1,462 @@
+#include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/debug_assert.h"
+#include "boke/str_hash.h"
+#include "boke/util.h"
+#include "json.h"
+#include "render_pass_info.h"
+#include "resource_info.h"
+#include "config_loader.h"
+#include "queue_schedule.h"
+namespace {
+using namespace boke;
+const int32_t kNotWaited = -1;
+const uint32_t kMaxSyncedResourceNum = 32;
+constexpr auto ToIndex(const QueueType queue) {
+  return static_cast<uint32_t>(queue);
+}
+constexpr auto kDirect = ToIndex(QueueType::kDirect);
+struct QueueScheduleBuilder {
+  uint32_t max_batch_num{}; // per queue
+  const QueueType* pass_queue{};
+  uint32_t* pass_batch{}; // 1 based batch of the pass in its queue
+  uint32_t* open_pass_list[kQueueTypeNum]{};
+  uint32_t open_pass_num[kQueueTypeNum]{};
+  int32_t open_wait[kQueueTypeNum][kQueueTypeNum]{}; // signal of each queue the open batch waits for
+  uint32_t closed_batch_num[kQueueTypeNum]{};
+  /**
+   * latest signal of each queue known to be complete at the current point of a queue, kNotWaited if none.
+   * signal 0 is the end of the previous frame.
+   **/
+  int32_t known[kQueueTypeNum][kQueueTypeNum]{};
+  int32_t* batch_known{}; // known of each closed batch, [queue][batch][queue]
+  uint32_t* batch_list_index{}; // [queue][batch]
+  ResizableArray<QueueBatch>* batch_list{};
+  ResizableArray<uint32_t>* pass_index_list{};
+  ResizableArray<QueueWait>* wait_list{};
+};
+auto PushSyncedResource(const StrHash resource_id, const uint32_t list_len, StrHash* list, uint32_t* num) {
+  for (uint32_t i = 0; i < *num; i++) {
+    if (list[i] == resource_id) { return; }
+  }
+  DEBUG_ASSERT(*num < list_len, DebugAssert{});
+  list[*num] = resource_id;
+  (*num)++;
+}
+/**
+ * cbv are excluded, their frame buffered copies are written by cpu only.
+ **/
+auto GatherSyncedResources(const RenderPassInfo& render_pass_info, const uint32_t list_len, StrHash* list) {
+  uint32_t num = 0;
+  for (uint32_t i = 0; i < render_pass_info.srv_num; i++) {
+    PushSyncedResource(render_pass_info.srv[i], list_len, list, &num);
+  }
+  for (uint32_t i = 0; i < render_pass_info.uav_num; i++) {
+    PushSyncedResource(render_pass_info.uav[i], list_len, list, &num);
+  }
+  for (uint32_t i = 0; i < render_pass_info.rtv_num; i++) {
+    PushSyncedResource(render_pass_info.rtv[i], list_len, list, &num);
+  }
+  if (render_pass_info.dsv != kEmptyStr) {
+    PushSyncedResource(render_pass_info.dsv, list_len, list, &num);
+  }
+  if (render_pass_info.present != kEmptyStr) {
+    PushSyncedResource(render_pass_info.present, list_len, list, &num);
+  }
+  return num;
+}
+auto GetBatchSlot(const uint32_t queue, const uint32_t batch, const QueueScheduleBuilder& builder) {
+  return queue * builder.max_batch_num + batch - 1;
+}
+auto HasOpenWait(const uint32_t queue, const QueueScheduleBuilder& builder) {
+  for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+    if (builder.open_wait[queue][i] != kNotWaited) { return true; }
+  }
+  return false;
+}
+void CloseBatch(const uint32_t queue, QueueScheduleBuilder* builder) {
+  const auto batch = builder->closed_batch_num[queue] + 1;
+  DEBUG_ASSERT(batch <= builder->max_batch_num, DebugAssert{});
+  QueueBatch queue_batch{
+    .queue = static_cast<QueueType>(queue),
+    .pass_offset = builder->pass_index_list->size(),
+    .pass_num = builder->open_pass_num[queue],
+    .wait_offset = builder->wait_list->size(),
+  };
+  for (uint32_t i = 0; i < builder->open_pass_num[queue]; i++) {
+    builder->pass_index_list->push_back(builder->open_pass_list[queue][i]);
+  }
+  for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+    if (builder->open_wait[queue][i] == kNotWaited) { continue; }
+    builder->wait_list->push_back({
+        .queue = static_cast<QueueType>(i),
+        .signal_index = static_cast<uint32_t>(builder->open_wait[queue][i]),
+      });
+    builder->open_wait[queue][i] = kNotWaited;
+  }
+  queue_batch.wait_num = builder->wait_list->size() - queue_batch.wait_offset;
+  const auto slot = GetBatchSlot(queue, batch, *builder);
+  builder->batch_list_index[slot] = builder->batch_list->size();
+  builder->batch_list->push_back(queue_batch);
+  builder->known[queue][queue] = static_cast<int32_t>(batch);
+  for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+    builder->batch_known[slot * kQueueTypeNum + i] = builder->known[queue][i];
+  }
+  builder->closed_batch_num[queue] = batch;
+  builder->open_pass_num[queue] = 0;
+}
+void SignalBatch(const uint32_t queue, const uint32_t batch, QueueScheduleBuilder* builder) {
+  (*builder->batch_list)[builder->batch_list_index[GetBatchSlot(queue, batch, *builder)]].signal_index = batch;
+}
+/**
+ * waits are issued before a batch executes, so passes already in the open batch are closed into their own batch.
+ **/
+void WaitForBatch(const uint32_t queue, const uint32_t signal_queue, const uint32_t batch, QueueScheduleBuilder* builder) {
+  if (builder->known[queue][signal_queue] >= static_cast<int32_t>(batch)) { return; }
+  if (builder->open_pass_num[queue] > 0) {
+    CloseBatch(queue, builder);
+  }
+  builder->open_wait[queue][signal_queue] = static_cast<int32_t>(batch);
+  if (batch == 0) {
+    // the previous frame ended with the direct queue waiting for all the others.
+    for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+      if (signal_queue != kDirect && i != signal_queue) { continue; }
+      if (builder->known[queue][i] < 0) {
+        builder->known[queue][i] = 0;
+      }
+    }
+    return;
+  }
+  SignalBatch(signal_queue, batch, builder);
+  const auto slot = GetBatchSlot(signal_queue, batch, *builder);
+  for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+    const auto known = builder->batch_known[slot * kQueueTypeNum + i];
+    if (builder->known[queue][i] < known) {
+      builder->known[queue][i] = known;
+    }
+  }
+}
+void AddDependency(const uint32_t pass_index, const uint32_t producer_pass_index, QueueScheduleBuilder* builder) {
+  const auto queue = ToIndex(builder->pass_queue[pass_index]);
+  const auto signal_queue = ToIndex(builder->pass_queue[producer_pass_index]);
+  if (queue == signal_queue) { return; }
+  const auto batch = builder->pass_batch[producer_pass_index];
+  if (builder->known[queue][signal_queue] >= static_cast<int32_t>(batch)) { return; }
+  if (batch > builder->closed_batch_num[signal_queue]) {
+    CloseBatch(signal_queue, builder);
+  }
+  WaitForBatch(queue, signal_queue, batch, builder);
+}
+} // namespace
+namespace boke {
+QueueType GetQueueType(const StrHash queue) {
+  switch (queue) {
+    case "compute"_id: { return QueueType::kCompute; }
+    case "copy"_id:    { return QueueType::kCopy; }
+    default:           { return QueueType::kDirect; }
+  }
+}
+bool IsQueueName(const StrHash queue) {
+  switch (queue) {
+    case "direct"_id:
+    case "compute"_id:
+    case "copy"_id: {
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+QueueSchedule* CompileQueueSchedule(const RenderPassList& render_pass_list) {
+  const auto pass_num = render_pass_list.render_pass_len;
+  auto pass_queue = AllocateArray<QueueType>(pass_num);
+  for (uint32_t i = 0; i < pass_num; i++) {
+    pass_queue[i] = GetQueueType(render_pass_list.render_pass_info[i].queue);
+  }
+  ResizableArray<QueueBatch> batch_list;
+  ResizableArray<uint32_t> pass_index_list(pass_num);
+  ResizableArray<QueueWait> wait_list;
+  QueueScheduleBuilder builder{
+    .max_batch_num = pass_num + 1,
+    .pass_queue = pass_queue,
+    .pass_batch = AllocateArray<uint32_t>(pass_num),
+    .batch_known = AllocateArray<int32_t>(kQueueTypeNum * (pass_num + 1) * kQueueTypeNum),
+    .batch_list_index = AllocateArray<uint32_t>(kQueueTypeNum * (pass_num + 1)),
+    .batch_list = &batch_list,
+    .pass_index_list = &pass_index_list,
+    .wait_list = &wait_list,
+  };
+  for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+    builder.open_pass_list[i] = AllocateArray<uint32_t>(pass_num);
+    for (uint32_t j = 0; j < kQueueTypeNum; j++) {
+      builder.open_wait[i][j] = kNotWaited;
+      // the direct queue waited for every queue at the end of the previous frame.
+      builder.known[i][j] = (i == kDirect || i == j) ? 0 : kNotWaited;
+    }
+  }
+  StrHash resource_list[kMaxSyncedResourceNum]{};
+  // last users of the previous frame, the list repeats every frame.
+  StrHashMap<uint32_t> frame_last_user;
+  for (uint32_t i = 0; i < pass_num; i++) {
+    const auto resource_num = GatherSyncedResources(render_pass_list.render_pass_info[i], kMaxSyncedResourceNum, resource_list);
+    for (uint32_t j = 0; j < resource_num; j++) {
+      frame_last_user[resource_list[j]] = i;
+    }
+  }
+  StrHashMap<uint32_t> last_user;
+  for (uint32_t i = 0; i < pass_num; i++) {
+    const auto queue = ToIndex(pass_queue[i]);
+    const auto resource_num = GatherSyncedResources(render_pass_list.render_pass_info[i], kMaxSyncedResourceNum, resource_list);
+    for (uint32_t j = 0; j < resource_num; j++) {
+      if (const auto producer = last_user.get(resource_list[j]); producer != nullptr) {
+        AddDependency(i, *producer, &builder);
+        continue;
+      }
+      const auto signal_queue = ToIndex(pass_queue[frame_last_user[resource_list[j]]]);
+      if (signal_queue == queue) { continue; }
+      WaitForBatch(queue, signal_queue, 0, &builder);
+    }
+    builder.open_pass_list[queue][builder.open_pass_num[queue]] = i;
+    builder.open_pass_num[queue]++;
+    builder.pass_batch[i] = builder.closed_batch_num[queue] + 1;
+    for (uint32_t j = 0; j < resource_num; j++) {
+      last_user[resource_list[j]] = i;
+    }
+  }
+  // join other queues on the direct queue so that a frame ends with a single direct signal.
+  for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+    if (i == kDirect) { continue; }
+    if (builder.open_pass_num[i] > 0 || HasOpenWait(i, builder)) {
+      CloseBatch(i, &builder);
+    }
+    if (builder.closed_batch_num[i] == 0) { continue; }
+    SignalBatch(i, builder.closed_batch_num[i], &builder);
+    WaitForBatch(kDirect, i, builder.closed_batch_num[i], &builder);
+  }
+  if (builder.open_pass_num[kDirect] > 0 || HasOpenWait(kDirect, builder) || builder.closed_batch_num[kDirect] == 0) {
+    CloseBatch(kDirect, &builder);
+  }
+  SignalBatch(kDirect, builder.closed_batch_num[kDirect], &builder);
+  auto schedule = New<QueueSchedule>();
+  schedule->batch_num = batch_list.size();
+  schedule->batch_list = AllocateArray<QueueBatch>(batch_list.size());
+  for (uint32_t i = 0; i < batch_list.size(); i++) {
+    schedule->batch_list[i] = batch_list[i];
+  }
+  schedule->pass_index_list = AllocateArray<uint32_t>(pass_index_list.size());
+  for (uint32_t i = 0; i < pass_index_list.size(); i++) {
+    schedule->pass_index_list[i] = pass_index_list[i];
+  }
+  schedule->wait_list = AllocateArray<QueueWait>(wait_list.size());
+  for (uint32_t i = 0; i < wait_list.size(); i++) {
+    schedule->wait_list[i] = wait_list[i];
+  }
+  for (uint32_t i = 0; i < kQueueTypeNum; i++) {
+    schedule->signal_num[i] = builder.closed_batch_num[i];
+    Deallocate(builder.open_pass_list[i]);
+  }
+  Deallocate(builder.batch_list_index);
+  Deallocate(builder.batch_known);
+  Deallocate(builder.pass_batch);
+  Deallocate(pass_queue);
+  return schedule;
+}
+void ReleaseQueueSchedule(QueueSchedule* schedule) {
+  Deallocate(schedule->batch_list);
+  Deallocate(schedule->pass_index_list);
+  Deallocate(schedule->wait_list);
+  Deallocate(schedule);
+}
+} // namespace boke
+#include <memory>
+#include "doctest/doctest.h"
+TEST_CASE("queue schedule") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 64 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  StrHash swapchain[] = {"swapchain"_id,};
+  SUBCASE("direct only") {
+    StrHash primary[] = {"primary"_id,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .rtv = primary,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .srv = primary,
+        .srv_num = 1,
+        .rtv = swapchain,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .present = "swapchain"_id,
+      },
+    };
+    auto schedule = CompileQueueSchedule({.render_pass_len = 3, .render_pass_info = render_pass_info,});
+    REQUIRE_EQ(schedule->batch_num, 1);
+    CHECK_EQ(schedule->batch_list[0].queue, QueueType::kDirect);
+    CHECK_EQ(schedule->batch_list[0].pass_num, 3);
+    CHECK_EQ(schedule->batch_list[0].wait_num, 0);
+    CHECK_EQ(schedule->batch_list[0].signal_index, 1);
+    for (uint32_t i = 0; i < 3; i++) {
+      CHECK_EQ(schedule->pass_index_list[i], i);
+    }
+    CHECK_EQ(schedule->signal_num[ToIndex(QueueType::kDirect)], 1);
+    CHECK_EQ(schedule->signal_num[ToIndex(QueueType::kCompute)], 0);
+    ReleaseQueueSchedule(schedule);
+  }
+  SUBCASE("async compute overlaps independent direct passes") {
+    StrHash gbuffer[] = {"gbuffer"_id,};
+    StrHash depth[] = {"depth"_id,};
+    StrHash ao[] = {"ao"_id,};
+    StrHash lighting_srv[] = {"gbuffer"_id, "ao"_id, "shadowmap"_id,};
+    StrHash primary[] = {"primary"_id,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        // gbuffer
+        .queue = "direct"_id,
+        .rtv = gbuffer,
+        .rtv_num = 1,
+        .dsv = "depth"_id,
+      },
+      {
+        // ssao
+        .queue = "compute"_id,
+        .srv = depth,
+        .srv_num = 1,
+        .uav = ao,
+        .uav_num = 1,
+      },
+      {
+        // shadow, runs while ssao does.
+        .queue = "direct"_id,
+        .dsv = "shadowmap"_id,
+      },
+      {
+        // lighting
+        .queue = "direct"_id,
+        .srv = lighting_srv,
+        .srv_num = 3,
+        .rtv = primary,
+        .rtv_num = 1,
+      },
+      {
+        // tonemap
+        .queue = "direct"_id,
+        .srv = primary,
+        .srv_num = 1,
+        .rtv = swapchain,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .present = "swapchain"_id,
+      },
+    };
+    auto schedule = CompileQueueSchedule({.render_pass_len = 6, .render_pass_info = render_pass_info,});
+    REQUIRE_EQ(schedule->batch_num, 4);
+    const auto& gbuffer_batch = schedule->batch_list[0];
+    CHECK_EQ(gbuffer_batch.queue, QueueType::kDirect);
+    REQUIRE_EQ(gbuffer_batch.pass_num, 1);
+    CHECK_EQ(schedule->pass_index_list[gbuffer_batch.pass_offset], 0);
+    CHECK_EQ(gbuffer_batch.wait_num, 0);
+    CHECK_EQ(gbuffer_batch.signal_index, 1);
+    const auto& ssao_batch = schedule->batch_list[1];
+    CHECK_EQ(ssao_batch.queue, QueueType::kCompute);
+    REQUIRE_EQ(ssao_batch.pass_num, 1);
+    CHECK_EQ(schedule->pass_index_list[ssao_batch.pass_offset], 1);
+    // waiting for gbuffer covers ao read by lighting in the previous frame.
+    REQUIRE_EQ(ssao_batch.wait_num, 1);
+    CHECK_EQ(schedule->wait_list[ssao_batch.wait_offset].queue, QueueType::kDirect);
+    CHECK_EQ(schedule->wait_list[ssao_batch.wait_offset].signal_index, 1);
+    CHECK_EQ(ssao_batch.signal_index, 1);
+    const auto& shadow_batch = schedule->batch_list[2];
+    CHECK_EQ(shadow_batch.queue, QueueType::kDirect);
+    REQUIRE_EQ(shadow_batch.pass_num, 1);
+    CHECK_EQ(schedule->pass_index_list[shadow_batch.pass_offset], 2);
+    CHECK_EQ(shadow_batch.wait_num, 0);
+    CHECK_EQ(shadow_batch.signal_index, 0);
+    const auto& lighting_batch = schedule->batch_list[3];
+    CHECK_EQ(lighting_batch.queue, QueueType::kDirect);
+    REQUIRE_EQ(lighting_batch.pass_num, 3);
+    CHECK_EQ(schedule->pass_index_list[lighting_batch.pass_offset], 3);
+    CHECK_EQ(schedule->pass_index_list[lighting_batch.pass_offset + 2], 5);
+    REQUIRE_EQ(lighting_batch.wait_num, 1);
+    CHECK_EQ(schedule->wait_list[lighting_batch.wait_offset].queue, QueueType::kCompute);
+    CHECK_EQ(schedule->wait_list[lighting_batch.wait_offset].signal_index, 1);
+    CHECK_EQ(lighting_batch.signal_index, 3);
+    CHECK_EQ(schedule->signal_num[ToIndex(QueueType::kDirect)], 3);
+    CHECK_EQ(schedule->signal_num[ToIndex(QueueType::kCompute)], 1);
+    CHECK_EQ(schedule->signal_num[ToIndex(QueueType::kCopy)], 0);
+    ReleaseQueueSchedule(schedule);
+  }
+  SUBCASE("waits implied by earlier waits are dropped") {
+    StrHash a[] = {"a"_id,};
+    StrHash b[] = {"b"_id,};
+    StrHash x[] = {"x"_id,};
+    StrHash srv_ab[] = {"b"_id, "a"_id,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        .queue = "compute"_id,
+        .uav = a,
+        .uav_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .rtv = x,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "compute"_id,
+        .srv = x,
+        .srv_num = 1,
+        .uav = b,
+        .uav_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .srv = srv_ab,
+        .srv_num = 2,
+        .rtv = swapchain,
+        .rtv_num = 1,
+        .present = "swapchain"_id,
+      },
+    };
+    auto schedule = CompileQueueSchedule({.render_pass_len = 4, .render_pass_info = render_pass_info,});
+    REQUIRE_EQ(schedule->batch_num, 4);
+    CHECK_EQ(schedule->batch_list[0].queue, QueueType::kDirect);
+    CHECK_EQ(schedule->batch_list[0].signal_index, 1);
+    // a was last read by direct in the previous frame.
+    const auto& first_compute = schedule->batch_list[1];
+    CHECK_EQ(first_compute.queue, QueueType::kCompute);
+    REQUIRE_EQ(first_compute.wait_num, 1);
+    CHECK_EQ(schedule->wait_list[first_compute.wait_offset].queue, QueueType::kDirect);
+    CHECK_EQ(schedule->wait_list[first_compute.wait_offset].signal_index, 0);
+    CHECK_EQ(first_compute.signal_index, 0);
+    const auto& second_compute = schedule->batch_list[2];
+    CHECK_EQ(second_compute.queue, QueueType::kCompute);
+    REQUIRE_EQ(second_compute.wait_num, 1);
+    CHECK_EQ(schedule->wait_list[second_compute.wait_offset].signal_index, 1);
+    CHECK_EQ(second_compute.signal_index, 2);
+    // waiting for the second compute batch implies the first one writing a.
+    const auto& last_direct = schedule->batch_list[3];
+    CHECK_EQ(last_direct.queue, QueueType::kDirect);
+    REQUIRE_EQ(last_direct.wait_num, 1);
+    CHECK_EQ(schedule->wait_list[last_direct.wait_offset].queue, QueueType::kCompute);
+    CHECK_EQ(schedule->wait_list[last_direct.wait_offset].signal_index, 2);
+    CHECK_EQ(last_direct.signal_index, 2);
+    ReleaseQueueSchedule(schedule);
+  }
+  SUBCASE("queue names") {
+    CHECK_EQ(GetQueueType("direct"_id), QueueType::kDirect);
+    CHECK_EQ(GetQueueType("compute"_id), QueueType::kCompute);
+    CHECK_EQ(GetQueueType("copy"_id), QueueType::kCopy);
+    CHECK_UNARY(IsQueueName("copy"_id));
+    CHECK_UNARY_FALSE(IsQueueName("graphics"_id));
+  }
+}
@@ -0,0 +1,52 @@
+#pragma once
+namespace boke {
+enum class QueueType : uint8_t {
+  kDirect,
+  kCompute,
+  kCopy,
+};
+const uint32_t kQueueTypeNum = 3;
+/**
+ * "direct", "compute" and "copy", unknown names fall back to direct.
+ **/
+QueueType GetQueueType(const StrHash queue);
+bool IsQueueName(const StrHash queue);
+struct QueueWait {
+  QueueType queue{};
+  uint32_t signal_index{}; // 0 waits for the last signal of the previous frame.
+};
+/**
+ * passes recorded into one command list and submitted to one queue,
+ * waiting for other queues before execution and signaling the queue fence after it.
+ **/
+struct QueueBatch {
+  QueueType queue{};
+  uint32_t pass_offset{};
+  uint32_t pass_num{};
+  uint32_t wait_offset{};
+  uint32_t wait_num{};
+  uint32_t signal_index{}; // 1 based within a frame, 0 if nothing waits for the batch.
+};
+struct QueueSchedule {
+  /**
+   * in submission order, a batch is submitted after every batch it waits for.
+   **/
+  uint32_t batch_num{};
+  QueueBatch* batch_list{};
+  uint32_t* pass_index_list{};
+  QueueWait* wait_list{};
+  /**
+   * fence values per queue advance by signal_num every frame, i.e. signal value is frame base + signal_index.
+   * the last batch of every used queue signals, the last batch of a frame is a direct batch waiting for the other queues.
+   **/
+  uint32_t signal_num[kQueueTypeNum]{};
+};
+/**
+ * partitions passes into per queue batches, keeping list order within a queue.
+ * passes on different queues sharing a texture or uav (including across frames) are ordered by fences,
+ * waits already implied by earlier waits are dropped.
+ * cbv are frame buffered by cpu and never synchronized.
+ **/
+QueueSchedule* CompileQueueSchedule(const RenderPassList& render_pass_list);
+void ReleaseQueueSchedule(QueueSchedule*);
+}
@@ -0,0 +1,713 @@
+#include <stdio.h>
+#include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/debug_assert.h"
+#include "boke/str_hash.h"
+#include "boke/util.h"
+#include "json.h"
+#include "render_pass_info.h"
+#include "resource_info.h"
+#include "config_loader.h"
+#include "render_graph.h"
+#include "render_pass_scheduler.h"
+namespace {
+using namespace boke;
+enum ResourceUsage : uint8_t {
+  kResourceUsageRtv = 1 << 0,
+  kResourceUsageSrv = 1 << 1,
+  kResourceUsageCbv = 1 << 2,
+  kResourceUsageDsv = 1 << 3,
+  kResourceUsagePresent = 1 << 4,
+  kResourceUsageUav = 1 << 5,
+};
+struct ResourceEntry {
+  ResourceInfo info{};
+  uint8_t usage{};
+};
+struct MaterialPermutation {
+  uint32_t base_material_index{};
+  uint32_t rtv_format_offset{};
+  uint32_t rtv_num{};
+};
+const uint32_t kPermutationHashStrLen = 16; // "%016llx"
+auto CombineHash(const uint64_t hash, const uint64_t val) {
+  // fnv-1a over 8 bytes of val.
+  auto h = hash;
+  for (uint32_t i = 0; i < 8; i++) {
+    h ^= (val >> (i * 8)) & 0xFF;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+auto GetCreationType(const ResourceUsage usage) {
+  switch (usage) {
+    case kResourceUsageRtv: return ResourceCreationType::kRtv;
+    case kResourceUsageCbv: return ResourceCreationType::kCbv;
+    case kResourceUsageDsv: return ResourceCreationType::kDsv;
+    case kResourceUsageUav: return ResourceCreationType::kUav;
+    default: return ResourceCreationType::kNone;
+  }
+}
+void RegisterResource(const StrHash id, const ResourceUsage usage, const RenderGraphDesc& desc, StrHashMap<ResourceEntry>* resource_list) {
+  const auto is_swapchain = id == "swapchain"_id;
+  if (!resource_list->contains(id)) {
+    const auto option = (desc.resource_option != nullptr) ? desc.resource_option->get(id) : nullptr;
+    ResourceEntry entry{
+      .info = {
+        .creation_type = is_swapchain ? ResourceCreationType::kNone : GetCreationType(usage),
+        .format = (option && option->override_format) ? option->format : desc.default_format,
+        .size = (option && option->override_size) ? option->size : desc.default_size,
+        .physical_resource_num = option ? option->physical_resource_num : 1,
+      },
+    };
+    if (usage == kResourceUsageCbv) {
+      entry.info.format = DXGI_FORMAT_UNKNOWN;
+    }
+    resource_list->insert(id, entry);
+  }
+  // swapchain buffers are created by the swapchain and only recorded for barriers.
+  if (!is_swapchain) {
+    resource_list->get(id)->usage |= usage;
+  }
+}
+void RegisterResourceList(const StrHash* list, const uint32_t num, const ResourceUsage usage, const RenderGraphDesc& desc, StrHashMap<ResourceEntry>* resource_list) {
+  for (uint32_t i = 0; i < num; i++) {
+    RegisterResource(list[i], usage, desc, resource_list);
+  }
+}
+void CheckPingpong(const RenderPassInfo& pass, StrHashMap<ResourceEntry>* resource_list) {
+  // a resource read and written in the same pass needs a buffer for each.
+  for (uint32_t i = 0; i < pass.rtv_num; i++) {
+    for (uint32_t j = 0; j < pass.srv_num; j++) {
+      if (pass.rtv[i] == pass.srv[j]) {
+        resource_list->get(pass.rtv[i])->info.pingpong = true;
+      }
+    }
+  }
+}
+void ConfigureResources(const RenderPassInfo& pass, const RenderGraphDesc& desc, StrHashMap<ResourceEntry>* resource_list) {
+  RegisterResourceList(pass.rtv, pass.rtv_num, kResourceUsageRtv, desc, resource_list);
+  RegisterResourceList(pass.srv, pass.srv_num, kResourceUsageSrv, desc, resource_list);
+  RegisterResourceList(pass.cbv, pass.cbv_num, kResourceUsageCbv, desc, resource_list);
+  RegisterResourceList(pass.uav, pass.uav_num, kResourceUsageUav, desc, resource_list);
+  if (pass.dsv != kEmptyStr) {
+    RegisterResource(pass.dsv, kResourceUsageDsv, desc, resource_list);
+  }
+  if (pass.present != kEmptyStr) {
+    RegisterResource(pass.present, kResourceUsagePresent, desc, resource_list);
+  }
+  CheckPingpong(pass, resource_list);
+}
+auto GetResourceFlags(const uint8_t usage, const bool add_srv_to_flags) {
+  auto flags = kDefaultResourceFlags;
+  if (usage & kResourceUsageRtv) {
+    flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+  }
+  if (usage & kResourceUsageDsv) {
+    flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+  }
+  if (usage & kResourceUsageSrv) {
+    flags &= ~D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+  }
+  if (usage & kResourceUsageUav) {
+    flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+  }
+  // every buffer other than constant buffers is readable for the debug buffer view.
+  if (add_srv_to_flags && (usage & kResourceUsageCbv) == 0) {
+    flags &= ~D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+  }
+  return flags;
+}
+auto GetPhysicalResourceNum(const ResourceEntry& entry) {
+  // read only resources are provided from outside of the graph.
+  if (entry.usage == 0 || entry.usage == kResourceUsageSrv) { return 0U; }
+  if (entry.info.pingpong) { return 2U; }
+  return entry.info.physical_resource_num;
+}
+struct ResourceInfoCreationAsset {
+  StrHashMap<ResourceInfo>* resource_info{};
+  const StrHashMap<Size2d>* explicit_buffer_size{};
+  bool add_srv_to_flags{};
+};
+void CreateResourceInfo(ResourceInfoCreationAsset* asset, const StrHash id, const ResourceEntry* entry) {
+  auto info = entry->info;
+  info.flags = GetResourceFlags(entry->usage, asset->add_srv_to_flags);
+  info.physical_resource_num = GetPhysicalResourceNum(*entry);
+  AdjustResourceSize(id, *asset->explicit_buffer_size, &info);
+  asset->resource_info->insert(id, info);
+}
+auto FindBaseMaterial(const StrHash id, const RenderGraphDesc& desc) {
+  for (uint32_t i = 0; i < desc.base_material_num; i++) {
+    if (GetStrHash(desc.base_material_list[i].name) == id) { return i; }
+  }
+  DEBUG_ASSERT(false, DebugAssert{});
+  return 0U;
+}
+auto HasMaterial(const RenderPassInfo& pass) {
+  return pass.material != kEmptyStr && pass.material != ""_id;
+}
+void AddToResourceSet(const StrHash* list, const uint32_t num, StrHashMap<bool>* resource_set) {
+  for (uint32_t i = 0; i < num; i++) {
+    if (resource_set->contains(list[i])) { continue; }
+    resource_set->insert(list[i], true);
+  }
+}
+void AddToResourceSet(const StrHash id, StrHashMap<bool>* resource_set) {
+  if (id == kEmptyStr) { return; }
+  AddToResourceSet(&id, 1, resource_set);
+}
+void AddPassResourcesToResourceSet(const RenderPassInfo& pass, StrHashMap<bool>* resource_set) {
+  AddToResourceSet(pass.cbv, pass.cbv_num, resource_set);
+  AddToResourceSet(pass.srv, pass.srv_num, resource_set);
+  AddToResourceSet(pass.uav, pass.uav_num, resource_set);
+  AddToResourceSet(pass.rtv, pass.rtv_num, resource_set);
+  AddToResourceSet(pass.dsv, resource_set);
+  AddToResourceSet(pass.present, resource_set);
+}
+/**
+ * resources read before any pass of the list writes them hold the previous frame (e.g. temporal history),
+ * the passes writing them later in the list are kept like ones writing outputs.
+ **/
+void AddReadBeforeWriteToResourceSet(const RenderPassList& render_pass_list, StrHashMap<bool>* resource_set) {
+  StrHashMap<bool> written_resource_set;
+  for (uint32_t i = 0; i < render_pass_list.render_pass_len; i++) {
+    const auto& pass = render_pass_list.render_pass_info[i];
+    for (uint32_t j = 0; j < pass.srv_num; j++) {
+      if (written_resource_set.contains(pass.srv[j])) { continue; }
+      AddToResourceSet(pass.srv[j], resource_set);
+    }
+    AddToResourceSet(pass.rtv, pass.rtv_num, &written_resource_set);
+    AddToResourceSet(pass.uav, pass.uav_num, &written_resource_set);
+    AddToResourceSet(pass.dsv, &written_resource_set);
+  }
+}
+auto IsContributing(const RenderPassInfo& pass, const StrHashMap<bool>& live_resource_set) {
+  if (pass.present != kEmptyStr) { return true; }
+  for (uint32_t i = 0; i < pass.rtv_num; i++) {
+    if (live_resource_set.contains(pass.rtv[i])) { return true; }
+  }
+  if (pass.dsv != kEmptyStr && live_resource_set.contains(pass.dsv)) { return true; }
+  for (uint32_t i = 0; i < pass.uav_num; i++) {
+    if (live_resource_set.contains(pass.uav[i])) { return true; }
+  }
+  return false;
+}
+struct UnusedResourceCollectionAsset {
+  const StrHashMap<bool>* used_resource_set{};
+  ResizableArray<StrHash>* unused_resource_list{};
+};
+void CollectUnusedResource(UnusedResourceCollectionAsset* asset, const StrHash id, const ResourceInfo*) {
+  if (asset->used_resource_set->contains(id)) { return; }
+  asset->unused_resource_list->push_back(id);
+}
+} // namespace
+namespace boke {
+RenderGraph* CompileRenderGraph(const RenderGraphDesc& desc) {
+  auto render_graph = New<RenderGraph>();
+  // culling and reordering, kept passes are copied and remember their source to write material_id back.
+  ResizableArray<RenderPassInfo*> source_pass_list;
+  {
+    uint32_t total_pass_num = 0;
+    for (uint32_t i = 0; i < desc.render_pass_list_num; i++) {
+      total_pass_num += desc.render_pass_list[i].render_pass_len;
+    }
+    render_graph->render_pass_list_num = desc.render_pass_list_num;
+    render_graph->render_pass_list = AllocateArray<RenderPassList>(desc.render_pass_list_num);
+    render_graph->render_pass_info_buffer = AllocateArray<RenderPassInfo>(total_pass_num);
+    auto kept_pass_index = AllocateArray<uint32_t>(total_pass_num);
+    auto pass_order = desc.reorder_passes ? AllocateArray<uint32_t>(total_pass_num) : nullptr;
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < desc.render_pass_list_num; i++) {
+      const auto& render_pass = desc.render_pass_list[i];
+      uint32_t kept_pass_num = render_pass.render_pass_len;
+      if (desc.cull_passes) {
+        kept_pass_num = CullRenderPassList(render_pass, desc.output_num, desc.output_list, kept_pass_index);
+      } else {
+        for (uint32_t j = 0; j < kept_pass_num; j++) {
+          kept_pass_index[j] = j;
+        }
+      }
+      auto dst = &render_graph->render_pass_info_buffer[offset];
+      for (uint32_t j = 0; j < kept_pass_num; j++) {
+        dst[j] = render_pass.render_pass_info[kept_pass_index[j]];
+      }
+      if (desc.reorder_passes) {
+        ScheduleRenderPassList({.render_pass_len = kept_pass_num, .render_pass_info = dst,}, pass_order);
+        for (uint32_t j = 0; j < kept_pass_num; j++) {
+          dst[j] = render_pass.render_pass_info[kept_pass_index[pass_order[j]]];
+          source_pass_list.push_back(&render_pass.render_pass_info[kept_pass_index[pass_order[j]]]);
+        }
+      } else {
+        for (uint32_t j = 0; j < kept_pass_num; j++) {
+          source_pass_list.push_back(&render_pass.render_pass_info[kept_pass_index[j]]);
+        }
+      }
+      render_graph->render_pass_list[i] = {
+        .render_pass_len = kept_pass_num,
+        .render_pass_info = dst,
+      };
+      offset += kept_pass_num;
+    }
+    Deallocate(pass_order);
+    Deallocate(kept_pass_index);
+  }
+  // resources
+  {
+    StrHashMap<ResourceEntry> resource_list;
+    for (uint32_t i = 0; i < render_graph->render_pass_list_num; i++) {
+      const auto& render_pass = render_graph->render_pass_list[i];
+      for (uint32_t j = 0; j < render_pass.render_pass_len; j++) {
+        ConfigureResources(render_pass.render_pass_info[j], desc, &resource_list);
+      }
+    }
+    render_graph->resource_info = New<StrHashMap<ResourceInfo>>(resource_list.size());
+    ResourceInfoCreationAsset asset{
+      .resource_info = render_graph->resource_info,
+      .explicit_buffer_size = desc.explicit_buffer_size,
+      .add_srv_to_flags = desc.add_srv_to_flags,
+    };
+    resource_list.iterate<ResourceInfoCreationAsset>(CreateResourceInfo, &asset);
+  }
+  // material permutations
+  ResizableArray<MaterialPermutation> permutation_list;
+  ResizableArray<DXGI_FORMAT> rtv_format_list;
+  ResizableArray<uint64_t> permutation_hash_list;
+  ResizableArray<uint32_t> pass_permutation_index;
+  {
+    StrHashMap<uint32_t> permutation_index;
+    for (uint32_t i = 0; i < render_graph->render_pass_list_num; i++) {
+      const auto& render_pass = render_graph->render_pass_list[i];
+      for (uint32_t j = 0; j < render_pass.render_pass_len; j++) {
+        const auto& pass = render_pass.render_pass_info[j];
+        if (!HasMaterial(pass)) { continue; }
+        auto hash = CombineHash(14695981039346656037ULL, pass.material);
+        for (uint32_t k = 0; k < pass.rtv_num; k++) {
+          hash = CombineHash(hash, static_cast<uint64_t>((*render_graph->resource_info)[pass.rtv[k]].format));
+        }
+        if (!permutation_index.contains(hash)) {
+          permutation_index.insert(hash, permutation_list.size());
+          permutation_list.push_back({
+              .base_material_index = FindBaseMaterial(pass.material, desc),
+              .rtv_format_offset = rtv_format_list.size(),
+              .rtv_num = pass.rtv_num,
+            });
+          permutation_hash_list.push_back(hash);
+          for (uint32_t k = 0; k < pass.rtv_num; k++) {
+            rtv_format_list.push_back((*render_graph->resource_info)[pass.rtv[k]].format);
+          }
+        }
+        pass_permutation_index.push_back(permutation_index[hash]);
+      }
+    }
+  }
+  if (permutation_list.empty()) { return render_graph; }
+  uint32_t name_buffer_len = 0;
+  for (const auto& permutation : permutation_list) {
+    name_buffer_len += GetUint32(strlen(desc.base_material_list[permutation.base_material_index].name)) + 1 + kPermutationHashStrLen + 1;
+  }
+  render_graph->material_num = permutation_list.size();
+  render_graph->material_list = AllocateArray<MaterialInfo>(render_graph->material_num);
+  render_graph->material_name_buffer = AllocateArray<char>(name_buffer_len);
+  if (!rtv_format_list.empty()) {
+    render_graph->rtv_format_buffer = AllocateArray<DXGI_FORMAT>(rtv_format_list.size());
+    for (uint32_t i = 0; i < rtv_format_list.size(); i++) {
+      render_graph->rtv_format_buffer[i] = rtv_format_list[i];
+    }
+  }
+  auto name = render_graph->material_name_buffer;
+  for (uint32_t i = 0; i < permutation_list.size(); i++) {
+    const auto& permutation = permutation_list[i];
+    const auto& base_material = desc.base_material_list[permutation.base_material_index];
+    const auto name_len = GetUint32(strlen(base_material.name)) + 1 + kPermutationHashStrLen;
+    snprintf(name, name_len + 1, "%s_%016llx", base_material.name, static_cast<unsigned long long>(permutation_hash_list[i]));
+    render_graph->material_list[i] = {
+      .name = name,
+      .rootsig = base_material.rootsig,
+      .shader_num = base_material.shader_num,
+      .shader_list = base_material.shader_list,
+      .rtv_num = permutation.rtv_num,
+      .rtv_format = permutation.rtv_num > 0 ? &render_graph->rtv_format_buffer[permutation.rtv_format_offset] : nullptr,
+    };
+    name += name_len + 1;
+  }
+  // passes refer to permutations by name hash, like passes in formatted configs.
+  uint32_t pass_index = 0;
+  for (uint32_t i = 0; i < source_pass_list.size(); i++) {
+    auto& pass = render_graph->render_pass_info_buffer[i];
+    if (!HasMaterial(pass)) { continue; }
+    pass.material_id = GetStrHash(render_graph->material_list[pass_permutation_index[pass_index]].name);
+    source_pass_list[i]->material_id = pass.material_id;
+    pass_index++;
+  }
+  return render_graph;
+}
+void ReleaseRenderGraph(RenderGraph* render_graph) {
+  render_graph->resource_info->~StrHashMap<ResourceInfo>();
+  Deallocate(render_graph->resource_info);
+  Deallocate(render_graph->material_list);
+  Deallocate(render_graph->material_name_buffer);
+  Deallocate(render_graph->rtv_format_buffer);
+  Deallocate(render_graph->render_pass_list);
+  Deallocate(render_graph->render_pass_info_buffer);
+  Deallocate(render_graph);
+}
+uint32_t CullRenderPassList(const RenderPassList& render_pass_list, const uint32_t output_num, const StrHash* output_list, uint32_t* kept_pass_index) {
+  StrHashMap<bool> live_resource_set;
+  AddToResourceSet(output_list, output_num, &live_resource_set);
+  AddReadBeforeWriteToResourceSet(render_pass_list, &live_resource_set);
+  uint32_t kept_pass_num = 0;
+  for (uint32_t i = render_pass_list.render_pass_len; i > 0; i--) {
+    const auto& pass = render_pass_list.render_pass_info[i - 1];
+    if (!IsContributing(pass, live_resource_set)) { continue; }
+    AddPassResourcesToResourceSet(pass, &live_resource_set);
+    kept_pass_index[kept_pass_num] = i - 1;
+    kept_pass_num++;
+  }
+  // collected backward, restore execution order.
+  for (uint32_t i = 0; i < kept_pass_num / 2; i++) {
+    std::swap(kept_pass_index[i], kept_pass_index[kept_pass_num - 1 - i]);
+  }
+  return kept_pass_num;
+}
+void CullUnusedResources(const uint32_t render_pass_list_num, const RenderPassList* render_pass_list, StrHashMap<ResourceInfo>* resource_info) {
+  StrHashMap<bool> used_resource_set;
+  for (uint32_t i = 0; i < render_pass_list_num; i++) {
+    for (uint32_t j = 0; j < render_pass_list[i].render_pass_len; j++) {
+      AddPassResourcesToResourceSet(render_pass_list[i].render_pass_info[j], &used_resource_set);
+    }
+  }
+  ResizableArray<StrHash> unused_resource_list;
+  UnusedResourceCollectionAsset asset{
+    .used_resource_set = &used_resource_set,
+    .unused_resource_list = &unused_resource_list,
+  };
+  resource_info->iterate<UnusedResourceCollectionAsset>(CollectUnusedResource, &asset);
+  for (const auto& id : unused_resource_list) {
+    resource_info->erase(id);
+  }
+}
+} // namespace boke
+#include <memory>
+#include "doctest/doctest.h"
+namespace {
+auto GetBaseMaterialName(const char* const permutation_name, char* base_name) {
+  // formatted configs name permutations as base name + "_" + hash.
+  const auto len = strrchr(permutation_name, '_') - permutation_name;
+  strncpy(base_name, permutation_name, len);
+  base_name[len] = '\0';
+}
+} // namespace
+TEST_CASE("render graph") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  InitStrHashSystem();
+  StrHashMap<Size2d> explicit_buffer_size;
+  explicit_buffer_size["camera"_id] = Size2d{sizeof(float) * 32,1};
+  auto config = LoadGfxConfig("tests/formatted-config-multipass.json", explicit_buffer_size);
+  // same as "resource_options" in tests/config-multipass.json
+  StrHashMap<RenderGraphResourceOption> resource_option;
+  resource_option["primary"_id] = {.override_format = true, .format = DXGI_FORMAT_R16G16B16A16_FLOAT,};
+  resource_option["gbuffer2"_id] = {.override_format = true, .format = DXGI_FORMAT_R10G10B10A2_UNORM,};
+  resource_option["depth"_id] = {.override_format = true, .format = DXGI_FORMAT_D24_UNORM_S8_UINT,};
+  resource_option["camera"_id] = {.override_size = true, .size = {0, 1}, .physical_resource_num = 2,};
+  // base materials and passes referring to them.
+  const uint32_t name_len = 128;
+  auto base_name = std::make_unique<char[]>(config->material_num * name_len);
+  auto base_material_list = std::make_unique<MaterialInfo[]>(config->material_num);
+  for (uint32_t i = 0; i < config->material_num; i++) {
+    GetBaseMaterialName(config->material_list[i].name, &base_name[i * name_len]);
+    base_material_list[i] = config->material_list[i];
+    base_material_list[i].name = &base_name[i * name_len];
+    base_material_list[i].rtv_num = 0;
+    base_material_list[i].rtv_format = nullptr;
+  }
+  RenderPassList render_pass_list[] = {
+    (*config->render_pass_list)["default"_id],
+    (*config->render_pass_list)["debug_buffer_view"_id],
+    (*config->render_pass_list)["default"_id],
+  };
+  StrHashMap<uint32_t> expected_material_index;
+  for (uint32_t i = 0; i < config->material_num; i++) {
+    expected_material_index.insert(GetStrHash(config->material_list[i].name), i);
+  }
+  ResizableArray<uint32_t> expected_pass_material;
+  for (auto& render_pass : render_pass_list) {
+    for (uint32_t i = 0; i < render_pass.render_pass_len; i++) {
+      auto& pass = render_pass.render_pass_info[i];
+      // the last list shares passes with the first one, so material_id is looked up instead of material.
+      if (!expected_material_index.contains(pass.material_id)) {
+        expected_pass_material.push_back(~0U);
+        continue;
+      }
+      const auto index = expected_material_index[pass.material_id];
+      expected_pass_material.push_back(index);
+      pass.material = GetStrHash(base_material_list[index].name);
+    }
+  }
+  RenderGraphDesc desc{
+    .render_pass_list_num = 2,
+    .render_pass_list = render_pass_list,
+    .default_format = DXGI_FORMAT_R8G8B8A8_UNORM,
+    .default_size = {1920, 1080},
+    .resource_option = &resource_option,
+    .base_material_num = config->material_num,
+    .base_material_list = base_material_list.get(),
+    .explicit_buffer_size = &explicit_buffer_size,
+  };
+  SUBCASE("resources match renderpassparser.py") {
+    auto render_graph = CompileRenderGraph(desc);
+    const auto& resource_info = *render_graph->resource_info;
+    CHECK_EQ(resource_info.size(), config->resource_info->size());
+    config->resource_info->iterate<const StrHashMap<ResourceInfo>>([](const StrHashMap<ResourceInfo>* resource_info, const StrHash id, const ResourceInfo* expected) {
+      REQUIRE_UNARY(resource_info->contains(id));
+      const auto& info = (*resource_info)[id];
+      CHECK_EQ(info.creation_type, expected->creation_type);
+      CHECK_EQ(info.flags, expected->flags);
+      CHECK_EQ(info.format, expected->format);
+      CHECK_EQ(info.size.width, expected->size.width);
+      CHECK_EQ(info.size.height, expected->size.height);
+      CHECK_EQ(info.physical_resource_num, expected->physical_resource_num);
+      CHECK_EQ(info.pingpong, expected->pingpong);
+    }, &resource_info);
+    ReleaseRenderGraph(render_graph);
+  }
+  SUBCASE("material permutations") {
+    // the last list repeats the first one and adds no permutation.
+    desc.render_pass_list_num = 3;
+    auto render_graph = CompileRenderGraph(desc);
+    CHECK_EQ(render_graph->material_num, config->material_num);
+    uint32_t pass_index = 0;
+    for (const auto& render_pass : render_pass_list) {
+      for (uint32_t i = 0; i < render_pass.render_pass_len; i++) {
+        const auto& pass = render_pass.render_pass_info[i];
+        const auto expected_index = expected_pass_material[pass_index];
+        pass_index++;
+        if (expected_index == ~0U) { continue; }
+        const MaterialInfo* material = nullptr;
+        for (uint32_t j = 0; j < render_graph->material_num; j++) {
+          if (GetStrHash(render_graph->material_list[j].name) == pass.material_id) {
+            material = &render_graph->material_list[j];
+          }
+        }
+        REQUIRE_UNARY(material != nullptr);
+        const auto& expected = config->material_list[expected_index];
+        CHECK_EQ(strcmp(material->rootsig, expected.rootsig), 0);
+        CHECK_EQ(material->shader_list, expected.shader_list);
+        REQUIRE_EQ(material->rtv_num, expected.rtv_num);
+        for (uint32_t j = 0; j < material->rtv_num; j++) {
+          CHECK_EQ(material->rtv_format[j], expected.rtv_format[j]);
+        }
+      }
+    }
+    ReleaseRenderGraph(render_graph);
+  }
+  ReleaseGfxConfig(config);
+  TermStrHashSystem();
+}
+TEST_CASE("render graph culling") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 256 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  StrHash gbuffers[] = {"gbuffer0"_id, "gbuffer1"_id, "gbuffer2"_id, "gbuffer3"_id,};
+  StrHash primary[] = {"primary"_id,};
+  StrHash swapchain[] = {"swapchain"_id,};
+  StrHash imgui_font[] = {"imgui_font"_id,};
+  StrHash unused[] = {"unused"_id,};
+  StrHash debug_output[] = {"debug_output"_id,};
+  RenderPassInfo render_pass_info[] = {
+    {
+      // gbuffer
+      .queue = "direct"_id,
+      .rtv = gbuffers,
+      .rtv_num = 4,
+      .dsv = "depth"_id,
+    },
+    {
+      // nobody reads "unused"
+      .queue = "direct"_id,
+      .srv = gbuffers,
+      .srv_num = 1,
+      .rtv = unused,
+      .rtv_num = 1,
+    },
+    {
+      // lighting
+      .queue = "direct"_id,
+      .srv = gbuffers,
+      .srv_num = 4,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+    {
+      // read outside of the graph when declared as output
+      .queue = "direct"_id,
+      .srv = primary,
+      .srv_num = 1,
+      .rtv = debug_output,
+      .rtv_num = 1,
+    },
+    {
+      // tonemap
+      .queue = "direct"_id,
+      .srv = primary,
+      .srv_num = 1,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+    {
+      // oetf
+      .queue = "direct"_id,
+      .srv = primary,
+      .srv_num = 1,
+      .rtv = swapchain,
+      .rtv_num = 1,
+    },
+    {
+      // imgui
+      .queue = "direct"_id,
+      .srv = imgui_font,
+      .srv_num = 1,
+      .rtv = swapchain,
+      .rtv_num = 1,
+    },
+    {
+      // present
+      .queue = "direct"_id,
+      .present = "swapchain"_id,
+    },
+  };
+  const uint32_t render_pass_info_len = 8;
+  RenderPassList render_pass_list{
+    .render_pass_len = render_pass_info_len,
+    .render_pass_info = render_pass_info,
+  };
+  uint32_t kept_pass_index[render_pass_info_len]{};
+  SUBCASE("cull passes") {
+    const auto kept_pass_num = CullRenderPassList(render_pass_list, 0, nullptr, kept_pass_index);
+    REQUIRE_EQ(kept_pass_num, 6);
+    CHECK_EQ(kept_pass_index[0], 0);
+    CHECK_EQ(kept_pass_index[1], 2);
+    CHECK_EQ(kept_pass_index[2], 4);
+    CHECK_EQ(kept_pass_index[3], 5);
+    CHECK_EQ(kept_pass_index[4], 6);
+    CHECK_EQ(kept_pass_index[5], 7);
+  }
+  SUBCASE("declared outputs") {
+    const auto kept_pass_num = CullRenderPassList(render_pass_list, 1, debug_output, kept_pass_index);
+    REQUIRE_EQ(kept_pass_num, 7);
+    CHECK_EQ(kept_pass_index[1], 2);
+    CHECK_EQ(kept_pass_index[2], 3);
+  }
+  SUBCASE("list without present") {
+    RenderPassList debug_list{
+      .render_pass_len = 2,
+      .render_pass_info = &render_pass_info[2],
+    };
+    CHECK_EQ(CullRenderPassList(debug_list, 0, nullptr, kept_pass_index), 0);
+    CHECK_EQ(CullRenderPassList(debug_list, 1, debug_output, kept_pass_index), 2);
+  }
+  SUBCASE("temporal history") {
+    StrHash color[] = {"color"_id,};
+    StrHash color_and_history[] = {"color"_id, "history"_id,};
+    StrHash history[] = {"history"_id,};
+    RenderPassInfo temporal_pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .rtv = color,
+        .rtv_num = 1,
+      },
+      {
+        // reads history written by the previous frame.
+        .queue = "direct"_id,
+        .srv = color_and_history,
+        .srv_num = 2,
+        .rtv = primary,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .srv = primary,
+        .srv_num = 1,
+        .rtv = swapchain,
+        .rtv_num = 1,
+      },
+      {
+        // read by no later pass, only by the next frame.
+        .queue = "direct"_id,
+        .srv = primary,
+        .srv_num = 1,
+        .rtv = history,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .present = "swapchain"_id,
+      },
+    };
+    RenderPassList temporal_list{
+      .render_pass_len = 5,
+      .render_pass_info = temporal_pass_info,
+    };
+    REQUIRE_EQ(CullRenderPassList(temporal_list, 0, nullptr, kept_pass_index), 5);
+    CHECK_EQ(kept_pass_index[3], 3);
+    // culled once nothing reads history.
+    temporal_pass_info[1].srv = color;
+    temporal_pass_info[1].srv_num = 1;
+    REQUIRE_EQ(CullRenderPassList(temporal_list, 0, nullptr, kept_pass_index), 4);
+    CHECK_EQ(kept_pass_index[3], 4);
+  }
+  SUBCASE("compile") {
+    StrHashMap<Size2d> explicit_buffer_size;
+    RenderGraphDesc desc{
+      .render_pass_list_num = 1,
+      .render_pass_list = &render_pass_list,
+      .default_format = DXGI_FORMAT_R8G8B8A8_UNORM,
+      .default_size = {1920, 1080},
+      .explicit_buffer_size = &explicit_buffer_size,
+      .cull_passes = true,
+      .add_srv_to_flags = false,
+    };
+    auto render_graph = CompileRenderGraph(desc);
+    REQUIRE_EQ(render_graph->render_pass_list_num, 1);
+    CHECK_EQ(render_graph->render_pass_list[0].render_pass_len, 6);
+    CHECK_EQ(render_graph->render_pass_list[0].render_pass_info[1].rtv, primary);
+    const auto& resource_info = *render_graph->resource_info;
+    CHECK_UNARY_FALSE(resource_info.contains("unused"_id));
+    CHECK_UNARY_FALSE(resource_info.contains("debug_output"_id));
+    CHECK_UNARY(resource_info.contains("gbuffer0"_id));
+    // only buffers bound as srv are readable.
+    CHECK_EQ(resource_info["gbuffer0"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+    CHECK_EQ(resource_info["depth"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL | D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE);
+    ReleaseRenderGraph(render_graph);
+    desc.cull_passes = false;
+    desc.add_srv_to_flags = true;
+    render_graph = CompileRenderGraph(desc);
+    CHECK_EQ(render_graph->render_pass_list[0].render_pass_len, render_pass_info_len);
+    CHECK_UNARY(render_graph->resource_info->contains("unused"_id));
+    CHECK_EQ((*render_graph->resource_info)["depth"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
+    ReleaseRenderGraph(render_graph);
+  }
+  SUBCASE("cull unused resources") {
+    StrHashMap<ResourceInfo> resource_info;
+    resource_info.insert("gbuffer0"_id, {.creation_type = ResourceCreationType::kRtv,});
+    resource_info.insert("unused"_id, {.creation_type = ResourceCreationType::kRtv,});
+    resource_info.insert("swapchain"_id, {.creation_type = ResourceCreationType::kNone,});
+    resource_info.insert("not_in_any_pass"_id, {.creation_type = ResourceCreationType::kRtv,});
+    const auto kept_pass_num = CullRenderPassList(render_pass_list, 0, nullptr, kept_pass_index);
+    auto culled_pass_info = std::make_unique<RenderPassInfo[]>(kept_pass_num);
+    for (uint32_t i = 0; i < kept_pass_num; i++) {
+      culled_pass_info[i] = render_pass_info[kept_pass_index[i]];
+    }
+    RenderPassList culled_list{
+      .render_pass_len = kept_pass_num,
+      .render_pass_info = culled_pass_info.get(),
+    };
+    CullUnusedResources(1, &culled_list, &resource_info);
+    CHECK_EQ(resource_info.size(), 2);
+    CHECK_UNARY(resource_info.contains("gbuffer0"_id));
+    CHECK_UNARY(resource_info.contains("swapchain"_id));
+  }
+}
@@ -0,0 +1,78 @@
+#pragma once
+namespace boke {
+struct RenderGraphResourceOption {
+  bool override_format{};
+  DXGI_FORMAT format{};
+  bool override_size{};
+  Size2d size{};
+  uint32_t physical_resource_num{1};
+};
+struct RenderGraphDesc {
+  /**
+   * resources take their initial state from the first pass using them,
+   * so lists are given in execution order rather than as a StrHashMap.
+   **/
+  uint32_t render_pass_list_num{};
+  const RenderPassList* render_pass_list{};
+  DXGI_FORMAT default_format{};
+  Size2d default_size{};
+  const StrHashMap<RenderGraphResourceOption>* resource_option{}; // optional
+  /**
+   * materials without output formats, referred by RenderPassInfo::material.
+   **/
+  uint32_t base_material_num{};
+  const MaterialInfo* base_material_list{};
+  const StrHashMap<Size2d>* explicit_buffer_size{}; // required, may be empty
+  /**
+   * passes contributing to neither present nor output_list are dropped, and resources only they use are never created.
+   **/
+  bool cull_passes{};
+  uint32_t output_num{};
+  const StrHash* output_list{};
+  /**
+   * kept passes are reordered by ScheduleRenderPassList.
+   **/
+  bool reorder_passes{};
+  /**
+   * makes every buffer readable for the debug buffer view as renderpassparser.py does.
+   * without it only buffers bound as srv lose DENY_SHADER_RESOURCE.
+   **/
+  bool add_srv_to_flags{true};
+};
+struct RenderGraph {
+  StrHashMap<ResourceInfo>* resource_info{};
+  /**
+   * one material per base material and rtv format combination.
+   * shader_list is shared with the base material.
+   **/
+  uint32_t material_num{};
+  MaterialInfo* material_list{};
+  char* material_name_buffer{};
+  DXGI_FORMAT* rtv_format_buffer{};
+  /**
+   * lists after culling and reordering, in the order of RenderGraphDesc::render_pass_list.
+   * passes are copies sharing cbv, srv and rtv lists with the desc.
+   **/
+  uint32_t render_pass_list_num{};
+  RenderPassList* render_pass_list{};
+  RenderPassInfo* render_pass_info_buffer{};
+};
+/**
+ * derives resources, pingpong and physical resource num from pass lists the way scripts/renderpassparser.py does,
+ * and sets material_id of each pass to its material permutation.
+ * pass lists can be edited and compiled again at runtime without the offline script.
+ **/
+RenderGraph* CompileRenderGraph(const RenderGraphDesc& desc);
+void ReleaseRenderGraph(RenderGraph*);
+/**
+ * walks a list backward from present and output_list, keeping passes whose rtv or dsv is read by a kept pass.
+ * resources read before written in the list (e.g. temporal history) are live at the end of the list like outputs.
+ * writes never end liveness since render targets may be loaded or blended.
+ * kept_pass_index needs render_pass_len entries, filled in execution order. returns the number of kept passes.
+ **/
+uint32_t CullRenderPassList(const RenderPassList& render_pass_list, const uint32_t output_num, const StrHash* output_list, uint32_t* kept_pass_index);
+/**
+ * erases resources referred by no pass in the lists, so neither resources nor descriptors are created for them.
+ **/
+void CullUnusedResources(const uint32_t render_pass_list_num, const RenderPassList* render_pass_list, StrHashMap<ResourceInfo>* resource_info);
+}
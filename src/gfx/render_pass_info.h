@@ -1,5 +1,14 @@
 #pragma once
 namespace boke {
+/**
+ * mip_num and slice_num of 0 cover the rest of the resource.
+ **/
+struct SubresourceRange {
+  uint32_t first_mip{};
+  uint32_t mip_num{};
+  uint32_t first_slice{};
+  uint32_t slice_num{};
+};
 struct RenderPassInfo {
   StrHash queue{kEmptyStr};
   StrHash type{kEmptyStr};
@@ -8,11 +17,19 @@ struct RenderPassInfo {
   uint32_t cbv_num{};
   StrHash* srv{};
   uint32_t srv_num{};
+  StrHash* uav{};
+  uint32_t uav_num{};
   StrHash* rtv{};
   uint32_t rtv_num{};
   StrHash  dsv{kEmptyStr};
   StrHash  present{kEmptyStr};
   StrHash  material_id{kEmptyStr};
   uint8_t stencil_val{};
+  /**
+   * optional, one range per srv and rtv, whole resources when nullptr.
+   **/
+  SubresourceRange* srv_subresource{};
+  SubresourceRange* rtv_subresource{};
+  SubresourceRange* dsv_subresource{};
 };
 }
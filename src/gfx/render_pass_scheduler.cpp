@@ -0,0 +1,606 @@
+#include <algorithm>
+#include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/debug_assert.h"
+#include "boke/str_hash.h"
+#include "boke/util.h"
+#include "json.h"
+#include "render_pass_info.h"
+#include "resource_info.h"
+#include "config_loader.h"
+#include "render_pass_scheduler.h"
+namespace {
+using namespace boke;
+enum class ResourceState : uint8_t {
+  kUndefined,
+  kRenderTarget,
+  kShaderResource,
+  kDepthStencil,
+  kPresent,
+  kUnorderedAccess,
+};
+struct PassResourceUsage {
+  uint32_t resource_index{};
+  ResourceState state{};
+  bool read{};
+  bool write{};
+};
+struct SchedulerPass {
+  uint64_t dependency_mask{};
+  uint64_t producer_mask{}; // subset of dependency_mask, passes writing what this pass reads.
+  uint32_t usage_offset{};
+  uint32_t usage_num{};
+  StrHash material{kEmptyStr};
+};
+const uint32_t kMaxPassResourceUsageNum = 32;
+const uint32_t kMaxProducerGapScore = 2;
+const uint32_t kSearchVisitBudget = 1 << 16;
+struct SchedulerContext {
+  uint32_t pass_num{};
+  const SchedulerPass* pass_list{};
+  const PassResourceUsage* usage_list{};
+  ResourceState* state{};
+  uint32_t* order{};
+  uint32_t* best_order{};
+  uint32_t best_transition_num{};
+  uint32_t best_gap_score{};
+  uint32_t best_material_switch_num{};
+  uint32_t visit_budget{};
+};
+auto GetResourceIndex(const StrHash id, StrHashMap<uint32_t>* resource_index) {
+  if (auto index = resource_index->get(id); index != nullptr) { return *index; }
+  const auto index = resource_index->size();
+  resource_index->insert(id, index);
+  return index;
+}
+void AddUsage(const StrHash id, const ResourceState state, const bool read, const bool write, StrHashMap<uint32_t>* resource_index, ResizableArray<PassResourceUsage>* usage_list, const uint32_t usage_offset) {
+  const auto index = GetResourceIndex(id, resource_index);
+  for (uint32_t i = usage_offset; i < usage_list->size(); i++) {
+    auto& usage = (*usage_list)[i];
+    if (usage.resource_index != index) { continue; }
+    // read and written in the same pass (pingpong), the written buffer decides the state.
+    usage.read |= read;
+    usage.write |= write;
+    if (write) {
+      usage.state = state;
+    }
+    return;
+  }
+  usage_list->push_back({
+      .resource_index = index,
+      .state = state,
+      .read = read,
+      .write = write,
+    });
+}
+auto BuildUsageList(const RenderPassList& render_pass_list, SchedulerPass* pass_list, ResizableArray<PassResourceUsage>* usage_list) {
+  StrHashMap<uint32_t> resource_index;
+  for (uint32_t i = 0; i < render_pass_list.render_pass_len; i++) {
+    const auto& pass = render_pass_list.render_pass_info[i];
+    const auto usage_offset = usage_list->size();
+    // cbv are written by cpu and never transitioned.
+    for (uint32_t j = 0; j < pass.srv_num; j++) {
+      AddUsage(pass.srv[j], ResourceState::kShaderResource, true, false, &resource_index, usage_list, usage_offset);
+    }
+    for (uint32_t j = 0; j < pass.rtv_num; j++) {
+      AddUsage(pass.rtv[j], ResourceState::kRenderTarget, false, true, &resource_index, usage_list, usage_offset);
+    }
+    // uav accesses are ordered as writes.
+    for (uint32_t j = 0; j < pass.uav_num; j++) {
+      AddUsage(pass.uav[j], ResourceState::kUnorderedAccess, false, true, &resource_index, usage_list, usage_offset);
+    }
+    if (pass.dsv != kEmptyStr) {
+      AddUsage(pass.dsv, ResourceState::kDepthStencil, false, true, &resource_index, usage_list, usage_offset);
+    }
+    if (pass.present != kEmptyStr) {
+      AddUsage(pass.present, ResourceState::kPresent, true, false, &resource_index, usage_list, usage_offset);
+    }
+    pass_list[i].usage_offset = usage_offset;
+    pass_list[i].usage_num = usage_list->size() - usage_offset;
+    pass_list[i].material = pass.material;
+    DEBUG_ASSERT(pass_list[i].usage_num <= kMaxPassResourceUsageNum, DebugAssert{});
+  }
+  return resource_index.size();
+}
+auto IsDependent(const SchedulerPass& pass, const SchedulerPass& prev_pass, const PassResourceUsage* usage_list) {
+  for (uint32_t i = 0; i < pass.usage_num; i++) {
+    const auto& usage = usage_list[pass.usage_offset + i];
+    for (uint32_t j = 0; j < prev_pass.usage_num; j++) {
+      const auto& prev_usage = usage_list[prev_pass.usage_offset + j];
+      if (usage.resource_index != prev_usage.resource_index) { continue; }
+      if (usage.write || prev_usage.write) { return true; }
+    }
+  }
+  return false;
+}
+void BuildDependency(const uint32_t pass_num, const PassResourceUsage* usage_list, SchedulerPass* pass_list) {
+  for (uint32_t i = 0; i < pass_num; i++) {
+    auto& pass = pass_list[i];
+    for (uint32_t j = 0; j < i; j++) {
+      const auto& prev_pass = pass_list[j];
+      for (uint32_t k = 0; k < pass.usage_num; k++) {
+        const auto& usage = usage_list[pass.usage_offset + k];
+        for (uint32_t l = 0; l < prev_pass.usage_num; l++) {
+          const auto& prev_usage = usage_list[prev_pass.usage_offset + l];
+          if (usage.resource_index != prev_usage.resource_index) { continue; }
+          if (!usage.write && !prev_usage.write) { continue; }
+          pass.dependency_mask |= 1ULL << j;
+          if (usage.read && prev_usage.write) {
+            pass.producer_mask |= 1ULL << j;
+          }
+        }
+      }
+    }
+  }
+}
+auto GetTransitionNum(const PassResourceUsage& usage, const ResourceState current_state) {
+  if (current_state == ResourceState::kUndefined) { return 0U; }
+  // pingpong passes read one buffer and write the other, both change their layouts.
+  if (usage.read && usage.write) { return 2U; }
+  return current_state != usage.state ? 1U : 0U;
+}
+auto ApplyPass(const SchedulerPass& pass, const PassResourceUsage* usage_list, ResourceState* state, ResourceState* prev_state) {
+  uint32_t transition_num = 0;
+  for (uint32_t i = 0; i < pass.usage_num; i++) {
+    const auto& usage = usage_list[pass.usage_offset + i];
+    if (prev_state != nullptr) {
+      prev_state[i] = state[usage.resource_index];
+    }
+    transition_num += GetTransitionNum(usage, state[usage.resource_index]);
+    state[usage.resource_index] = usage.state;
+  }
+  return transition_num;
+}
+void RevertPass(const SchedulerPass& pass, const PassResourceUsage* usage_list, const ResourceState* prev_state, ResourceState* state) {
+  // restore in reverse in case a resource appears twice.
+  for (uint32_t i = pass.usage_num; i > 0; i--) {
+    state[usage_list[pass.usage_offset + i - 1].resource_index] = prev_state[i - 1];
+  }
+}
+auto GetGapScore(const uint32_t pass_num, const SchedulerPass* pass_list, const uint32_t* order) {
+  // independent passes between a producer and its consumer hide the barrier between them.
+  uint32_t position[kMaxScheduledRenderPassNum]{};
+  for (uint32_t i = 0; i < pass_num; i++) {
+    position[order[i]] = i;
+  }
+  uint32_t score = 0;
+  for (uint32_t i = 0; i < pass_num; i++) {
+    for (uint32_t j = 0; j < pass_num; j++) {
+      if ((pass_list[i].producer_mask & (1ULL << j)) == 0) { continue; }
+      const auto gap = position[i] - position[j] - 1;
+      score += std::min(gap, kMaxProducerGapScore);
+    }
+  }
+  return score;
+}
+auto GetMaterialSwitchNum(const uint32_t pass_num, const SchedulerPass* pass_list, const uint32_t* order) {
+  // the base material decides rootsig and shaders, consecutive passes sharing it skip rebinding them.
+  // passes without material (copy, present) neither break nor continue a run.
+  uint32_t switch_num = 0;
+  StrHash prev_material = kEmptyStr;
+  for (uint32_t i = 0; i < pass_num; i++) {
+    const auto material = pass_list[order[i]].material;
+    if (material == kEmptyStr) { continue; }
+    if (prev_material != kEmptyStr && material != prev_material) {
+      switch_num++;
+    }
+    prev_material = material;
+  }
+  return switch_num;
+}
+void Search(SchedulerContext* context, const uint32_t depth, const uint64_t scheduled_mask, const uint32_t transition_num) {
+  if (context->visit_budget == 0) { return; }
+  context->visit_budget--;
+  if (transition_num > context->best_transition_num) { return; }
+  if (depth == context->pass_num) {
+    const auto gap_score = GetGapScore(context->pass_num, context->pass_list, context->order);
+    const auto material_switch_num = GetMaterialSwitchNum(context->pass_num, context->pass_list, context->order);
+    if (transition_num == context->best_transition_num) {
+      if (gap_score < context->best_gap_score) { return; }
+      if (gap_score == context->best_gap_score && material_switch_num >= context->best_material_switch_num) { return; }
+    }
+    context->best_transition_num = transition_num;
+    context->best_gap_score = gap_score;
+    context->best_material_switch_num = material_switch_num;
+    for (uint32_t i = 0; i < context->pass_num; i++) {
+      context->best_order[i] = context->order[i];
+    }
+    return;
+  }
+  ResourceState prev_state[kMaxPassResourceUsageNum];
+  for (uint32_t i = 0; i < context->pass_num; i++) {
+    if (scheduled_mask & (1ULL << i)) { continue; }
+    const auto& pass = context->pass_list[i];
+    if ((pass.dependency_mask & ~scheduled_mask) != 0) { continue; }
+    const auto pass_transition_num = ApplyPass(pass, context->usage_list, context->state, prev_state);
+    context->order[depth] = i;
+    Search(context, depth + 1, scheduled_mask | (1ULL << i), transition_num + pass_transition_num);
+    RevertPass(pass, context->usage_list, prev_state, context->state);
+  }
+}
+struct SchedulerGraph {
+  SchedulerPass* pass_list{};
+  ResizableArray<PassResourceUsage>* usage_list{};
+  uint32_t resource_num{};
+};
+auto BuildSchedulerGraph(const RenderPassList& render_pass_list) {
+  SchedulerGraph graph{
+    .pass_list = AllocateArray<SchedulerPass>(render_pass_list.render_pass_len),
+    .usage_list = New<ResizableArray<PassResourceUsage>>(),
+  };
+  for (uint32_t i = 0; i < render_pass_list.render_pass_len; i++) {
+    graph.pass_list[i] = {};
+  }
+  graph.resource_num = BuildUsageList(render_pass_list, graph.pass_list, graph.usage_list);
+  // dependency and producer masks hold one bit per pass, longer lists are never searched.
+  if (render_pass_list.render_pass_len <= kMaxScheduledRenderPassNum) {
+    BuildDependency(render_pass_list.render_pass_len, graph.usage_list->begin(), graph.pass_list);
+  }
+  return graph;
+}
+void ReleaseSchedulerGraph(SchedulerGraph& graph) {
+  Deallocate(graph.pass_list);
+  graph.usage_list->~ResizableArray<PassResourceUsage>();
+  Deallocate(graph.usage_list);
+}
+auto CountTransitions(const uint32_t pass_num, const SchedulerGraph& graph, const uint32_t* order) {
+  auto state = AllocateArray<ResourceState>(graph.resource_num);
+  for (uint32_t i = 0; i < graph.resource_num; i++) {
+    state[i] = ResourceState::kUndefined;
+  }
+  uint32_t transition_num = 0;
+  for (uint32_t i = 0; i < pass_num; i++) {
+    transition_num += ApplyPass(graph.pass_list[order ? order[i] : i], graph.usage_list->begin(), state, nullptr);
+  }
+  Deallocate(state);
+  return transition_num;
+}
+} // namespace
+namespace boke {
+uint32_t ScheduleRenderPassList(const RenderPassList& render_pass_list, uint32_t* order) {
+  const auto pass_num = render_pass_list.render_pass_len;
+  for (uint32_t i = 0; i < pass_num; i++) {
+    order[i] = i;
+  }
+  if (pass_num <= 1) { return 0; }
+  if (pass_num > kMaxScheduledRenderPassNum) {
+    spdlog::warn("render pass list too long to schedule, list order kept. {}", pass_num);
+    return CountRenderPassListTransitions(render_pass_list, nullptr);
+  }
+  auto graph = BuildSchedulerGraph(render_pass_list);
+  auto state = AllocateArray<ResourceState>(graph.resource_num);
+  for (uint32_t i = 0; i < graph.resource_num; i++) {
+    state[i] = ResourceState::kUndefined;
+  }
+  auto work_order = AllocateArray<uint32_t>(pass_num);
+  // list order is the first candidate, others must be strictly better.
+  SchedulerContext context{
+    .pass_num = pass_num,
+    .pass_list = graph.pass_list,
+    .usage_list = graph.usage_list->begin(),
+    .state = state,
+    .order = work_order,
+    .best_order = order,
+    .best_transition_num = CountTransitions(pass_num, graph, nullptr),
+    .best_gap_score = GetGapScore(pass_num, graph.pass_list, order),
+    .best_material_switch_num = GetMaterialSwitchNum(pass_num, graph.pass_list, order),
+    .visit_budget = kSearchVisitBudget,
+  };
+  Search(&context, 0, 0, 0);
+  Deallocate(work_order);
+  Deallocate(state);
+  ReleaseSchedulerGraph(graph);
+  return context.best_transition_num;
+}
+uint32_t CountRenderPassListTransitions(const RenderPassList& render_pass_list, const uint32_t* order) {
+  auto graph = BuildSchedulerGraph(render_pass_list);
+  const auto transition_num = CountTransitions(render_pass_list.render_pass_len, graph, order);
+  ReleaseSchedulerGraph(graph);
+  return transition_num;
+}
+bool IsValidRenderPassOrder(const RenderPassList& render_pass_list, const uint32_t* order) {
+  const auto pass_num = render_pass_list.render_pass_len;
+  auto graph = BuildSchedulerGraph(render_pass_list);
+  // positions instead of pass masks, lists longer than kMaxScheduledRenderPassNum are checked as well.
+  auto position = AllocateArray<uint32_t>(pass_num);
+  for (uint32_t i = 0; i < pass_num; i++) {
+    position[i] = pass_num;
+  }
+  bool valid = true;
+  for (uint32_t i = 0; i < pass_num; i++) {
+    const auto index = order[i];
+    if (index >= pass_num || position[index] != pass_num) {
+      valid = false;
+      break;
+    }
+    position[index] = i;
+  }
+  for (uint32_t i = 0; valid && i < pass_num; i++) {
+    for (uint32_t j = 0; j < i; j++) {
+      if (position[j] < position[i]) { continue; }
+      if (IsDependent(graph.pass_list[i], graph.pass_list[j], graph.usage_list->begin())) {
+        valid = false;
+        break;
+      }
+    }
+  }
+  Deallocate(position);
+  ReleaseSchedulerGraph(graph);
+  return valid;
+}
+} // namespace boke
+#include <memory>
+#include "doctest/doctest.h"
+TEST_CASE("render pass scheduler") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 64 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  StrHash swapchain[] = {"swapchain"_id,};
+  uint32_t order[kMaxScheduledRenderPassNum]{};
+  SUBCASE("chain keeps list order") {
+    StrHash gbuffers[] = {"gbuffer0"_id, "gbuffer1"_id, "gbuffer2"_id, "gbuffer3"_id,};
+    StrHash primary[] = {"primary"_id,};
+    StrHash imgui_font[] = {"imgui_font"_id,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        // gbuffer
+        .queue = "direct"_id,
+        .rtv = gbuffers,
+        .rtv_num = 4,
+        .dsv = "depth"_id,
+      },
+      {
+        // lighting
+        .queue = "direct"_id,
+        .srv = gbuffers,
+        .srv_num = 4,
+        .rtv = primary,
+        .rtv_num = 1,
+      },
+      {
+        // tonemap
+        .queue = "direct"_id,
+        .srv = primary,
+        .srv_num = 1,
+        .rtv = primary,
+        .rtv_num = 1,
+      },
+      {
+        // oetf
+        .queue = "direct"_id,
+        .srv = primary,
+        .srv_num = 1,
+        .rtv = swapchain,
+        .rtv_num = 1,
+      },
+      {
+        // imgui
+        .queue = "direct"_id,
+        .srv = imgui_font,
+        .srv_num = 1,
+        .rtv = swapchain,
+        .rtv_num = 1,
+      },
+      {
+        // present
+        .queue = "direct"_id,
+        .present = "swapchain"_id,
+      },
+    };
+    RenderPassList render_pass_list{
+      .render_pass_len = 6,
+      .render_pass_info = render_pass_info,
+    };
+    // gbuffers to srv (4), pingpong primary (2), primary to srv (1), swapchain to present (1).
+    CHECK_EQ(CountRenderPassListTransitions(render_pass_list, nullptr), 8);
+    CHECK_EQ(ScheduleRenderPassList(render_pass_list, order), 8);
+    for (uint32_t i = 0; i < 6; i++) {
+      CAPTURE(i);
+      CHECK_EQ(order[i], i);
+    }
+  }
+  SUBCASE("independent pass moves between producer and consumer") {
+    StrHash shadow[] = {"shadow"_id,};
+    StrHash ao[] = {"ao"_id,};
+    StrHash gbuffer[] = {"gbuffer"_id,};
+    StrHash ao_and_gbuffer[] = {"ao"_id, "gbuffer"_id,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .rtv = shadow,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .srv = shadow,
+        .srv_num = 1,
+        .rtv = ao,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .rtv = gbuffer,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .srv = ao_and_gbuffer,
+        .srv_num = 2,
+        .rtv = swapchain,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .present = "swapchain"_id,
+      },
+    };
+    RenderPassList render_pass_list{
+      .render_pass_len = 5,
+      .render_pass_info = render_pass_info,
+    };
+    CHECK_EQ(ScheduleRenderPassList(render_pass_list, order), 4);
+    CHECK_UNARY(IsValidRenderPassOrder(render_pass_list, order));
+    CHECK_EQ(order[0], 0);
+    CHECK_EQ(order[1], 2);
+    CHECK_EQ(order[2], 1);
+    CHECK_EQ(order[3], 3);
+    CHECK_EQ(order[4], 4);
+  }
+  SUBCASE("reads in the same layout are batched") {
+    StrHash color[] = {"color"_id,};
+    StrHash blur[] = {"blur"_id,};
+    StrHash luminance[] = {"luminance"_id,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .rtv = color,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .srv = color,
+        .srv_num = 1,
+        .rtv = blur,
+        .rtv_num = 1,
+      },
+      {
+        // presented directly, independent of the reads around it.
+        .queue = "direct"_id,
+        .present = "color"_id,
+      },
+      {
+        .queue = "direct"_id,
+        .srv = color,
+        .srv_num = 1,
+        .rtv = luminance,
+        .rtv_num = 1,
+      },
+    };
+    RenderPassList render_pass_list{
+      .render_pass_len = 4,
+      .render_pass_info = render_pass_info,
+    };
+    // srv, present, srv.
+    CHECK_EQ(CountRenderPassListTransitions(render_pass_list, nullptr), 3);
+    CHECK_EQ(ScheduleRenderPassList(render_pass_list, order), 2);
+    CHECK_UNARY(IsValidRenderPassOrder(render_pass_list, order));
+    CHECK_EQ(CountRenderPassListTransitions(render_pass_list, order), 2);
+    CHECK_EQ(order[0], 0);
+    CHECK_EQ(order[3], 2);
+  }
+  SUBCASE("passes sharing a material are grouped") {
+    StrHash target0[] = {"target0"_id,};
+    StrHash target1[] = {"target1"_id,};
+    StrHash target2[] = {"target2"_id,};
+    StrHash targets[] = {"target0"_id, "target1"_id, "target2"_id,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .material = "material0"_id,
+        .rtv = target0,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .material = "material1"_id,
+        .rtv = target1,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .material = "material0"_id,
+        .rtv = target2,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .material = "material2"_id,
+        .srv = targets,
+        .srv_num = 3,
+        .rtv = swapchain,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .present = "swapchain"_id,
+      },
+    };
+    RenderPassList render_pass_list{
+      .render_pass_len = 5,
+      .render_pass_info = render_pass_info,
+    };
+    // transitions and gaps are the same in either order.
+    CHECK_EQ(ScheduleRenderPassList(render_pass_list, order), 4);
+    CHECK_UNARY(IsValidRenderPassOrder(render_pass_list, order));
+    CHECK_EQ(order[0], 0);
+    CHECK_EQ(order[1], 2);
+    CHECK_EQ(order[2], 1);
+    CHECK_EQ(order[3], 3);
+    CHECK_EQ(order[4], 4);
+  }
+  SUBCASE("dependencies") {
+    StrHash color[] = {"color"_id,};
+    RenderPassInfo render_pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .srv = color,
+        .srv_num = 1,
+        .rtv = swapchain,
+        .rtv_num = 1,
+      },
+      {
+        // write after read
+        .queue = "direct"_id,
+        .rtv = color,
+        .rtv_num = 1,
+      },
+    };
+    RenderPassList render_pass_list{
+      .render_pass_len = 2,
+      .render_pass_info = render_pass_info,
+    };
+    uint32_t swapped[] = {1, 0,};
+    CHECK_UNARY_FALSE(IsValidRenderPassOrder(render_pass_list, swapped));
+    ScheduleRenderPassList(render_pass_list, order);
+    CHECK_EQ(order[0], 0);
+    CHECK_EQ(order[1], 1);
+  }
+  SUBCASE("lists longer than the limit keep list order") {
+    const uint32_t pass_num = kMaxScheduledRenderPassNum + 2;
+    StrHash pingpong[] = {"pingpong"_id,};
+    StrHash independent[] = {"independent"_id,};
+    auto render_pass_info = std::make_unique<RenderPassInfo[]>(pass_num);
+    for (uint32_t i = 0; i < pass_num; i++) {
+      render_pass_info[i] = {
+        .queue = "direct"_id,
+        .srv = pingpong,
+        .srv_num = 1,
+        .rtv = pingpong,
+        .rtv_num = 1,
+      };
+    }
+    // last pass depends on nothing, a searched order would move it.
+    render_pass_info[pass_num - 1] = {
+      .queue = "direct"_id,
+      .rtv = independent,
+      .rtv_num = 1,
+    };
+    RenderPassList render_pass_list{
+      .render_pass_len = pass_num,
+      .render_pass_info = render_pass_info.get(),
+    };
+    auto long_order = std::make_unique<uint32_t[]>(pass_num);
+    CHECK_EQ(ScheduleRenderPassList(render_pass_list, long_order.get()), CountRenderPassListTransitions(render_pass_list, nullptr));
+    for (uint32_t i = 0; i < pass_num; i++) {
+      CAPTURE(i);
+      CHECK_EQ(long_order[i], i);
+    }
+    CHECK_UNARY(IsValidRenderPassOrder(render_pass_list, long_order.get()));
+    std::swap(long_order[pass_num - 3], long_order[pass_num - 2]);
+    CHECK_UNARY_FALSE(IsValidRenderPassOrder(render_pass_list, long_order.get()));
+    std::swap(long_order[pass_num - 3], long_order[pass_num - 2]);
+    std::rotate(long_order.get(), long_order.get() + pass_num - 1, long_order.get() + pass_num);
+    CHECK_UNARY(IsValidRenderPassOrder(render_pass_list, long_order.get()));
+  }
+}
@@ -0,0 +1,22 @@
+#pragma once
+namespace boke {
+const uint32_t kMaxScheduledRenderPassNum = 64;
+/**
+ * chooses a topological order of the pass dependency dag (read after write, write after read, write after write)
+ * with the fewest layout transitions, then with the most independent passes between producers and consumers,
+ * then with the fewest material switches between consecutive passes.
+ * list order is kept unless a better order is found within a bounded search,
+ * lists longer than kMaxScheduledRenderPassNum always keep list order.
+ * writes render_pass_len indices to order and returns the number of layout transitions of the order.
+ **/
+uint32_t ScheduleRenderPassList(const RenderPassList& render_pass_list, uint32_t* order);
+/**
+ * layout transitions of the list executed in order, list order if order is nullptr.
+ * the first use of a resource is free as its initial layout is taken from it.
+ **/
+uint32_t CountRenderPassListTransitions(const RenderPassList& render_pass_list, const uint32_t* order);
+/**
+ * returns false if order breaks a dependency of the list.
+ **/
+bool IsValidRenderPassOrder(const RenderPassList& render_pass_list, const uint32_t* order);
+}
@@ -0,0 +1,486 @@
+#include <algorithm>
+#include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/debug_assert.h"
+#include "boke/str_hash.h"
+#include "boke/util.h"
+#include "json.h"
+#include "render_pass_info.h"
+#include "resource_info.h"
+#include "config_loader.h"
+#include "dxgi_format.h"
+#include "queue_schedule.h"
+#include "resource_aliasing.h"
+namespace {
+using namespace boke;
+const uint32_t kUnusedPass = ~0U;
+struct TransientResource {
+  StrHash resource_id{kEmptyStr};
+  uint32_t local_index{};
+  uint64_t size_in_bytes{};
+  ResourceLifetime* lifetime_list{}; // per render pass list, first_pass is kUnusedPass if not used.
+  bool persistent{};
+  uint64_t heap_offset{};
+};
+auto AlignSize(const uint64_t size, const uint64_t alignment) {
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+void UpdateLifetime(const StrHash id, const uint32_t pass_index, const bool write, const bool async_queue, StrHashMap<ResourceLifetime>* lifetime_list) {
+  if (auto lifetime = lifetime_list->get(id); lifetime != nullptr) {
+    lifetime->last_pass = pass_index;
+    lifetime->async_queue = lifetime->async_queue || async_queue;
+    return;
+  }
+  lifetime_list->insert(id, {.first_pass = pass_index, .last_pass = pass_index, .read_before_write = !write, .async_queue = async_queue,});
+}
+void UpdateLifetime(const StrHash* list, const uint32_t num, const uint32_t pass_index, const bool write, const bool async_queue, StrHashMap<ResourceLifetime>* lifetime_list) {
+  for (uint32_t i = 0; i < num; i++) {
+    UpdateLifetime(list[i], pass_index, write, async_queue, lifetime_list);
+  }
+}
+auto IsAliasingCandidate(const ResourceInfo& info) {
+  if (info.physical_resource_num == 0) { return false; }
+  return info.creation_type == ResourceCreationType::kRtv || info.creation_type == ResourceCreationType::kDsv;
+}
+auto IsPersistent(const StrHash resource_id, const ResourceAliasingDesc& desc) {
+  for (uint32_t i = 0; i < desc.persistent_resource_num; i++) {
+    if (desc.persistent_resource_list[i] == resource_id) { return true; }
+  }
+  return false;
+}
+struct TransientResourceCollectionAsset {
+  const ResourceAliasingDesc* desc{};
+  ResizableArray<TransientResource>* resource_list{};
+};
+void CollectTransientResource(TransientResourceCollectionAsset* asset, const StrHash resource_id, const ResourceInfo* info) {
+  if (!IsAliasingCandidate(*info)) { return; }
+  if (IsPersistent(resource_id, *asset->desc)) { return; }
+  const auto size_ptr = (asset->desc->resource_size_in_bytes != nullptr) ? asset->desc->resource_size_in_bytes->get(resource_id) : nullptr;
+  const auto size_in_bytes = AlignSize((size_ptr != nullptr) ? *size_ptr : EstimateResourceSizeInBytes(*info), kResourcePlacementAlignment);
+  // each physical resource of a pingpong pair gets its own placement with the same lifetime.
+  for (uint32_t i = 0; i < info->physical_resource_num; i++) {
+    asset->resource_list->push_back({
+        .resource_id = resource_id,
+        .local_index = i,
+        .size_in_bytes = size_in_bytes,
+      });
+  }
+}
+auto IsOverlapping(const ResourceLifetime& a, const ResourceLifetime& b) {
+  if (a.first_pass == kUnusedPass || b.first_pass == kUnusedPass) { return false; }
+  return a.first_pass <= b.last_pass && b.first_pass <= a.last_pass;
+}
+auto IsConflicting(const TransientResource& a, const TransientResource& b, const uint32_t render_pass_list_num) {
+  for (uint32_t i = 0; i < render_pass_list_num; i++) {
+    if (IsOverlapping(a.lifetime_list[i], b.lifetime_list[i])) { return true; }
+  }
+  return false;
+}
+auto IsUsed(const TransientResource& resource, const uint32_t render_pass_list_num) {
+  for (uint32_t i = 0; i < render_pass_list_num; i++) {
+    if (resource.lifetime_list[i].first_pass != kUnusedPass) { return true; }
+  }
+  return false;
+}
+void SortBySizeDescending(TransientResource** list, const uint32_t num) {
+  // insertion sort, keeps collection order for equal sizes.
+  for (uint32_t i = 1; i < num; i++) {
+    const auto resource = list[i];
+    auto j = i;
+    while (j > 0 && list[j - 1]->size_in_bytes < resource->size_in_bytes) {
+      list[j] = list[j - 1];
+      j--;
+    }
+    list[j] = resource;
+  }
+}
+auto FindHeapOffset(const TransientResource& resource, TransientResource** placed_list, const uint32_t placed_num, const uint32_t render_pass_list_num) {
+  // first fit: try the heap head and the end of each conflicting placement, lowest offset wins.
+  uint64_t best_offset = ~0ULL;
+  for (uint32_t i = 0; i <= placed_num; i++) {
+    uint64_t offset = 0;
+    if (i < placed_num) {
+      if (!IsConflicting(resource, *placed_list[i], render_pass_list_num)) { continue; }
+      offset = placed_list[i]->heap_offset + placed_list[i]->size_in_bytes;
+    }
+    if (offset >= best_offset) { continue; }
+    bool fits = true;
+    for (uint32_t j = 0; j < placed_num; j++) {
+      const auto& placed = *placed_list[j];
+      if (!IsConflicting(resource, placed, render_pass_list_num)) { continue; }
+      if (offset < placed.heap_offset + placed.size_in_bytes && placed.heap_offset < offset + resource.size_in_bytes) {
+        fits = false;
+        break;
+      }
+    }
+    if (fits) {
+      best_offset = offset;
+    }
+  }
+  return best_offset;
+}
+} // namespace
+namespace boke {
+StrHashMap<ResourceLifetime> AnalyzeResourceLifetime(const RenderPassList& render_pass_list) {
+  StrHashMap<ResourceLifetime> lifetime_list;
+  for (uint32_t i = 0; i < render_pass_list.render_pass_len; i++) {
+    const auto& pass = render_pass_list.render_pass_info[i];
+    const auto async_queue = GetQueueType(pass.queue) != QueueType::kDirect;
+    // reads are registered first, so a pass reading and writing a resource counts as a read.
+    UpdateLifetime(pass.cbv, pass.cbv_num, i, false, async_queue, &lifetime_list);
+    UpdateLifetime(pass.srv, pass.srv_num, i, false, async_queue, &lifetime_list);
+    UpdateLifetime(pass.rtv, pass.rtv_num, i, true, async_queue, &lifetime_list);
+    UpdateLifetime(pass.uav, pass.uav_num, i, true, async_queue, &lifetime_list);
+    if (pass.dsv != kEmptyStr) {
+      UpdateLifetime(pass.dsv, i, true, async_queue, &lifetime_list);
+    }
+    if (pass.present != kEmptyStr) {
+      UpdateLifetime(pass.present, i, false, async_queue, &lifetime_list);
+    }
+  }
+  return lifetime_list;
+}
+ResourceAliasingPlan* PlanResourceAliasing(const ResourceAliasingDesc& desc) {
+  const auto render_pass_list_num = desc.render_pass_list_num;
+  ResizableArray<TransientResource> resource_list(desc.resource_info->size());
+  {
+    TransientResourceCollectionAsset asset{
+      .desc = &desc,
+      .resource_list = &resource_list,
+    };
+    desc.resource_info->iterate<TransientResourceCollectionAsset>(CollectTransientResource, &asset);
+  }
+  const auto resource_num = resource_list.size();
+  auto lifetime_buffer = AllocateArray<ResourceLifetime>(resource_num * render_pass_list_num);
+  for (uint32_t i = 0; i < resource_num; i++) {
+    resource_list[i].lifetime_list = &lifetime_buffer[i * render_pass_list_num];
+  }
+  for (uint32_t i = 0; i < render_pass_list_num; i++) {
+    auto lifetime_list = AnalyzeResourceLifetime(desc.render_pass_list[i]);
+    for (auto& resource : resource_list) {
+      auto lifetime = lifetime_list.get(resource.resource_id);
+      if (lifetime == nullptr) {
+        resource.lifetime_list[i] = {.first_pass = kUnusedPass, .last_pass = kUnusedPass,};
+        continue;
+      }
+      resource.lifetime_list[i] = *lifetime;
+      // pass indices do not order passes on different queues, e.g. a compute pass reading a resource
+      // may run after a later direct pass wrote another resource placed in the same memory.
+      if (lifetime->read_before_write || lifetime->async_queue) {
+        resource.persistent = true;
+      }
+    }
+  }
+  // place larger resources first to reduce fragmentation.
+  auto placed_list = AllocateArray<TransientResource*>(resource_num);
+  uint32_t placed_num = 0;
+  for (auto& resource : resource_list) {
+    if (resource.persistent) { continue; }
+    if (!IsUsed(resource, render_pass_list_num)) { continue; }
+    placed_list[placed_num] = &resource;
+    placed_num++;
+  }
+  SortBySizeDescending(placed_list, placed_num);
+  auto plan = New<ResourceAliasingPlan>();
+  plan->placement_num = placed_num;
+  plan->placement_list = AllocateArray<AliasedResourcePlacement>(placed_num);
+  for (uint32_t i = 0; i < placed_num; i++) {
+    auto& resource = *placed_list[i];
+    resource.heap_offset = FindHeapOffset(resource, placed_list, i, render_pass_list_num);
+    plan->placement_list[i] = {
+      .resource_id = resource.resource_id,
+      .local_index = resource.local_index,
+      .heap_offset = resource.heap_offset,
+      .size_in_bytes = resource.size_in_bytes,
+    };
+    plan->heap_size_in_bytes = std::max(plan->heap_size_in_bytes, resource.heap_offset + resource.size_in_bytes);
+    plan->unaliased_size_in_bytes += resource.size_in_bytes;
+  }
+  Deallocate(placed_list);
+  Deallocate(lifetime_buffer);
+  return plan;
+}
+void ReleaseResourceAliasingPlan(ResourceAliasingPlan* plan) {
+  Deallocate(plan->placement_list);
+  Deallocate(plan);
+}
+const AliasedResourcePlacement* FindAliasedResourcePlacement(const ResourceAliasingPlan& plan, const StrHash resource_id, const uint32_t local_index) {
+  for (uint32_t i = 0; i < plan.placement_num; i++) {
+    const auto& placement = plan.placement_list[i];
+    if (placement.resource_id == resource_id && placement.local_index == local_index) { return &placement; }
+  }
+  return nullptr;
+}
+uint64_t EstimateResourceSizeInBytes(const ResourceInfo& resource_info) {
+  const auto format_info = GetDxgiFormatInfo(resource_info.format);
+  DEBUG_ASSERT(format_info != nullptr, DebugAssert{});
+  uint64_t pixel_num = 0;
+  for (uint32_t i = 0; i < resource_info.mip_levels; i++) {
+    pixel_num += static_cast<uint64_t>(std::max(resource_info.size.width >> i, 1U)) * std::max(resource_info.size.height >> i, 1U);
+  }
+  pixel_num *= resource_info.array_size;
+  return AlignSize(pixel_num * format_info->bits_per_pixel / 8, kResourcePlacementAlignment);
+}
+void LogResourceAliasingPlan(const ResourceAliasingPlan& plan) {
+  spdlog::info("transient resources: {} placements, heap {} bytes, {} bytes without aliasing, {} bytes saved",
+               plan.placement_num,
+               plan.heap_size_in_bytes,
+               plan.unaliased_size_in_bytes,
+               plan.unaliased_size_in_bytes - plan.heap_size_in_bytes);
+}
+} // namespace boke
+#include "doctest/doctest.h"
+namespace {
+auto GetPlacementEnd(const boke::AliasedResourcePlacement& placement) {
+  return placement.heap_offset + placement.size_in_bytes;
+}
+} // namespace
+TEST_CASE("resource aliasing") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 16 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  StrHash gbuffers[] = {"gbuffer0"_id, "gbuffer1"_id, "gbuffer2"_id, "gbuffer3"_id,};
+  StrHash primary[] = {"primary"_id,};
+  StrHash swapchain[] = {"swapchain"_id,};
+  StrHash imgui_font[] = {"imgui_font"_id,};
+  const uint32_t render_pass_info_len = 6;
+  RenderPassInfo render_pass_info[render_pass_info_len] = {
+    {
+      // gbuffer
+      .queue = "direct"_id,
+      .rtv = gbuffers,
+      .rtv_num = 4,
+      .dsv = "depth"_id,
+    },
+    {
+      // lighting
+      .queue = "direct"_id,
+      .srv = gbuffers,
+      .srv_num = 4,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+    {
+      // tonemap
+      .queue = "direct"_id,
+      .srv = primary,
+      .srv_num = 1,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+    {
+      // oetf
+      .queue = "direct"_id,
+      .srv = primary,
+      .srv_num = 1,
+      .rtv = swapchain,
+      .rtv_num = 1,
+    },
+    {
+      // imgui
+      .queue = "direct"_id,
+      .srv = imgui_font,
+      .srv_num = 1,
+      .rtv = swapchain,
+      .rtv_num = 1,
+    },
+    {
+      // present
+      .queue = "direct"_id,
+      .present = "swapchain"_id,
+    },
+  };
+  RenderPassList render_pass_list{
+    .render_pass_len = render_pass_info_len,
+    .render_pass_info = render_pass_info,
+  };
+  auto resource_info = ParseResourceInfo(GetJson("tests/resources.json"), {});
+  // 1920x1080 aligned to 64KB.
+  const uint64_t size_32bpp = 127 * kResourcePlacementAlignment;
+  const uint64_t size_64bpp = 254 * kResourcePlacementAlignment;
+  SUBCASE("lifetime") {
+    auto lifetime_list = AnalyzeResourceLifetime(render_pass_list);
+    CHECK_EQ(lifetime_list["gbuffer0"_id].first_pass, 0);
+    CHECK_EQ(lifetime_list["gbuffer0"_id].last_pass, 1);
+    CHECK_UNARY_FALSE(lifetime_list["gbuffer0"_id].read_before_write);
+    CHECK_EQ(lifetime_list["gbuffer3"_id].first_pass, 0);
+    CHECK_EQ(lifetime_list["gbuffer3"_id].last_pass, 1);
+    CHECK_EQ(lifetime_list["depth"_id].first_pass, 0);
+    CHECK_EQ(lifetime_list["depth"_id].last_pass, 0);
+    CHECK_EQ(lifetime_list["primary"_id].first_pass, 1);
+    CHECK_EQ(lifetime_list["primary"_id].last_pass, 3);
+    CHECK_UNARY_FALSE(lifetime_list["primary"_id].read_before_write);
+    CHECK_EQ(lifetime_list["swapchain"_id].first_pass, 3);
+    CHECK_EQ(lifetime_list["swapchain"_id].last_pass, 5);
+    CHECK_EQ(lifetime_list["imgui_font"_id].first_pass, 4);
+    CHECK_UNARY(lifetime_list["imgui_font"_id].read_before_write);
+  }
+  SUBCASE("estimated size") {
+    CHECK_EQ(EstimateResourceSizeInBytes(resource_info["gbuffer0"_id]), size_32bpp);
+    CHECK_EQ(EstimateResourceSizeInBytes(resource_info["depth"_id]), size_32bpp);
+    CHECK_EQ(EstimateResourceSizeInBytes(resource_info["primary"_id]), size_64bpp);
+  }
+  SUBCASE("single list") {
+    auto plan = PlanResourceAliasing({
+        .render_pass_list_num = 1,
+        .render_pass_list = &render_pass_list,
+        .resource_info = &resource_info,
+      });
+    // gbuffer0-3, depth and two primary buffers.
+    CHECK_EQ(plan->placement_num, 7);
+    CHECK_EQ(plan->unaliased_size_in_bytes, size_32bpp * 5 + size_64bpp * 2);
+    // depth is dead before primary is written.
+    CHECK_EQ(plan->heap_size_in_bytes, size_32bpp * 4 + size_64bpp * 2);
+    CHECK_EQ(plan->unaliased_size_in_bytes - plan->heap_size_in_bytes, size_32bpp);
+    auto depth = FindAliasedResourcePlacement(*plan, "depth"_id, 0);
+    auto primary0 = FindAliasedResourcePlacement(*plan, "primary"_id, 0);
+    auto primary1 = FindAliasedResourcePlacement(*plan, "primary"_id, 1);
+    REQUIRE_NE(depth, nullptr);
+    REQUIRE_NE(primary0, nullptr);
+    REQUIRE_NE(primary1, nullptr);
+    CHECK_EQ(FindAliasedResourcePlacement(*plan, "primary"_id, 2), nullptr);
+    CHECK_EQ(FindAliasedResourcePlacement(*plan, "swapchain"_id, 0), nullptr);
+    // resources alive at the same time never share memory.
+    for (uint32_t i = 0; i < plan->placement_num; i++) {
+      const auto& a = plan->placement_list[i];
+      CHECK_EQ(a.heap_offset % kResourcePlacementAlignment, 0);
+      for (uint32_t j = i + 1; j < plan->placement_num; j++) {
+        const auto& b = plan->placement_list[j];
+        if (a.resource_id == "depth"_id || b.resource_id == "depth"_id) {
+          if (a.resource_id == "primary"_id || b.resource_id == "primary"_id) { continue; }
+        }
+        CAPTURE(i);
+        CAPTURE(j);
+        CHECK_UNARY(GetPlacementEnd(a) <= b.heap_offset || GetPlacementEnd(b) <= a.heap_offset);
+      }
+    }
+    ReleaseResourceAliasingPlan(plan);
+  }
+  SUBCASE("persistent resources") {
+    StrHash persistent_resource_list[] = {"depth"_id,};
+    auto plan = PlanResourceAliasing({
+        .render_pass_list_num = 1,
+        .render_pass_list = &render_pass_list,
+        .resource_info = &resource_info,
+        .persistent_resource_num = 1,
+        .persistent_resource_list = persistent_resource_list,
+      });
+    CHECK_EQ(plan->placement_num, 6);
+    CHECK_EQ(FindAliasedResourcePlacement(*plan, "depth"_id, 0), nullptr);
+    CHECK_EQ(plan->heap_size_in_bytes, plan->unaliased_size_in_bytes);
+    ReleaseResourceAliasingPlan(plan);
+  }
+  SUBCASE("compute queue") {
+    StrHash depth[] = {"depth"_id,};
+    RenderPassInfo async_pass_info[] = {
+      render_pass_info[0],
+      {
+        // ssao, may still read depth while lighting writes primary.
+        .queue = "compute"_id,
+        .srv = depth,
+        .srv_num = 1,
+      },
+      render_pass_info[1],
+      render_pass_info[2],
+      render_pass_info[3],
+      render_pass_info[4],
+      render_pass_info[5],
+    };
+    RenderPassList list{
+      .render_pass_len = render_pass_info_len + 1,
+      .render_pass_info = async_pass_info,
+    };
+    auto lifetime_list = AnalyzeResourceLifetime(list);
+    CHECK_UNARY(lifetime_list["depth"_id].async_queue);
+    CHECK_UNARY_FALSE(lifetime_list["primary"_id].async_queue);
+    auto plan = PlanResourceAliasing({
+        .render_pass_list_num = 1,
+        .render_pass_list = &list,
+        .resource_info = &resource_info,
+      });
+    // depth keeps its own memory instead of sharing it with primary.
+    CHECK_EQ(plan->placement_num, 6);
+    CHECK_EQ(FindAliasedResourcePlacement(*plan, "depth"_id, 0), nullptr);
+    CHECK_EQ(plan->heap_size_in_bytes, plan->unaliased_size_in_bytes);
+    ReleaseResourceAliasingPlan(plan);
+  }
+  SUBCASE("read before write") {
+    RenderPassInfo read_first_pass_info[] = {
+      {
+        // reads gbuffers written in a previous frame.
+        .queue = "direct"_id,
+        .srv = gbuffers,
+        .srv_num = 4,
+        .rtv = swapchain,
+        .rtv_num = 1,
+      },
+    };
+    RenderPassList list[] = {
+      render_pass_list,
+      {
+        .render_pass_len = 1,
+        .render_pass_info = read_first_pass_info,
+      },
+    };
+    auto plan = PlanResourceAliasing({
+        .render_pass_list_num = 2,
+        .render_pass_list = list,
+        .resource_info = &resource_info,
+      });
+    CHECK_EQ(plan->placement_num, 3);
+    CHECK_EQ(FindAliasedResourcePlacement(*plan, "gbuffer0"_id, 0), nullptr);
+    CHECK_NE(FindAliasedResourcePlacement(*plan, "depth"_id, 0), nullptr);
+    CHECK_EQ(plan->heap_size_in_bytes, size_64bpp * 2);
+    ReleaseResourceAliasingPlan(plan);
+  }
+  SUBCASE("exclusive lists") {
+    StrHash gbuffer0[] = {"gbuffer0"_id,};
+    StrHash gbuffer1[] = {"gbuffer1"_id,};
+    RenderPassInfo pass_info[] = {
+      {
+        .queue = "direct"_id,
+        .rtv = gbuffer0,
+        .rtv_num = 1,
+      },
+      {
+        .queue = "direct"_id,
+        .rtv = gbuffer1,
+        .rtv_num = 1,
+      },
+    };
+    RenderPassList list[] = {
+      {
+        .render_pass_len = 1,
+        .render_pass_info = &pass_info[0],
+      },
+      {
+        .render_pass_len = 1,
+        .render_pass_info = &pass_info[1],
+      },
+    };
+    auto plan = PlanResourceAliasing({
+        .render_pass_list_num = 2,
+        .render_pass_list = list,
+        .resource_info = &resource_info,
+      });
+    CHECK_EQ(plan->placement_num, 2);
+    CHECK_EQ(FindAliasedResourcePlacement(*plan, "gbuffer0"_id, 0)->heap_offset, 0);
+    CHECK_EQ(FindAliasedResourcePlacement(*plan, "gbuffer1"_id, 0)->heap_offset, 0);
+    CHECK_EQ(plan->heap_size_in_bytes, size_32bpp);
+    ReleaseResourceAliasingPlan(plan);
+  }
+  SUBCASE("queried size") {
+    StrHashMap<uint64_t> resource_size_in_bytes;
+    resource_size_in_bytes["depth"_id] = size_32bpp + 1;
+    auto plan = PlanResourceAliasing({
+        .render_pass_list_num = 1,
+        .render_pass_list = &render_pass_list,
+        .resource_info = &resource_info,
+        .resource_size_in_bytes = &resource_size_in_bytes,
+      });
+    CHECK_EQ(FindAliasedResourcePlacement(*plan, "depth"_id, 0)->size_in_bytes, size_32bpp + kResourcePlacementAlignment);
+    ReleaseResourceAliasingPlan(plan);
+  }
+  resource_info.~StrHashMap<ResourceInfo>();
+}
@@ -0,0 +1,57 @@
+#pragma once
+namespace boke {
+struct ResourceLifetime {
+  uint32_t first_pass{};
+  uint32_t last_pass{};
+  bool read_before_write{}; // contents come from a previous frame
+  bool async_queue{}; // used by a compute or copy pass, which may still run while later direct passes do
+};
+struct ResourceAliasingDesc {
+  /**
+   * lists are assumed to be executed exclusively, one list per frame.
+   **/
+  uint32_t render_pass_list_num{};
+  const RenderPassList* render_pass_list{};
+  const StrHashMap<ResourceInfo>* resource_info{};
+  /**
+   * allocation sizes queried from device (see GetResourceAllocationSizeList).
+   * sizes are estimated from format and size when omitted.
+   **/
+  const StrHashMap<uint64_t>* resource_size_in_bytes{}; // optional
+  /**
+   * resources read outside of lists, e.g. by the debug buffer view.
+   **/
+  uint32_t persistent_resource_num{};
+  const StrHash* persistent_resource_list{};
+};
+struct AliasedResourcePlacement {
+  StrHash resource_id{kEmptyStr};
+  uint32_t local_index{};
+  uint64_t heap_offset{};
+  uint64_t size_in_bytes{};
+};
+struct ResourceAliasingPlan {
+  uint32_t placement_num{};
+  AliasedResourcePlacement* placement_list{};
+  uint64_t heap_size_in_bytes{};
+  uint64_t unaliased_size_in_bytes{}; // sum of placed resources, i.e. without aliasing
+};
+const uint64_t kResourcePlacementAlignment = 64 * 1024; // D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT
+/**
+ * first and last pass index using each resource in a list.
+ **/
+StrHashMap<ResourceLifetime> AnalyzeResourceLifetime(const RenderPassList& render_pass_list);
+/**
+ * rtv and dsv resources written before read in every list using them are transient,
+ * others (cbv, read before written, persistent, used on compute or copy queues) keep their own allocations.
+ * a placement shares memory only with resources whose lifetimes never overlap in any list.
+ **/
+ResourceAliasingPlan* PlanResourceAliasing(const ResourceAliasingDesc& desc);
+void ReleaseResourceAliasingPlan(ResourceAliasingPlan*);
+/**
+ * returns nullptr if not aliased.
+ **/
+const AliasedResourcePlacement* FindAliasedResourcePlacement(const ResourceAliasingPlan& plan, const StrHash resource_id, const uint32_t local_index);
+uint64_t EstimateResourceSizeInBytes(const ResourceInfo& resource_info);
+void LogResourceAliasingPlan(const ResourceAliasingPlan& plan);
+}
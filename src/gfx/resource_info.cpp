@@ -0,0 +1,186 @@
+#include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/debug_assert.h"
+#include "boke/str_hash.h"
+#include "boke/util.h"
+#include "json.h"
+#include "dxgi_format.h"
+#include "resource_info.h"
+namespace {
+using namespace boke;
+const uint32_t kSinglePhysicalResource = ~0U;
+auto GetFlagHash(const char* const flag) {
+  // flag names are not registered to the str hash database.
+  return foonathan::string_id::detail::sid_hash(flag);
+}
+auto GetResourceFlags(const JsonValue& array) {
+  auto flag = kDefaultResourceFlags;
+  for (const auto& entity : array.GetArray()) {
+    flag = AddResourceFlag(flag, entity.GetString());
+  }
+  return flag;
+}
+void SucceedFrameBufferedBufferLocalIndicesImpl(StrHashMap<uint32_t>* current_write_index_list, const StrHash resource_id, const ResourceInfo* info) {
+  if (info->creation_type != ResourceCreationType::kCbv) { return; }
+  auto it = current_write_index_list->get(resource_id);
+  *it = *it + 1;
+  if (*it >= info->physical_resource_num) {
+    *it = 0;
+  }
+}
+} // namespace
+namespace boke {
+bool FindResourceCreationType(const char* const flag, ResourceCreationType* creation_type) {
+  switch (GetFlagHash(flag)) {
+    case "rtv"_id: { *creation_type = ResourceCreationType::kRtv; return true; }
+    case "dsv"_id: { *creation_type = ResourceCreationType::kDsv; return true; }
+    case "cbv"_id: { *creation_type = ResourceCreationType::kCbv; return true; }
+    case "uav"_id: { *creation_type = ResourceCreationType::kUav; return true; }
+    case "present"_id:
+    case "srv"_id: { *creation_type = ResourceCreationType::kNone; return true; }
+  }
+  return false;
+}
+ResourceCreationType GetResourceCreationType(const char* const flag) {
+  auto creation_type = ResourceCreationType::kNone;
+  if (FindResourceCreationType(flag, &creation_type)) {
+    return creation_type;
+  }
+  DEBUG_ASSERT(false, DebugAssert{});
+  return ResourceCreationType::kNone;
+}
+bool IsResourceFlagName(const char* const flag_name) {
+  switch (GetFlagHash(flag_name)) {
+    case "rtv"_id:
+    case "dsv"_id:
+    case "srv"_id:
+    case "cbv"_id:
+    case "uav"_id:
+    case "present"_id: {
+      return true;
+    }
+  }
+  return false;
+}
+D3D12_RESOURCE_FLAGS AddResourceFlag(const D3D12_RESOURCE_FLAGS current_flag, const char* const flag_name) {
+  // rtv and dsv on the same resource is reported by ValidateGfxConfig.
+  switch (GetFlagHash(flag_name)) {
+    case "rtv"_id: { return current_flag | D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET; }
+    case "dsv"_id: { return current_flag | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL; }
+    case "srv"_id: { return current_flag & ~D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE; }
+    case "uav"_id: { return current_flag | D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS; }
+  }
+  return current_flag;
+}
+void AdjustResourceSize(const StrHash resource_id, const StrHashMap<Size2d>& explicit_buffer_size, ResourceInfo* info) {
+  if (explicit_buffer_size.contains(resource_id)) {
+    info->size = explicit_buffer_size[resource_id];
+  }
+  if (info->creation_type == ResourceCreationType::kCbv) {
+    info->size.width = Align(info->size.width, 256);
+  }
+}
+bool IsBufferResource(const ResourceInfo& info) {
+  if (info.creation_type == ResourceCreationType::kCbv) { return true; }
+  return info.creation_type == ResourceCreationType::kUav && info.format == DXGI_FORMAT_UNKNOWN;
+}
+Size2d GetSize2d(const JsonValue& array) {
+  return Size2d {
+    .width = array[0].GetUint(),
+    .height = array[1].GetUint(),
+  };
+}
+StrHashMap<ResourceInfo> ParseResourceInfo(const JsonValue& resources, const StrHashMap<Size2d>& explicit_buffer_size) {
+  StrHashMap<ResourceInfo> resource_info(resources.Size());
+  for (const auto& resource : resources.GetArray()) {
+    const auto name = resource["name"].GetString();
+    const auto hash = GetStrHash(name);
+    auto& info = resource_info[hash];
+    info = {
+      .creation_type = GetResourceCreationType(resource["initial_flag"].GetString()),
+      .flags = GetResourceFlags(resource["flags"]),
+      .format = GetDxgiFormat(resource["format"].GetString()),
+      .size = explicit_buffer_size.contains(hash) ? Size2d{} : GetSize2d(resource["size"]),
+      .physical_resource_num = resource["physical_resource_num"].GetUint(),
+      .pingpong = resource["pingpong"].GetBool(),
+    };
+    AdjustResourceSize(hash, explicit_buffer_size, &info);
+  }
+  return resource_info;
+}
+StrHashMap<uint32_t> InitWriteIndexList(const StrHashMap<ResourceInfo>& resource_info) {
+  StrHashMap<uint32_t> current_write_index_list(resource_info.size());
+  resource_info.iterate<StrHashMap<uint32_t>>([](StrHashMap<uint32_t>* current_write_index_list, const StrHash resource_id, const ResourceInfo* resource_info) {
+    const auto index = resource_info->physical_resource_num > 1 ? 0U : kSinglePhysicalResource;
+    current_write_index_list->insert(resource_id, index);
+  }, &current_write_index_list);
+  return current_write_index_list;
+}
+uint32_t GetResourceLocalIndexRead(const StrHashMap<uint32_t>& current_write_index_list, const StrHash id) {
+  const auto index = current_write_index_list[id];
+  if (index == kSinglePhysicalResource) { return 0; }
+  // buggy if physical_resource_num > 2
+  return index == 0 ? 1 : 0;
+}
+uint32_t GetResourceLocalIndexWrite(const StrHashMap<uint32_t>& current_write_index_list, const StrHash id) {
+  const auto index = current_write_index_list[id];
+  if (index == kSinglePhysicalResource) { return 0; }
+  return index;
+}
+void SucceedFrameBufferedBufferLocalIndices(const StrHashMap<ResourceInfo>& resource_info, StrHashMap<uint32_t>& current_write_index_list) {
+  resource_info.iterate<StrHashMap<uint32_t>>(SucceedFrameBufferedBufferLocalIndicesImpl, &current_write_index_list);
+}
+} // namespace boke
+#include "doctest/doctest.h"
+TEST_CASE("resource info") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 16 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  const uint32_t primary_width = 1920;
+  const uint32_t primary_height = 1080;
+  auto resource_info = ParseResourceInfo(GetJson("tests/resources.json"), {});
+  CHECK_EQ(resource_info.size(), 7);
+  CHECK_EQ(resource_info["gbuffer0"_id].creation_type, ResourceCreationType::kRtv);
+  CHECK_EQ(resource_info["gbuffer0"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+  CHECK_EQ(resource_info["gbuffer0"_id].format, DXGI_FORMAT_R8G8B8A8_UNORM);
+  CHECK_EQ(resource_info["gbuffer0"_id].size.width, primary_width);
+  CHECK_EQ(resource_info["gbuffer0"_id].size.height, primary_height);
+  CHECK_EQ(resource_info["gbuffer0"_id].pingpong, false);
+  CHECK_EQ(resource_info["gbuffer1"_id].creation_type, ResourceCreationType::kRtv);
+  CHECK_EQ(resource_info["gbuffer1"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+  CHECK_EQ(resource_info["gbuffer1"_id].format, DXGI_FORMAT_R8G8B8A8_UNORM);
+  CHECK_EQ(resource_info["gbuffer1"_id].size.width, primary_width);
+  CHECK_EQ(resource_info["gbuffer1"_id].size.height, primary_height);
+  CHECK_EQ(resource_info["gbuffer1"_id].pingpong, false);
+  CHECK_EQ(resource_info["gbuffer2"_id].creation_type, ResourceCreationType::kRtv);
+  CHECK_EQ(resource_info["gbuffer2"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+  CHECK_EQ(resource_info["gbuffer2"_id].format, DXGI_FORMAT_R10G10B10A2_UNORM);
+  CHECK_EQ(resource_info["gbuffer2"_id].size.width, primary_width);
+  CHECK_EQ(resource_info["gbuffer2"_id].size.height, primary_height);
+  CHECK_EQ(resource_info["gbuffer2"_id].pingpong, false);
+  CHECK_EQ(resource_info["gbuffer3"_id].creation_type, ResourceCreationType::kRtv);
+  CHECK_EQ(resource_info["gbuffer3"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+  CHECK_EQ(resource_info["gbuffer3"_id].format, DXGI_FORMAT_R8G8B8A8_UNORM);
+  CHECK_EQ(resource_info["gbuffer3"_id].size.width, primary_width);
+  CHECK_EQ(resource_info["gbuffer3"_id].size.height, primary_height);
+  CHECK_EQ(resource_info["gbuffer3"_id].pingpong, false);
+  CHECK_EQ(resource_info["depth"_id].creation_type, ResourceCreationType::kDsv);
+  CHECK_EQ(resource_info["depth"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL | D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE);
+  CHECK_EQ(resource_info["depth"_id].format, DXGI_FORMAT_D24_UNORM_S8_UINT);
+  CHECK_EQ(resource_info["depth"_id].size.width, primary_width);
+  CHECK_EQ(resource_info["depth"_id].size.height, primary_height);
+  CHECK_EQ(resource_info["depth"_id].pingpong, false);
+  CHECK_EQ(resource_info["primary"_id].creation_type, ResourceCreationType::kRtv);
+  CHECK_EQ(resource_info["primary"_id].format, DXGI_FORMAT_R16G16B16A16_FLOAT);
+  CHECK_EQ(resource_info["primary"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+  CHECK_EQ(resource_info["primary"_id].size.width, primary_width);
+  CHECK_EQ(resource_info["primary"_id].size.height, primary_height);
+  CHECK_EQ(resource_info["primary"_id].pingpong, true);
+  CHECK_EQ(resource_info["swapchain"_id].creation_type, ResourceCreationType::kNone);
+  CHECK_EQ(resource_info["swapchain"_id].flags, D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE);
+  CHECK_EQ(resource_info["swapchain"_id].format, DXGI_FORMAT_R8G8B8A8_UNORM);
+  CHECK_EQ(resource_info["swapchain"_id].size.width, primary_width);
+  CHECK_EQ(resource_info["swapchain"_id].size.height, primary_height);
+  CHECK_EQ(resource_info["swapchain"_id].pingpong, false);
+}
@@ -0,0 +1,50 @@
+#pragma once
+namespace boke {
+struct Size2d {
+  uint32_t width{};
+  uint32_t height{};
+};
+enum class ResourceCreationType : uint8_t {
+  kNone,
+  kRtv,
+  kDsv,
+  kCbv,
+  kUav, // buffer if format is DXGI_FORMAT_UNKNOWN, texture otherwise.
+};
+struct ResourceInfo {
+  ResourceCreationType creation_type{};
+  D3D12_RESOURCE_FLAGS flags{};
+  DXGI_FORMAT format{};
+  Size2d size{};
+  uint32_t physical_resource_num{};
+  bool pingpong{false};
+  uint32_t mip_levels{1};
+  uint32_t array_size{1};
+};
+constexpr D3D12_RESOURCE_FLAGS kDefaultResourceFlags = D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+/**
+ * Find* return false for unknown names while Get* assert.
+ **/
+bool FindResourceCreationType(const char* const flag, ResourceCreationType* creation_type);
+ResourceCreationType GetResourceCreationType(const char* const flag);
+bool IsResourceFlagName(const char* const flag_name);
+/**
+ * returns current_flag updated with a single entry of a resource's "flags" list.
+ * start from kDefaultResourceFlags.
+ **/
+D3D12_RESOURCE_FLAGS AddResourceFlag(const D3D12_RESOURCE_FLAGS current_flag, const char* const flag_name);
+/**
+ * applies explicit_buffer_size and cbv alignment after parsing.
+ **/
+void AdjustResourceSize(const StrHash resource_id, const StrHashMap<Size2d>& explicit_buffer_size, ResourceInfo* info);
+/**
+ * cbv and formatless uav, size.width holds their size in bytes.
+ **/
+bool IsBufferResource(const ResourceInfo& info);
+Size2d GetSize2d(const JsonValue&);
+StrHashMap<ResourceInfo> ParseResourceInfo(const JsonValue& resources, const StrHashMap<Size2d>& explicit_buffer_size);
+StrHashMap<uint32_t> InitWriteIndexList(const StrHashMap<ResourceInfo>& resource_info);
+uint32_t GetResourceLocalIndexRead(const StrHashMap<uint32_t>& current_write_index_list, const StrHash id);
+uint32_t GetResourceLocalIndexWrite(const StrHashMap<uint32_t>& current_write_index_list, const StrHash id);
+void SucceedFrameBufferedBufferLocalIndices(const StrHashMap<ResourceInfo>& resource_info, StrHashMap<uint32_t>& current_write_index_list);
+}
@@ -0,0 +1,25 @@
+#include "boke/allocator.h"
+#include "boke/container.h"
+#include "boke/str_hash.h"
+#include "d3d12_util.h"
+#include "resource_set.h"
+namespace boke {
+ID3D12Resource* GetResource(const ResourceSet* resource_set, const StrHash id, const uint32_t index) {
+  return (*resource_set->resources)[(*resource_set->resource_index)[id] + index];
+}
+void SetResource(StrHash id, ID3D12Resource* resource, ResourceSet* resource_set) {
+  if (auto ptr = resource_set->resource_index->get(id); ptr != nullptr) {
+    (*resource_set->resources)[*ptr] = resource;
+    return;
+  }
+  (*resource_set->resource_index)[id] = resource_set->resource_index->size();
+  resource_set->resources->push_back(resource);
+}
+void AddResource(const StrHash id, ID3D12Resource** resource, const uint32_t resource_num, ResourceSet* resource_set) {
+  (*resource_set->resource_index)[id] = resource_set->resources->size();
+  for (uint32_t i = 0; i < resource_num; i++) {
+    resource_set->resources->push_back(resource[i]);
+    SetD3d12Name(resource[i], id, i);
+  }
+}
+} // namespace boke
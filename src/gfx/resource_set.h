@@ -0,0 +1,15 @@
+#pragma once
+namespace D3D12MA {
+class Allocation;
+}
+namespace boke {
+struct ResourceSet {
+  StrHashMap<uint32_t>* resource_index;
+  ResizableArray<D3D12MA::Allocation*>* allocations;
+  ResizableArray<ID3D12Resource*>* resources;
+  D3D12MA::Allocation* aliasing_heap{};
+  ResizableArray<ID3D12Resource*>* aliased_resources{};
+};
+void AddResource(const StrHash id, ID3D12Resource** resource, const uint32_t resource_num, ResourceSet* resource_set);
+ID3D12Resource* GetResource(const ResourceSet* resource_set, const StrHash id, const uint32_t index);
+}
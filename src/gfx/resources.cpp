@@ -7,18 +7,13 @@
 #include "boke/util.h"
 #include "core.h"
 #include "d3d12_util.h"
+#include "dxgi_format.h"
 #include "json.h"
 #include "render_pass_info.h"
 #include "resources.h"
-namespace boke {
-struct ResourceSet {
-  StrHashMap<uint32_t>* resource_index;
-  ResizableArray<D3D12MA::Allocation*>* allocations;
-  ResizableArray<ID3D12Resource*>* resources;
-};
-} // namespace boke
+#include "config_loader.h"
+#include "resource_aliasing.h"
 namespace {
-const uint32_t kSinglePhysicalResource = ~0U;
 using namespace boke;
 void* GpuMemoryAllocatorAllocate(size_t size, size_t alignment, void*) {
   return boke::Allocate(boke::GetUint32(size), boke::GetUint32(alignment));
@@ -84,10 +79,11 @@ auto CreateTexture2d(D3D12MA::Allocator* allocator,
   DEBUG_ASSERT(SUCCEEDED(hr), DebugAssert{});
   return allocation;
 }
-auto CreateConstantBuffer(D3D12MA::Allocator* allocator,
-                          const uint32_t width,
-                          const DXGI_FORMAT format,
-                          const D3D12_RESOURCE_FLAGS flags) {
+auto CreateBuffer(D3D12MA::Allocator* allocator,
+                  const uint32_t width,
+                  const DXGI_FORMAT format,
+                  const D3D12_RESOURCE_FLAGS flags,
+                  const D3D12_HEAP_TYPE heap_type) {
   using namespace D3D12MA;
   D3D12_RESOURCE_DESC1 resource_desc{
     .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
@@ -105,7 +101,7 @@ auto CreateConstantBuffer(D3D12MA::Allocator* allocator,
     .Flags = flags,
   };
   D3D12MA::ALLOCATION_DESC allocation_desc{
-    .HeapType = D3D12_HEAP_TYPE_UPLOAD,
+    .HeapType = heap_type,
   };
   D3D12MA::Allocation* allocation{};
   const auto hr = allocator->CreateResource3(
@@ -119,21 +115,21 @@ auto CreateConstantBuffer(D3D12MA::Allocator* allocator,
   DEBUG_ASSERT(SUCCEEDED(hr), DebugAssert{});
   return allocation;
 }
-auto GetTexture2dDesc(const Size2d& size, const DXGI_FORMAT format, const D3D12_RESOURCE_FLAGS flags) {
+auto GetTexture2dDesc(const ResourceInfo& resource_info, const DXGI_FORMAT format) {
   return D3D12_RESOURCE_DESC1{
     .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
     .Alignment = 0,
-    .Width = size.width,
-    .Height = size.height,
-    .DepthOrArraySize = 1,
-    .MipLevels = 1,
+    .Width = resource_info.size.width,
+    .Height = resource_info.size.height,
+    .DepthOrArraySize = static_cast<uint16_t>(resource_info.array_size),
+    .MipLevels = static_cast<uint16_t>(resource_info.mip_levels),
     .Format = format,
     .SampleDesc = {
       .Count = 1,
       .Quality = 0,
     },
     .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
-    .Flags = flags,
+    .Flags = resource_info.flags,
   };
 }
 auto GetClearValueRtv(const DXGI_FORMAT format) {
@@ -142,14 +138,6 @@ auto GetClearValueRtv(const DXGI_FORMAT format) {
     .Color = {},
   };
 }
-auto GetTypelessFormat(const DXGI_FORMAT format) {
-  switch (format) {
-    case DXGI_FORMAT_D24_UNORM_S8_UINT:
-      return DXGI_FORMAT_R24G8_TYPELESS;
-    default:
-      return format;
-  }
-}
 auto GetClearValueDsv(const DXGI_FORMAT format) {
   return D3D12_CLEAR_VALUE{
     .Format = format,
@@ -159,18 +147,72 @@ auto GetClearValueDsv(const DXGI_FORMAT format) {
     },
   };
 }
+auto AllocateAliasingHeap(D3D12MA::Allocator* allocator, const uint64_t size_in_bytes) {
+  using namespace D3D12MA;
+  // rtv and dsv only, which keeps the heap valid on resource heap tier 1.
+  D3D12MA::ALLOCATION_DESC allocation_desc{
+    .HeapType = D3D12_HEAP_TYPE_DEFAULT,
+    .ExtraHeapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+  };
+  D3D12_RESOURCE_ALLOCATION_INFO allocation_info{
+    .SizeInBytes = size_in_bytes,
+    .Alignment = kResourcePlacementAlignment,
+  };
+  D3D12MA::Allocation* allocation{};
+  const auto hr = allocator->AllocateMemory(&allocation_desc, &allocation_info, &allocation);
+  DEBUG_ASSERT(SUCCEEDED(hr), DebugAssert{});
+  return allocation;
+}
+auto CreateAliasedTexture2d(D3D12MA::Allocator* allocator,
+                            D3D12MA::Allocation* heap,
+                            const uint64_t heap_offset,
+                            const D3D12_RESOURCE_DESC1& resource_desc,
+                            const D3D12_CLEAR_VALUE* clear_value) {
+  ID3D12Resource* resource{};
+  const auto hr = allocator->CreateAliasingResource2(
+      heap,
+      heap_offset,
+      &resource_desc,
+      D3D12_BARRIER_LAYOUT_UNDEFINED, // first barrier of each frame discards contents.
+      clear_value,
+      0, nullptr, // castable_format_num, castable_formats,
+      IID_PPV_ARGS(&resource));
+  DEBUG_ASSERT(SUCCEEDED(hr), DebugAssert{});
+  return resource;
+}
 struct ResourceSetCreationAsseet {
   D3D12MA::Allocator* allocator{};
   StrHashMap<uint32_t>* resource_index;
   ResizableArray<D3D12MA::Allocation*>* allocations;
   ResizableArray<ID3D12Resource*>* resources;
+  const ResourceAliasingPlan* aliasing_plan{};
+  D3D12MA::Allocation* aliasing_heap{};
+  ResizableArray<ID3D12Resource*>* aliased_resources{};
 };
+auto CreateAliasedResource(ResourceSetCreationAsseet* asset, const StrHash resource_id, const ResourceInfo* resource_info) {
+  if (asset->aliasing_plan == nullptr) { return false; }
+  if (FindAliasedResourcePlacement(*asset->aliasing_plan, resource_id, 0) == nullptr) { return false; }
+  const auto is_dsv = resource_info->creation_type == ResourceCreationType::kDsv;
+  const auto desc = GetTexture2dDesc(*resource_info, is_dsv ? GetTypelessFormat(resource_info->format) : resource_info->format);
+  const auto clear_value = is_dsv ? GetClearValueDsv(resource_info->format) : GetClearValueRtv(resource_info->format);
+  (*asset->resource_index)[resource_id] = asset->resources->size();
+  for (uint32_t i = 0; i < resource_info->physical_resource_num; i++) {
+    const auto placement = FindAliasedResourcePlacement(*asset->aliasing_plan, resource_id, i);
+    DEBUG_ASSERT(placement != nullptr, DebugAssert{});
+    auto resource = CreateAliasedTexture2d(asset->allocator, asset->aliasing_heap, placement->heap_offset, desc, &clear_value);
+    asset->resources->push_back(resource);
+    asset->aliased_resources->push_back(resource);
+    SetD3d12Name(resource, resource_id, i);
+  }
+  return true;
+}
 void CreateResourceImpl(ResourceSetCreationAsseet* asset, const StrHash resource_id, const ResourceInfo* resource_info) {
   if (resource_info->physical_resource_num == 0) { return; }
+  if (CreateAliasedResource(asset, resource_id, resource_info)) { return; }
   D3D12MA::Allocation* allocation[2];
   switch (resource_info->creation_type) {
     case ResourceCreationType::kRtv: {
-      auto desc = GetTexture2dDesc(resource_info->size, resource_info->format, resource_info->flags);
+      auto desc = GetTexture2dDesc(*resource_info, resource_info->format);
       auto clear_value = GetClearValueRtv(resource_info->format);
       for (uint32_t i = 0; i < resource_info->physical_resource_num; i++) {
         allocation[i] = CreateTexture2d(asset->allocator, desc, &clear_value, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
@@ -179,14 +221,28 @@ void CreateResourceImpl(ResourceSetCreationAsseet* asset, const StrHash resource
     }
     case ResourceCreationType::kDsv: {
       DEBUG_ASSERT(resource_info->physical_resource_num == 1, DebugAssert{});
-      auto desc = GetTexture2dDesc(resource_info->size, GetTypelessFormat(resource_info->format), resource_info->flags);
+      auto desc = GetTexture2dDesc(*resource_info, GetTypelessFormat(resource_info->format));
       auto clear_value = GetClearValueDsv(resource_info->format);
       allocation[0] = CreateTexture2d(asset->allocator, desc, &clear_value, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE);
       break;
     }
     case ResourceCreationType::kCbv: {
       for (uint32_t i = 0; i < resource_info->physical_resource_num; i++) {
-        allocation[i] = CreateConstantBuffer(asset->allocator, resource_info->size.width, resource_info->format, resource_info->flags);
+        allocation[i] = CreateBuffer(asset->allocator, resource_info->size.width, resource_info->format, resource_info->flags, D3D12_HEAP_TYPE_UPLOAD);
+      }
+      break;
+    }
+    case ResourceCreationType::kUav: {
+      if (IsBufferResource(*resource_info)) {
+        // raw buffer of size.width bytes, buffers cannot deny shader resource views.
+        for (uint32_t i = 0; i < resource_info->physical_resource_num; i++) {
+          allocation[i] = CreateBuffer(asset->allocator, resource_info->size.width, DXGI_FORMAT_UNKNOWN, resource_info->flags & ~D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE, D3D12_HEAP_TYPE_DEFAULT);
+        }
+        break;
+      }
+      auto desc = GetTexture2dDesc(*resource_info, resource_info->format);
+      for (uint32_t i = 0; i < resource_info->physical_resource_num; i++) {
+        allocation[i] = CreateTexture2d(asset->allocator, desc, nullptr, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS);
       }
       break;
     }
@@ -198,52 +254,13 @@ void CreateResourceImpl(ResourceSetCreationAsseet* asset, const StrHash resource
       return;
     }
   }
-  (*asset->resource_index)[resource_id] = asset->allocations->size();
+  (*asset->resource_index)[resource_id] = asset->resources->size();
   for (uint32_t i = 0; i < resource_info->physical_resource_num; i++) {
     asset->allocations->push_back(allocation[i]);
     asset->resources->push_back(allocation[i]->GetResource());
     SetD3d12Name(allocation[i]->GetResource(), resource_id, i);
   }
 }
-auto GetCreationType(const char* const flag) {
-  if (strcmp(flag, "rtv") == 0) {
-    return ResourceCreationType::kRtv;
-  }
-  if (strcmp(flag, "dsv") == 0) {
-    return ResourceCreationType::kDsv;
-  }
-  if (strcmp(flag, "cbv") == 0) {
-    return ResourceCreationType::kCbv;
-  }
-  if (strcmp(flag, "present") == 0) {
-    return ResourceCreationType::kNone;
-  }
-  if (strcmp(flag, "srv") == 0) {
-    return ResourceCreationType::kNone;
-  }
-  DEBUG_ASSERT(false, DebugAssert{});
-  return ResourceCreationType::kNone;
-}
-auto GetResourceFlags(const rapidjson::Value& array) {
-  D3D12_RESOURCE_FLAGS flag = D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
-  for (const auto& entity : array.GetArray()) {
-    if ((flag & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) == 0 && strcmp(entity.GetString(), "rtv") == 0) {
-      DEBUG_ASSERT((flag & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) == 0, DebugAssert{});
-      flag |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
-      continue;
-    }
-    if ((flag & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) == 0 && strcmp(entity.GetString(), "dsv") == 0) {
-      DEBUG_ASSERT((flag & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) == 0, DebugAssert{});
-      flag |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
-      continue;
-    }
-    if ((flag & D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE) != 0 && strcmp(entity.GetString(), "srv") == 0) {
-      flag &= ~D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
-      continue;
-    }
-  }
-  return flag;
-}
 auto GetTotalPhysicalResourceNum(const StrHashMap<ResourceInfo>& resource_info) {
   uint32_t sum = 0;
   resource_info.iterate<uint32_t>([](uint32_t* sum, const StrHash, const ResourceInfo* info) {
@@ -251,93 +268,20 @@ auto GetTotalPhysicalResourceNum(const StrHashMap<ResourceInfo>& resource_info)
   }, &sum);
   return sum;
 }
-void SucceedFrameBufferedBufferLocalIndicesImpl(StrHashMap<uint32_t>* current_write_index_list, const StrHash resource_id, const ResourceInfo* info) {
-  if (info->creation_type != ResourceCreationType::kCbv) { return; }
-  auto it = current_write_index_list->get(resource_id);
-  *it = *it + 1;
-  if (*it >= info->physical_resource_num) {
-    *it = 0;
-  }
+struct ResourceAllocationSizeAsset {
+  D3d12Device* device{};
+  StrHashMap<uint64_t>* size_list{};
+};
+void GetResourceAllocationSizeImpl(ResourceAllocationSizeAsset* asset, const StrHash resource_id, const ResourceInfo* resource_info) {
+  if (resource_info->physical_resource_num == 0) { return; }
+  if (resource_info->creation_type != ResourceCreationType::kRtv && resource_info->creation_type != ResourceCreationType::kDsv) { return; }
+  const auto format = (resource_info->creation_type == ResourceCreationType::kDsv) ? GetTypelessFormat(resource_info->format) : resource_info->format;
+  const auto desc = GetTexture2dDesc(*resource_info, format);
+  const auto allocation_info = asset->device->GetResourceAllocationInfo2(0, 1, &desc, nullptr);
+  asset->size_list->insert(resource_id, allocation_info.SizeInBytes);
 }
 } // namespace
 namespace boke {
-DXGI_FORMAT GetDxgiFormat(const char* format) {
-  if (strcmp(format, "R8G8B8A8_UNORM") == 0) {
-    return DXGI_FORMAT_R8G8B8A8_UNORM;
-  }
-  if (strcmp(format, "R8G8B8A8_UNORM_SRGB") == 0) {
-    return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-  }
-  if (strcmp(format, "B8G8R8A8_UNORM") == 0) {
-    return DXGI_FORMAT_B8G8R8A8_UNORM;
-  }
-  if (strcmp(format, "B8G8R8A8_UNORM_SRGB") == 0) {
-    return DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
-  }
-  if (strcmp(format, "R16G16B16A16_FLOAT") == 0) {
-    return DXGI_FORMAT_R16G16B16A16_FLOAT;
-  }
-  if (strcmp(format, "R10G10B10A2_UNORM") == 0) {
-    return DXGI_FORMAT_R10G10B10A2_UNORM;
-  }
-  if (strcmp(format, "R10G10B10_XR_BIAS_A2_UNORM") == 0) {
-    return DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM;
-  }
-  if (strcmp(format, "D24_UNORM_S8_UINT") == 0) {
-    return DXGI_FORMAT_D24_UNORM_S8_UINT;
-  }
-  if (strcmp(format, "R24G8_TYPELESS") == 0) {
-    return DXGI_FORMAT_R24G8_TYPELESS;
-  }
-  if (strcmp(format, "R24_UNORM_X8_TYPELESS") == 0) {
-    return DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
-  }
-  if (strcmp(format, "X24_TYPELESS_G8_UINT") == 0) {
-    return DXGI_FORMAT_X24_TYPELESS_G8_UINT;
-  }
-  if (strcmp(format, "UNKNOWN") == 0) {
-    return DXGI_FORMAT_UNKNOWN;
-  }
-  DEBUG_ASSERT(false, DebugAssert{});
-  return DXGI_FORMAT_R8G8B8A8_UNORM;
-}
-Size2d GetSize2d(const rapidjson::Value& array) {
-  return Size2d {
-    .width = array[0].GetUint(),
-    .height = array[1].GetUint(),
-  };
-}
-StrHashMap<ResourceInfo> ParseResourceInfo(const rapidjson::Value& resources, const StrHashMap<Size2d>& explicit_buffer_size) {
-  StrHashMap<ResourceInfo> resource_info(resources.Size());
-  for (const auto& resource : resources.GetArray()) {
-    const auto name = resource["name"].GetString();
-    const auto hash = GetStrHash(name);
-    auto& info = resource_info[hash];
-    info = {
-      .creation_type = GetCreationType(resource["initial_flag"].GetString()),
-      .flags = GetResourceFlags(resource["flags"]),
-      .format = GetDxgiFormat(resource["format"].GetString()),
-      .size = explicit_buffer_size.contains(hash) ? explicit_buffer_size[hash] : GetSize2d(resource["size"]),
-      .physical_resource_num = resource["physical_resource_num"].GetUint(),
-      .pingpong = resource["pingpong"].GetBool(),
-    };
-    if (info.creation_type == ResourceCreationType::kCbv) {
-      info.size.width = Align(info.size.width, 256);
-    }
-  }
-  return resource_info;
-}
-ID3D12Resource* GetResource(const ResourceSet* resource_set, const StrHash id, const uint32_t index) {
-  return (*resource_set->resources)[(*resource_set->resource_index)[id] + index];
-}
-void SetResource(StrHash id, ID3D12Resource* resource, ResourceSet* resource_set) {
-  if (auto ptr = resource_set->resource_index->get(id); ptr != nullptr) {
-    (*resource_set->resources)[*ptr] = resource;
-    return;
-  }
-  (*resource_set->resource_index)[id] = resource_set->resource_index->size();
-  resource_set->resources->push_back(resource);
-}
 D3D12MA::Allocator* CreateGpuMemoryAllocator(DxgiAdapter* adapter, D3d12Device* device) {
   using namespace D3D12MA;
   ALLOCATION_CALLBACKS allocation_callbacks{
@@ -361,21 +305,39 @@ void ReleaseGpuMemoryAllocator(D3D12MA::Allocator* allocator) {
   allocator->Release();
 }
 ResourceSet* CreateResources(const StrHashMap<ResourceInfo>& resource_info, D3D12MA::Allocator* allocator) {
+  return CreateResources(resource_info, nullptr, allocator);
+}
+ResourceSet* CreateResources(const StrHashMap<ResourceInfo>& resource_info, const ResourceAliasingPlan* aliasing_plan, D3D12MA::Allocator* allocator) {
   auto resource_set = New<ResourceSet>();
   const uint32_t physical_resource_num = GetTotalPhysicalResourceNum(resource_info);
+  const uint32_t aliased_resource_num = (aliasing_plan != nullptr) ? aliasing_plan->placement_num : 0;
   resource_set->resource_index = New<StrHashMap<uint32_t>>(resource_info.size());
   resource_set->allocations = New<ResizableArray<D3D12MA::Allocation*>>(physical_resource_num);
   resource_set->resources = New<ResizableArray<ID3D12Resource*>>(physical_resource_num);
+  resource_set->aliased_resources = New<ResizableArray<ID3D12Resource*>>(aliased_resource_num);
+  if (aliased_resource_num > 0) {
+    resource_set->aliasing_heap = AllocateAliasingHeap(allocator, aliasing_plan->heap_size_in_bytes);
+  }
   ResourceSetCreationAsseet asset{
     .allocator = allocator,
     .resource_index = resource_set->resource_index,
     .allocations = resource_set->allocations,
     .resources = resource_set->resources,
+    .aliasing_plan = aliasing_plan,
+    .aliasing_heap = resource_set->aliasing_heap,
+    .aliased_resources = resource_set->aliased_resources,
   };
   resource_info.iterate<ResourceSetCreationAsseet>(CreateResourceImpl, &asset);
   return resource_set;
 };
 void ReleaseResources(ResourceSet* resource_set) {
+  // aliased resources are created without allocations and must be released before the heap.
+  for (auto& resource : (*resource_set->aliased_resources)) {
+    resource->Release();
+  }
+  if (resource_set->aliasing_heap != nullptr) {
+    resource_set->aliasing_heap->Release();
+  }
   // allocation->GetResource() does not increment ref count.
   for (auto& allocation : (*resource_set->allocations)) {
     allocation->Release();
@@ -383,38 +345,20 @@ void ReleaseResources(ResourceSet* resource_set) {
   resource_set->resource_index->~StrHashMap<uint32_t>();
   resource_set->allocations->~ResizableArray<D3D12MA::Allocation*>();
   resource_set->resources->~ResizableArray<ID3D12Resource*>();
+  resource_set->aliased_resources->~ResizableArray<ID3D12Resource*>();
   Deallocate(resource_set->resource_index);
   Deallocate(resource_set->allocations);
   Deallocate(resource_set->resources);
+  Deallocate(resource_set->aliased_resources);
 }
-StrHashMap<uint32_t> InitWriteIndexList(const StrHashMap<ResourceInfo>& resource_info) {
-  StrHashMap<uint32_t> current_write_index_list(resource_info.size());
-  resource_info.iterate<StrHashMap<uint32_t>>([](StrHashMap<uint32_t>* current_write_index_list, const StrHash resource_id, const ResourceInfo* resource_info) {
-    const auto index = resource_info->physical_resource_num > 1 ? 0U : kSinglePhysicalResource;
-    current_write_index_list->insert(resource_id, index);
-  }, &current_write_index_list);
-  return current_write_index_list;
-}
-void AddResource(const StrHash id, ID3D12Resource** resource, const uint32_t resource_num, ResourceSet* resource_set) {
-  (*resource_set->resource_index)[id] = resource_set->resources->size();
-  for (uint32_t i = 0; i < resource_num; i++) {
-    resource_set->resources->push_back(resource[i]);
-    SetD3d12Name(resource[i], id, i);
-  }
-}
-uint32_t GetResourceLocalIndexRead(const StrHashMap<uint32_t>& current_write_index_list, const StrHash id) {
-  const auto index = current_write_index_list[id];
-  if (index == kSinglePhysicalResource) { return 0; }
-  // buggy if physical_resource_num > 2
-  return index == 0 ? 1 : 0;
-}
-uint32_t GetResourceLocalIndexWrite(const StrHashMap<uint32_t>& current_write_index_list, const StrHash id) {
-  const auto index = current_write_index_list[id];
-  if (index == kSinglePhysicalResource) { return 0; }
-  return index;
-}
-void SucceedFrameBufferedBufferLocalIndices(const StrHashMap<ResourceInfo>& resource_info, StrHashMap<uint32_t>& current_write_index_list) {
-  resource_info.iterate<StrHashMap<uint32_t>>(SucceedFrameBufferedBufferLocalIndicesImpl, &current_write_index_list);
+StrHashMap<uint64_t> GetResourceAllocationSizeList(const StrHashMap<ResourceInfo>& resource_info, D3d12Device* device) {
+  StrHashMap<uint64_t> size_list(resource_info.size());
+  ResourceAllocationSizeAsset asset{
+    .device = device,
+    .size_list = &size_list,
+  };
+  resource_info.iterate<ResourceAllocationSizeAsset>(GetResourceAllocationSizeImpl, &asset);
+  return size_list;
 }
 void* Map(ID3D12Resource* resource) {
   D3D12_RANGE range{.Begin = 0, .End = 0,};
@@ -495,49 +439,6 @@ TEST_CASE("resources") {
   const uint32_t primary_width = 1920;
   const uint32_t primary_height = 1080;
   auto resource_info = ParseResourceInfo(GetJson("tests/resources.json"), {});
-  CHECK_EQ(resource_info.size(), 7);
-  CHECK_EQ(resource_info["gbuffer0"_id].creation_type, ResourceCreationType::kRtv);
-  CHECK_EQ(resource_info["gbuffer0"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
-  CHECK_EQ(resource_info["gbuffer0"_id].format, DXGI_FORMAT_R8G8B8A8_UNORM);
-  CHECK_EQ(resource_info["gbuffer0"_id].size.width, primary_width);
-  CHECK_EQ(resource_info["gbuffer0"_id].size.height, primary_height);
-  CHECK_EQ(resource_info["gbuffer0"_id].pingpong, false);
-  CHECK_EQ(resource_info["gbuffer1"_id].creation_type, ResourceCreationType::kRtv);
-  CHECK_EQ(resource_info["gbuffer1"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
-  CHECK_EQ(resource_info["gbuffer1"_id].format, DXGI_FORMAT_R8G8B8A8_UNORM);
-  CHECK_EQ(resource_info["gbuffer1"_id].size.width, primary_width);
-  CHECK_EQ(resource_info["gbuffer1"_id].size.height, primary_height);
-  CHECK_EQ(resource_info["gbuffer1"_id].pingpong, false);
-  CHECK_EQ(resource_info["gbuffer2"_id].creation_type, ResourceCreationType::kRtv);
-  CHECK_EQ(resource_info["gbuffer2"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
-  CHECK_EQ(resource_info["gbuffer2"_id].format, DXGI_FORMAT_R10G10B10A2_UNORM);
-  CHECK_EQ(resource_info["gbuffer2"_id].size.width, primary_width);
-  CHECK_EQ(resource_info["gbuffer2"_id].size.height, primary_height);
-  CHECK_EQ(resource_info["gbuffer2"_id].pingpong, false);
-  CHECK_EQ(resource_info["gbuffer3"_id].creation_type, ResourceCreationType::kRtv);
-  CHECK_EQ(resource_info["gbuffer3"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
-  CHECK_EQ(resource_info["gbuffer3"_id].format, DXGI_FORMAT_R8G8B8A8_UNORM);
-  CHECK_EQ(resource_info["gbuffer3"_id].size.width, primary_width);
-  CHECK_EQ(resource_info["gbuffer3"_id].size.height, primary_height);
-  CHECK_EQ(resource_info["gbuffer3"_id].pingpong, false);
-  CHECK_EQ(resource_info["depth"_id].creation_type, ResourceCreationType::kDsv);
-  CHECK_EQ(resource_info["depth"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL | D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE);
-  CHECK_EQ(resource_info["depth"_id].format, DXGI_FORMAT_D24_UNORM_S8_UINT);
-  CHECK_EQ(resource_info["depth"_id].size.width, primary_width);
-  CHECK_EQ(resource_info["depth"_id].size.height, primary_height);
-  CHECK_EQ(resource_info["depth"_id].pingpong, false);
-  CHECK_EQ(resource_info["primary"_id].creation_type, ResourceCreationType::kRtv);
-  CHECK_EQ(resource_info["primary"_id].format, DXGI_FORMAT_R16G16B16A16_FLOAT);
-  CHECK_EQ(resource_info["primary"_id].flags, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
-  CHECK_EQ(resource_info["primary"_id].size.width, primary_width);
-  CHECK_EQ(resource_info["primary"_id].size.height, primary_height);
-  CHECK_EQ(resource_info["primary"_id].pingpong, true);
-  CHECK_EQ(resource_info["swapchain"_id].creation_type, ResourceCreationType::kNone);
-  CHECK_EQ(resource_info["swapchain"_id].flags, D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE);
-  CHECK_EQ(resource_info["swapchain"_id].format, DXGI_FORMAT_R8G8B8A8_UNORM);
-  CHECK_EQ(resource_info["swapchain"_id].size.width, primary_width);
-  CHECK_EQ(resource_info["swapchain"_id].size.height, primary_height);
-  CHECK_EQ(resource_info["swapchain"_id].pingpong, false);
   // gpu resources
   auto gpu_memory_allocator = CreateGpuMemoryAllocator(dxgi.adapter, device);
   auto resource_set = CreateResources(resource_info, gpu_memory_allocator);
@@ -639,3 +540,90 @@ TEST_CASE("resources") {
   ReleaseGfxLibraries(gfx_libraries);
   delete[] main_buffer;
 }
+TEST_CASE("resources aliased") {
+  using namespace boke;
+  StrHash gbuffers[] = {"gbuffer0"_id, "gbuffer1"_id, "gbuffer2"_id, "gbuffer3"_id,};
+  StrHash primary[] = {"primary"_id,};
+  StrHash swapchain[] = {"swapchain"_id,};
+  RenderPassInfo render_pass_info[] = {
+    {
+      // gbuffer
+      .queue = "direct"_id,
+      .rtv = gbuffers,
+      .rtv_num = 4,
+      .dsv = "depth"_id,
+    },
+    {
+      // lighting
+      .queue = "direct"_id,
+      .srv = gbuffers,
+      .srv_num = 4,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+    {
+      // tonemap
+      .queue = "direct"_id,
+      .srv = primary,
+      .srv_num = 1,
+      .rtv = primary,
+      .rtv_num = 1,
+    },
+    {
+      // oetf
+      .queue = "direct"_id,
+      .srv = primary,
+      .srv_num = 1,
+      .rtv = swapchain,
+      .rtv_num = 1,
+    },
+  };
+  RenderPassList render_pass_list{
+    .render_pass_len = 4,
+    .render_pass_info = render_pass_info,
+  };
+  // allocator
+  const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
+  auto main_buffer = new std::byte[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  // core units
+  auto gfx_libraries = LoadGfxLibraries();
+  auto dxgi = InitDxgi(gfx_libraries.dxgi_library, AdapterType::kHighPerformance);
+  auto device = CreateDevice(gfx_libraries.d3d12_library, dxgi.adapter);
+  // plan with sizes from device
+  auto resource_info = ParseResourceInfo(GetJson("tests/resources.json"), {});
+  auto resource_size_list = GetResourceAllocationSizeList(resource_info, device);
+  CHECK_EQ(resource_size_list.size(), 6);
+  auto aliasing_plan = PlanResourceAliasing({
+      .render_pass_list_num = 1,
+      .render_pass_list = &render_pass_list,
+      .resource_info = &resource_info,
+      .resource_size_in_bytes = &resource_size_list,
+    });
+  CHECK_EQ(aliasing_plan->placement_num, 7);
+  CHECK_LT(aliasing_plan->heap_size_in_bytes, aliasing_plan->unaliased_size_in_bytes);
+  // gpu resources
+  auto gpu_memory_allocator = CreateGpuMemoryAllocator(dxgi.adapter, device);
+  auto resource_set = CreateResources(resource_info, aliasing_plan, gpu_memory_allocator);
+  CHECK_NE(resource_set->aliasing_heap, nullptr);
+  CHECK_EQ(resource_set->aliased_resources->size(), 7);
+  CHECK_EQ(resource_set->allocations->size(), 0);
+  CHECK_EQ(resource_set->resources->size(), 7);
+  CHECK_EQ(resource_set->resource_index->size(), 6);
+  auto desc = GetResource(resource_set, "depth"_id, 0)->GetDesc();
+  CHECK_EQ(desc.Format, DXGI_FORMAT_R24G8_TYPELESS);
+  CHECK_EQ(desc.Flags, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL | D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE);
+  desc = GetResource(resource_set, "primary"_id, 1)->GetDesc();
+  CHECK_EQ(desc.Format, DXGI_FORMAT_R16G16B16A16_FLOAT);
+  CHECK_NE(GetResource(resource_set, "primary"_id, 0), GetResource(resource_set, "primary"_id, 1));
+  // terminate
+  ReleaseResources(resource_set);
+  gpu_memory_allocator->Release();
+  ReleaseResourceAliasingPlan(aliasing_plan);
+  resource_size_list.~StrHashMap<uint64_t>();
+  resource_info.~StrHashMap<ResourceInfo>();
+  device->Release();
+  TermDxgi(dxgi);
+  ReleaseGfxLibraries(gfx_libraries);
+  delete[] main_buffer;
+}
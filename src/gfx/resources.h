@@ -1,43 +1,24 @@
 #pragma once
 #include "d3d12_name_alias.h"
+#include "resource_info.h"
+#include "resource_set.h"
 namespace D3D12MA {
 class Allocator;
-class Allocation;
 }
 namespace boke {
-struct RenderPassInfo;
-struct Size2d {
-  uint32_t width{};
-  uint32_t height{};
-};
-enum class ResourceCreationType : uint8_t {
-  kNone,
-  kRtv,
-  kDsv,
-  kCbv,
-};
-struct ResourceInfo {
-  ResourceCreationType creation_type{};
-  D3D12_RESOURCE_FLAGS flags{};
-  DXGI_FORMAT format{};
-  Size2d size{};
-  uint32_t physical_resource_num{};
-  bool pingpong{false};
-};
-struct ResourceSet;
-DXGI_FORMAT GetDxgiFormat(const char* format);
-Size2d GetSize2d(const rapidjson::Value&);
-StrHashMap<ResourceInfo> ParseResourceInfo(const rapidjson::Value& resources, const StrHashMap<Size2d>& explicit_buffer_size);
-StrHashMap<uint32_t> InitWriteIndexList(const StrHashMap<ResourceInfo>& resource_info);
+struct ResourceAliasingPlan;
 D3D12MA::Allocator* CreateGpuMemoryAllocator(DxgiAdapter* adapter, D3d12Device* device);
 void ReleaseGpuMemoryAllocator(D3D12MA::Allocator* allocator);
 ResourceSet* CreateResources(const StrHashMap<ResourceInfo>& resource_info, D3D12MA::Allocator* allocator);
+/**
+ * resources in aliasing_plan are placed in a single shared heap, others get committed allocations.
+ **/
+ResourceSet* CreateResources(const StrHashMap<ResourceInfo>& resource_info, const ResourceAliasingPlan* aliasing_plan, D3D12MA::Allocator* allocator);
 void ReleaseResources(ResourceSet*);
-void AddResource(const StrHash id, ID3D12Resource** resource, const uint32_t resource_num, ResourceSet* resource_set);
-uint32_t GetResourceLocalIndexRead(const StrHashMap<uint32_t>& current_write_index_list, const StrHash id);
-uint32_t GetResourceLocalIndexWrite(const StrHashMap<uint32_t>& current_write_index_list, const StrHash id);
-void SucceedFrameBufferedBufferLocalIndices(const StrHashMap<ResourceInfo>& resource_info, StrHashMap<uint32_t>& current_write_index_list);
-ID3D12Resource* GetResource(const ResourceSet* resource_set, const StrHash id, const uint32_t index);
+/**
+ * rtv and dsv allocation sizes for PlanResourceAliasing.
+ **/
+StrHashMap<uint64_t> GetResourceAllocationSizeList(const StrHashMap<ResourceInfo>& resource_info, D3d12Device* device);
 void* Map(ID3D12Resource*);
 template <typename T>
 T* Map(ID3D12Resource* resource) { return static_cast<T*>(Map(resource)); }
@@ -0,0 +1,479 @@
+#include "boke/job_system.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include "boke/allocator.h"
+#include "boke/debug_assert.h"
+namespace {
+const uint32_t kJobPoolSize = 512; // jobs in flight per thread, power of two
+const uint32_t kJobDequeSize = kJobPoolSize;
+const uint32_t kStealAttemptNumBeforeSleep = 64;
+} // namespace
+namespace boke {
+struct alignas(64) Job {
+  JobFunc func{};
+  void* user_data{};
+  Job* parent{};
+  std::atomic<int32_t> unfinished_job_num{};
+  bool low_priority{};
+  // ParallelFor range
+  uint32_t begin{};
+  uint32_t end{};
+};
+} // namespace boke
+namespace {
+using namespace boke;
+/**
+ * chase-lev deque, the owner pushes and pops at bottom, others steal from top.
+ **/
+struct JobDeque {
+  std::atomic<int64_t> top{};
+  std::atomic<int64_t> bottom{};
+  std::atomic<Job*>* job_list{};
+};
+struct JobWorker {
+  JobSystem* job_system{};
+  uint32_t worker_index{};
+  JobDeque deque{};
+  JobDeque low_priority_deque{};
+  Job* job_pool{};
+  uint32_t allocated_job_num{};
+  uint32_t random_state{};
+};
+thread_local JobWorker* current_worker = nullptr;
+} // namespace
+namespace boke {
+struct JobSystem {
+  uint32_t worker_num{}; // including the creating thread
+  JobWorker* worker_list{};
+  std::thread* worker_thread_list{};
+  std::atomic<bool> terminate{};
+  // sleeping workers wake up when job_epoch changes.
+  std::atomic<uint32_t> job_epoch{};
+  std::atomic<uint32_t> sleeping_worker_num{};
+  std::mutex mutex;
+  std::condition_variable wake_cv;
+};
+} // namespace boke
+namespace {
+void PushJob(JobDeque* deque, Job* job) {
+  const auto bottom = deque->bottom.load(std::memory_order_relaxed);
+  const auto top = deque->top.load(std::memory_order_acquire);
+  // jobs in deques are in flight in the pool of their owner, AllocateJob keeps them within a deque.
+  DEBUG_ASSERT(bottom - top < kJobDequeSize, DebugAssert{});
+  if (bottom - top >= kJobDequeSize) {
+    spdlog::critical("job deque overflow. {}", bottom - top);
+    exit(1);
+  }
+  deque->job_list[bottom & (kJobDequeSize - 1)].store(job, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+Job* PopJob(JobDeque* deque) {
+  const auto bottom = deque->bottom.load(std::memory_order_relaxed) - 1;
+  deque->bottom.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto top = deque->top.load(std::memory_order_relaxed);
+  if (top > bottom) {
+    deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  auto job = deque->job_list[bottom & (kJobDequeSize - 1)].load(std::memory_order_relaxed);
+  if (top == bottom) {
+    // last job, race against stealers.
+    if (!deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      job = nullptr;
+    }
+    deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return job;
+}
+Job* StealJob(JobDeque* deque) {
+  auto top = deque->top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const auto bottom = deque->bottom.load(std::memory_order_acquire);
+  if (top >= bottom) { return nullptr; }
+  auto job = deque->job_list[top & (kJobDequeSize - 1)].load(std::memory_order_relaxed);
+  if (!deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  return job;
+}
+auto GetCurrentWorker(const JobSystem* job_system) {
+  DEBUG_ASSERT(current_worker != nullptr && current_worker->job_system == job_system, DebugAssert{});
+  return current_worker;
+}
+auto GetRandomVal(JobWorker* worker) {
+  // xorshift32
+  auto x = worker->random_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  worker->random_state = x;
+  return x;
+}
+JobWorker* ChooseVictim(JobWorker* worker) {
+  const auto worker_num = worker->job_system->worker_num;
+  if (worker_num <= 1) { return nullptr; }
+  const auto victim_index = GetRandomVal(worker) % worker_num;
+  if (victim_index == worker->worker_index) { return nullptr; }
+  return &worker->job_system->worker_list[victim_index];
+}
+/**
+ * low priority jobs are taken only when no other job is found.
+ **/
+Job* FindJob(JobWorker* worker, const bool low_priority_allowed) {
+  if (auto job = PopJob(&worker->deque)) { return job; }
+  auto victim = ChooseVictim(worker);
+  if (victim) {
+    if (auto job = StealJob(&victim->deque)) { return job; }
+  }
+  if (!low_priority_allowed) { return nullptr; }
+  if (auto job = PopJob(&worker->low_priority_deque)) { return job; }
+  if (victim == nullptr) { return nullptr; }
+  return StealJob(&victim->low_priority_deque);
+}
+void FinishJob(Job* job) {
+  // job may be recycled as soon as it is complete.
+  const auto parent = job->parent;
+  const auto unfinished_job_num = job->unfinished_job_num.fetch_sub(1, std::memory_order_acq_rel) - 1;
+  if (unfinished_job_num > 0) { return; }
+  if (parent) {
+    FinishJob(parent);
+  }
+}
+void ExecuteJob(JobSystem* job_system, Job* job) {
+  job->func(job_system, job, job->user_data);
+  FinishJob(job);
+}
+/**
+ * jobs are recycled round robin, skipping ones still running (e.g. a root job waiting for its tree).
+ * while every job of the pool is in flight, the caller runs queued jobs until one of them is recycled.
+ **/
+Job* AllocateJob(JobWorker* worker) {
+  while (true) {
+    for (uint32_t i = 0; i < kJobPoolSize; i++) {
+      auto job = &worker->job_pool[worker->allocated_job_num & (kJobPoolSize - 1)];
+      worker->allocated_job_num++;
+      if (job->unfinished_job_num.load(std::memory_order_acquire) == 0) { return job; }
+    }
+    if (auto job = FindJob(worker, true)) {
+      ExecuteJob(worker->job_system, job);
+      continue;
+    }
+    // nothing to run and no worker thread to recycle jobs, the pool is held by jobs created but never run.
+    DEBUG_ASSERT(worker->job_system->worker_num > 1, DebugAssert{});
+    if (worker->job_system->worker_num <= 1) {
+      spdlog::critical("job pool exhausted. {}", kJobPoolSize);
+      exit(1);
+    }
+    std::this_thread::yield();
+  }
+}
+void WakeSleepingWorkers(JobSystem* job_system) {
+  job_system->job_epoch.fetch_add(1, std::memory_order_seq_cst);
+  if (job_system->sleeping_worker_num.load(std::memory_order_seq_cst) == 0) { return; }
+  std::lock_guard<std::mutex> lock(job_system->mutex);
+  job_system->wake_cv.notify_all();
+}
+void WorkerThreadLoop(JobWorker* worker) {
+  current_worker = worker;
+  auto job_system = worker->job_system;
+  uint32_t failed_attempt_num = 0;
+  while (!job_system->terminate.load(std::memory_order_acquire)) {
+    const auto job_epoch = job_system->job_epoch.load(std::memory_order_seq_cst);
+    if (auto job = FindJob(worker, true)) {
+      ExecuteJob(job_system, job);
+      failed_attempt_num = 0;
+      continue;
+    }
+    failed_attempt_num++;
+    if (failed_attempt_num < kStealAttemptNumBeforeSleep) {
+      std::this_thread::yield();
+      continue;
+    }
+    failed_attempt_num = 0;
+    std::unique_lock<std::mutex> lock(job_system->mutex);
+    job_system->sleeping_worker_num.fetch_add(1, std::memory_order_seq_cst);
+    job_system->wake_cv.wait(lock, [job_system, job_epoch]() {
+      return job_system->terminate.load(std::memory_order_acquire) || job_system->job_epoch.load(std::memory_order_seq_cst) != job_epoch;
+    });
+    job_system->sleeping_worker_num.fetch_sub(1, std::memory_order_seq_cst);
+  }
+  current_worker = nullptr;
+}
+void InitJobDeque(JobDeque* deque) {
+  deque->job_list = AllocateArray<std::atomic<Job*>>(kJobDequeSize);
+  for (uint32_t i = 0; i < kJobDequeSize; i++) {
+    new (&deque->job_list[i]) std::atomic<Job*>(nullptr);
+  }
+}
+void InitJobWorker(JobSystem* job_system, const uint32_t worker_index, JobWorker* worker) {
+  new (worker) JobWorker{
+    .job_system = job_system,
+    .worker_index = worker_index,
+    .job_pool = AllocateArray<Job>(kJobPoolSize),
+    .random_state = 0x9E3779B9u * (worker_index + 1),
+  };
+  InitJobDeque(&worker->deque);
+  InitJobDeque(&worker->low_priority_deque);
+  for (uint32_t i = 0; i < kJobPoolSize; i++) {
+    new (&worker->job_pool[i]) Job{};
+  }
+}
+void ReleaseJobWorker(JobWorker* worker) {
+  Deallocate(worker->deque.job_list);
+  Deallocate(worker->low_priority_deque.job_list);
+  Deallocate(worker->job_pool);
+  worker->~JobWorker();
+}
+struct ParallelForParams {
+  ParallelForFunc func{};
+  void* user_data{};
+  uint32_t min_batch_size{};
+};
+/**
+ * hands the upper half of the range to a child job until the rest fits in a batch.
+ **/
+void ParallelForJob(JobSystem* job_system, Job* job, void* user_data) {
+  const auto params = static_cast<const ParallelForParams*>(user_data);
+  const auto begin = job->begin;
+  auto end = job->end;
+  while (end - begin > params->min_batch_size) {
+    const auto mid = begin + (end - begin) / 2;
+    auto child = CreateChildJob(job_system, job, ParallelForJob, user_data);
+    child->begin = mid;
+    child->end = end;
+    RunJob(job_system, child);
+    end = mid;
+  }
+  params->func(params->user_data, begin, end);
+}
+} // namespace
+namespace boke {
+JobSystem* CreateJobSystem(const uint32_t worker_thread_num) {
+  auto job_system = New<JobSystem>();
+  job_system->worker_num = worker_thread_num + 1;
+  job_system->worker_list = AllocateArray<JobWorker>(job_system->worker_num);
+  for (uint32_t i = 0; i < job_system->worker_num; i++) {
+    InitJobWorker(job_system, i, &job_system->worker_list[i]);
+  }
+  DEBUG_ASSERT(current_worker == nullptr, DebugAssert{});
+  current_worker = &job_system->worker_list[0];
+  if (worker_thread_num == 0) { return job_system; }
+  job_system->worker_thread_list = AllocateArray<std::thread>(worker_thread_num);
+  for (uint32_t i = 0; i < worker_thread_num; i++) {
+    new (&job_system->worker_thread_list[i]) std::thread(WorkerThreadLoop, &job_system->worker_list[i + 1]);
+  }
+  return job_system;
+}
+void ReleaseJobSystem(JobSystem* job_system) {
+  DEBUG_ASSERT(GetCurrentWorker(job_system)->worker_index == 0, DebugAssert{});
+  {
+    std::lock_guard<std::mutex> lock(job_system->mutex);
+    job_system->terminate.store(true, std::memory_order_release);
+  }
+  job_system->wake_cv.notify_all();
+  const auto worker_thread_num = job_system->worker_num - 1;
+  for (uint32_t i = 0; i < worker_thread_num; i++) {
+    job_system->worker_thread_list[i].join();
+    job_system->worker_thread_list[i].~thread();
+  }
+  if (job_system->worker_thread_list) {
+    Deallocate(job_system->worker_thread_list);
+  }
+  current_worker = nullptr;
+  for (uint32_t i = 0; i < job_system->worker_num; i++) {
+    ReleaseJobWorker(&job_system->worker_list[i]);
+  }
+  Deallocate(job_system->worker_list);
+  job_system->~JobSystem();
+  Deallocate(job_system);
+}
+uint32_t GetJobSystemThreadNum(const JobSystem* job_system) {
+  return job_system->worker_num;
+}
+Job* CreateJob(JobSystem* job_system, JobFunc func, void* user_data) {
+  auto job = AllocateJob(GetCurrentWorker(job_system));
+  job->func = func;
+  job->user_data = user_data;
+  job->parent = nullptr;
+  job->unfinished_job_num.store(1, std::memory_order_relaxed);
+  job->low_priority = false;
+  job->begin = 0;
+  job->end = 0;
+  return job;
+}
+Job* CreateChildJob(JobSystem* job_system, Job* parent, JobFunc func, void* user_data) {
+  parent->unfinished_job_num.fetch_add(1, std::memory_order_relaxed);
+  auto job = CreateJob(job_system, func, user_data);
+  job->parent = parent;
+  return job;
+}
+void RunJob(JobSystem* job_system, Job* job) {
+  PushJob(&GetCurrentWorker(job_system)->deque, job);
+  WakeSleepingWorkers(job_system);
+}
+void RunLowPriorityJob(JobSystem* job_system, Job* job) {
+  job->low_priority = true;
+  PushJob(&GetCurrentWorker(job_system)->low_priority_deque, job);
+  WakeSleepingWorkers(job_system);
+}
+void WaitJob(JobSystem* job_system, const Job* job) {
+  auto worker = GetCurrentWorker(job_system);
+  const auto low_priority_allowed = job->low_priority;
+  while (!IsJobComplete(job)) {
+    if (auto next_job = FindJob(worker, low_priority_allowed)) {
+      ExecuteJob(job_system, next_job);
+      continue;
+    }
+    std::this_thread::yield();
+  }
+}
+bool IsJobComplete(const Job* job) {
+  return job->unfinished_job_num.load(std::memory_order_acquire) == 0;
+}
+void ParallelFor(JobSystem* job_system, const uint32_t count, const uint32_t min_batch_size, ParallelForFunc func, void* user_data) {
+  if (count == 0) { return; }
+  ParallelForParams params{
+    .func = func,
+    .user_data = user_data,
+    .min_batch_size = (min_batch_size > 0) ? min_batch_size : 1,
+  };
+  auto job = CreateJob(job_system, ParallelForJob, &params);
+  job->begin = 0;
+  job->end = count;
+  ExecuteJob(job_system, job);
+  WaitJob(job_system, job);
+}
+} // namespace boke
+#include <memory>
+#include "doctest/doctest.h"
+namespace {
+void EmptyJob(boke::JobSystem*, boke::Job*, void*) {}
+struct FibonacciJobData {
+  uint32_t n{};
+  uint64_t result{};
+};
+/**
+ * forks two jobs and joins them with WaitJob, which keeps this thread busy with other jobs meanwhile.
+ **/
+void FibonacciJob(boke::JobSystem* job_system, boke::Job*, void* user_data) {
+  using namespace boke;
+  auto data = static_cast<FibonacciJobData*>(user_data);
+  if (data->n < 2) {
+    data->result = data->n;
+    return;
+  }
+  FibonacciJobData child_data[2]{{.n = data->n - 1,}, {.n = data->n - 2,}};
+  auto join = CreateJob(job_system, EmptyJob, nullptr);
+  for (auto& d : child_data) {
+    RunJob(job_system, CreateChildJob(job_system, join, FibonacciJob, &d));
+  }
+  RunJob(job_system, join);
+  WaitJob(job_system, join);
+  data->result = child_data[0].result + child_data[1].result;
+}
+struct ParallelForTestAsset {
+  static const uint32_t kCount = 10000;
+  uint32_t visited_count[kCount]{};
+  std::atomic<uint32_t> batch_num{};
+};
+void VisitRange(void* user_data, const uint32_t begin, const uint32_t end) {
+  auto asset = static_cast<ParallelForTestAsset*>(user_data);
+  for (uint32_t i = begin; i < end; i++) {
+    asset->visited_count[i]++;
+  }
+  asset->batch_num++;
+}
+struct CounterJobData {
+  std::atomic<uint32_t> executed_num{};
+};
+void CountJob(boke::JobSystem*, boke::Job*, void* user_data) {
+  static_cast<CounterJobData*>(user_data)->executed_num++;
+}
+} // namespace
+TEST_CASE("job system") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 1024 * 1024;
+  auto main_buffer = std::make_unique<std::byte[]>(main_buffer_size_in_bytes);
+  InitAllocator(main_buffer.get(), main_buffer_size_in_bytes);
+  uint32_t worker_thread_num = 0;
+  SUBCASE("no worker thread") {
+    worker_thread_num = 0;
+  }
+  SUBCASE("with worker threads") {
+    worker_thread_num = 3;
+  }
+  auto job_system = CreateJobSystem(worker_thread_num);
+  CHECK_EQ(GetJobSystemThreadNum(job_system), worker_thread_num + 1);
+  SUBCASE("children complete before parent") {
+    CounterJobData data{};
+    auto parent = CreateJob(job_system, CountJob, &data);
+    const uint32_t child_num = 100;
+    for (uint32_t i = 0; i < child_num; i++) {
+      RunJob(job_system, CreateChildJob(job_system, parent, CountJob, &data));
+    }
+    RunJob(job_system, parent);
+    WaitJob(job_system, parent);
+    CHECK_UNARY(IsJobComplete(parent));
+    CHECK_EQ(data.executed_num.load(), child_num + 1);
+  }
+  SUBCASE("more jobs than the pool holds") {
+    CounterJobData data{};
+    auto parent = CreateJob(job_system, CountJob, &data);
+    const uint32_t child_num = kJobPoolSize * 4;
+    for (uint32_t i = 0; i < child_num; i++) {
+      RunJob(job_system, CreateChildJob(job_system, parent, CountJob, &data));
+    }
+    RunJob(job_system, parent);
+    WaitJob(job_system, parent);
+    CHECK_EQ(data.executed_num.load(), child_num + 1);
+  }
+  SUBCASE("low priority jobs") {
+    CounterJobData data{};
+    CounterJobData frame_data{};
+    auto frame_job = CreateJob(job_system, CountJob, &frame_data);
+    RunJob(job_system, frame_job);
+    auto parent = CreateJob(job_system, CountJob, &data);
+    RunLowPriorityJob(job_system, CreateChildJob(job_system, parent, CountJob, &data));
+    RunLowPriorityJob(job_system, parent);
+    WaitJob(job_system, frame_job);
+    CHECK_EQ(frame_data.executed_num.load(), 1);
+    if (worker_thread_num == 0) {
+      // queued after frame_job, yet left alone while waiting for it.
+      CHECK_EQ(data.executed_num.load(), 0);
+    }
+    WaitJob(job_system, parent);
+    CHECK_EQ(data.executed_num.load(), 2);
+  }
+  SUBCASE("fork join") {
+    FibonacciJobData data{.n = 16,};
+    auto job = CreateJob(job_system, FibonacciJob, &data);
+    RunJob(job_system, job);
+    WaitJob(job_system, job);
+    CHECK_EQ(data.result, 987);
+  }
+  SUBCASE("parallel for") {
+    auto asset = std::make_unique<ParallelForTestAsset>();
+    ParallelFor(job_system, ParallelForTestAsset::kCount, 64, VisitRange, asset.get());
+    for (uint32_t i = 0; i < ParallelForTestAsset::kCount; i++) {
+      if (asset->visited_count[i] == 1) { continue; }
+      CAPTURE(i);
+      CHECK_EQ(asset->visited_count[i], 1);
+    }
+    CHECK_GE(asset->batch_num.load(), ParallelForTestAsset::kCount / 64);
+    // job pools wrap around across frames.
+    for (uint32_t frame = 0; frame < 8; frame++) {
+      ParallelFor(job_system, ParallelForTestAsset::kCount, 64, VisitRange, asset.get());
+    }
+    CHECK_EQ(asset->visited_count[0], 9);
+    CHECK_EQ(asset->visited_count[ParallelForTestAsset::kCount - 1], 9);
+  }
+  SUBCASE("empty parallel for") {
+    ParallelFor(job_system, 0, 64, VisitRange, nullptr);
+  }
+  ReleaseJobSystem(job_system);
+}
@@ -1,15 +1,76 @@
 #include "json.h"
-#include <windows.h>
+#include <algorithm>
+#include <limits>
 #include "boke/allocator.h"
-#include "boke/file.h"
+#include "boke/debug_assert.h"
+#include "boke/util.h"
+#include "platform/file_io.h"
+namespace {
+using namespace boke;
+const uint32_t kJsonAlignment = 8; // RAPIDJSON_ALIGN
+char* LoadJsonText(const char* const json_path, JsonPoolAllocator& allocator) {
+  auto file = OpenFile(json_path);
+  if (file == kInvalidFileHandle) { return nullptr; }
+  const auto file_size = GetFileSize(file);
+  if (file_size >= std::numeric_limits<uint32_t>::max()) {
+    CloseFile(file);
+    return nullptr;
+  }
+  const auto text_size = static_cast<uint32_t>(file_size);
+  auto text = static_cast<char*>(allocator.Malloc(text_size + 1));
+  const auto read_size = ReadFileToBuffer(file, text_size, text);
+  CloseFile(file);
+  if (read_size != text_size) { return nullptr; }
+  text[text_size] = '\0';
+  return text;
+}
+} // namespace
 namespace boke {
-rapidjson::Document GetJson(const char* const json_path) {
-  using namespace boke;
-  using namespace rapidjson;
-  auto json_text = LoadFileToBuffer(json_path);
-  Document d;
-  d.Parse(json_text);
-  Deallocate(json_text);
+void* JsonAllocator::Malloc(size_t size) {
+  if (size == 0) { return nullptr; }
+  return Allocate(GetUint32(size), kJsonAlignment);
+}
+void* JsonAllocator::Realloc(void* original_ptr, size_t original_size, size_t new_size) {
+  if (new_size == 0) {
+    Free(original_ptr);
+    return nullptr;
+  }
+  auto ptr = Malloc(new_size);
+  if (original_ptr != nullptr) {
+    memcpy(ptr, original_ptr, std::min(original_size, new_size));
+    Free(original_ptr);
+  }
+  return ptr;
+}
+void JsonAllocator::Free(void* ptr) {
+  Deallocate(ptr);
+}
+JsonAllocator* GetJsonBaseAllocator() {
+  static JsonAllocator allocator;
+  return &allocator;
+}
+JsonDocument::JsonDocument() : JsonDocument(New<JsonPoolAllocator>()) {}
+JsonDocument::JsonDocument(JsonPoolAllocator* pool_allocator)
+    : Base(pool_allocator, JsonPoolAllocator::kChunkCapacity, GetJsonBaseAllocator())
+    , pool_allocator_(pool_allocator) {}
+JsonDocument::JsonDocument(JsonDocument&& other)
+    : Base(std::move(other))
+    , pool_allocator_(other.pool_allocator_) {
+  other.pool_allocator_ = nullptr;
+}
+JsonDocument::~JsonDocument() {
+  if (pool_allocator_ == nullptr) { return; }
+  // values live in the pool and are not touched by ~GenericDocument as it does not own the allocator.
+  pool_allocator_->~JsonPoolAllocator();
+  Deallocate(pool_allocator_);
+}
+JsonDocument GetJson(const char* const json_path) {
+  JsonDocument d;
+  auto text = LoadJsonText(json_path, d.GetAllocator());
+  DEBUG_ASSERT(text != nullptr, DebugAssert{});
+  if (text == nullptr) { return d; }
+  d.ParseInsitu(text);
+  DEBUG_ASSERT(!d.HasParseError(), DebugAssert{});
   return d;
 }
 } // namespace boke
@@ -23,3 +84,21 @@ TEST_CASE("json") {
   auto json = GetJson(config_path);
   CHECK_EQ(json["testval"], 123);
 }
+TEST_CASE("json memory is taken from engine heap") {
+  using namespace boke;
+  const uint32_t main_buffer_size_in_bytes = 64 * 1024;
+  std::byte main_buffer[main_buffer_size_in_bytes];
+  InitAllocator(main_buffer, main_buffer_size_in_bytes);
+  const auto free_size_before_parse = GetAllocatorStats().free_size;
+  {
+    auto json = GetJson("tests/resources.json");
+    CHECK_LT(GetAllocatorStats().free_size, free_size_before_parse);
+    REQUIRE_UNARY(json.IsArray());
+    REQUIRE_GT(json.Size(), 0);
+    const auto& name = json[0]["name"];
+    CHECK_UNARY(name.IsString());
+    CHECK_GE(reinterpret_cast<std::uintptr_t>(name.GetString()), reinterpret_cast<std::uintptr_t>(main_buffer));
+    CHECK_LT(reinterpret_cast<std::uintptr_t>(name.GetString()), reinterpret_cast<std::uintptr_t>(main_buffer) + main_buffer_size_in_bytes);
+  }
+  CHECK_EQ(GetAllocatorStats().free_size, free_size_before_parse);
+}
@@ -1,4 +1,53 @@
 #pragma once
 namespace boke {
-rapidjson::Document GetJson(const char* const json_path);
+/**
+ * rapidjson allocator on top of the engine heap.
+ **/
+class JsonAllocator final {
+ public:
+  static const bool kNeedFree = true;
+  void* Malloc(size_t size);
+  void* Realloc(void* original_ptr, size_t original_size, size_t new_size);
+  static void Free(void* ptr);
+  bool operator==(const JsonAllocator&) const { return true; }
+  bool operator!=(const JsonAllocator&) const { return false; }
+};
+/**
+ * JsonAllocator has no state, rapidjson objects share this instance
+ * instead of creating their own with RAPIDJSON_NEW.
+ **/
+JsonAllocator* GetJsonBaseAllocator();
+/**
+ * pool with smaller chunks than rapidjson's default (64KiB)
+ * so that configs fit in small test heaps.
+ **/
+class JsonPoolAllocator final : public rapidjson::MemoryPoolAllocator<JsonAllocator> {
+ public:
+  static const size_t kChunkCapacity = 4 * 1024;
+  JsonPoolAllocator() : rapidjson::MemoryPoolAllocator<JsonAllocator>(kChunkCapacity, GetJsonBaseAllocator()) {}
+};
+using JsonValue = rapidjson::GenericValue<rapidjson::UTF8<>, JsonPoolAllocator>;
+/**
+ * rapidjson document whose pool is created on the engine heap.
+ * a document without allocator would create it with RAPIDJSON_NEW (crt heap).
+ **/
+class JsonDocument final : public rapidjson::GenericDocument<rapidjson::UTF8<>, JsonPoolAllocator, JsonAllocator> {
+ public:
+  using Base = rapidjson::GenericDocument<rapidjson::UTF8<>, JsonPoolAllocator, JsonAllocator>;
+  JsonDocument();
+  JsonDocument(JsonDocument&& other);
+  ~JsonDocument();
+  JsonDocument(const JsonDocument&) = delete;
+  JsonDocument& operator=(const JsonDocument&) = delete;
+  JsonDocument& operator=(JsonDocument&&) = delete;
+ private:
+  explicit JsonDocument(JsonPoolAllocator* pool_allocator);
+  JsonPoolAllocator* pool_allocator_{};
+};
+/**
+ * file text is read into the document's pool and parsed in-situ,
+ * so strings point into the text instead of being copied.
+ * the document must be destroyed before the engine allocator buffer is released.
+ **/
+JsonDocument GetJson(const char* const json_path);
 }
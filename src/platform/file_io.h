@@ -0,0 +1,41 @@
+#pragma once
+#include "boke/file.h"
+namespace boke {
+/**
+ * per-platform file primitives, implemented in file_io_win32.cpp and file_io_posix.cpp.
+ **/
+using FileHandle = intptr_t;
+constexpr FileHandle kInvalidFileHandle = -1;
+FileHandle OpenFile(const char* const filepath);
+void CloseFile(const FileHandle file);
+uint64_t GetFileSize(const FileHandle file);
+uint32_t ReadFileToBuffer(const FileHandle file, const uint32_t file_size, void* buffer);
+/**
+ * creates the file or truncates an existing one.
+ **/
+FileHandle CreateFileForWrite(const char* const filepath);
+uint32_t WriteBufferToFile(const FileHandle file, const uint32_t size, const void* buffer);
+bool RemoveFile(const char* const filepath);
+/**
+ * read-only view of the whole file which stays valid after the handle is closed.
+ **/
+MappedFile MapFileView(const FileHandle file, const uint64_t file_size);
+/**
+ * private view which can be written to. changes are never written back to the file.
+ **/
+MappedFile MapFileViewCopyOnWrite(const FileHandle file, const uint64_t file_size);
+void UnmapFileView(const MappedFile& file);
+/**
+ * reports names of files written to or moved into a directory, subdirectories are not watched.
+ * changes made before CreateDirectoryWatch are not reported, a name may be reported more than once per change.
+ **/
+struct DirectoryWatch;
+DirectoryWatch* CreateDirectoryWatch(const char* const directory);
+void ReleaseDirectoryWatch(DirectoryWatch*);
+using DirectoryChangeCallback = void (*)(void* user_data, const char* const filename);
+/**
+ * calls callback for changes since the last call and returns without blocking.
+ * filename is nullptr when the system dropped changes (queue overflow), any file in the directory may have changed.
+ **/
+void ReadDirectoryChanges(DirectoryWatch*, DirectoryChangeCallback callback, void* user_data);
+}
@@ -0,0 +1,109 @@
+#include "file_io.h"
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "boke/allocator.h"
+namespace {
+int GetDescriptor(const boke::FileHandle file) {
+  return static_cast<int>(file);
+}
+boke::MappedFile MapFileViewImpl(const boke::FileHandle file, const uint64_t file_size, const int protection) {
+  // the mapping stays valid after closing the descriptor.
+  // MAP_PRIVATE keeps writes to copy-on-write views away from the file.
+  auto view = mmap(nullptr, file_size, protection, MAP_PRIVATE, GetDescriptor(file), 0);
+  if (view == MAP_FAILED) { return {}; }
+  posix_madvise(view, file_size, POSIX_MADV_SEQUENTIAL);
+  return {
+    .buffer = static_cast<const char*>(view),
+    .size = file_size,
+  };
+}
+} // namespace
+namespace boke {
+struct DirectoryWatch {
+  int descriptor{-1};
+};
+FileHandle OpenFile(const char* const filepath) {
+  return open(filepath, O_RDONLY | O_CLOEXEC);
+}
+void CloseFile(const FileHandle file) {
+  close(GetDescriptor(file));
+}
+uint64_t GetFileSize(const FileHandle file) {
+  if (file == kInvalidFileHandle) { return 0; }
+  struct stat file_stat{};
+  if (fstat(GetDescriptor(file), &file_stat) != 0) { return 0; }
+  return static_cast<uint64_t>(file_stat.st_size);
+}
+uint32_t ReadFileToBuffer(const FileHandle file, const uint32_t file_size, void* buffer) {
+  uint32_t bytes_read = 0;
+  while (bytes_read < file_size) {
+    const auto result = read(GetDescriptor(file), static_cast<char*>(buffer) + bytes_read, file_size - bytes_read);
+    if (result <= 0) { break; }
+    bytes_read += static_cast<uint32_t>(result);
+  }
+  return bytes_read;
+}
+FileHandle CreateFileForWrite(const char* const filepath) {
+  return open(filepath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+}
+uint32_t WriteBufferToFile(const FileHandle file, const uint32_t size, const void* buffer) {
+  uint32_t bytes_written = 0;
+  while (bytes_written < size) {
+    const auto result = write(GetDescriptor(file), static_cast<const char*>(buffer) + bytes_written, size - bytes_written);
+    if (result <= 0) { break; }
+    bytes_written += static_cast<uint32_t>(result);
+  }
+  return bytes_written;
+}
+bool RemoveFile(const char* const filepath) {
+  return unlink(filepath) == 0;
+}
+MappedFile MapFileView(const FileHandle file, const uint64_t file_size) {
+  return MapFileViewImpl(file, file_size, PROT_READ);
+}
+MappedFile MapFileViewCopyOnWrite(const FileHandle file, const uint64_t file_size) {
+  return MapFileViewImpl(file, file_size, PROT_READ | PROT_WRITE);
+}
+void UnmapFileView(const MappedFile& file) {
+  munmap(const_cast<char*>(file.buffer), file.size);
+}
+DirectoryWatch* CreateDirectoryWatch(const char* const directory) {
+  const auto descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (descriptor < 0) { return nullptr; }
+  // IN_CLOSE_WRITE instead of IN_MODIFY so that files are reported once fully written.
+  if (inotify_add_watch(descriptor, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+    close(descriptor);
+    return nullptr;
+  }
+  auto watch = New<DirectoryWatch>();
+  watch->descriptor = descriptor;
+  return watch;
+}
+void ReleaseDirectoryWatch(DirectoryWatch* watch) {
+  if (watch == nullptr) { return; }
+  close(watch->descriptor);
+  Deallocate(watch);
+}
+void ReadDirectoryChanges(DirectoryWatch* watch, DirectoryChangeCallback callback, void* user_data) {
+  if (watch == nullptr) { return; }
+  alignas(inotify_event) char buffer[4096];
+  while (true) {
+    // fails with EAGAIN once the queue is drained.
+    const auto size = read(watch->descriptor, buffer, sizeof(buffer));
+    if (size <= 0) { break; }
+    for (ssize_t offset = 0; offset < size;) {
+      const auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+      if (event->mask & IN_Q_OVERFLOW) {
+        callback(user_data, nullptr);
+        continue;
+      }
+      if (event->len == 0) { continue; }
+      callback(user_data, event->name);
+    }
+  }
+}
+} // namespace boke
@@ -0,0 +1,121 @@
+#include "file_io.h"
+#include <windows.h>
+#include "boke/allocator.h"
+namespace {
+HANDLE GetHandle(const boke::FileHandle file) {
+  return reinterpret_cast<HANDLE>(file);
+}
+boke::MappedFile MapFileViewImpl(const boke::FileHandle file, const uint64_t file_size, const DWORD protection, const DWORD access) {
+  // the view keeps the mapping alive, so the mapping handle can be closed right away.
+  auto mapping = CreateFileMapping(GetHandle(file), NULL, protection, 0, 0, NULL);
+  if (mapping == NULL) { return {}; }
+  auto view = MapViewOfFile(mapping, access, 0, 0, 0);
+  CloseHandle(mapping);
+  if (view == NULL) { return {}; }
+  return {
+    .buffer = static_cast<const char*>(view),
+    .size = file_size,
+  };
+}
+const DWORD kDirectoryChangeFilter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME;
+} // namespace
+namespace boke {
+struct DirectoryWatch {
+  HANDLE directory{};
+  OVERLAPPED overlapped{};
+  alignas(DWORD) char buffer[16 * 1024]{};
+};
+} // namespace boke
+namespace {
+auto IssueDirectoryRead(boke::DirectoryWatch* watch) {
+  ResetEvent(watch->overlapped.hEvent);
+  return ReadDirectoryChangesW(watch->directory, watch->buffer, sizeof(watch->buffer), FALSE, kDirectoryChangeFilter, NULL, &watch->overlapped, NULL) != 0;
+}
+} // namespace
+namespace boke {
+FileHandle OpenFile(const char* const filepath) {
+  auto file = CreateFile(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  return reinterpret_cast<FileHandle>(file);
+}
+void CloseFile(const FileHandle file) {
+  CloseHandle(GetHandle(file));
+}
+uint64_t GetFileSize(const FileHandle file) {
+  if (file == kInvalidFileHandle) { return 0; }
+  LARGE_INTEGER file_size{};
+  if (!GetFileSizeEx(GetHandle(file), &file_size)) { return 0; }
+  return static_cast<uint64_t>(file_size.QuadPart);
+}
+uint32_t ReadFileToBuffer(const FileHandle file, const uint32_t file_size, void* buffer) {
+  DWORD bytes_read{};
+  ReadFile(GetHandle(file), buffer, file_size, &bytes_read, NULL);
+  return bytes_read;
+}
+FileHandle CreateFileForWrite(const char* const filepath) {
+  auto file = CreateFile(filepath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  return reinterpret_cast<FileHandle>(file);
+}
+uint32_t WriteBufferToFile(const FileHandle file, const uint32_t size, const void* buffer) {
+  DWORD bytes_written{};
+  WriteFile(GetHandle(file), buffer, size, &bytes_written, NULL);
+  return bytes_written;
+}
+bool RemoveFile(const char* const filepath) {
+  return DeleteFile(filepath) != 0;
+}
+MappedFile MapFileView(const FileHandle file, const uint64_t file_size) {
+  return MapFileViewImpl(file, file_size, PAGE_READONLY, FILE_MAP_READ);
+}
+MappedFile MapFileViewCopyOnWrite(const FileHandle file, const uint64_t file_size) {
+  return MapFileViewImpl(file, file_size, PAGE_WRITECOPY, FILE_MAP_COPY);
+}
+void UnmapFileView(const MappedFile& file) {
+  UnmapViewOfFile(file.buffer);
+}
+DirectoryWatch* CreateDirectoryWatch(const char* const directory) {
+  auto handle = CreateFile(directory, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+  if (handle == INVALID_HANDLE_VALUE) { return nullptr; }
+  auto watch = New<DirectoryWatch>();
+  watch->directory = handle;
+  watch->overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+  // changes are buffered by the system from the first read on.
+  if (!IssueDirectoryRead(watch)) {
+    ReleaseDirectoryWatch(watch);
+    return nullptr;
+  }
+  return watch;
+}
+void ReleaseDirectoryWatch(DirectoryWatch* watch) {
+  if (watch == nullptr) { return; }
+  CancelIoEx(watch->directory, &watch->overlapped);
+  DWORD size{};
+  GetOverlappedResult(watch->directory, &watch->overlapped, &size, TRUE);
+  CloseHandle(watch->overlapped.hEvent);
+  CloseHandle(watch->directory);
+  Deallocate(watch);
+}
+void ReadDirectoryChanges(DirectoryWatch* watch, DirectoryChangeCallback callback, void* user_data) {
+  if (watch == nullptr) { return; }
+  DWORD size{};
+  while (GetOverlappedResult(watch->directory, &watch->overlapped, &size, FALSE)) {
+    // size is zero when the buffer overflowed and changes were dropped.
+    if (size == 0) {
+      callback(user_data, nullptr);
+    }
+    for (DWORD offset = 0; offset < size;) {
+      const auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(watch->buffer + offset);
+      if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+        char filename[MAX_PATH];
+        const auto len = WideCharToMultiByte(CP_UTF8, 0, info->FileName, static_cast<int>(info->FileNameLength / sizeof(WCHAR)), filename, MAX_PATH - 1, NULL, NULL);
+        if (len > 0) {
+          filename[len] = '\0';
+          callback(user_data, filename);
+        }
+      }
+      if (info->NextEntryOffset == 0) { break; }
+      offset += info->NextEntryOffset;
+    }
+    if (!IssueDirectoryRead(watch)) { break; }
+  }
+}
+} // namespace boke